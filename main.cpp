@@ -1,25 +1,212 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include <QCommandLineParser>
+#include <QThread>
+#include <QDebug>
 #include "MapController.hpp"
+#include "ConflictDetector.hpp"
+#include "TelemetryBus.hpp"
+#include "SharedTelemetryExport.hpp"
+#include "TelemetryHistory.hpp"
+#include "TelemetryChartModel.hpp"
+#include "TelemetrySeriesItem.hpp"
+#include "VehiclePositions.hpp"
+#include "TelemetryPresenter.hpp"
+#include "VehicleMarkerLayer.hpp"
+#include "VehicleTracks.hpp"
+#include "VehicleTrackLayer.hpp"
 #include "TelemetryData.hpp"
 #include "TelemetryDataSimulator.hpp"
+#include "TelemetryDataLink.hpp"
+#include "TelemetryDataReplay.hpp"
+#include "FleetSimulator.hpp"
+#include "FleetVehicle.hpp"
+#include "FlightRecorder.hpp"
+#include "Geofence.hpp"
+#include "SimulationThread.hpp"
+#include "EventLog.hpp"
 
 int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption fleetOption("fleet", "Simulate a fleet of <count> vehicles and display the first one.", "count");
+    parser.addOption(fleetOption);
+    QCommandLineOption threadsOption("threads", "Step the fleet on <count> threads, by default one per core.", "count");
+    parser.addOption(threadsOption);
+    QCommandLineOption warpOption("warp", "Run the simulation or replay <factor> times faster than real time; 0 runs the simulation as fast as possible.", "factor", "1");
+    parser.addOption(warpOption);
+    QCommandLineOption linkOption("link", "Receive telemetry of a real vehicle on UDP <port>.", "port");
+    parser.addOption(linkOption);
+    QCommandLineOption replayOption("replay", "Replay a recorded flight log <file>.", "file");
+    parser.addOption(replayOption);
+    QCommandLineOption vehicleOption("vehicle", "Display the vehicle with <id> when receiving or replaying telemetry.", "id", "1");
+    parser.addOption(vehicleOption);
+    QCommandLineOption recordOption("record", "Record the displayed vehicle's telemetry into flight log <file>.", "file");
+    parser.addOption(recordOption);
+    QCommandLineOption logOption("log", "Write flight events to <file> instead of the console.", "file");
+    parser.addOption(logOption);
+    QCommandLineOption geofenceOption("geofence", "Check vehicles against the zones of fence <file>.", "file");
+    parser.addOption(geofenceOption);
+    QCommandLineOption exportOption("export", "Export telemetry into POSIX shared memory <name> for other processes on this host.", "name");
+    parser.addOption(exportOption);
+    parser.process(app);
+
+    bool timeWarpValid = false;
+    const double timeWarp = parser.value(warpOption).toDouble(&timeWarpValid);
+    if (!timeWarpValid || !qIsFinite(timeWarp) || timeWarp < 0.0) {
+        qCritical().noquote() << QStringLiteral("Invalid time warp factor: %1").arg(parser.value(warpOption));
+        return -1;
+    }
+
+    // A recorder records a single vehicle; a fleet publishes all of its
+    // vehicles through the bus only
+    if (parser.isSet(recordOption) && parser.isSet(fleetOption)) {
+        qCritical().noquote() << QStringLiteral("--record cannot be combined with --fleet");
+        return -1;
+    }
+
+    Geofence geofence;
+    if (parser.isSet(geofenceOption) && !geofence.load(parser.value(geofenceOption))) {
+        qCritical().noquote() << geofence.errorString();
+        return -1;
+    }
+    const Geofence* activeGeofence = parser.isSet(geofenceOption) ? &geofence : nullptr;
+
+    // Format logged events on a background thread, away from the simulation
+    if (!EventLog::start(parser.value(logOption))) {
+        return -1;
+    }
+
     QQmlApplicationEngine engine;
-    
-    // Create the telemetry simulator
-    auto* telemetrySimulator = new TelemetryDataSimulator();
+
+    // Predicts losses of separation; only a fleet has more than one vehicle to check
+    auto* conflictDetector = new ConflictDetector(&app);
+
+    // Publishes frames and state transitions to in-process subscribers
+    auto* telemetryBus = new TelemetryBus(&app);
+
+    // Mirror the bus into shared memory for co-located processes if requested
+    if (parser.isSet(exportOption)) {
+        auto* sharedExport = new SharedTelemetryExport(&app);
+        if (!sharedExport->open(parser.value(exportOption))) {
+            qCritical().noquote() << sharedExport->errorString();
+            return -1;
+        }
+        sharedExport->attach(telemetryBus);
+    }
+
+    // Keep the recent telemetry of the first vehicles for history charts
+    auto* telemetryHistory = new TelemetryHistory(TelemetryHistory::DEFAULT_VEHICLE_CAPACITY, &app);
+    telemetryHistory->attach(telemetryBus);
+
+    // Present the position of every vehicle at the display rate to the
+    // map's marker layer and auto-centering
+    auto* vehiclePositions = new VehiclePositions(&app);
+    auto* telemetryPresenter = new TelemetryPresenter(vehiclePositions, &app);
+    telemetryPresenter->attach(telemetryBus);
+
+    // Keep the flown track of the first vehicles for the map's track layer
+    auto* vehicleTracks = new VehicleTracks(VehicleTracks::DEFAULT_VEHICLE_CAPACITY, &app);
+    vehicleTracks->attach(telemetryBus);
+
+    // Create the telemetry source: a single simulated vehicle by default, a
+    // recorded flight, a real vehicle received over UDP, or the first vehicle
+    // of a simulated fleet
+    TelemetryData* telemetryData = nullptr;
+    const int fleetSize = parser.value(fleetOption).toInt();
+    if (parser.isSet(replayOption)) {
+        auto* replay = new TelemetryDataReplay(parser.value(vehicleOption).toUShort(), &app);
+        if (!replay->open(parser.value(replayOption))) {
+            return -1;
+        }
+        replay->setPlaybackRate(timeWarp);
+        replay->play();
+        telemetryData = replay;
+    } else if (parser.isSet(linkOption)) {
+        auto* link = new TelemetryDataLink(parser.value(vehicleOption).toUShort(), &app);
+        if (!link->start(parser.value(linkOption).toUShort())) {
+            return -1;
+        }
+        telemetryData = link;
+    } else if (fleetSize > 0) {
+        auto* fleet = new FleetSimulator(&app);
+        fleet->addVehicles(fleetSize, QGeoCoordinate(42.3314, -83.0458)); // Detroit, MI
+        fleet->setThreadCount(parser.isSet(threadsOption) ? parser.value(threadsOption).toInt() : QThread::idealThreadCount());
+        fleet->clock()->setTimeWarp(timeWarp);
+        fleet->setGeofence(activeGeofence);
+        conflictDetector->setFleet(fleet);
+        telemetryBus->attach(fleet);
+        fleet->start();
+        telemetryData = fleet->vehicle(0);
+    } else {
+        // Step the physics on a worker thread, away from the render loop
+        auto* simulationThread = new SimulationThread(&app);
+        simulationThread->setTimeWarp(timeWarp);
+        auto* simulator = new TelemetryDataSimulator();
+        simulator->setClock(simulationThread->clock());
+        simulationThread->start();
+        telemetryData = simulator;
+    }
+
+    // Fleet vehicles are checked and published by their fleet, all other
+    // sources by themselves
+    if (!qobject_cast<FleetVehicle*>(telemetryData)) {
+        telemetryData->setGeofence(activeGeofence);
+        telemetryBus->attach(telemetryData, parser.value(vehicleOption).toUShort());
+    }
+
+    // Chart the recent trend of the displayed vehicle; fleet vehicles are
+    // published under their fleet index
+    auto* chartModel = new TelemetryChartModel(telemetryHistory, &app);
+    chartModel->setVehicle(qobject_cast<FleetVehicle*>(telemetryData) ? 0 : parser.value(vehicleOption).toUInt());
+    telemetryPresenter->setVehicle(chartModel->vehicle());
+
+    // Record the displayed vehicle under the id it is published with
+    if (parser.isSet(recordOption)) {
+        auto* recorder = new FlightRecorder(&app);
+        if (!recorder->open(parser.value(recordOption))) {
+            return -1;
+        }
+        recorder->attach(telemetryData, quint16(chartModel->vehicle()));
+    }
 
     auto* mapController = new MapController();
 
     // Register the UASState enum type with QML
     qmlRegisterUncreatableType<UASState>("GroundControlStation", 1, 0, "UASState", "UASState is an enum type, not creatable");
-    
-    // Register simulator instance as the TelemetryData singleton in QML
-    qmlRegisterSingletonInstance<TelemetryData>("GroundControlStation", 1, 0, "TelemetryData", telemetrySimulator);
+
+    // Register the telemetry source as the TelemetryData singleton in QML
+    qmlRegisterSingletonInstance<TelemetryData>("GroundControlStation", 1, 0, "TelemetryData", telemetryData);
+
+    // Register the TelemetryHistory::Channel enum type with QML
+    qmlRegisterUncreatableType<TelemetryHistory>("GroundControlStation", 1, 0, "TelemetryHistory", "TelemetryHistory is only available for its enums");
+
+    // Register the chart model as the TelemetryChart singleton in QML
+    qmlRegisterSingletonInstance<TelemetryChartModel>("GroundControlStation", 1, 0, "TelemetryChart", chartModel);
+
+    // Register the scene graph line chart as the TelemetrySeries type in QML
+    qmlRegisterType<TelemetrySeriesItem>("GroundControlStation", 1, 0, "TelemetrySeries");
+
+    // Register the vehicle positions as the VehiclePositions singleton in QML
+    qmlRegisterSingletonInstance<VehiclePositions>("GroundControlStation", 1, 0, "VehiclePositions", vehiclePositions);
+
+    // Register the presenter as the TelemetryPresenter singleton in QML
+    qmlRegisterSingletonInstance<TelemetryPresenter>("GroundControlStation", 1, 0, "TelemetryPresenter", telemetryPresenter);
+
+    // Register the batched map marker overlay as the VehicleMarkers type in QML
+    qmlRegisterType<VehicleMarkerLayer>("GroundControlStation", 1, 0, "VehicleMarkers");
+
+    // Register the vehicle tracks as the VehicleTracks singleton in QML
+    qmlRegisterSingletonInstance<VehicleTracks>("GroundControlStation", 1, 0, "VehicleTracks", vehicleTracks);
+
+    // Register the simplified track overlay as the VehicleTrack type in QML
+    qmlRegisterType<VehicleTrackLayer>("GroundControlStation", 1, 0, "VehicleTrack");
+
+    // Register the conflict detector as the ConflictDetector singleton in QML
+    qmlRegisterSingletonInstance<ConflictDetector>("GroundControlStation", 1, 0, "ConflictDetector", conflictDetector);
 
     // Register mapcontroller instance as a QML singleton
     qmlRegisterSingletonInstance<MapController>("GroundControlStation", 1, 0, "MapController", mapController);
@@ -33,5 +220,7 @@ int main(int argc, char *argv[])
 
     engine.loadFromModule("GroundControlStation", "Main");
 
-    return app.exec();
+    const int result = app.exec();
+    EventLog::stop();
+    return result;
 }
@@ -0,0 +1,414 @@
+#include "ConflictDetector.hpp"
+#include "EventLog.hpp"
+#include "FleetSimulator.hpp"
+#include "Geodesy.hpp"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/** @brief Squared relative speed below which two vehicles count as moving in parallel */
+constexpr double PARALLEL_EPSILON = 1e-12;
+
+/** @brief Relative climb rate below which two vehicles count as level with each other */
+constexpr double LEVEL_EPSILON = 1e-9;
+
+} // namespace
+
+/**
+ * @brief Constructs a ConflictDetector with the default separations and horizon
+ * @param parent The parent QObject
+ */
+ConflictDetector::ConflictDetector(QObject* parent)
+    : QObject(parent)
+    , m_horizontalSeparation(DEFAULT_HORIZONTAL_SEPARATION)
+    , m_verticalSeparation(DEFAULT_VERTICAL_SEPARATION)
+    , m_horizon(DEFAULT_HORIZON)
+    , m_fleet(nullptr)
+    , m_candidateCount(0)
+    , m_detectionTime(0)
+    , m_lastTime(-1)
+{
+}
+
+double ConflictDetector::horizontalSeparation() const
+{
+    return m_horizontalSeparation;
+}
+
+void ConflictDetector::setHorizontalSeparation(double meters)
+{
+    if (meters > 0.0) {
+        m_horizontalSeparation = meters;
+    }
+}
+
+double ConflictDetector::verticalSeparation() const
+{
+    return m_verticalSeparation;
+}
+
+void ConflictDetector::setVerticalSeparation(double meters)
+{
+    if (meters > 0.0) {
+        m_verticalSeparation = meters;
+    }
+}
+
+double ConflictDetector::horizon() const
+{
+    return m_horizon;
+}
+
+void ConflictDetector::setHorizon(double seconds)
+{
+    m_horizon = qMax(0.0, seconds);
+}
+
+FleetSimulator* ConflictDetector::fleet() const
+{
+    return m_fleet;
+}
+
+/**
+ * @brief Checks a fleet after every tick
+ * @param fleet The fleet, or nullptr to stop; the caller keeps ownership
+ *
+ * The detection is connected directly to FleetSimulator::stepped(), so it
+ * runs on the fleet's thread before the next tick starts. Removing the
+ * fleet clears all conflicts.
+ */
+void ConflictDetector::setFleet(FleetSimulator* fleet)
+{
+    if (m_fleet) {
+        disconnect(m_fleet, nullptr, this, nullptr);
+    }
+
+    m_fleet = fleet;
+    m_lastAltitude.clear();
+    m_lastTime = -1;
+
+    if (m_fleet) {
+        connect(m_fleet, &FleetSimulator::stepped, this, &ConflictDetector::detectFleet, Qt::DirectConnection);
+        connect(m_fleet, &QObject::destroyed, this, [this]() { setFleet(nullptr); });
+        detectFleet();
+    } else {
+        m_tracks.clear();
+        detect(m_tracks);
+    }
+}
+
+/**
+ * @brief Collects the fleet's airborne vehicles and runs detect()
+ *
+ * Climb rates are only known from the second tick on; before that, every
+ * vehicle is assumed to fly level.
+ */
+void ConflictDetector::detectFleet()
+{
+    const int count = m_fleet->vehicleCount();
+    const qint64 time = m_fleet->simulatedTime();
+    const double dt = m_lastTime >= 0 ? (time - m_lastTime) / 1000.0 : 0.0;
+    const quint8* state = m_fleet->stateStore()->states();
+
+    m_lastAltitude.resize(count, 0.0);
+    m_lastTime = time;
+    m_tracks.clear();
+
+    for (int i = 0; i < count; ++i) {
+        const double altitude = m_fleet->altitude(i);
+        if (state[i] != UASState::Landed) {
+            Track track;
+            track.id = i;
+            track.latitude = m_fleet->latitude(i);
+            track.longitude = m_fleet->longitude(i);
+            track.altitude = altitude;
+            track.speed = m_fleet->speed(i);
+            track.heading = m_fleet->heading(i);
+            track.climbRate = dt > 0.0 ? (altitude - m_lastAltitude[i]) / dt : 0.0;
+            m_tracks.push_back(track);
+        }
+        m_lastAltitude[i] = altitude;
+    }
+
+    detect(m_tracks);
+}
+
+/**
+ * @brief Replaces the conflicts with those predicted for a set of tracks
+ * @param tracks The airborne vehicles, with unique ids
+ *
+ * Projects the tracks, hashes their swept boxes into cells sized so that a
+ * box covers at most two cells per axis, and tests every pair sharing a
+ * cell whose boxes overlap. The hash table has at least as many buckets as
+ * cell entries and is filled with a counting sort, so building it is
+ * linear in the number of tracks. Conflicts that start are logged as
+ * warnings and conflicts that end as info events, and conflictsChanged() is
+ * emitted once if there were any.
+ */
+void ConflictDetector::detect(const std::vector<Track>& tracks)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<Conflict> previous;
+    previous.swap(m_conflicts);
+    m_candidateCount = 0;
+
+    const int count = static_cast<int>(tracks.size());
+    if (count < 2) {
+        m_detectionTime = timer.nsecsElapsed();
+        reportChanges(previous);
+        return;
+    }
+
+    // Project onto a plane tangent at the first track and sweep over the horizon
+    const double latitude0 = qDegreesToRadians(tracks[0].latitude);
+    const double longitude0 = qDegreesToRadians(tracks[0].longitude);
+    const double metersPerRadianX = Geodesy::EARTH_MEAN_RADIUS * qCos(latitude0);
+    const double pad = m_horizontalSeparation * 0.5;
+
+    m_bodies.resize(count);
+    double originX = std::numeric_limits<double>::max();
+    double originY = std::numeric_limits<double>::max();
+    double maxSpeed = 0.0;
+
+    for (int i = 0; i < count; ++i) {
+        const Track& track = tracks[i];
+        const double heading = qDegreesToRadians(track.heading);
+        Body& body = m_bodies[i];
+
+        body.x = (qDegreesToRadians(track.longitude) - longitude0) * metersPerRadianX;
+        body.y = (qDegreesToRadians(track.latitude) - latitude0) * Geodesy::EARTH_MEAN_RADIUS;
+        body.z = track.altitude;
+        body.vx = track.speed * qSin(heading);
+        body.vy = track.speed * qCos(heading);
+        body.vz = track.climbRate;
+
+        const double endX = body.x + body.vx * m_horizon;
+        const double endY = body.y + body.vy * m_horizon;
+        body.minX = qMin(body.x, endX) - pad;
+        body.maxX = qMax(body.x, endX) + pad;
+        body.minY = qMin(body.y, endY) - pad;
+        body.maxY = qMax(body.y, endY) + pad;
+
+        originX = qMin(originX, body.minX);
+        originY = qMin(originY, body.minY);
+        maxSpeed = qMax(maxSpeed, qAbs(track.speed));
+    }
+
+    // A box is at most 2 * pad + maxSpeed * horizon wide, so it covers up to two cells per axis
+    const double cellSize = m_horizontalSeparation + maxSpeed * m_horizon;
+    const double cellScale = 1.0 / cellSize;
+
+    int items = 0;
+    for (int i = 0; i < count; ++i) {
+        Body& body = m_bodies[i];
+        body.minColumn = static_cast<qint32>((body.minX - originX) * cellScale);
+        body.minRow = static_cast<qint32>((body.minY - originY) * cellScale);
+        body.maxColumn = static_cast<qint32>((body.maxX - originX) * cellScale);
+        body.maxRow = static_cast<qint32>((body.maxY - originY) * cellScale);
+        items += (body.maxColumn - body.minColumn + 1) * (body.maxRow - body.minRow + 1);
+    }
+
+    // Hash every covered cell into a bucket and group the buckets with a counting sort
+    int bucketCount = 1;
+    while (bucketCount < items) {
+        bucketCount <<= 1;
+    }
+    const quint32 bucketMask = static_cast<quint32>(bucketCount - 1);
+    auto bucketOf = [bucketMask](quint64 cell) {
+        return static_cast<quint32>((cell * 0x9e3779b97f4a7c15ull) >> 32) & bucketMask;
+    };
+    auto cellOf = [](qint32 row, qint32 column) {
+        return (quint64(quint32(row)) << 32) | quint32(column);
+    };
+
+    m_bucketStart.assign(bucketCount + 1, 0);
+    for (const Body& body : m_bodies) {
+        for (qint32 row = body.minRow; row <= body.maxRow; ++row) {
+            for (qint32 column = body.minColumn; column <= body.maxColumn; ++column) {
+                ++m_bucketStart[bucketOf(cellOf(row, column)) + 1];
+            }
+        }
+    }
+    for (int bucket = 0; bucket < bucketCount; ++bucket) {
+        m_bucketStart[bucket + 1] += m_bucketStart[bucket];
+    }
+
+    m_cells.resize(items);
+    m_bucketFill.assign(m_bucketStart.begin(), m_bucketStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        const Body& body = m_bodies[i];
+        for (qint32 row = body.minRow; row <= body.maxRow; ++row) {
+            for (qint32 column = body.minColumn; column <= body.maxColumn; ++column) {
+                const quint64 cell = cellOf(row, column);
+                m_cells[m_bucketFill[bucketOf(cell)]++] = {cell, i};
+            }
+        }
+    }
+
+    // Pair the bodies of every cell, each pair in the first cell both cover
+    for (int bucket = 0; bucket < bucketCount; ++bucket) {
+        const int end = m_bucketStart[bucket + 1];
+        for (int i = m_bucketStart[bucket]; i < end; ++i) {
+            const CellItem& itemA = m_cells[i];
+            const Body& a = m_bodies[itemA.body];
+            const qint32 row = static_cast<qint32>(itemA.cell >> 32);
+            const qint32 column = static_cast<qint32>(itemA.cell & 0xffffffffu);
+
+            for (int j = i + 1; j < end; ++j) {
+                const CellItem& itemB = m_cells[j];
+                if (itemB.cell != itemA.cell) {
+                    continue;
+                }
+                const Body& b = m_bodies[itemB.body];
+                if (a.maxX < b.minX || b.maxX < a.minX || a.maxY < b.minY || b.maxY < a.minY) {
+                    continue;
+                }
+                if (qMax(a.minColumn, b.minColumn) != column || qMax(a.minRow, b.minRow) != row) {
+                    continue;
+                }
+
+                ++m_candidateCount;
+                Conflict conflict;
+                if (predict(a, b, conflict)) {
+                    conflict.first = qMin(tracks[itemA.body].id, tracks[itemB.body].id);
+                    conflict.second = qMax(tracks[itemA.body].id, tracks[itemB.body].id);
+                    m_conflicts.push_back(conflict);
+                }
+            }
+        }
+    }
+
+    std::sort(m_conflicts.begin(), m_conflicts.end(), [](const Conflict& a, const Conflict& b) {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    });
+
+    m_detectionTime = timer.nsecsElapsed();
+    reportChanges(previous);
+}
+
+/**
+ * @brief Tests one pair of bodies for a conflict
+ * @param a The first body
+ * @param b The second body
+ * @param conflict Receives the timing of the conflict
+ * @return True if the pair is in conflict
+ *
+ * With relative position d and velocity w, horizontal separation is lost
+ * while |d + w t| < H, between the roots of a quadratic in t, and vertical
+ * separation while |dz + wz t| < V. A conflict exists if both intervals
+ * overlap within [0, horizon].
+ */
+bool ConflictDetector::predict(const Body& a, const Body& b, Conflict& conflict) const
+{
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double wx = b.vx - a.vx;
+    const double wy = b.vy - a.vy;
+
+    const double speed2 = wx * wx + wy * wy;
+    const double dot = dx * wx + dy * wy;
+    const double excess = dx * dx + dy * dy - m_horizontalSeparation * m_horizontalSeparation;
+
+    double begin = 0.0;
+    double end = m_horizon;
+
+    if (speed2 < PARALLEL_EPSILON) {
+        if (excess >= 0.0) {
+            return false;
+        }
+    } else {
+        const double discriminant = dot * dot - speed2 * excess;
+        if (discriminant <= 0.0) {
+            return false;
+        }
+        const double root = std::sqrt(discriminant);
+        begin = qMax(begin, (-dot - root) / speed2);
+        end = qMin(end, (-dot + root) / speed2);
+    }
+
+    const double dz = b.z - a.z;
+    const double wz = b.vz - a.vz;
+    if (qAbs(wz) < LEVEL_EPSILON) {
+        if (qAbs(dz) >= m_verticalSeparation) {
+            return false;
+        }
+    } else {
+        const double t1 = (-m_verticalSeparation - dz) / wz;
+        const double t2 = (m_verticalSeparation - dz) / wz;
+        begin = qMax(begin, qMin(t1, t2));
+        end = qMin(end, qMax(t1, t2));
+    }
+
+    if (begin > end) {
+        return false;
+    }
+
+    const double closest = speed2 < PARALLEL_EPSILON ? 0.0 : qBound(0.0, -dot / speed2, m_horizon);
+    conflict.timeToLoss = begin;
+    conflict.closestTime = closest;
+    conflict.closestDistance = std::hypot(dx + wx * closest, dy + wy * closest);
+    return true;
+}
+
+/**
+ * @brief Logs the conflicts that started or ended and notifies
+ * @param previous The conflicts of the previous detection, ordered
+ *
+ * Both lists are ordered by pair, so they are merged in one pass.
+ */
+void ConflictDetector::reportChanges(const std::vector<Conflict>& previous)
+{
+    auto before = [](const Conflict& a, const Conflict& b) {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    };
+
+    bool changed = false;
+    auto oldConflict = previous.begin();
+    auto newConflict = m_conflicts.cbegin();
+
+    while (oldConflict != previous.end() || newConflict != m_conflicts.cend()) {
+        if (newConflict == m_conflicts.cend() || (oldConflict != previous.end() && before(*oldConflict, *newConflict))) {
+            EventLog::info(EventLog::ConflictResolved, oldConflict->first, oldConflict->second);
+            changed = true;
+            ++oldConflict;
+        } else if (oldConflict == previous.end() || before(*newConflict, *oldConflict)) {
+            EventLog::warning(EventLog::ConflictPredicted, newConflict->first, newConflict->second,
+                              newConflict->timeToLoss, newConflict->closestDistance);
+            changed = true;
+            ++newConflict;
+        } else {
+            ++oldConflict;
+            ++newConflict;
+        }
+    }
+
+    if (changed) {
+        emit conflictsChanged(conflictCount());
+    }
+}
+
+const std::vector<ConflictDetector::Conflict>& ConflictDetector::conflicts() const
+{
+    return m_conflicts;
+}
+
+int ConflictDetector::conflictCount() const
+{
+    return static_cast<int>(m_conflicts.size());
+}
+
+qint64 ConflictDetector::candidateCount() const
+{
+    return m_candidateCount;
+}
+
+qint64 ConflictDetector::detectionTime() const
+{
+    return m_detectionTime;
+}
@@ -0,0 +1,285 @@
+#ifndef CONFLICTDETECTOR_HPP
+#define CONFLICTDETECTOR_HPP
+
+#include <QObject>
+#include <vector>
+
+class FleetSimulator;
+
+/**
+ * @class ConflictDetector
+ * @brief Predicts losses of separation between airborne vehicles
+ *
+ * Two vehicles are in conflict if, flying on with their current speed,
+ * heading and climb rate, they come closer than the horizontal separation
+ * and the vertical separation at the same time within the horizon. The
+ * conflict starts at the first moment both separations are lost; a loss
+ * that already exists starts at time 0.
+ *
+ * Positions are projected onto a local plane around the first track. The
+ * broad phase sweeps every track over the horizon into a box padded by half
+ * the horizontal separation, and enters the box into a spatial hash under
+ * every square cell it covers. Only tracks sharing a cell are paired, and a
+ * pair is only tested in the first cell both boxes cover, so it is tested
+ * once. The narrow phase solves for
+ * the time intervals of horizontal and vertical loss and intersects them.
+ * The cost grows with the number of nearby pairs rather than with the
+ * square of the fleet size.
+ *
+ * Tracks are either passed to detect() after every ingest of new positions,
+ * or taken from a fleet with setFleet(), which runs detect() within each
+ * fleet tick so that conflicts are never a tick late.
+ */
+class ConflictDetector : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int conflictCount READ conflictCount NOTIFY conflictsChanged)
+
+public:
+    /**
+     * @struct Track
+     * @brief Position and velocity of one airborne vehicle
+     */
+    struct Track
+    {
+        /** @brief Identifies the vehicle in conflicts, e.g. the fleet index */
+        int id = 0;
+
+        /** @brief Latitude in degrees */
+        double latitude = 0.0;
+
+        /** @brief Longitude in degrees */
+        double longitude = 0.0;
+
+        /** @brief Altitude in meters */
+        double altitude = 0.0;
+
+        /** @brief Ground speed in meters per second */
+        double speed = 0.0;
+
+        /** @brief Heading in degrees clockwise from north */
+        double heading = 0.0;
+
+        /** @brief Climb rate in meters per second, negative when descending */
+        double climbRate = 0.0;
+    };
+
+    /**
+     * @struct Conflict
+     * @brief A predicted loss of separation between two vehicles
+     */
+    struct Conflict
+    {
+        /** @brief Id of the first vehicle, the lower of the two */
+        int first = 0;
+
+        /** @brief Id of the second vehicle */
+        int second = 0;
+
+        /** @brief Seconds until separation is lost, 0 if it is lost already */
+        double timeToLoss = 0.0;
+
+        /** @brief Seconds until the closest horizontal approach within the horizon */
+        double closestTime = 0.0;
+
+        /** @brief Horizontal distance at the closest approach in meters */
+        double closestDistance = 0.0;
+    };
+
+    /** @brief Default horizontal separation in meters */
+    static constexpr double DEFAULT_HORIZONTAL_SEPARATION = 30.0;
+
+    /** @brief Default vertical separation in meters */
+    static constexpr double DEFAULT_VERTICAL_SEPARATION = 10.0;
+
+    /** @brief Default prediction horizon in seconds */
+    static constexpr double DEFAULT_HORIZON = 10.0;
+
+    /**
+     * @brief Constructs a ConflictDetector with the default separations and horizon
+     * @param parent The parent QObject
+     */
+    explicit ConflictDetector(QObject* parent = nullptr);
+
+    /**
+     * @brief Gets the horizontal separation
+     * @return The separation in meters
+     */
+    double horizontalSeparation() const;
+
+    /**
+     * @brief Sets the horizontal separation
+     * @param meters The separation in meters, greater than 0
+     */
+    void setHorizontalSeparation(double meters);
+
+    /**
+     * @brief Gets the vertical separation
+     * @return The separation in meters
+     */
+    double verticalSeparation() const;
+
+    /**
+     * @brief Sets the vertical separation
+     * @param meters The separation in meters, greater than 0
+     */
+    void setVerticalSeparation(double meters);
+
+    /**
+     * @brief Gets how far ahead conflicts are predicted
+     * @return The horizon in seconds
+     */
+    double horizon() const;
+
+    /**
+     * @brief Sets how far ahead conflicts are predicted
+     * @param seconds The horizon in seconds, 0 to report current losses only
+     */
+    void setHorizon(double seconds);
+
+    /**
+     * @brief Gets the fleet checked after every tick
+     * @return The fleet, or nullptr if none is set
+     */
+    FleetSimulator* fleet() const;
+
+    /**
+     * @brief Checks a fleet after every tick
+     * @param fleet The fleet, or nullptr to stop; the caller keeps ownership
+     *
+     * Only vehicles that are not landed are checked, identified by their
+     * fleet index. Climb rates are derived from the altitude change since
+     * the previous tick.
+     */
+    void setFleet(FleetSimulator* fleet);
+
+    /**
+     * @brief Replaces the conflicts with those predicted for a set of tracks
+     * @param tracks The airborne vehicles, with unique ids
+     */
+    void detect(const std::vector<Track>& tracks);
+
+    /**
+     * @brief Gets the conflicts found by the last detection
+     * @return The conflicts, ordered by first and second id
+     */
+    const std::vector<Conflict>& conflicts() const;
+
+    /**
+     * @brief Gets the number of conflicts found by the last detection
+     * @return The conflict count
+     */
+    int conflictCount() const;
+
+    /**
+     * @brief Gets the number of pairs the last detection passed to the narrow phase
+     * @return The candidate pair count
+     */
+    qint64 candidateCount() const;
+
+    /**
+     * @brief Gets how long the last detection took
+     * @return The wall clock time in nanoseconds
+     */
+    qint64 detectionTime() const;
+
+signals:
+    /**
+     * @brief Emitted once per detection in which conflicts started or ended
+     * @param count The new number of conflicts
+     */
+    void conflictsChanged(int count);
+
+private slots:
+    /**
+     * @brief Collects the fleet's airborne vehicles and runs detect()
+     */
+    void detectFleet();
+
+private:
+    /**
+     * @struct Body
+     * @brief A track projected onto the local plane, with its swept box
+     */
+    struct Body
+    {
+        double x;
+        double y;
+        double z;
+        double vx;
+        double vy;
+        double vz;
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+        qint32 minColumn;
+        qint32 minRow;
+        qint32 maxColumn;
+        qint32 maxRow;
+    };
+
+    /**
+     * @struct CellItem
+     * @brief A body covering a cell, with the cell's row and column packed into one key
+     */
+    struct CellItem
+    {
+        quint64 cell;
+        qint32 body;
+    };
+
+    /**
+     * @brief Tests one pair of bodies for a conflict
+     * @param a The first body
+     * @param b The second body
+     * @param conflict Receives the timing of the conflict
+     * @return True if the pair is in conflict
+     */
+    bool predict(const Body& a, const Body& b, Conflict& conflict) const;
+
+    /**
+     * @brief Logs the conflicts that started or ended and notifies
+     * @param previous The conflicts of the previous detection, ordered
+     */
+    void reportChanges(const std::vector<Conflict>& previous);
+
+    /** @brief Horizontal separation in meters */
+    double m_horizontalSeparation;
+
+    /** @brief Vertical separation in meters */
+    double m_verticalSeparation;
+
+    /** @brief Prediction horizon in seconds */
+    double m_horizon;
+
+    /** @brief The fleet checked after every tick */
+    FleetSimulator* m_fleet;
+
+    /** @brief Conflicts of the last detection */
+    std::vector<Conflict> m_conflicts;
+
+    /** @brief Pairs the last detection passed to the narrow phase */
+    qint64 m_candidateCount;
+
+    /** @brief Duration of the last detection in nanoseconds */
+    qint64 m_detectionTime;
+
+    /** @name Buffers reused by every detection */
+    ///@{
+    std::vector<Track> m_tracks;
+    std::vector<Body> m_bodies;
+    std::vector<CellItem> m_cells;
+    std::vector<qint32> m_bucketStart;
+    std::vector<qint32> m_bucketFill;
+    ///@}
+
+    /** @brief Fleet altitudes at the previous tick, for climb rates */
+    std::vector<double> m_lastAltitude;
+
+    /** @brief Simulated time of the previous fleet tick in milliseconds */
+    qint64 m_lastTime;
+};
+
+#endif // CONFLICTDETECTOR_HPP
@@ -0,0 +1,134 @@
+#include "EnergyModel.hpp"
+#include <algorithm>
+
+namespace {
+
+/** @brief Sea-level air density in kilograms per cubic meter */
+constexpr double AIR_DENSITY = 1.225;
+
+} // namespace
+
+/**
+ * @brief Builds the lookup tables for the default airframe
+ */
+EnergyModel::EnergyModel()
+    : EnergyModel(Airframe())
+{
+}
+
+/**
+ * @brief Builds the lookup tables for an airframe
+ * @param airframe The vehicle parameters
+ *
+ * Level-flight power at airspeed v is
+ *
+ *     P(v) = (½ρSC_D0·v³ + 2k(mg)²/(ρSv)) / η + P_avionics
+ *
+ * split into the profile and induced tables. Below stall speed the
+ * stall-speed values are scaled down linearly to zero at rest. Each table
+ * repeats its last entry, so interpolating at MAX_AIRSPEED needs no index
+ * clamp. The speeds of maximum endurance and range are found on the tables
+ * as well.
+ */
+EnergyModel::EnergyModel(const Airframe& airframe)
+    : m_airframe(airframe)
+    , m_climbPower(airframe.mass * GRAVITY / airframe.propulsiveEfficiency)
+    , m_minimumPower(0.0)
+    , m_enduranceSpeed(airframe.stallSpeed)
+    , m_rangeSpeed(airframe.stallSpeed)
+    , m_bestRangePerJoule(0.0)
+{
+    const double weight = airframe.mass * GRAVITY;
+    const double parasiteFactor = 0.5 * AIR_DENSITY * airframe.wingArea * airframe.zeroLiftDrag;
+    const double inducedFactor = 2.0 * airframe.inducedDragFactor * weight * weight / (AIR_DENSITY * airframe.wingArea);
+
+    for (int i = 0; i < TABLE_SIZE; ++i) {
+        const double speed = i * TABLE_STEP;
+        const double flightSpeed = std::max(speed, airframe.stallSpeed);
+        const double ramp = std::min(1.0, speed / airframe.stallSpeed);
+
+        const double parasite = parasiteFactor * flightSpeed * flightSpeed * flightSpeed;
+        const double induced = inducedFactor / flightSpeed;
+
+        m_profilePower[i] = ramp * (parasite / airframe.propulsiveEfficiency + airframe.avionicsPower);
+        m_inducedPower[i] = ramp * induced / airframe.propulsiveEfficiency;
+
+        if (speed < airframe.stallSpeed) {
+            continue;
+        }
+
+        const double level = m_profilePower[i] + m_inducedPower[i];
+        if (m_minimumPower == 0.0 || level < m_minimumPower) {
+            m_minimumPower = level;
+            m_enduranceSpeed = speed;
+        }
+        if (speed / level > m_bestRangePerJoule) {
+            m_bestRangePerJoule = speed / level;
+            m_rangeSpeed = speed;
+        }
+    }
+
+    m_profilePower[TABLE_SIZE] = m_profilePower[TABLE_SIZE - 1];
+    m_inducedPower[TABLE_SIZE] = m_inducedPower[TABLE_SIZE - 1];
+}
+
+const EnergyModel::Airframe& EnergyModel::airframe() const
+{
+    return m_airframe;
+}
+
+/**
+ * @brief Gets the usable battery energy
+ * @return Energy in joules
+ */
+double EnergyModel::capacity() const
+{
+    return m_airframe.capacity * JOULES_PER_WATT_HOUR;
+}
+
+double EnergyModel::minimumPower() const
+{
+    return m_minimumPower;
+}
+
+double EnergyModel::enduranceSpeed() const
+{
+    return m_enduranceSpeed;
+}
+
+double EnergyModel::rangeSpeed() const
+{
+    return m_rangeSpeed;
+}
+
+/**
+ * @brief Estimates the remaining flight time
+ * @param energy Remaining energy in joules
+ * @param averagePower Averaged power draw in watts
+ * @return Seconds until the battery is empty
+ *
+ * The average draw is never taken below minimumPower(), so a vehicle on
+ * the ground reports the longest flight it could still make.
+ */
+double EnergyModel::remainingFlightTime(double energy, double averagePower) const
+{
+    return energy / std::max(averagePower, m_minimumPower);
+}
+
+/**
+ * @brief Estimates the remaining range
+ * @param energy Remaining energy in joules
+ * @param averagePower Averaged power draw in watts
+ * @param averageSpeed Averaged airspeed in meters per second
+ * @return Meters until the battery is empty
+ *
+ * Uses the current averages while flying faster than stall speed on
+ * average, and the best range at rangeSpeed() otherwise.
+ */
+double EnergyModel::remainingRange(double energy, double averagePower, double averageSpeed) const
+{
+    if (averageSpeed < m_airframe.stallSpeed) {
+        return energy * m_bestRangePerJoule;
+    }
+    return remainingFlightTime(energy, averagePower) * averageSpeed;
+}
@@ -0,0 +1,189 @@
+#ifndef ENERGYMODEL_HPP
+#define ENERGYMODEL_HPP
+
+#include <QtGlobal>
+#include <array>
+
+/**
+ * @class EnergyModel
+ * @brief Electrical power draw and endurance of a small fixed-wing UAS
+ *
+ * The power needed to fly is split into a profile part (parasite drag plus
+ * avionics) and an induced part, both functions of airspeed only. They are
+ * precomputed once per airframe into lookup tables at TABLE_STEP spacing,
+ * so evaluating power() every tick costs two interpolated table reads and a
+ * few multiplications, without any transcendental calls or branches.
+ *
+ * Maneuvers scale the table values: turning at rate ω multiplies the
+ * induced part by the load factor n² = 1 + (vω/g)², and climbing adds the
+ * rate of change of potential energy. Descents reduce the draw down to the
+ * avionics load; there is no regeneration. Below stall speed the vehicle is
+ * on the ground and the draw ramps down to zero at rest, so a landed
+ * vehicle is treated as powered down.
+ *
+ * Remaining flight time and range are estimated from the remaining energy
+ * and exponential averages of power and speed that the simulators update
+ * incrementally every tick (see smoothing()).
+ */
+class EnergyModel
+{
+public:
+    /**
+     * @struct Airframe
+     * @brief Physical parameters of the modelled vehicle
+     *
+     * The defaults describe a 15 kg electric fixed-wing built for the 40 m/s
+     * cruise of the simulators, with a 1.5 kWh battery good for a little
+     * over an hour at cruise and almost five hours loitering.
+     */
+    struct Airframe
+    {
+        double mass = 15.0;                  ///< Kilograms
+        double wingArea = 0.8;               ///< Square meters
+        double zeroLiftDrag = 0.025;         ///< Zero-lift drag coefficient
+        double inducedDragFactor = 0.047;    ///< 1 / (π e AR)
+        double stallSpeed = 15.0;            ///< Meters per second
+        double propulsiveEfficiency = 0.65;  ///< Battery to thrust power
+        double avionicsPower = 25.0;         ///< Watts
+        double capacity = 1500.0;            ///< Usable battery energy in watt-hours
+    };
+
+    /**
+     * @brief Builds the lookup tables for the default airframe
+     */
+    EnergyModel();
+
+    /**
+     * @brief Builds the lookup tables for an airframe
+     * @param airframe The vehicle parameters
+     */
+    explicit EnergyModel(const Airframe& airframe);
+
+    /**
+     * @brief Gets the modelled vehicle
+     * @return The airframe parameters
+     */
+    const Airframe& airframe() const;
+
+    /**
+     * @brief Gets the usable battery energy
+     * @return Energy in joules
+     */
+    double capacity() const;
+
+    /**
+     * @brief Gets the electrical power drawn in a flight condition
+     * @param airspeed Airspeed in meters per second, not negative
+     * @param climbRate Vertical speed in meters per second, negative when descending
+     * @param turnRate Heading rate in radians per second, either sign
+     * @return Power in watts
+     */
+    double power(double airspeed, double climbRate, double turnRate) const
+    {
+        // Clamping the integer index rather than the airspeed keeps the body
+        // free of branches. The tables repeat their last entry, so faster
+        // flight reads as MAX_AIRSPEED.
+        const double x = airspeed * (1.0 / TABLE_STEP);
+        const int truncated = static_cast<int>(x);
+        const int index = truncated < TABLE_SIZE - 1 ? truncated : TABLE_SIZE - 1;
+        const double fraction = x - index;
+
+        const double profile = m_profilePower[index] + (m_profilePower[index + 1] - m_profilePower[index]) * fraction;
+        const double induced = m_inducedPower[index] + (m_inducedPower[index + 1] - m_inducedPower[index]) * fraction;
+
+        const double lateral = airspeed * turnRate * (1.0 / GRAVITY);
+        const double total = profile + induced * (1.0 + lateral * lateral) + m_climbPower * climbRate;
+        const double idle = profile < m_airframe.avionicsPower ? profile : m_airframe.avionicsPower;
+        return total > idle ? total : idle;
+    }
+
+    /**
+     * @brief Gets the lowest power that keeps the vehicle airborne
+     * @return Power in watts, drawn in level flight at enduranceSpeed()
+     */
+    double minimumPower() const;
+
+    /**
+     * @brief Gets the airspeed of maximum endurance
+     * @return Speed in meters per second
+     */
+    double enduranceSpeed() const;
+
+    /**
+     * @brief Gets the airspeed of maximum range
+     * @return Speed in meters per second
+     */
+    double rangeSpeed() const;
+
+    /**
+     * @brief Estimates the remaining flight time
+     * @param energy Remaining energy in joules
+     * @param averagePower Averaged power draw in watts
+     * @return Seconds until the battery is empty
+     */
+    double remainingFlightTime(double energy, double averagePower) const;
+
+    /**
+     * @brief Estimates the remaining range
+     * @param energy Remaining energy in joules
+     * @param averagePower Averaged power draw in watts
+     * @param averageSpeed Averaged airspeed in meters per second
+     * @return Meters until the battery is empty
+     */
+    double remainingRange(double energy, double averagePower, double averageSpeed) const;
+
+    /**
+     * @brief Gets the weight of a new sample in the power and speed averages
+     * @param dt The time step in seconds
+     * @return The smoothing factor, for average += (sample - average) * factor
+     */
+    static double smoothing(double dt)
+    {
+        return dt / (AVERAGING_TIME + dt);
+    }
+
+    /** @brief Highest tabulated airspeed in meters per second */
+    static constexpr double MAX_AIRSPEED = 64.0;
+
+    /** @brief Airspeed spacing of the lookup tables in meters per second */
+    static constexpr double TABLE_STEP = 0.25;
+
+    /** @brief Number of entries per lookup table */
+    static constexpr int TABLE_SIZE = static_cast<int>(MAX_AIRSPEED / TABLE_STEP) + 1;
+
+    /** @brief Time constant of the power and speed averages in seconds */
+    static constexpr double AVERAGING_TIME = 30.0;
+
+    /** @brief Standard gravity in meters per second squared */
+    static constexpr double GRAVITY = 9.80665;
+
+    /** @brief Joules per watt-hour */
+    static constexpr double JOULES_PER_WATT_HOUR = 3600.0;
+
+private:
+    /** @brief The modelled vehicle */
+    Airframe m_airframe;
+
+    /** @brief Parasite and avionics power over airspeed, in watts, with the last entry repeated */
+    std::array<double, TABLE_SIZE + 1> m_profilePower;
+
+    /** @brief Induced power in level flight over airspeed, in watts, with the last entry repeated */
+    std::array<double, TABLE_SIZE + 1> m_inducedPower;
+
+    /** @brief Power per meter per second of climb, in watts */
+    double m_climbPower;
+
+    /** @brief Lowest level-flight power above stall, in watts */
+    double m_minimumPower;
+
+    /** @brief Airspeed of the lowest level-flight power */
+    double m_enduranceSpeed;
+
+    /** @brief Airspeed of the most distance per joule */
+    double m_rangeSpeed;
+
+    /** @brief Most meters flown per joule in level flight */
+    double m_bestRangePerJoule;
+};
+
+#endif // ENERGYMODEL_HPP
@@ -0,0 +1,425 @@
+#include "EventLog.hpp"
+#include "UASStateMachine.hpp"
+#include <QFile>
+#include <QMetaEnum>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <algorithm>
+#include <vector>
+
+namespace EventLog {
+
+namespace Detail {
+
+thread_local ThreadRing* t_ring = nullptr;
+
+} // namespace Detail
+
+namespace {
+
+/** @brief Time between two drains of the rings in milliseconds */
+constexpr unsigned long DRAIN_INTERVAL = 50;
+
+/**
+ * @struct Pending
+ * @brief A drained record with the thread that logged it
+ */
+struct Pending
+{
+    Record record;
+    quint32 thread;
+};
+
+/**
+ * @struct Registry
+ * @brief The rings of all logging threads and the drain thread
+ *
+ * Rings of threads that are still running at exit are deliberately not
+ * freed, since those threads may still log.
+ */
+struct Registry
+{
+    /**
+     * @brief Joins a drain thread that was not stopped
+     */
+    ~Registry()
+    {
+        if (thread) {
+            {
+                QMutexLocker locker(&mutex);
+                stopping = true;
+                wake.wakeAll();
+            }
+            thread->wait();
+            delete thread;
+        }
+    }
+
+    /** @brief Guards rings, nextThread, retiredDrops, thread and stopping */
+    QMutex mutex;
+
+    /** @brief Wakes the drain thread when it is stopped */
+    QWaitCondition wake;
+
+    /** @brief Rings of all threads that have logged */
+    QVector<Detail::ThreadRing*> rings;
+
+    /** @brief Number given to the next registered thread */
+    quint32 nextThread = 1;
+
+    /** @brief Drops counted by rings that have been freed */
+    quint64 retiredDrops = 0;
+
+    /** @brief The drain thread, null while stopped */
+    QThread* thread = nullptr;
+
+    /** @brief Set to end the drain thread */
+    bool stopping = false;
+
+    /** @brief Output file; unused when logging to the Qt message handler */
+    QFile file;
+
+    /** @brief Time of start(), the origin of the printed timestamps */
+    qint64 startTime = 0;
+
+    /** @brief Drops already reported in the output (drain thread) */
+    quint64 reportedDrops = 0;
+
+    /** @brief Records of the current drain, reused between drains (drain thread) */
+    std::vector<Pending> pending;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @struct RingOwner
+ * @brief Marks the ring of a thread as orphaned when the thread exits
+ */
+struct RingOwner
+{
+    ~RingOwner()
+    {
+        if (ring) {
+            Detail::t_ring = nullptr;
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+    }
+
+    Detail::ThreadRing* ring = nullptr;
+};
+
+thread_local RingOwner t_owner;
+
+/**
+ * @brief Counts the dropped records (mutex held)
+ * @param r The registry
+ * @return Drops of freed and live rings
+ */
+quint64 countDrops(const Registry& r)
+{
+    quint64 dropped = r.retiredDrops;
+    for (const Detail::ThreadRing* ring : r.rings) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+/**
+ * @brief Writes one line to the output (drain thread)
+ * @param r The registry
+ * @param level The level of the line
+ * @param line The text
+ */
+void writeLine(Registry& r, Level level, const QString& line)
+{
+    if (r.file.isOpen()) {
+        r.file.write(line.toUtf8());
+        r.file.write("\n", 1);
+        return;
+    }
+
+    switch (level) {
+    case Debug:
+        qDebug().noquote() << line;
+        break;
+    case Info:
+        qInfo().noquote() << line;
+        break;
+    default:
+        qWarning().noquote() << line;
+        break;
+    }
+}
+
+/**
+ * @brief Moves all records out of the rings and writes them
+ * @param r The registry
+ *
+ * Called by the drain thread, or by stop() once the drain thread has ended.
+ * Records are ordered by time across threads; records of one thread keep
+ * their order. Rings of exited threads are freed once they are empty.
+ */
+void drain(Registry& r)
+{
+    static const char* const levelNames[] = {"debug", "info", "warning"};
+
+    quint64 dropped = 0;
+    r.pending.clear();
+    {
+        QMutexLocker locker(&r.mutex);
+        for (int i = 0; i < r.rings.size();) {
+            Detail::ThreadRing* ring = r.rings[i];
+
+            // Read before popping: every record of an exited thread is visible then
+            const bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+
+            Pending entry;
+            entry.thread = ring->thread;
+            while (ring->records.pop(entry.record)) {
+                r.pending.push_back(entry);
+            }
+
+            if (orphaned) {
+                r.retiredDrops += ring->dropped.load(std::memory_order_relaxed);
+                r.rings.removeAt(i);
+                delete ring;
+            } else {
+                ++i;
+            }
+        }
+        dropped = countDrops(r);
+    }
+
+    std::stable_sort(r.pending.begin(), r.pending.end(), [](const Pending& a, const Pending& b) {
+        return a.record.timestamp < b.record.timestamp;
+    });
+
+    for (const Pending& entry : r.pending) {
+        const Level level = static_cast<Level>(qMin<int>(entry.record.level, Warning));
+        writeLine(r, level, QStringLiteral("%1 [T%2] %3: %4")
+            .arg((entry.record.timestamp - r.startTime) / 1e9, 0, 'f', 3)
+            .arg(entry.thread)
+            .arg(QLatin1String(levelNames[level]))
+            .arg(format(entry.record)));
+    }
+
+    if (dropped > r.reportedDrops) {
+        writeLine(r, Warning, QStringLiteral("%1 records dropped, log rings were full")
+            .arg(dropped - r.reportedDrops));
+        r.reportedDrops = dropped;
+    }
+
+    if (r.file.isOpen()) {
+        r.file.flush();
+    }
+}
+
+/**
+ * @brief Drains the rings until the logger is stopped (drain thread)
+ */
+void drainLoop()
+{
+    Registry& r = registry();
+
+    for (;;) {
+        {
+            QMutexLocker locker(&r.mutex);
+            if (!r.stopping) {
+                r.wake.wait(&r.mutex, DRAIN_INTERVAL);
+            }
+            if (r.stopping) {
+                break;
+            }
+        }
+        drain(r);
+    }
+}
+
+/**
+ * @brief Gets the name of a flight state
+ * @param value The state stored in a record value
+ * @return The enumerator name
+ */
+QString stateName(double value)
+{
+    const char* key = QMetaEnum::fromType<UASState::State>().valueToKey(static_cast<int>(value));
+    return key ? QString::fromLatin1(key) : QString::number(value);
+}
+
+} // namespace
+
+namespace Detail {
+
+/**
+ * @brief Creates and registers the ring of the calling thread
+ * @return The ring
+ *
+ * Runs once per thread, on its first logged event.
+ */
+ThreadRing* registerThread()
+{
+    Registry& r = registry();
+    auto* ring = new ThreadRing;
+    {
+        QMutexLocker locker(&r.mutex);
+        ring->thread = r.nextThread++;
+        r.rings.append(ring);
+    }
+
+    t_owner.ring = ring;
+    t_ring = ring;
+    return ring;
+}
+
+} // namespace Detail
+
+/**
+ * @brief Starts the background thread that drains and formats the records
+ * @param path File the text is appended to, or empty for the Qt message handler
+ * @return False if the file cannot be opened
+ *
+ * Records logged before start() are kept as long as they fit into their
+ * ring. Calling start() while running does nothing.
+ */
+bool start(const QString& path)
+{
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (r.thread) {
+        return true;
+    }
+
+    if (!path.isEmpty()) {
+        r.file.setFileName(path);
+        if (!r.file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qWarning() << "Cannot open event log:" << r.file.errorString();
+            return false;
+        }
+    }
+
+    r.startTime = now();
+    r.stopping = false;
+    r.thread = QThread::create(drainLoop);
+    r.thread->setObjectName(QStringLiteral("EventLog"));
+    r.thread->start();
+    return true;
+}
+
+/**
+ * @brief Stops the background thread after writing all pending records
+ *
+ * Records logged concurrently with stop() may stay in their rings until
+ * the next start().
+ */
+void stop()
+{
+    Registry& r = registry();
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&r.mutex);
+        if (!r.thread) {
+            return;
+        }
+        thread = r.thread;
+        r.stopping = true;
+        r.wake.wakeAll();
+    }
+
+    thread->wait();
+    delete thread;
+
+    drain(r);
+    r.file.close();
+
+    QMutexLocker locker(&r.mutex);
+    r.thread = nullptr;
+    r.stopping = false;
+}
+
+bool isRunning()
+{
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    return r.thread != nullptr;
+}
+
+quint64 droppedRecords()
+{
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    return countDrops(r);
+}
+
+/**
+ * @brief Formats the message of a record
+ * @param record The record
+ * @return The text, without time and thread
+ */
+QString format(const Record& record)
+{
+    const double* values = record.values;
+    QString message;
+
+    switch (record.event) {
+    case StateChanged:
+        message = QStringLiteral("state changed from %1 to %2").arg(stateName(values[0]), stateName(values[1]));
+        break;
+    case TakeOffStarted:
+        message = QStringLiteral("taking off to %1 m").arg(values[0]);
+        break;
+    case TakeOffCompleted:
+        message = QStringLiteral("takeoff completed - altitude %1 m, speed %2 m/s").arg(values[0]).arg(values[1]);
+        break;
+    case LandingStarted:
+        message = QStringLiteral("landing");
+        break;
+    case Landed:
+        message = QStringLiteral("landed");
+        break;
+    case WaypointSet:
+        message = QStringLiteral("flying to %1, %2").arg(values[0], 0, 'f', 6).arg(values[1], 0, 'f', 6);
+        break;
+    case WaypointReached:
+        message = QStringLiteral("reached destination %1, %2").arg(values[0], 0, 'f', 6).arg(values[1], 0, 'f', 6);
+        break;
+    case CommandDropped:
+        message = QStringLiteral("simulation is not keeping up, command dropped");
+        break;
+    case GeofenceBreached:
+        message = values[0] >= 0.0
+            ? QStringLiteral("geofence breached - inside exclusion zone %1 at %2, %3").arg(values[0]).arg(values[1], 0, 'f', 6).arg(values[2], 0, 'f', 6)
+            : QStringLiteral("geofence breached - outside all inclusion zones at %1, %2").arg(values[1], 0, 'f', 6).arg(values[2], 0, 'f', 6);
+        break;
+    case GeofenceCleared:
+        message = QStringLiteral("back inside the geofence at %1, %2").arg(values[0], 0, 'f', 6).arg(values[1], 0, 'f', 6);
+        break;
+    case GeofenceRejected:
+        message = QStringLiteral("command to %1 rejected by the geofence").arg(stateName(values[0]));
+        break;
+    case ConflictPredicted:
+        message = QStringLiteral("conflict with vehicle %1 in %2 s, closest approach %3 m")
+                      .arg(values[0])
+                      .arg(values[1], 0, 'f', 1)
+                      .arg(values[2], 0, 'f', 1);
+        break;
+    case ConflictResolved:
+        message = QStringLiteral("conflict with vehicle %1 resolved").arg(values[0]);
+        break;
+    default:
+        message = QStringLiteral("unknown event %1").arg(record.event);
+        break;
+    }
+
+    if (record.subject >= 0) {
+        return QStringLiteral("vehicle %1 %2").arg(record.subject).arg(message);
+    }
+    return message;
+}
+
+} // namespace EventLog
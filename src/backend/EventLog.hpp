@@ -0,0 +1,255 @@
+#ifndef EVENTLOG_HPP
+#define EVENTLOG_HPP
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+#include "SpscRing.hpp"
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+#include <time.h>
+#endif
+
+/**
+ * @brief Lowest level compiled into the binary: 0 debug, 1 info, 2 warning, 3 off
+ *
+ * Calls below this level compile to nothing. Defined by the build; release
+ * builds keep info and above.
+ */
+#ifndef GCS_LOG_LEVEL
+#define GCS_LOG_LEVEL 1
+#endif
+
+/**
+ * @namespace EventLog
+ * @brief Structured logging for the simulation hot paths
+ *
+ * An event is a fixed-size binary Record: an event code, the vehicle it
+ * concerns and up to three numbers. Logging writes the record into a
+ * lock-free ring owned by the calling thread and returns; no string is built
+ * and no lock is taken. A background thread started with start() drains all
+ * rings every few milliseconds, orders the drained records by time and
+ * formats them into text.
+ *
+ * A full ring drops the record and counts it instead of blocking, so logging
+ * never stalls a simulation step. Timestamps come from a coarse monotonic
+ * clock where one is available, which is resolved to a few milliseconds.
+ */
+namespace EventLog {
+
+/**
+ * @enum Level
+ * @brief Severity of an event
+ */
+enum Level : quint8 {
+    Debug,   ///< Per-vehicle detail, compiled out of release builds
+    Info,    ///< Operator-visible flight events
+    Warning, ///< Unexpected conditions
+    Off      ///< Nothing is logged
+};
+
+/**
+ * @enum Event
+ * @brief Kind of a logged event, which selects the meaning of its values
+ */
+enum Event : quint16 {
+    StateChanged,      ///< values: previous state, new state
+    TakeOffStarted,    ///< values: target altitude in meters
+    TakeOffCompleted,  ///< values: altitude in meters, speed in m/s
+    LandingStarted,    ///< no values
+    Landed,            ///< no values
+    WaypointSet,       ///< values: latitude, longitude
+    WaypointReached,   ///< values: latitude, longitude
+    CommandDropped,    ///< no values
+    GeofenceBreached,  ///< values: exclusion zone or Geofence::OUTSIDE_INCLUSION, latitude, longitude
+    GeofenceCleared,   ///< values: latitude, longitude
+    GeofenceRejected,  ///< values: requested state
+    ConflictPredicted, ///< values: other vehicle, seconds until separation is lost, closest distance in meters
+    ConflictResolved,  ///< values: other vehicle
+    EVENT_COUNT
+};
+
+/** @brief Lowest level compiled into the binary */
+constexpr Level COMPILED_LEVEL = static_cast<Level>(GCS_LOG_LEVEL);
+
+/** @brief Number of records each thread can buffer between two drains */
+constexpr int RING_CAPACITY = 4096;
+
+/**
+ * @struct Record
+ * @brief One logged event, copied into the ring as is
+ */
+struct Record
+{
+    /** @brief Monotonic time in nanoseconds */
+    qint64 timestamp;
+
+    /** @brief The vehicle index, or -1 for a single vehicle */
+    qint32 subject;
+
+    /** @brief The Event */
+    quint16 event;
+
+    /** @brief The Level */
+    quint8 level;
+
+    /** @brief Padding */
+    quint8 reserved;
+
+    /** @brief Event-specific values */
+    double values[3];
+};
+
+static_assert(sizeof(Record) == 40, "EventLog::Record must stay 40 bytes");
+
+/**
+ * @brief Checks whether a level is compiled in
+ * @param level The level
+ * @return True if calls at this level produce records
+ */
+constexpr bool isEnabled(Level level)
+{
+    return level >= COMPILED_LEVEL && level < Off;
+}
+
+/**
+ * @brief Reads the clock used for timestamps
+ * @return Monotonic time in nanoseconds
+ */
+inline qint64 now()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &time);
+    return qint64(time.tv_sec) * 1000000000 + time.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+namespace Detail {
+
+/**
+ * @struct ThreadRing
+ * @brief The records of one logging thread
+ */
+struct ThreadRing
+{
+    /** @brief Records not yet drained; the owning thread is the producer */
+    SpscRing<Record, RING_CAPACITY> records;
+
+    /** @brief Records dropped because the ring was full */
+    std::atomic<quint64> dropped{0};
+
+    /** @brief Set when the owning thread has exited */
+    std::atomic<bool> orphaned{false};
+
+    /** @brief Number of the owning thread in the log output */
+    quint32 thread = 0;
+};
+
+/** @brief Ring of the calling thread, null until its first record */
+extern thread_local ThreadRing* t_ring;
+
+/**
+ * @brief Creates and registers the ring of the calling thread
+ * @return The ring
+ */
+ThreadRing* registerThread();
+
+} // namespace Detail
+
+/**
+ * @brief Logs an event if its level is compiled in
+ * @tparam L The level
+ * @param event The event
+ * @param subject The vehicle index, or -1 for a single vehicle
+ * @param a First value
+ * @param b Second value
+ * @param c Third value
+ */
+template <Level L>
+inline void log(Event event, qint32 subject = -1, double a = 0.0, double b = 0.0, double c = 0.0)
+{
+    if constexpr (isEnabled(L)) {
+        Detail::ThreadRing* ring = Detail::t_ring;
+        if (Q_UNLIKELY(!ring)) {
+            ring = Detail::registerThread();
+        }
+
+        const Record record{now(), subject, event, L, 0, {a, b, c}};
+        if (Q_UNLIKELY(!ring->records.push(record))) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else {
+        Q_UNUSED(event);
+        Q_UNUSED(subject);
+        Q_UNUSED(a);
+        Q_UNUSED(b);
+        Q_UNUSED(c);
+    }
+}
+
+/**
+ * @brief Logs a debug event
+ * @see log()
+ */
+inline void debug(Event event, qint32 subject = -1, double a = 0.0, double b = 0.0, double c = 0.0)
+{
+    log<Debug>(event, subject, a, b, c);
+}
+
+/**
+ * @brief Logs an info event
+ * @see log()
+ */
+inline void info(Event event, qint32 subject = -1, double a = 0.0, double b = 0.0, double c = 0.0)
+{
+    log<Info>(event, subject, a, b, c);
+}
+
+/**
+ * @brief Logs a warning event
+ * @see log()
+ */
+inline void warning(Event event, qint32 subject = -1, double a = 0.0, double b = 0.0, double c = 0.0)
+{
+    log<Warning>(event, subject, a, b, c);
+}
+
+/**
+ * @brief Starts the background thread that drains and formats the records
+ * @param path File the text is appended to, or empty for the Qt message handler
+ * @return False if the file cannot be opened
+ */
+bool start(const QString& path = QString());
+
+/**
+ * @brief Stops the background thread after writing all pending records
+ */
+void stop();
+
+/**
+ * @brief Checks whether the background thread is running
+ * @return True between start() and stop()
+ */
+bool isRunning();
+
+/**
+ * @brief Gets the number of records dropped because a ring was full
+ * @return The drop count since the program started
+ */
+quint64 droppedRecords();
+
+/**
+ * @brief Formats the message of a record
+ * @param record The record
+ * @return The text, without time and thread
+ */
+QString format(const Record& record);
+
+} // namespace EventLog
+
+#endif // EVENTLOG_HPP
@@ -0,0 +1,906 @@
+#include "FleetSimulator.hpp"
+#include "EventLog.hpp"
+#include "FleetVehicle.hpp"
+#include "Geofence.hpp"
+#include "WorkStealingPool.hpp"
+#include <QtMath>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Advances a xorshift32 generator
+ * @param state The generator state, updated in place
+ * @return The next pseudo-random value
+ *
+ * Plain shifts and xors keep per-vehicle randomness cheap, and per-vehicle
+ * state keeps results independent of the order in which vehicles are
+ * stepped.
+ */
+inline quint32 nextRandom(quint32& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief Converts a xorshift value to a double in [0.0, 1.0)
+ */
+inline double toUnit(quint32 value)
+{
+    return (value >> 8) * (1.0 / 16777216.0);
+}
+
+/** @brief A full turn in radians */
+constexpr double FULL_TURN = 2.0 * M_PI;
+
+} // namespace
+
+/**
+ * @brief Constructs an empty FleetSimulator
+ * @param parent The parent QObject
+ *
+ * The fleet owns a real-time clock that is not started; call start(),
+ * inject another clock with setClock(), or drive the fleet manually with
+ * step().
+ */
+FleetSimulator::FleetSimulator(QObject* parent)
+    : QObject(parent)
+    , m_clock(nullptr)
+    , m_ownClock(new SimulationClock(this))
+    , m_random(QRandomGenerator::global()->generate())
+    , m_tickCount(0)
+    , m_simulatedTime(0)
+    , m_states(new FleetStateStore(this))
+    , m_geofence(nullptr)
+    , m_breachCount(0)
+{
+    m_ownClock->setTickInterval(TICK_INTERVAL);
+    setClock(m_ownClock);
+}
+
+/**
+ * @brief Destructor
+ */
+FleetSimulator::~FleetSimulator()
+{
+}
+
+/**
+ * @brief Adds landed vehicles on a square grid around an origin
+ * @param count The number of vehicles to add
+ * @param origin The center of the grid
+ * @param spacing The distance between neighbouring vehicles in meters
+ * @param group The group of the new vehicles
+ * @return The index of the first added vehicle
+ *
+ * New vehicles start landed with a full battery and a 120 m cruise altitude,
+ * matching the defaults of TelemetryDataSimulator.
+ */
+int FleetSimulator::addVehicles(int count, const QGeoCoordinate& origin, double spacing, quint8 group)
+{
+    const int first = vehicleCount();
+    if (count <= 0) {
+        return first;
+    }
+
+    const int total = first + count;
+    const int columns = qCeil(qSqrt(count));
+    const double metersPerLonDegree = METERS_PER_DEGREE * qCos(qDegreesToRadians(origin.latitude()));
+
+    m_latitude.resize(total);
+    m_longitude.resize(total);
+    m_altitude.resize(total, 0.0);
+    m_speed.resize(total, 0.0);
+    m_heading.resize(total, 0.0);
+    m_energy.resize(total, m_energyModel.capacity());
+    m_averagePower.resize(total, 0.0);
+    m_averageSpeed.resize(total, 0.0);
+    m_lastAltitude.resize(total, 0.0);
+    m_lastHeading.resize(total, 0.0);
+    m_targetAltitude.resize(total, 120.0);
+    m_phaseElapsed.resize(total, 0.0);
+    m_destLatitude.resize(total);
+    m_destLongitude.resize(total);
+    m_loiterRadius.resize(total, 100.0);
+    m_loiterAngle.resize(total, 0.0);
+    m_loiterDirection.resize(total, 1.0);
+    m_rngState.resize(total);
+    m_breach.resize(total, Geofence::NO_BREACH);
+    m_breachChanged.resize(total, 0);
+    m_views.resize(total, nullptr);
+
+    for (int i = first; i < total; ++i) {
+        const int slot = i - first;
+        const double north = (slot / columns - columns / 2) * spacing;
+        const double east = (slot % columns - columns / 2) * spacing;
+
+        m_latitude[i] = origin.latitude() + north / METERS_PER_DEGREE;
+        m_longitude[i] = origin.longitude() + east / metersPerLonDegree;
+        m_destLatitude[i] = m_latitude[i];
+        m_destLongitude[i] = m_longitude[i];
+
+        // xorshift must never be seeded with zero
+        m_rngState[i] = m_random.generate() | 1u;
+    }
+
+    m_states->addVehicles(count, group);
+
+    emit vehicleCountChanged(total);
+    return first;
+}
+
+/**
+ * @brief Reseeds the generator that seeds new vehicles
+ * @param seed The seed
+ *
+ * Vehicles already in the fleet keep their generators.
+ */
+void FleetSimulator::setSeed(quint32 seed)
+{
+    m_random.seed(seed);
+}
+
+int FleetSimulator::threadCount() const
+{
+    return m_pool ? m_pool->threadCount() : 1;
+}
+
+/**
+ * @brief Sets the number of threads stepping the fleet
+ * @param threads The thread count, including the thread calling step()
+ *
+ * A count of 1 or less steps the fleet on the calling thread only. The
+ * worker threads are started here, not per tick.
+ */
+void FleetSimulator::setThreadCount(int threads)
+{
+    threads = qMax(1, threads);
+    if (threads == threadCount()) {
+        return;
+    }
+
+    m_pool.reset(threads > 1 ? new WorkStealingPool(threads) : nullptr);
+}
+
+/**
+ * @brief Gets the number of simulated vehicles
+ * @return The fleet size
+ */
+int FleetSimulator::vehicleCount() const
+{
+    return m_states->vehicleCount();
+}
+
+/**
+ * @brief Gets the number of ticks simulated so far
+ * @return The tick counter
+ */
+quint64 FleetSimulator::tickCount() const
+{
+    return m_tickCount;
+}
+
+/**
+ * @brief Gets the simulated time elapsed so far
+ * @return Milliseconds of simulated time
+ */
+qint64 FleetSimulator::simulatedTime() const
+{
+    return m_simulatedTime;
+}
+
+FleetStateStore* FleetSimulator::stateStore() const
+{
+    return m_states;
+}
+
+const Geofence* FleetSimulator::geofence() const
+{
+    return m_geofence;
+}
+
+/**
+ * @brief Sets the geofence the fleet is checked against
+ * @param geofence The geofence, or nullptr to stop checking; the caller keeps ownership
+ *
+ * The fleet is checked against the new fence right away, so breaches and
+ * the breach action do not wait for the next tick. Removing the fence
+ * clears all breaches.
+ */
+void FleetSimulator::setGeofence(const Geofence* geofence)
+{
+    m_geofence = geofence;
+    checkGeofence(0, vehicleCount());
+    reportBreaches();
+
+    for (FleetVehicle* view : std::as_const(m_activeViews)) {
+        view->refresh();
+    }
+}
+
+int FleetSimulator::breachCount() const
+{
+    return m_breachCount;
+}
+
+/**
+ * @brief Gets a TelemetryData view onto a single vehicle
+ * @param index The vehicle index
+ * @return The view, or nullptr if the index is out of range
+ *
+ * Views are created on first use and owned by the fleet. Only existing
+ * views are refreshed after each tick.
+ */
+FleetVehicle* FleetSimulator::vehicle(int index)
+{
+    if (index < 0 || index >= vehicleCount()) {
+        return nullptr;
+    }
+
+    if (!m_views[index]) {
+        m_views[index] = new FleetVehicle(this, index);
+        m_activeViews.append(m_views[index]);
+    }
+
+    return m_views[index];
+}
+
+UASState::State FleetSimulator::state(int index) const
+{
+    return m_states->state(index);
+}
+
+QGeoCoordinate FleetSimulator::position(int index) const
+{
+    return QGeoCoordinate(m_latitude[index], m_longitude[index]);
+}
+
+double FleetSimulator::latitude(int index) const
+{
+    return m_latitude[index];
+}
+
+double FleetSimulator::longitude(int index) const
+{
+    return m_longitude[index];
+}
+
+double FleetSimulator::altitude(int index) const
+{
+    return m_altitude[index];
+}
+
+double FleetSimulator::speed(int index) const
+{
+    return m_speed[index];
+}
+
+/**
+ * @brief Gets the heading of a vehicle
+ * @param index The vehicle index
+ * @return Heading in degrees clockwise from north (0-360)
+ */
+double FleetSimulator::heading(int index) const
+{
+    const double degrees = qRadiansToDegrees(m_heading[index]);
+    return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
+/**
+ * @brief Gets the battery level of a vehicle
+ * @param index The vehicle index
+ * @return Remaining energy as a percentage of the capacity
+ */
+double FleetSimulator::battery(int index) const
+{
+    return m_energy[index] * 100.0 / m_energyModel.capacity();
+}
+
+/**
+ * @brief Gets the estimated remaining flight time of a vehicle
+ * @param index The vehicle index
+ * @return Seconds until the battery is empty at the recent average power draw
+ */
+double FleetSimulator::remainingFlightTime(int index) const
+{
+    return m_energyModel.remainingFlightTime(m_energy[index], m_averagePower[index]);
+}
+
+/**
+ * @brief Gets the estimated remaining range of a vehicle
+ * @param index The vehicle index
+ * @return Meters until the battery is empty at the recent average speed
+ */
+double FleetSimulator::remainingRange(int index) const
+{
+    return m_energyModel.remainingRange(m_energy[index], m_averagePower[index], m_averageSpeed[index]);
+}
+
+/**
+ * @brief Gets the geofence breach of a vehicle
+ * @param index The vehicle index
+ * @return Geofence::NO_BREACH, Geofence::OUTSIDE_INCLUSION or the exclusion zone the vehicle is in, as of the last tick
+ */
+int FleetSimulator::geofenceBreach(int index) const
+{
+    return m_breach[index];
+}
+
+int FleetSimulator::targetAltitude(int index) const
+{
+    return static_cast<int>(m_targetAltitude[index]);
+}
+
+/**
+ * @brief Gets the recent transitions of a vehicle
+ * @param index The vehicle index
+ * @return The audit ring, timestamped in simulated milliseconds
+ */
+const TransitionAudit& FleetSimulator::audit(int index) const
+{
+    return m_states->audit(index);
+}
+
+void FleetSimulator::setTargetAltitude(int index, int altitude)
+{
+    m_targetAltitude[index] = altitude;
+}
+
+/**
+ * @brief Drops the requests of a command that the geofence forbids
+ * @param indices The commanded vehicles
+ * @param state The state the command requests
+ * @param permits Called as permits(position, index) for requests the transition rules accept
+ * @param positions Receives the position within indices of every request kept, if a geofence is set
+ * @return The vehicles whose requests are kept
+ *
+ * Without a geofence the indices are returned as they are. Out of range
+ * indices and requests the transition rules reject are kept, so the state
+ * store skips or rejects them for its own reasons. Forbidden requests are
+ * recorded in the vehicle's audit.
+ */
+template <typename Permits>
+QVector<int> FleetSimulator::permittedVehicles(const QVector<int>& indices, UASState::State state, Permits&& permits,
+                                               QVector<int>* positions)
+{
+    if (!m_geofence) {
+        return indices;
+    }
+
+    const int total = vehicleCount();
+    QVector<int> permitted;
+    permitted.reserve(indices.size());
+
+    for (int position = 0; position < indices.size(); ++position) {
+        const int index = indices[position];
+        const bool checked = index >= 0 && index < total &&
+                             UASStateMachine::isValidTransition(m_states->state(index), state);
+        if (checked && !permits(position, index)) {
+            m_states->recordRejection(index, state, UASState::GeofenceViolation);
+            EventLog::debug(EventLog::GeofenceRejected, index, state);
+            continue;
+        }
+
+        permitted.append(index);
+        if (positions) {
+            positions->append(position);
+        }
+    }
+    return permitted;
+}
+
+/**
+ * @brief Commands a vehicle to take off
+ * @param index The vehicle index
+ * @return True if the command was accepted, false otherwise
+ *
+ * The vehicle picks a random departure heading and climbs to its target
+ * altitude over TAKEOFF_LANDING_DURATION.
+ */
+bool FleetSimulator::takeOff(int index)
+{
+    return takeOff(QVector<int>{index}) == 1;
+}
+
+/**
+ * @brief Commands a vehicle to land
+ * @param index The vehicle index
+ * @return True if the command was accepted, false otherwise
+ */
+bool FleetSimulator::land(int index)
+{
+    return land(QVector<int>{index}) == 1;
+}
+
+/**
+ * @brief Commands a vehicle to fly to a destination and loiter there
+ * @param index The vehicle index
+ * @param destination The geographical coordinates to fly to
+ * @param loiterRadius The radius size for loitering in meters
+ * @param loiterClockwise True to loiter clockwise, false for counterclockwise
+ * @return True if the command was accepted, false otherwise
+ */
+bool FleetSimulator::goTo(int index, const QGeoCoordinate& destination, int loiterRadius, bool loiterClockwise)
+{
+    return goTo(QVector<int>{index}, QVector<QGeoCoordinate>{destination}, loiterRadius, loiterClockwise) == 1;
+}
+
+/**
+ * @brief Commands several vehicles to take off
+ * @param indices The vehicle indices
+ * @return The number of accepted commands
+ *
+ * Vehicles standing where the geofence does not permit them are rejected.
+ */
+int FleetSimulator::takeOff(const QVector<int>& indices)
+{
+    const QVector<int> permitted = permittedVehicles(indices, UASState::TakingOff, [this](int, int index) {
+        return m_geofence->permits(m_latitude[index], m_longitude[index]);
+    });
+
+    return m_states->transition(permitted, UASState::TakingOff, [this](int, int index) {
+        beginTakeOff(index);
+    });
+}
+
+/**
+ * @brief Commands several vehicles to land
+ * @param indices The vehicle indices
+ * @return The number of accepted commands
+ */
+int FleetSimulator::land(const QVector<int>& indices)
+{
+    return m_states->transition(indices, UASState::Landing, [this](int, int index) {
+        beginLanding(index);
+    });
+}
+
+/**
+ * @brief Commands every vehicle in a state and group to land
+ * @param state The state of the vehicles to land
+ * @param group The group of the vehicles to land, or FleetStateStore::ANY_GROUP
+ * @return The number of accepted commands
+ *
+ * E.g. landWhere(UASState::Loitering, 3) lands all loitering vehicles of
+ * group 3. Selecting the vehicles costs no index list.
+ */
+int FleetSimulator::landWhere(UASState::State state, int group)
+{
+    return m_states->transitionWhere(state, group, UASState::Landing, [this](int index) {
+        beginLanding(index);
+    });
+}
+
+/**
+ * @brief Commands several vehicles to fly to destinations and loiter there
+ * @param indices The vehicle indices
+ * @param destinations One destination per vehicle, or a single one shared by all
+ * @param loiterRadius The radius size for loitering in meters
+ * @param loiterClockwise True to loiter clockwise, false for counterclockwise
+ * @return The number of accepted commands
+ *
+ * Vehicles already flying to a waypoint are retargeted. Destinations the
+ * geofence does not permit, or that a vehicle could only reach through an
+ * exclusion zone, are rejected for that vehicle.
+ */
+int FleetSimulator::goTo(const QVector<int>& indices, const QVector<QGeoCoordinate>& destinations, int loiterRadius, bool loiterClockwise)
+{
+    if (destinations.size() != 1 && destinations.size() != indices.size()) {
+        qWarning() << "Expected one destination per vehicle or a single shared one";
+        return 0;
+    }
+
+    const bool shared = destinations.size() == 1;
+    QVector<int> positions;
+    const QVector<int> permitted = permittedVehicles(indices, UASState::FlyingToWaypoint, [&](int position, int index) {
+        const QGeoCoordinate& destination = destinations[shared ? 0 : position];
+        return m_geofence->permitsPath(m_latitude[index], m_longitude[index], destination.latitude(), destination.longitude());
+    }, &positions);
+
+    return m_states->transition(permitted, UASState::FlyingToWaypoint, [&](int position, int index) {
+        const int request = positions.isEmpty() ? position : positions[position];
+        setDestination(index, destinations[shared ? 0 : request], loiterRadius, loiterClockwise);
+    });
+}
+
+SimulationClock* FleetSimulator::clock() const
+{
+    return m_clock;
+}
+
+/**
+ * @brief Replaces the clock driving the fleet
+ * @param clock The clock to use; the caller keeps ownership
+ *
+ * The fleet steps by the clock's tick duration on every tick. The default
+ * real-time clock is released once another clock is injected.
+ */
+void FleetSimulator::setClock(SimulationClock* clock)
+{
+    if (!clock || clock == m_clock) {
+        return;
+    }
+
+    disconnect(m_tickConnection);
+    m_clock = clock;
+    m_tickConnection = connect(m_clock, &SimulationClock::tick, this, &FleetSimulator::step);
+
+    if (m_ownClock && m_ownClock != m_clock) {
+        delete m_ownClock;
+        m_ownClock = nullptr;
+    }
+}
+
+/**
+ * @brief Starts the clock driving the fleet
+ */
+void FleetSimulator::start()
+{
+    m_clock->start();
+}
+
+/**
+ * @brief Stops the clock driving the fleet
+ */
+void FleetSimulator::stop()
+{
+    m_clock->stop();
+}
+
+/**
+ * @brief Advances every vehicle by one tick
+ * @param dtMs The simulated time step in milliseconds
+ *
+ * Runs the phase, kinematics, energy and geofence passes over the whole
+ * fleet, reports breaches, then refreshes the existing views and emits
+ * stepped() exactly once. In parallel mode each shard runs all passes back
+ * to back while its arrays are still in cache, and breaches are only
+ * reported and views refreshed once every shard has finished.
+ */
+void FleetSimulator::step(int dtMs)
+{
+    const int count = vehicleCount();
+    const int shards = (count + SHARD_SIZE - 1) / SHARD_SIZE;
+
+    if (m_pool && shards > 1) {
+        m_pool->run(shards, [this, dtMs, count](int shard) {
+            const int begin = shard * SHARD_SIZE;
+            stepRange(dtMs, begin, qMin(count, begin + SHARD_SIZE));
+        });
+    } else {
+        stepRange(dtMs, 0, count);
+    }
+
+    ++m_tickCount;
+    m_simulatedTime += dtMs;
+    m_states->setTimestamp(m_simulatedTime);
+
+    if (m_geofence || m_breachCount > 0) {
+        reportBreaches();
+    }
+
+    for (FleetVehicle* view : std::as_const(m_activeViews)) {
+        view->refresh();
+    }
+
+    emit stepped(m_tickCount);
+}
+
+/**
+ * @brief Runs all passes of one tick over a range of vehicles
+ * @param dtMs The time step in milliseconds
+ * @param begin The first vehicle index
+ * @param end One past the last vehicle index
+ *
+ * Writes only to the vehicles in the range, so disjoint ranges may be
+ * stepped concurrently.
+ */
+void FleetSimulator::stepRange(int dtMs, int begin, int end)
+{
+    updatePhases(dtMs, begin, end);
+    integratePositions(dtMs / 1000.0, begin, end);
+    drainBatteries(dtMs / 1000.0, begin, end);
+    if (m_geofence) {
+        checkGeofence(begin, end);
+    }
+}
+
+/**
+ * @brief Runs the per-vehicle flight-phase logic for one tick
+ * @param dtMs The time step in milliseconds
+ * @param begin The first vehicle index
+ * @param end One past the last vehicle index
+ *
+ * This is the only branchy pass. It mirrors the phase behavior of
+ * TelemetryDataSimulator: speed and altitude are interpolated towards their
+ * targets during takeoff and landing, cruise speed jitters slightly while
+ * flying, vehicles steer towards their waypoint and then circle it.
+ */
+void FleetSimulator::updatePhases(int dtMs, int begin, int end)
+{
+    const quint8* state = m_states->states();
+
+    for (int i = begin; i < end; ++i) {
+        switch (state[i]) {
+        case UASState::TakingOff: {
+            m_phaseElapsed[i] += dtMs;
+            const double progress = qMin(1.0, m_phaseElapsed[i] / TAKEOFF_LANDING_DURATION);
+
+            m_speed[i] += (CRUISE_SPEED - m_speed[i]) * progress;
+
+            // Begin altitude increase after rotation speed
+            if (m_speed[i] > 10.0) {
+                m_altitude[i] += (m_targetAltitude[i] - m_altitude[i]) * progress;
+            }
+
+            if (m_phaseElapsed[i] >= TAKEOFF_LANDING_DURATION) {
+                EventLog::debug(EventLog::TakeOffCompleted, i, m_altitude[i], m_speed[i]);
+                transition(i, UASState::Flying);
+            }
+            break;
+        }
+        case UASState::Flying: {
+            const double adjust = (toUnit(nextRandom(m_rngState[i])) * 2.0 - 1.0) * 2.0;
+            m_speed[i] = qBound(CRUISE_SPEED - 2.0, m_speed[i] + adjust, CRUISE_SPEED + 2.0);
+            break;
+        }
+        case UASState::FlyingToWaypoint: {
+            const double north = (m_destLatitude[i] - m_latitude[i]) * METERS_PER_DEGREE;
+            const double east = (m_destLongitude[i] - m_longitude[i]) * METERS_PER_DEGREE
+                                * std::cos(qDegreesToRadians(m_latitude[i]));
+
+            if (std::hypot(north, east) < ARRIVAL_DISTANCE) {
+                // Join the loiter circle at the point closest to the vehicle
+                m_loiterAngle[i] = std::atan2(-east, -north);
+                EventLog::debug(EventLog::WaypointReached, i, m_destLatitude[i], m_destLongitude[i]);
+                transition(i, UASState::Loitering);
+            } else {
+                m_heading[i] = std::atan2(east, north);
+            }
+            break;
+        }
+        case UASState::Loitering: {
+            const double radius = m_loiterRadius[i];
+            const double direction = m_loiterDirection[i];
+
+            // Maintain lower speed and a tight altitude band while loitering
+            const double speedAdjust = toUnit(nextRandom(m_rngState[i])) * 2.0 - 1.0;
+            m_speed[i] = qBound(15.0, m_speed[i] + speedAdjust, 20.0);
+            const double altAdjust = toUnit(nextRandom(m_rngState[i])) * 2.0 - 1.0;
+            m_altitude[i] = qBound(m_targetAltitude[i] - 5.0, m_altitude[i] + altAdjust, m_targetAltitude[i] + 5.0);
+
+            m_loiterAngle[i] += direction * m_speed[i] * (dtMs / 1000.0) / radius;
+
+            const double north = radius * std::cos(m_loiterAngle[i]);
+            const double east = radius * std::sin(m_loiterAngle[i]);
+            m_latitude[i] = m_destLatitude[i] + north / METERS_PER_DEGREE;
+            m_longitude[i] = m_destLongitude[i] + east / (METERS_PER_DEGREE * std::cos(qDegreesToRadians(m_destLatitude[i])));
+
+            // Direction is tangent to the circle
+            m_heading[i] = m_loiterAngle[i] + direction * M_PI_2;
+            break;
+        }
+        case UASState::Landing: {
+            m_phaseElapsed[i] += dtMs;
+            const double progress = qMin(1.0, m_phaseElapsed[i] / TAKEOFF_LANDING_DURATION);
+
+            m_speed[i] -= m_speed[i] * progress;
+            m_altitude[i] -= m_altitude[i] * progress;
+
+            if (m_phaseElapsed[i] >= TAKEOFF_LANDING_DURATION) {
+                m_speed[i] = 0.0;
+                m_altitude[i] = 0.0;
+                EventLog::debug(EventLog::Landed, i);
+                transition(i, UASState::Landed);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Integrates positions from speed and heading
+ * @param dt The time step in seconds
+ * @param begin The first vehicle index
+ * @param end One past the last vehicle index
+ *
+ * Branch-free over the range so it vectorizes. Loitering vehicles are
+ * positioned on their circle by updatePhases() and landed vehicles have zero
+ * speed, so both are masked out arithmetically.
+ */
+void FleetSimulator::integratePositions(double dt, int begin, int end)
+{
+    const quint8* state = m_states->states();
+    const double* speed = m_speed.data();
+    const double* heading = m_heading.data();
+    double* latitude = m_latitude.data();
+    double* longitude = m_longitude.data();
+    const double degreesPerRadian = 180.0 / M_PI;
+
+    for (int i = begin; i < end; ++i) {
+        const double moving = state[i] != UASState::Loitering ? 1.0 : 0.0;
+        const double distance = moving * speed[i] * dt;
+        const double north = distance * std::cos(heading[i]);
+        const double east = distance * std::sin(heading[i]);
+
+        latitude[i] += north / METERS_PER_DEGREE;
+        longitude[i] += east / (METERS_PER_DEGREE * std::cos(latitude[i] / degreesPerRadian));
+    }
+}
+
+/**
+ * @brief Drains the batteries by the power each vehicle draws
+ * @param dt The time step in seconds
+ * @param begin The first vehicle index
+ * @param end One past the last vehicle index
+ *
+ * Climb and turn rates are the altitude and heading changes since the
+ * previous tick; heading changes are wrapped to the shorter turn. Power
+ * comes from the shared EnergyModel tables, and the power and speed
+ * averages behind the endurance estimates are updated in the same pass.
+ * The pass is branch-free; its cost is dominated by streaming the arrays,
+ * which are still in cache when a shard runs all passes back to back.
+ */
+void FleetSimulator::drainBatteries(double dt, int begin, int end)
+{
+    const double* altitude = m_altitude.data();
+    const double* heading = m_heading.data();
+    const double* speed = m_speed.data();
+    double* lastAltitude = m_lastAltitude.data();
+    double* lastHeading = m_lastHeading.data();
+    double* energy = m_energy.data();
+    double* averagePower = m_averagePower.data();
+    double* averageSpeed = m_averageSpeed.data();
+
+    const double rate = 1.0 / dt;
+    const double smoothing = EnergyModel::smoothing(dt);
+
+    for (int i = begin; i < end; ++i) {
+        const double climbRate = (altitude[i] - lastAltitude[i]) * rate;
+        double turn = heading[i] - lastHeading[i];
+        turn -= FULL_TURN * static_cast<int>(turn * (1.0 / FULL_TURN) + (turn < 0.0 ? -0.5 : 0.5));
+        lastAltitude[i] = altitude[i];
+        lastHeading[i] = heading[i];
+
+        const double power = m_energyModel.power(speed[i], climbRate, turn * rate);
+        const double left = energy[i] - power * dt;
+        energy[i] = left > 0.0 ? left : 0.0;
+        averagePower[i] += (power - averagePower[i]) * smoothing;
+        averageSpeed[i] += (speed[i] - averageSpeed[i]) * smoothing;
+    }
+}
+
+/**
+ * @brief Checks positions against the geofence
+ * @param begin The first vehicle index
+ * @param end One past the last vehicle index
+ *
+ * Stores each vehicle's breach and flags the vehicles that entered or left
+ * a breach; moving from one exclusion zone into another is not a change.
+ * Without a geofence every vehicle is clear. Only the vehicles' own slots
+ * are written, so shards may be checked concurrently.
+ */
+void FleetSimulator::checkGeofence(int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const qint32 zone = m_geofence ? m_geofence->breach(m_latitude[i], m_longitude[i]) : Geofence::NO_BREACH;
+        if ((zone != Geofence::NO_BREACH) != (m_breach[i] != Geofence::NO_BREACH)) {
+            m_breachChanged[i] = 1;
+        }
+        m_breach[i] = zone;
+    }
+}
+
+/**
+ * @brief Reports the breaches found by checkGeofence() and applies the breach action
+ *
+ * Collects the flagged vehicles into one geofenceBreached() and one
+ * geofenceCleared() batch. With the Land breach action, every breaching
+ * vehicle whose state allows it is then landed in a single batch; vehicles
+ * still taking off are landed on the first tick after their takeoff.
+ */
+void FleetSimulator::reportBreaches()
+{
+    const int count = vehicleCount();
+    QVector<int> breached;
+    QVector<int> cleared;
+
+    for (int i = 0; i < count; ++i) {
+        if (!m_breachChanged[i]) {
+            continue;
+        }
+        m_breachChanged[i] = 0;
+
+        if (m_breach[i] != Geofence::NO_BREACH) {
+            EventLog::debug(EventLog::GeofenceBreached, i, m_breach[i], m_latitude[i], m_longitude[i]);
+            breached.append(i);
+        } else {
+            EventLog::debug(EventLog::GeofenceCleared, i, m_latitude[i], m_longitude[i]);
+            cleared.append(i);
+        }
+    }
+
+    m_breachCount += breached.size() - cleared.size();
+    if (!breached.isEmpty()) {
+        emit geofenceBreached(breached);
+    }
+    if (!cleared.isEmpty()) {
+        emit geofenceCleared(cleared);
+    }
+
+    if (!m_geofence || m_geofence->breachAction() != Geofence::Land || m_breachCount == 0) {
+        return;
+    }
+
+    const quint8* state = m_states->states();
+    QVector<int> landing;
+    for (int i = 0; i < count; ++i) {
+        if (m_breach[i] != Geofence::NO_BREACH &&
+            UASStateMachine::isValidTransition(static_cast<UASState::State>(state[i]), UASState::Landing)) {
+            landing.append(i);
+        }
+    }
+    if (!landing.isEmpty()) {
+        land(landing);
+    }
+}
+
+/**
+ * @brief Applies a validated state transition made by the simulation
+ * @param index The vehicle index
+ * @param state The new state
+ *
+ * Goes through the state store without notification; the change is
+ * announced by stepped() and picked up by views on their next refresh.
+ * Only the vehicle's own slots are written, which keeps transitions safe
+ * within parallel shards.
+ */
+void FleetSimulator::transition(int index, UASState::State state)
+{
+    m_states->transition(index, state);
+}
+
+/**
+ * @brief Resets the timed phase of a vehicle starting to take off
+ * @param index The vehicle index
+ *
+ * The vehicle picks a random departure heading. Lining up on the ground
+ * is not a turn, so the energy pass sees none.
+ */
+void FleetSimulator::beginTakeOff(int index)
+{
+    m_heading[index] = toUnit(nextRandom(m_rngState[index])) * 2.0 * M_PI;
+    m_lastHeading[index] = m_heading[index];
+    m_phaseElapsed[index] = 0.0;
+}
+
+/**
+ * @brief Resets the timed phase of a vehicle starting to land
+ * @param index The vehicle index
+ */
+void FleetSimulator::beginLanding(int index)
+{
+    m_phaseElapsed[index] = 0.0;
+}
+
+/**
+ * @brief Sets the destination and loiter pattern of a vehicle
+ * @param index The vehicle index
+ * @param destination The geographical coordinates to fly to
+ * @param loiterRadius The radius size for loitering in meters
+ * @param loiterClockwise True to loiter clockwise, false for counterclockwise
+ */
+void FleetSimulator::setDestination(int index, const QGeoCoordinate& destination, int loiterRadius, bool loiterClockwise)
+{
+    m_destLatitude[index] = destination.latitude();
+    m_destLongitude[index] = destination.longitude();
+    m_loiterRadius[index] = qMax(1, loiterRadius);
+    m_loiterDirection[index] = loiterClockwise ? 1.0 : -1.0;
+}
@@ -0,0 +1,451 @@
+#ifndef FLEETSIMULATOR_HPP
+#define FLEETSIMULATOR_HPP
+
+#include <QObject>
+#include <QGeoCoordinate>
+#include <QRandomGenerator>
+#include <QVector>
+#include <memory>
+#include <vector>
+#include "EnergyModel.hpp"
+#include "FleetStateStore.hpp"
+#include "SimulationClock.hpp"
+
+class FleetVehicle;
+class Geofence;
+class WorkStealingPool;
+
+/**
+ * @class FleetSimulator
+ * @brief Simulates a large fleet of UAS with structure-of-arrays state
+ *
+ * Unlike TelemetryDataSimulator, which models one vehicle with a callback per
+ * flight phase, this class keeps the state of every vehicle in contiguous
+ * per-field arrays and advances the whole fleet once per SimulationClock tick.
+ * Each tick runs one pass over the flight-phase logic followed by branch-free
+ * kinematics and energy passes that the compiler can vectorize. Every
+ * vehicle flies the same EnergyModel airframe; its lookup tables are shared
+ * by the whole fleet and stay in cache.
+ *
+ * Flight states live in a FleetStateStore. Commands can be sent to single
+ * vehicles or to many at once; a batch is validated and applied in one pass
+ * and announced with a single FleetStateStore::statesChanged() signal.
+ *
+ * Individual vehicles are exposed through the TelemetryData interface by
+ * FleetVehicle views. Views are created on demand and refreshed once per
+ * tick, so only vehicles that are actually displayed cost any signal traffic.
+ *
+ * With setThreadCount() the fleet is split into shards of SHARD_SIZE
+ * vehicles that are stepped in parallel on a WorkStealingPool. Vehicles
+ * never read each other's state and each has its own random generator, so
+ * the result of a tick does not depend on the thread count. Every tick is a
+ * barrier: views and stepped() only see fully stepped fleets.
+ *
+ * With setGeofence(), every shard checks its vehicles against the fence at
+ * the end of each tick. Vehicles entering or leaving a breach are reported
+ * once per tick in a geofenceBreached() or geofenceCleared() batch, and
+ * with the Land breach action all breaching vehicles are landed. Takeoffs
+ * and flights to waypoints that the fence forbids are rejected and recorded
+ * in the vehicles' audits as UASState::GeofenceViolation.
+ */
+class FleetSimulator : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int vehicleCount READ vehicleCount NOTIFY vehicleCountChanged)
+
+public:
+    /**
+     * @brief Constructs an empty FleetSimulator
+     * @param parent The parent QObject
+     */
+    explicit FleetSimulator(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetSimulator();
+
+    /**
+     * @brief Adds landed vehicles on a square grid around an origin
+     * @param count The number of vehicles to add
+     * @param origin The center of the grid
+     * @param spacing The distance between neighbouring vehicles in meters
+     * @param group The group of the new vehicles
+     * @return The index of the first added vehicle
+     */
+    int addVehicles(int count, const QGeoCoordinate& origin, double spacing = 50.0, quint8 group = 0);
+
+    /**
+     * @brief Reseeds the generator that seeds new vehicles
+     * @param seed The seed
+     *
+     * Fleets seeded alike and given the same commands evolve identically.
+     */
+    void setSeed(quint32 seed);
+
+    /**
+     * @brief Gets the number of threads stepping the fleet
+     * @return The thread count, 1 for single-threaded stepping
+     */
+    int threadCount() const;
+
+    /**
+     * @brief Sets the number of threads stepping the fleet
+     * @param threads The thread count, including the thread calling step()
+     */
+    void setThreadCount(int threads);
+
+    /**
+     * @brief Gets the number of simulated vehicles
+     * @return The fleet size
+     */
+    int vehicleCount() const;
+
+    /**
+     * @brief Gets the number of ticks simulated so far
+     * @return The tick counter
+     */
+    quint64 tickCount() const;
+
+    /**
+     * @brief Gets the simulated time elapsed so far
+     * @return Milliseconds of simulated time
+     */
+    qint64 simulatedTime() const;
+
+    /**
+     * @brief Gets the store holding the flight state of every vehicle
+     * @return The state store, owned by the fleet
+     */
+    FleetStateStore* stateStore() const;
+
+    /**
+     * @brief Gets the geofence the fleet is checked against
+     * @return The geofence, or nullptr if none is set
+     */
+    const Geofence* geofence() const;
+
+    /**
+     * @brief Sets the geofence the fleet is checked against
+     * @param geofence The geofence, or nullptr to stop checking; the caller keeps ownership
+     */
+    void setGeofence(const Geofence* geofence);
+
+    /**
+     * @brief Gets the number of vehicles breaching the geofence
+     * @return The count as of the last tick
+     */
+    int breachCount() const;
+
+    /**
+     * @brief Gets a TelemetryData view onto a single vehicle
+     * @param index The vehicle index
+     * @return The view, created on first use and owned by the fleet
+     */
+    FleetVehicle* vehicle(int index);
+
+    /** @name Per-vehicle state accessors */
+    ///@{
+    UASState::State state(int index) const;
+    QGeoCoordinate position(int index) const;
+    double latitude(int index) const;
+    double longitude(int index) const;
+    double altitude(int index) const;
+    double speed(int index) const;
+    double heading(int index) const;
+    double battery(int index) const;
+    double remainingFlightTime(int index) const;
+    double remainingRange(int index) const;
+    int geofenceBreach(int index) const;
+    int targetAltitude(int index) const;
+    const TransitionAudit& audit(int index) const;
+    ///@}
+
+    /**
+     * @brief Sets the cruise altitude of a vehicle
+     * @param index The vehicle index
+     * @param altitude Altitude in meters
+     */
+    void setTargetAltitude(int index, int altitude);
+
+    /**
+     * @brief Commands a vehicle to take off
+     * @param index The vehicle index
+     * @return True if the command was accepted, false otherwise
+     */
+    bool takeOff(int index);
+
+    /**
+     * @brief Commands a vehicle to land
+     * @param index The vehicle index
+     * @return True if the command was accepted, false otherwise
+     */
+    bool land(int index);
+
+    /**
+     * @brief Commands a vehicle to fly to a destination and loiter there
+     * @param index The vehicle index
+     * @param destination The geographical coordinates to fly to
+     * @param loiterRadius The radius size for loitering in meters
+     * @param loiterClockwise True to loiter clockwise, false for counterclockwise
+     * @return True if the command was accepted, false otherwise
+     */
+    bool goTo(int index, const QGeoCoordinate& destination, int loiterRadius, bool loiterClockwise);
+
+    /**
+     * @brief Commands several vehicles to take off
+     * @param indices The vehicle indices
+     * @return The number of accepted commands
+     */
+    int takeOff(const QVector<int>& indices);
+
+    /**
+     * @brief Commands several vehicles to land
+     * @param indices The vehicle indices
+     * @return The number of accepted commands
+     */
+    int land(const QVector<int>& indices);
+
+    /**
+     * @brief Commands every vehicle in a state and group to land
+     * @param state The state of the vehicles to land
+     * @param group The group of the vehicles to land, or FleetStateStore::ANY_GROUP
+     * @return The number of accepted commands
+     */
+    int landWhere(UASState::State state, int group = FleetStateStore::ANY_GROUP);
+
+    /**
+     * @brief Commands several vehicles to fly to destinations and loiter there
+     * @param indices The vehicle indices
+     * @param destinations One destination per vehicle, or a single one shared by all
+     * @param loiterRadius The radius size for loitering in meters
+     * @param loiterClockwise True to loiter clockwise, false for counterclockwise
+     * @return The number of accepted commands
+     */
+    int goTo(const QVector<int>& indices, const QVector<QGeoCoordinate>& destinations, int loiterRadius, bool loiterClockwise);
+
+    /**
+     * @brief Gets the clock driving the fleet
+     * @return The simulation clock
+     */
+    SimulationClock* clock() const;
+
+    /**
+     * @brief Replaces the clock driving the fleet
+     * @param clock The clock to use; the caller keeps ownership
+     */
+    void setClock(SimulationClock* clock);
+
+    /**
+     * @brief Starts the clock driving the fleet
+     */
+    void start();
+
+    /**
+     * @brief Stops the clock driving the fleet
+     */
+    void stop();
+
+    /**
+     * @brief Advances every vehicle by one tick
+     * @param dtMs The simulated time step in milliseconds
+     *
+     * Called on every clock tick, but may also be called directly to
+     * step the fleet deterministically.
+     */
+    void step(int dtMs = TICK_INTERVAL);
+
+    /** @brief Default tick interval in milliseconds */
+    static constexpr int TICK_INTERVAL = 250;
+
+    /** @brief Number of vehicles stepped as one task in parallel mode */
+    static constexpr int SHARD_SIZE = 1024;
+
+signals:
+    /**
+     * @brief Emitted when the number of vehicles changes
+     * @param count The new fleet size
+     */
+    void vehicleCountChanged(int count);
+
+    /**
+     * @brief Emitted once after every tick, regardless of fleet size
+     * @param tick The tick counter after the step
+     */
+    void stepped(quint64 tick);
+
+    /**
+     * @brief Emitted once per tick in which vehicles breached the geofence
+     * @param indices The vehicles that entered a breach
+     */
+    void geofenceBreached(const QVector<int>& indices);
+
+    /**
+     * @brief Emitted once per tick in which vehicles returned inside the geofence
+     * @param indices The vehicles whose breach ended
+     */
+    void geofenceCleared(const QVector<int>& indices);
+
+private:
+    /**
+     * @brief Runs all passes of one tick over a range of vehicles
+     * @param dtMs The time step in milliseconds
+     * @param begin The first vehicle index
+     * @param end One past the last vehicle index
+     */
+    void stepRange(int dtMs, int begin, int end);
+
+    /**
+     * @brief Runs the per-vehicle flight-phase logic for one tick
+     * @param dtMs The time step in milliseconds
+     * @param begin The first vehicle index
+     * @param end One past the last vehicle index
+     */
+    void updatePhases(int dtMs, int begin, int end);
+
+    /**
+     * @brief Integrates positions from speed and heading
+     * @param dt The time step in seconds
+     * @param begin The first vehicle index
+     * @param end One past the last vehicle index
+     */
+    void integratePositions(double dt, int begin, int end);
+
+    /**
+     * @brief Drains the batteries by the power each vehicle draws
+     * @param dt The time step in seconds
+     * @param begin The first vehicle index
+     * @param end One past the last vehicle index
+     */
+    void drainBatteries(double dt, int begin, int end);
+
+    /**
+     * @brief Checks positions against the geofence
+     * @param begin The first vehicle index
+     * @param end One past the last vehicle index
+     */
+    void checkGeofence(int begin, int end);
+
+    /**
+     * @brief Reports the breaches found by checkGeofence() and applies the breach action
+     */
+    void reportBreaches();
+
+    /**
+     * @brief Drops the requests of a command that the geofence forbids
+     * @param indices The commanded vehicles
+     * @param state The state the command requests
+     * @param permits Called as permits(position, index) for requests the transition rules accept
+     * @param positions Receives the position within indices of every request kept, if a geofence is set
+     * @return The vehicles whose requests are kept
+     */
+    template <typename Permits>
+    QVector<int> permittedVehicles(const QVector<int>& indices, UASState::State state, Permits&& permits,
+                                   QVector<int>* positions = nullptr);
+
+    /**
+     * @brief Applies a validated state transition made by the simulation
+     * @param index The vehicle index
+     * @param state The new state
+     */
+    void transition(int index, UASState::State state);
+
+    /**
+     * @brief Resets the timed phase of a vehicle starting to take off
+     * @param index The vehicle index
+     */
+    void beginTakeOff(int index);
+
+    /**
+     * @brief Resets the timed phase of a vehicle starting to land
+     * @param index The vehicle index
+     */
+    void beginLanding(int index);
+
+    /**
+     * @brief Sets the destination and loiter pattern of a vehicle
+     * @param index The vehicle index
+     * @param destination The geographical coordinates to fly to
+     * @param loiterRadius The radius size for loitering in meters
+     * @param loiterClockwise True to loiter clockwise, false for counterclockwise
+     */
+    void setDestination(int index, const QGeoCoordinate& destination, int loiterRadius, bool loiterClockwise);
+
+    /** @brief The clock driving the whole fleet */
+    SimulationClock* m_clock;
+
+    /** @brief The default real-time clock, owned by the fleet */
+    SimulationClock* m_ownClock;
+
+    /** @brief Connection from the clock tick to step() */
+    QMetaObject::Connection m_tickConnection;
+
+    /** @brief Random number generator used to seed per-vehicle generators */
+    QRandomGenerator m_random;
+
+    /** @brief Number of ticks simulated so far */
+    quint64 m_tickCount;
+
+    /** @brief Simulated time elapsed so far in milliseconds */
+    qint64 m_simulatedTime;
+
+    /** @brief Flight state of every vehicle */
+    FleetStateStore* m_states;
+
+    /** @brief Power draw of every vehicle */
+    EnergyModel m_energyModel;
+
+    /** @brief The geofence the fleet is checked against, not owned */
+    const Geofence* m_geofence;
+
+    /** @brief Number of vehicles breaching the geofence */
+    int m_breachCount;
+
+    /** @brief Pool stepping the shards, null for single-threaded stepping */
+    std::unique_ptr<WorkStealingPool> m_pool;
+
+    /** @name Structure-of-arrays vehicle state, one element per vehicle */
+    ///@{
+    std::vector<double> m_latitude;         ///< Degrees
+    std::vector<double> m_longitude;        ///< Degrees
+    std::vector<double> m_altitude;         ///< Meters
+    std::vector<double> m_speed;            ///< Meters per second
+    std::vector<double> m_heading;          ///< Radians, clockwise from north
+    std::vector<double> m_energy;           ///< Joules left in the battery
+    std::vector<double> m_averagePower;     ///< Watts, averaged over EnergyModel::AVERAGING_TIME
+    std::vector<double> m_averageSpeed;     ///< Meters per second, averaged likewise
+    std::vector<double> m_lastAltitude;     ///< Meters, at the end of the previous tick
+    std::vector<double> m_lastHeading;      ///< Radians, at the end of the previous tick
+    std::vector<double> m_targetAltitude;   ///< Meters
+    std::vector<double> m_phaseElapsed;     ///< Milliseconds spent in the current timed phase
+    std::vector<double> m_destLatitude;     ///< Degrees
+    std::vector<double> m_destLongitude;    ///< Degrees
+    std::vector<double> m_loiterRadius;     ///< Meters
+    std::vector<double> m_loiterAngle;      ///< Radians around the loiter center
+    std::vector<double> m_loiterDirection;  ///< +1 clockwise, -1 counterclockwise
+    std::vector<quint32> m_rngState;        ///< Per-vehicle xorshift state
+    std::vector<qint32> m_breach;           ///< Geofence::breach() of the position
+    std::vector<quint8> m_breachChanged;    ///< 1 if the vehicle entered or left a breach this tick
+    ///@}
+
+    /** @brief Lazily created views, indexed by vehicle */
+    QVector<FleetVehicle*> m_views;
+
+    /** @brief Views that exist and need refreshing every tick */
+    QVector<FleetVehicle*> m_activeViews;
+
+    /** @brief Duration of takeoff and landing sequences in milliseconds */
+    static constexpr double TAKEOFF_LANDING_DURATION = 7000.0;
+
+    /** @brief Nominal cruise speed in meters per second */
+    static constexpr double CRUISE_SPEED = 40.0;
+
+    /** @brief Distance to a waypoint at which loitering begins, in meters */
+    static constexpr double ARRIVAL_DISTANCE = 50.0;
+
+    /** @brief Approximate length of one degree of latitude in meters */
+    static constexpr double METERS_PER_DEGREE = 111320.0;
+};
+
+#endif // FLEETSIMULATOR_HPP
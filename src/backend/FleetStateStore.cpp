@@ -0,0 +1,187 @@
+#include "FleetStateStore.hpp"
+
+/**
+ * @brief Constructs an empty store
+ * @param parent The parent QObject
+ */
+FleetStateStore::FleetStateStore(QObject* parent)
+    : QObject(parent)
+    , m_timestamp(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+FleetStateStore::~FleetStateStore()
+{
+}
+
+/**
+ * @brief Adds landed vehicles
+ * @param count The number of vehicles to add
+ * @param group The group of the new vehicles
+ * @return The index of the first added vehicle
+ */
+int FleetStateStore::addVehicles(int count, quint8 group)
+{
+    const int first = vehicleCount();
+    if (count <= 0) {
+        return first;
+    }
+
+    const int total = first + count;
+    m_states.resize(total, UASState::Landed);
+    m_groups.resize(total, group);
+    m_audit.resize(total);
+
+    emit vehicleCountChanged(total);
+    return first;
+}
+
+int FleetStateStore::vehicleCount() const
+{
+    return static_cast<int>(m_states.size());
+}
+
+UASState::State FleetStateStore::state(int index) const
+{
+    return static_cast<UASState::State>(m_states[index]);
+}
+
+const quint8* FleetStateStore::states() const
+{
+    return m_states.data();
+}
+
+quint8 FleetStateStore::group(int index) const
+{
+    return m_groups[index];
+}
+
+void FleetStateStore::setGroup(int index, quint8 group)
+{
+    m_groups[index] = group;
+}
+
+/**
+ * @brief Gets the number of vehicles in a state
+ * @param state The state
+ * @param group The group to count, or ANY_GROUP
+ * @return The vehicle count
+ */
+int FleetStateStore::count(UASState::State state, int group) const
+{
+    const int total = vehicleCount();
+    const quint8* states = m_states.data();
+    const quint8* groups = m_groups.data();
+    int matches = 0;
+
+    for (int i = 0; i < total; ++i) {
+        matches += states[i] == state && (group == ANY_GROUP || groups[i] == group) ? 1 : 0;
+    }
+    return matches;
+}
+
+const TransitionAudit& FleetStateStore::audit(int index) const
+{
+    return m_audit[index];
+}
+
+void FleetStateStore::setTimestamp(qint64 timestamp)
+{
+    m_timestamp = timestamp;
+}
+
+/**
+ * @brief Applies a validated transition to one vehicle without notification
+ * @param index The vehicle index
+ * @param state The requested state
+ * @return Accepted, or the reason the transition was rejected
+ *
+ * An accepted request for the current state is a no-op and not recorded,
+ * matching UASStateMachine. Only the vehicle's own slots are written.
+ */
+UASState::TransitionResult FleetStateStore::transition(int index, UASState::State state)
+{
+    const UASState::State current = static_cast<UASState::State>(m_states[index]);
+    const UASState::TransitionResult result = UASStateMachine::transitionResult(current, state);
+    if (result == UASState::Accepted && current == state) {
+        return result;
+    }
+
+    m_audit[index].record(m_timestamp, current, state, result);
+    if (result == UASState::Accepted) {
+        m_states[index] = static_cast<quint8>(state);
+    }
+    return result;
+}
+
+/**
+ * @brief Records a request rejected by a rule outside the transition table
+ * @param index The vehicle index
+ * @param state The requested state
+ * @param reason Why the request was rejected
+ *
+ * Lets the owner of the store reject commands for reasons of its own, such
+ * as the geofence, while keeping them in the vehicle's audit.
+ */
+void FleetStateStore::recordRejection(int index, UASState::State state, UASState::TransitionResult reason)
+{
+    m_audit[index].record(m_timestamp, static_cast<UASState::State>(m_states[index]), state, reason);
+}
+
+/**
+ * @brief Requests a state for a list of vehicles
+ * @param indices The vehicles; out of range indices are skipped
+ * @param state The requested state
+ * @return The number of accepted requests
+ */
+int FleetStateStore::transition(const QVector<int>& indices, UASState::State state)
+{
+    return transition(indices, state, [](int, int) {});
+}
+
+/**
+ * @brief Requests a state for every vehicle in a state and group
+ * @param from The state of the affected vehicles
+ * @param group The group of the affected vehicles, or ANY_GROUP
+ * @param state The requested state
+ * @return The number of accepted requests
+ */
+int FleetStateStore::transitionWhere(UASState::State from, int group, UASState::State state)
+{
+    return transitionWhere(from, group, state, [](int) {});
+}
+
+/**
+ * @brief Validates, applies and records one request of a batch
+ * @param index The vehicle index
+ * @param state The requested state
+ * @param changed Receives the index if the state changed
+ * @return True if the request was accepted
+ */
+bool FleetStateStore::applyBatched(int index, UASState::State state, QVector<int>& changed)
+{
+    const bool wasInState = m_states[index] == state;
+    if (transition(index, state) != UASState::Accepted) {
+        return false;
+    }
+
+    if (!wasInState) {
+        changed.append(index);
+    }
+    return true;
+}
+
+/**
+ * @brief Reports the vehicles changed by a batch
+ * @param changed The vehicles whose state changed
+ * @param state Their new state
+ */
+void FleetStateStore::finishBatch(const QVector<int>& changed, UASState::State state)
+{
+    if (!changed.isEmpty()) {
+        emit statesChanged(changed, state);
+    }
+}
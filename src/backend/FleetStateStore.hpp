@@ -0,0 +1,247 @@
+#ifndef FLEETSTATESTORE_HPP
+#define FLEETSTATESTORE_HPP
+
+#include <QObject>
+#include <QVector>
+#include <vector>
+#include "UASStateMachine.hpp"
+
+/**
+ * @class FleetStateStore
+ * @brief Flight states of a whole fleet with batch transitions
+ *
+ * Where UASStateMachine holds the state of one vehicle, the store keeps the
+ * state and group of N vehicles in compact byte arrays and applies commands
+ * to many vehicles at once. A batch is validated against the transition
+ * table and applied in a single pass, recorded in each vehicle's
+ * TransitionAudit, and reported with one statesChanged() signal instead of
+ * one signal per vehicle.
+ *
+ * Single transitions made by transition() are silent and only touch the
+ * vehicle's own slots, so a simulation may advance disjoint vehicles from
+ * several threads; it reports that progress through its own notification.
+ */
+class FleetStateStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief Group filter matching every group */
+    static constexpr int ANY_GROUP = -1;
+
+    /**
+     * @brief Constructs an empty store
+     * @param parent The parent QObject
+     */
+    explicit FleetStateStore(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetStateStore();
+
+    /**
+     * @brief Adds landed vehicles
+     * @param count The number of vehicles to add
+     * @param group The group of the new vehicles
+     * @return The index of the first added vehicle
+     */
+    int addVehicles(int count, quint8 group = 0);
+
+    /**
+     * @brief Gets the number of vehicles
+     * @return The fleet size
+     */
+    int vehicleCount() const;
+
+    /**
+     * @brief Gets the state of a vehicle
+     * @param index The vehicle index
+     * @return The state
+     */
+    UASState::State state(int index) const;
+
+    /**
+     * @brief Gets the states of all vehicles
+     * @return One UASState::State per vehicle, stored as a byte
+     */
+    const quint8* states() const;
+
+    /**
+     * @brief Gets the group of a vehicle
+     * @param index The vehicle index
+     * @return The group
+     */
+    quint8 group(int index) const;
+
+    /**
+     * @brief Moves a vehicle to a group
+     * @param index The vehicle index
+     * @param group The new group
+     */
+    void setGroup(int index, quint8 group);
+
+    /**
+     * @brief Gets the number of vehicles in a state
+     * @param state The state
+     * @param group The group to count, or ANY_GROUP
+     * @return The vehicle count
+     */
+    int count(UASState::State state, int group = ANY_GROUP) const;
+
+    /**
+     * @brief Gets the recent transitions of a vehicle
+     * @param index The vehicle index
+     * @return The audit ring
+     */
+    const TransitionAudit& audit(int index) const;
+
+    /**
+     * @brief Sets the time stamped into audit records
+     * @param timestamp Time in milliseconds of the owner's time base
+     */
+    void setTimestamp(qint64 timestamp);
+
+    /**
+     * @brief Applies a validated transition to one vehicle without notification
+     * @param index The vehicle index
+     * @param state The requested state
+     * @return Accepted, or the reason the transition was rejected
+     */
+    UASState::TransitionResult transition(int index, UASState::State state);
+
+    /**
+     * @brief Records a request rejected by a rule outside the transition table
+     * @param index The vehicle index
+     * @param state The requested state
+     * @param reason Why the request was rejected
+     */
+    void recordRejection(int index, UASState::State state, UASState::TransitionResult reason);
+
+    /**
+     * @brief Requests a state for a list of vehicles
+     * @param indices The vehicles; out of range indices are skipped
+     * @param state The requested state
+     * @param onAccepted Called as onAccepted(position, index) for every accepted request
+     * @return The number of accepted requests
+     *
+     * The position within indices lets callers pair accepted requests with
+     * per-request arguments. onAccepted runs in the validation pass, before
+     * statesChanged() is emitted. Vehicles already in the requested state
+     * count as accepted but are not reported as changed.
+     */
+    template <typename OnAccepted>
+    int transition(const QVector<int>& indices, UASState::State state, OnAccepted&& onAccepted)
+    {
+        const int total = vehicleCount();
+        QVector<int> changed;
+        changed.reserve(indices.size());
+
+        int accepted = 0;
+        for (int position = 0; position < indices.size(); ++position) {
+            const int index = indices[position];
+            if (index >= 0 && index < total && applyBatched(index, state, changed)) {
+                onAccepted(position, index);
+                ++accepted;
+            }
+        }
+
+        finishBatch(changed, state);
+        return accepted;
+    }
+
+    /**
+     * @brief Requests a state for a list of vehicles
+     * @param indices The vehicles; out of range indices are skipped
+     * @param state The requested state
+     * @return The number of accepted requests
+     */
+    int transition(const QVector<int>& indices, UASState::State state);
+
+    /**
+     * @brief Requests a state for every vehicle in a state and group
+     * @param from The state of the affected vehicles
+     * @param group The group of the affected vehicles, or ANY_GROUP
+     * @param state The requested state
+     * @param onAccepted Called as onAccepted(index) for every accepted request
+     * @return The number of accepted requests
+     *
+     * Selection, validation and application happen in the same pass over
+     * the state and group arrays. Vehicles outside the selection are not
+     * recorded.
+     */
+    template <typename OnAccepted>
+    int transitionWhere(UASState::State from, int group, UASState::State state, OnAccepted&& onAccepted)
+    {
+        const int total = vehicleCount();
+        QVector<int> changed;
+
+        int accepted = 0;
+        for (int i = 0; i < total; ++i) {
+            if (m_states[i] != from || (group != ANY_GROUP && m_groups[i] != group)) {
+                continue;
+            }
+            if (applyBatched(i, state, changed)) {
+                onAccepted(i);
+                ++accepted;
+            }
+        }
+
+        finishBatch(changed, state);
+        return accepted;
+    }
+
+    /**
+     * @brief Requests a state for every vehicle in a state and group
+     * @param from The state of the affected vehicles
+     * @param group The group of the affected vehicles, or ANY_GROUP
+     * @param state The requested state
+     * @return The number of accepted requests
+     */
+    int transitionWhere(UASState::State from, int group, UASState::State state);
+
+signals:
+    /**
+     * @brief Emitted once per batch that changed the state of any vehicle
+     * @param indices The vehicles whose state changed
+     * @param state Their new state
+     */
+    void statesChanged(const QVector<int>& indices, UASState::State state);
+
+    /**
+     * @brief Emitted when the number of vehicles changes
+     * @param count The new fleet size
+     */
+    void vehicleCountChanged(int count);
+
+private:
+    /**
+     * @brief Validates, applies and records one request of a batch
+     * @param index The vehicle index
+     * @param state The requested state
+     * @param changed Receives the index if the state changed
+     * @return True if the request was accepted
+     */
+    bool applyBatched(int index, UASState::State state, QVector<int>& changed);
+
+    /**
+     * @brief Reports the vehicles changed by a batch
+     * @param changed The vehicles whose state changed
+     * @param state Their new state
+     */
+    void finishBatch(const QVector<int>& changed, UASState::State state);
+
+    /** @brief One UASState::State per vehicle */
+    std::vector<quint8> m_states;
+
+    /** @brief Group of every vehicle */
+    std::vector<quint8> m_groups;
+
+    /** @brief Recent transitions of every vehicle */
+    std::vector<TransitionAudit> m_audit;
+
+    /** @brief Time stamped into audit records */
+    qint64 m_timestamp;
+};
+
+#endif // FLEETSTATESTORE_HPP
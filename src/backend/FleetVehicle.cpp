@@ -0,0 +1,103 @@
+#include "FleetVehicle.hpp"
+#include "FleetSimulator.hpp"
+#include "Geofence.hpp"
+
+/**
+ * @brief Constructs a view onto a fleet vehicle
+ * @param fleet The fleet owning the vehicle, also used as parent
+ * @param index The index of the vehicle within the fleet
+ *
+ * The view is refreshed immediately so it is consistent with the fleet
+ * before the first tick.
+ */
+FleetVehicle::FleetVehicle(FleetSimulator* fleet, int index)
+    : TelemetryData(fleet)
+    , m_fleet(fleet)
+    , m_index(index)
+{
+    refresh();
+}
+
+/**
+ * @brief Destructor
+ */
+FleetVehicle::~FleetVehicle()
+{
+}
+
+int FleetVehicle::index() const
+{
+    return m_index;
+}
+
+int FleetVehicle::targetAltitude() const
+{
+    return m_fleet->targetAltitude(m_index);
+}
+
+void FleetVehicle::setTargetAltitude(const int altitude)
+{
+    if (altitude != m_fleet->targetAltitude(m_index))
+    {
+        m_fleet->setTargetAltitude(m_index, altitude);
+        emit targetAltitudeChanged(altitude);
+    }
+}
+
+/**
+ * @brief Commands the vehicle to take off
+ *
+ * The fleet validates the command; the view is refreshed immediately so the
+ * new state is visible without waiting for the next tick.
+ */
+void FleetVehicle::takeOff()
+{
+    if (m_fleet->takeOff(m_index)) {
+        refresh();
+    }
+}
+
+/**
+ * @brief Commands the vehicle to land
+ */
+void FleetVehicle::land()
+{
+    if (m_fleet->land(m_index)) {
+        refresh();
+    }
+}
+
+/**
+ * @brief Commands the vehicle to fly to a destination and loiter there
+ * @param destination The geographical coordinates to fly to
+ * @param loiterRadius The radius size for loitering
+ * @param loiterClockwise True if the UAS should loiter clockwise, false if it should loiter counterclockwise
+ */
+void FleetVehicle::goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise)
+{
+    if (m_fleet->goTo(m_index, destination, loiterRadius, loiterClockwise)) {
+        refresh();
+    }
+}
+
+/**
+ * @brief Pulls the latest vehicle state from the fleet
+ *
+ * Publishes all fields as one frame; publishFrame() drops the fields whose
+ * rounded value did not change. The endurance estimates follow in whole
+ * seconds and meters, and the breach is the one found by the fleet.
+ */
+void FleetVehicle::refresh()
+{
+    TelemetryFrame frame;
+    frame.timestamp = m_fleet->clock()->now();
+    frame.setBattery(qRound(m_fleet->battery(m_index)));
+    frame.setAltitude(qRound(m_fleet->altitude(m_index)));
+    frame.setSpeed(qRound(m_fleet->speed(m_index)));
+    frame.setPosition(m_fleet->latitude(m_index), m_fleet->longitude(m_index));
+    publishFrame(frame);
+    publishEndurance(qRound(m_fleet->remainingFlightTime(m_index)), qRound(m_fleet->remainingRange(m_index)));
+    publishGeofenceBreach(m_fleet->geofenceBreach(m_index) != Geofence::NO_BREACH);
+
+    m_stateMachine->syncState(m_fleet->state(m_index));
+}
@@ -0,0 +1,80 @@
+#ifndef FLEETVEHICLE_HPP
+#define FLEETVEHICLE_HPP
+
+#include "TelemetryData.hpp"
+
+class FleetSimulator;
+
+/**
+ * @class FleetVehicle
+ * @brief Exposes a single FleetSimulator vehicle through the TelemetryData interface
+ *
+ * A FleetVehicle holds no simulation state of its own. When the fleet
+ * refreshes it after a tick, it publishes the vehicle's values as one
+ * TelemetryFrame, so change signals are only emitted for properties that
+ * actually changed. Its state machine mirrors the state held by the fleet.
+ * Geofence breaches are checked by the fleet as well; set the geofence on
+ * the FleetSimulator rather than on its views.
+ */
+class FleetVehicle : public TelemetryData
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a view onto a fleet vehicle
+     * @param fleet The fleet owning the vehicle, also used as parent
+     * @param index The index of the vehicle within the fleet
+     */
+    FleetVehicle(FleetSimulator* fleet, int index);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FleetVehicle();
+
+    /**
+     * @brief Gets the index of the vehicle within its fleet
+     * @return The vehicle index
+     */
+    int index() const;
+
+    // TelemetryData interface implementation
+    int targetAltitude() const override;
+    void setTargetAltitude(const int altitude) override;
+
+    /**
+     * @brief Command the vehicle to take off
+     */
+    Q_INVOKABLE virtual void takeOff() override;
+
+    /**
+     * @brief Command the vehicle to land
+     */
+    Q_INVOKABLE virtual void land() override;
+
+    /**
+     * @brief Command the vehicle to fly to a specific destination
+     * @param destination The geographical coordinates to fly to
+     * @param loiterRadius The radius size for loitering
+     * @param loiterClockwise True if the UAS should loiter clockwise, false if it should loiter counterclockwise
+     */
+    Q_INVOKABLE virtual void goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise) override;
+
+    /**
+     * @brief Pulls the latest vehicle state from the fleet
+     *
+     * Called by FleetSimulator after each tick. Publishes the vehicle's
+     * values as one frame stamped with the fleet's simulated time.
+     */
+    void refresh();
+
+private:
+    /** @brief The fleet owning the vehicle */
+    FleetSimulator* m_fleet;
+
+    /** @brief Index of the vehicle within the fleet */
+    int m_index;
+};
+
+#endif // FLEETVEHICLE_HPP
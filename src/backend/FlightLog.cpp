@@ -0,0 +1,110 @@
+#include "FlightLog.hpp"
+#include <QtMath>
+#include <cstring>
+
+namespace FlightLog {
+
+/**
+ * @brief Encodes the log header
+ * @param startTime Recording start in milliseconds since epoch
+ * @param out Destination of at least HEADER_SIZE bytes
+ */
+void encodeHeader(qint64 startTime, char* out)
+{
+    std::memset(out, 0, HEADER_SIZE);
+    qToLittleEndian<quint32>(MAGIC, out);
+    qToLittleEndian<quint16>(VERSION, out + 4);
+    qToLittleEndian<quint16>(RECORD_SIZE, out + 6);
+    qToLittleEndian<qint64>(startTime, out + 8);
+}
+
+/**
+ * @brief Validates a log header
+ * @param data The start of the log
+ * @param size The log size in bytes
+ * @return True if the header is valid
+ */
+bool validateHeader(const uchar* data, qint64 size)
+{
+    return size >= HEADER_SIZE &&
+           qFromLittleEndian<quint32>(data) == MAGIC &&
+           qFromLittleEndian<quint16>(data + 4) == VERSION &&
+           qFromLittleEndian<quint16>(data + 6) == RECORD_SIZE;
+}
+
+/**
+ * @brief Encodes the index header
+ * @param out Destination of at least INDEX_HEADER_SIZE bytes
+ */
+void encodeIndexHeader(char* out)
+{
+    std::memset(out, 0, INDEX_HEADER_SIZE);
+    qToLittleEndian<quint32>(INDEX_MAGIC, out);
+    qToLittleEndian<quint16>(VERSION, out + 4);
+    qToLittleEndian<quint16>(INDEX_ENTRY_SIZE, out + 6);
+    qToLittleEndian<qint64>(INDEX_INTERVAL, out + 8);
+}
+
+/**
+ * @brief Validates an index header
+ * @param data The start of the index
+ * @param size The index size in bytes
+ * @return True if the header is valid
+ */
+bool validateIndexHeader(const uchar* data, qint64 size)
+{
+    return size >= INDEX_HEADER_SIZE &&
+           qFromLittleEndian<quint32>(data) == INDEX_MAGIC &&
+           qFromLittleEndian<quint16>(data + 4) == VERSION &&
+           qFromLittleEndian<quint16>(data + 6) == INDEX_ENTRY_SIZE;
+}
+
+/**
+ * @brief Encodes one record
+ * @param record The record to encode
+ * @param out Destination of at least RECORD_SIZE bytes
+ */
+void encodeRecord(const Record& record, char* out)
+{
+    const TelemetryFrame& frame = record.frame;
+    qToLittleEndian<qint64>(frame.timestamp, out);
+    qToLittleEndian<quint16>(record.vehicleId, out + 8);
+    out[10] = static_cast<char>(record.type);
+    out[11] = static_cast<char>(frame.dirty);
+    out[12] = static_cast<char>(record.state);
+    out[13] = static_cast<char>(frame.battery);
+    qToLittleEndian<qint16>(frame.speed, out + 14);
+    qToLittleEndian<qint32>(static_cast<qint32>(qRound64(frame.latitude * 1e7)), out + 16);
+    qToLittleEndian<qint32>(static_cast<qint32>(qRound64(frame.longitude * 1e7)), out + 20);
+    qToLittleEndian<qint32>(frame.altitude, out + 24);
+    qToLittleEndian<quint32>(static_cast<quint32>(record.time), out + 28);
+}
+
+/**
+ * @brief Decodes one record in place
+ * @param in Source of at least RECORD_SIZE bytes
+ * @return The decoded record
+ *
+ * Unknown states are clamped to Landed rather than passed on as invalid
+ * enum values.
+ */
+Record decodeRecord(const uchar* in)
+{
+    Record record;
+    record.time = recordTime(in);
+    record.vehicleId = qFromLittleEndian<quint16>(in + 8);
+    record.type = in[10] == StateChange ? StateChange : Telemetry;
+    record.state = in[12] <= UASState::Landing ? static_cast<UASState::State>(in[12]) : UASState::Landed;
+
+    TelemetryFrame& frame = record.frame;
+    frame.timestamp = qFromLittleEndian<qint64>(in);
+    frame.battery = in[13];
+    frame.speed = qFromLittleEndian<qint16>(in + 14);
+    frame.latitude = qFromLittleEndian<qint32>(in + 16) / 1e7;
+    frame.longitude = qFromLittleEndian<qint32>(in + 20) / 1e7;
+    frame.altitude = qFromLittleEndian<qint32>(in + 24);
+    frame.dirty = in[11] & TelemetryFrame::AllFields;
+    return record;
+}
+
+} // namespace FlightLog
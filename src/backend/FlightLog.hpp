@@ -0,0 +1,166 @@
+#ifndef FLIGHTLOG_HPP
+#define FLIGHTLOG_HPP
+
+#include <QtGlobal>
+#include <QtEndian>
+#include "TelemetryFrame.hpp"
+#include "UASStateMachine.hpp"
+
+/**
+ * @namespace FlightLog
+ * @brief Binary format of recorded flight logs
+ *
+ * A log is an append-only file made of a 32 byte header followed by fixed
+ * 32 byte records, so record i always lives at HEADER_SIZE + i * RECORD_SIZE
+ * and a log cut short by a crash is still readable up to its last complete
+ * record. All values are little-endian.
+ *
+ * Header:
+ * | Offset | Size | Field                               |
+ * |--------|------|-------------------------------------|
+ * | 0      | 4    | Magic "GCSL"                        |
+ * | 4      | 2    | Format version                      |
+ * | 6      | 2    | Record size                         |
+ * | 8      | 8    | Recording start (ms since epoch)    |
+ * | 16     | 16   | Reserved, must be zero              |
+ *
+ * Record:
+ * | Offset | Size | Field                               |
+ * |--------|------|-------------------------------------|
+ * | 0      | 8    | Timestamp (ms of source time)       |
+ * | 8      | 2    | Vehicle id                          |
+ * | 10     | 1    | Record type                         |
+ * | 11     | 1    | Changed fields (Telemetry records)  |
+ * | 12     | 1    | UASState::State                     |
+ * | 13     | 1    | Battery (%)                         |
+ * | 14     | 2    | Speed (m/s)                         |
+ * | 16     | 4    | Latitude (degrees * 1e7)            |
+ * | 20     | 4    | Longitude (degrees * 1e7)           |
+ * | 24     | 4    | Altitude (m)                        |
+ * | 28     | 4    | Log time (ms since recording start) |
+ *
+ * Every record carries the complete telemetry snapshot of its vehicle, so
+ * playback can start at any record without replaying earlier ones.
+ *
+ * The timestamp is stored as the source stamped it, in whatever time base
+ * that source uses. Seeking uses the log time instead, which the recorder
+ * takes from its own monotonic clock: it never decreases from one record to
+ * the next, so readers can bisect on it, and it covers up to 49 days.
+ *
+ * A sidecar index file (log path + ".idx") holds a 16 byte header (magic
+ * "GCSI", version, interval) followed by 16 byte entries of (log time,
+ * record number), written at least every INDEX_INTERVAL ms of log time.
+ */
+namespace FlightLog {
+
+/** @brief Log file magic, "GCSL" when read as little-endian bytes */
+constexpr quint32 MAGIC = 0x4C534347;
+
+/** @brief Index file magic, "GCSI" when read as little-endian bytes */
+constexpr quint32 INDEX_MAGIC = 0x49534347;
+
+/** @brief Current format version */
+constexpr quint16 VERSION = 2;
+
+/** @brief Size of the log header in bytes */
+constexpr int HEADER_SIZE = 32;
+
+/** @brief Size of one record in bytes */
+constexpr int RECORD_SIZE = 32;
+
+/** @brief Size of the index header in bytes */
+constexpr int INDEX_HEADER_SIZE = 16;
+
+/** @brief Size of one index entry in bytes */
+constexpr int INDEX_ENTRY_SIZE = 16;
+
+/** @brief Log time between index entries in milliseconds */
+constexpr qint64 INDEX_INTERVAL = 1000;
+
+/**
+ * @enum RecordType
+ * @brief Kind of event a record describes
+ */
+enum RecordType : quint8 {
+    Telemetry = 1,  ///< A published telemetry frame
+    StateChange = 2 ///< A state machine transition
+};
+
+/**
+ * @struct Record
+ * @brief A decoded log record
+ */
+struct Record
+{
+    /** @brief Milliseconds since the recording started, see FlightRecorder */
+    qint64 time = 0;
+
+    /** @brief Vehicle the record belongs to */
+    quint16 vehicleId = 0;
+
+    /** @brief Kind of record */
+    RecordType type = Telemetry;
+
+    /** @brief Vehicle state at the time of the record */
+    UASState::State state = UASState::Landed;
+
+    /** @brief Telemetry snapshot; the dirty mask holds the changed fields */
+    TelemetryFrame frame;
+};
+
+/**
+ * @brief Encodes the log header
+ * @param startTime Recording start in milliseconds since epoch
+ * @param out Destination of at least HEADER_SIZE bytes
+ */
+void encodeHeader(qint64 startTime, char* out);
+
+/**
+ * @brief Validates a log header
+ * @param data The start of the log
+ * @param size The log size in bytes
+ * @return True if the header is valid
+ */
+bool validateHeader(const uchar* data, qint64 size);
+
+/**
+ * @brief Encodes the index header
+ * @param out Destination of at least INDEX_HEADER_SIZE bytes
+ */
+void encodeIndexHeader(char* out);
+
+/**
+ * @brief Validates an index header
+ * @param data The start of the index
+ * @param size The index size in bytes
+ * @return True if the header is valid
+ */
+bool validateIndexHeader(const uchar* data, qint64 size);
+
+/**
+ * @brief Encodes one record
+ * @param record The record to encode
+ * @param out Destination of at least RECORD_SIZE bytes
+ */
+void encodeRecord(const Record& record, char* out);
+
+/**
+ * @brief Decodes one record in place
+ * @param in Source of at least RECORD_SIZE bytes
+ * @return The decoded record
+ */
+Record decodeRecord(const uchar* in);
+
+/**
+ * @brief Reads only the log time of an encoded record
+ * @param in Source of at least RECORD_SIZE bytes
+ * @return Milliseconds since the recording started
+ */
+inline qint64 recordTime(const uchar* in)
+{
+    return qFromLittleEndian<quint32>(in + 28);
+}
+
+} // namespace FlightLog
+
+#endif // FLIGHTLOG_HPP
@@ -0,0 +1,177 @@
+#include "FlightLogReader.hpp"
+#include <QDebug>
+
+/**
+ * @brief Constructs a reader with no log open
+ */
+FlightLogReader::FlightLogReader()
+    : m_records(nullptr)
+    , m_recordCount(0)
+    , m_index(nullptr)
+    , m_indexCount(0)
+    , m_startTime(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+FlightLogReader::~FlightLogReader()
+{
+    close();
+}
+
+/**
+ * @brief Maps a log and its index
+ * @param path The log file
+ * @return True if the log could be mapped and has a valid header
+ *
+ * A trailing partial record, as left by an interrupted recording, is
+ * ignored. A missing or invalid index is not an error; seeks then fall back
+ * to bisection.
+ */
+bool FlightLogReader::open(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open flight log" << path;
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    const uchar* data = size > 0 ? m_file.map(0, size) : nullptr;
+    if (!data || !FlightLog::validateHeader(data, size)) {
+        qWarning() << "Invalid flight log" << path;
+        close();
+        return false;
+    }
+
+    m_startTime = qFromLittleEndian<qint64>(data + 8);
+    m_records = data + FlightLog::HEADER_SIZE;
+    m_recordCount = (size - FlightLog::HEADER_SIZE) / FlightLog::RECORD_SIZE;
+
+    m_indexFile.setFileName(path + QStringLiteral(".idx"));
+    if (m_indexFile.open(QIODevice::ReadOnly)) {
+        const qint64 indexSize = m_indexFile.size();
+        const uchar* index = indexSize > 0 ? m_indexFile.map(0, indexSize) : nullptr;
+        if (index && FlightLog::validateIndexHeader(index, indexSize)) {
+            m_index = index + FlightLog::INDEX_HEADER_SIZE;
+            m_indexCount = (indexSize - FlightLog::INDEX_HEADER_SIZE) / FlightLog::INDEX_ENTRY_SIZE;
+        } else {
+            m_indexFile.close();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Unmaps the log
+ */
+void FlightLogReader::close()
+{
+    // Closing a QFile also unmaps it
+    m_file.close();
+    m_indexFile.close();
+    m_records = nullptr;
+    m_recordCount = 0;
+    m_index = nullptr;
+    m_indexCount = 0;
+    m_startTime = 0;
+}
+
+bool FlightLogReader::isOpen() const
+{
+    return m_records != nullptr;
+}
+
+bool FlightLogReader::hasIndex() const
+{
+    return m_indexCount > 0;
+}
+
+qint64 FlightLogReader::startTime() const
+{
+    return m_startTime;
+}
+
+qint64 FlightLogReader::recordCount() const
+{
+    return m_recordCount;
+}
+
+FlightLog::Record FlightLogReader::record(qint64 index) const
+{
+    Q_ASSERT(index >= 0 && index < m_recordCount);
+    return FlightLog::decodeRecord(m_records + index * FlightLog::RECORD_SIZE);
+}
+
+qint64 FlightLogReader::time(qint64 index) const
+{
+    Q_ASSERT(index >= 0 && index < m_recordCount);
+    return FlightLog::recordTime(m_records + index * FlightLog::RECORD_SIZE);
+}
+
+qint64 FlightLogReader::firstTime() const
+{
+    return m_recordCount > 0 ? time(0) : 0;
+}
+
+qint64 FlightLogReader::lastTime() const
+{
+    return m_recordCount > 0 ? time(m_recordCount - 1) : 0;
+}
+
+/**
+ * @brief Finds the first record at or after a point in log time
+ * @param time Log time in milliseconds
+ * @return The record number, or recordCount() if all records are earlier
+ *
+ * The index entry closest before the requested time is found by bisection,
+ * then the records after it are scanned. Entries pointing past the mapped
+ * records, which happens while the log is still being written, are ignored.
+ */
+qint64 FlightLogReader::seek(qint64 time) const
+{
+    qint64 first = 0;
+    qint64 last = m_recordCount;
+
+    if (m_indexCount > 0) {
+        // Last index entry with a log time at or before the requested time
+        qint64 low = 0;
+        qint64 high = m_indexCount;
+        while (low < high) {
+            const qint64 middle = low + (high - low) / 2;
+            if (qFromLittleEndian<qint64>(m_index + middle * FlightLog::INDEX_ENTRY_SIZE) <= time) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low > 0) {
+            const quint64 record = qFromLittleEndian<quint64>(m_index + (low - 1) * FlightLog::INDEX_ENTRY_SIZE + 8);
+            first = qMin<qint64>(static_cast<qint64>(record), m_recordCount);
+        }
+
+        for (qint64 i = first; i < m_recordCount; ++i) {
+            if (this->time(i) >= time) {
+                return i;
+            }
+        }
+        return m_recordCount;
+    }
+
+    // No index: bisect the records directly
+    while (first < last) {
+        const qint64 middle = first + (last - first) / 2;
+        if (this->time(middle) < time) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
@@ -0,0 +1,128 @@
+#ifndef FLIGHTLOGREADER_HPP
+#define FLIGHTLOGREADER_HPP
+
+#include <QFile>
+#include <QString>
+#include "FlightLog.hpp"
+
+/**
+ * @class FlightLogReader
+ * @brief Random access to a recorded flight log
+ *
+ * The log and its index are memory-mapped rather than read, so opening a
+ * log of any length is immediate and only the pages actually visited are
+ * loaded. Records are decoded in place on access.
+ *
+ * Positions in the log are given in log time, the recorder's clock rather
+ * than the timestamps of the sources. seek() looks up the time index and
+ * then scans at most one index interval of records. Logs without a usable
+ * index are searched by bisection over the record log times instead.
+ */
+class FlightLogReader
+{
+public:
+    /**
+     * @brief Constructs a reader with no log open
+     */
+    FlightLogReader();
+
+    /**
+     * @brief Destructor
+     */
+    ~FlightLogReader();
+
+    /**
+     * @brief Maps a log and its index
+     * @param path The log file
+     * @return True if the log could be mapped and has a valid header
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Unmaps the log
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a log is open
+     * @return True if a log is mapped
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Checks whether the log has a usable time index
+     * @return True if seeks use the index
+     */
+    bool hasIndex() const;
+
+    /**
+     * @brief Gets the time the recording started
+     * @return Milliseconds since epoch
+     */
+    qint64 startTime() const;
+
+    /**
+     * @brief Gets the number of complete records
+     * @return The record count
+     */
+    qint64 recordCount() const;
+
+    /**
+     * @brief Decodes a record
+     * @param index The record number, 0 to recordCount() - 1
+     * @return The record
+     */
+    FlightLog::Record record(qint64 index) const;
+
+    /**
+     * @brief Reads only the log time of a record
+     * @param index The record number, 0 to recordCount() - 1
+     * @return Milliseconds since the recording started
+     */
+    qint64 time(qint64 index) const;
+
+    /**
+     * @brief Gets the log time of the first record
+     * @return The log time, or 0 for an empty log
+     */
+    qint64 firstTime() const;
+
+    /**
+     * @brief Gets the log time of the last record
+     * @return The log time, or 0 for an empty log
+     */
+    qint64 lastTime() const;
+
+    /**
+     * @brief Finds the first record at or after a point in log time
+     * @param time Log time in milliseconds
+     * @return The record number, or recordCount() if all records are earlier
+     */
+    qint64 seek(qint64 time) const;
+
+private:
+    Q_DISABLE_COPY(FlightLogReader)
+
+    /** @brief The log file */
+    QFile m_file;
+
+    /** @brief The index file */
+    QFile m_indexFile;
+
+    /** @brief Start of the mapped records */
+    const uchar* m_records;
+
+    /** @brief Number of complete records */
+    qint64 m_recordCount;
+
+    /** @brief Start of the mapped index entries, or nullptr */
+    const uchar* m_index;
+
+    /** @brief Number of index entries */
+    qint64 m_indexCount;
+
+    /** @brief Recording start in milliseconds since epoch */
+    qint64 m_startTime;
+};
+
+#endif // FLIGHTLOGREADER_HPP
@@ -0,0 +1,320 @@
+#include "FlightRecorder.hpp"
+#include "TelemetryData.hpp"
+#include <QDateTime>
+#include <QFile>
+#include <QThread>
+#include <QTimer>
+#include <limits>
+
+/**
+ * @brief Constructs an idle recorder
+ * @param parent The parent QObject
+ */
+FlightRecorder::FlightRecorder(QObject* parent)
+    : QObject(parent)
+    , m_writerThread(new QThread(this))
+    , m_writerContext(new QObject)
+    , m_file(nullptr)
+    , m_indexFile(nullptr)
+    , m_flushTimer(new QTimer(this))
+    , m_pendingCount(0)
+    , m_lastTime(0)
+    , m_recordCount(0)
+    , m_nextIndexTime(std::numeric_limits<qint64>::min())
+    , m_recordsWritten(0)
+{
+    m_writerContext->moveToThread(m_writerThread);
+
+    m_flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(m_flushTimer, &QTimer::timeout, this, &FlightRecorder::flush);
+}
+
+/**
+ * @brief Destructor
+ */
+FlightRecorder::~FlightRecorder()
+{
+    for (const Source& source : std::as_const(m_sources)) {
+        disconnect(source.frameConnection);
+        disconnect(source.stateConnection);
+        disconnect(source.destroyedConnection);
+    }
+
+    close();
+    delete m_writerContext;
+}
+
+/**
+ * @brief Creates a new log and starts recording
+ * @param path The log file; its index is written next to it
+ * @return True if both files could be created
+ *
+ * Existing files are truncated. The files are created on the writer thread;
+ * this call blocks until that has finished.
+ */
+bool FlightRecorder::open(const QString& path)
+{
+    close();
+
+    m_writerThread->start();
+
+    bool opened = false;
+    QMetaObject::invokeMethod(m_writerContext, [this, path, &opened]() {
+        m_file = new QFile(path, m_writerContext);
+        m_indexFile = new QFile(path + QStringLiteral(".idx"), m_writerContext);
+
+        if (!m_file->open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            !m_indexFile->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Cannot create flight log" << path;
+            delete m_file;
+            delete m_indexFile;
+            m_file = nullptr;
+            m_indexFile = nullptr;
+            return;
+        }
+
+        char header[FlightLog::HEADER_SIZE];
+        FlightLog::encodeHeader(QDateTime::currentMSecsSinceEpoch(), header);
+        m_file->write(header, sizeof(header));
+
+        char indexHeader[FlightLog::INDEX_HEADER_SIZE];
+        FlightLog::encodeIndexHeader(indexHeader);
+        m_indexFile->write(indexHeader, sizeof(indexHeader));
+
+        m_recordCount = 0;
+        m_nextIndexTime = std::numeric_limits<qint64>::min();
+        opened = true;
+    }, Qt::BlockingQueuedConnection);
+
+    if (!opened) {
+        m_writerThread->quit();
+        m_writerThread->wait();
+        return false;
+    }
+
+    m_path = path;
+    m_recordsWritten = 0;
+    m_pending = QByteArray(BATCH_SIZE * FlightLog::RECORD_SIZE, Qt::Uninitialized);
+    m_pendingCount = 0;
+    m_lastTime = 0;
+    m_clock.start();
+    m_flushTimer->start();
+
+    emit recordingChanged(true);
+    return true;
+}
+
+/**
+ * @brief Writes all pending records and closes the log
+ *
+ * Blocks until the writer thread has written everything and finished.
+ */
+void FlightRecorder::close()
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    m_flushTimer->stop();
+    flush();
+
+    QMetaObject::invokeMethod(m_writerContext, [this]() {
+        delete m_file;
+        delete m_indexFile;
+        m_file = nullptr;
+        m_indexFile = nullptr;
+    }, Qt::BlockingQueuedConnection);
+
+    m_writerThread->quit();
+    m_writerThread->wait();
+
+    m_path.clear();
+    m_pending = QByteArray();
+    m_clock.invalidate();
+
+    emit recordingChanged(false);
+}
+
+bool FlightRecorder::isRecording() const
+{
+    return !m_path.isEmpty();
+}
+
+QString FlightRecorder::path() const
+{
+    return m_path;
+}
+
+/**
+ * @brief Records all frames and state changes of a telemetry source
+ * @param source The source to record
+ * @param vehicleId The vehicle id stored with its records
+ *
+ * State change records carry the source's last published frame, so their
+ * timestamps are in the vehicle's time like those of its frames.
+ */
+void FlightRecorder::attach(TelemetryData* source, quint16 vehicleId)
+{
+    detach(source);
+
+    Source entry;
+    entry.data = source;
+    entry.frameConnection = connect(source, &TelemetryData::frameChanged, this,
+        [this, source, vehicleId](const TelemetryFrame& frame) {
+            recordFrame(vehicleId, frame, source->state());
+        });
+    entry.stateConnection = connect(source, &TelemetryData::stateChanged, this,
+        [this, source, vehicleId](UASState::State state) {
+            recordStateChange(vehicleId, source->frame(), state);
+        });
+    entry.destroyedConnection = connect(source, &QObject::destroyed, this,
+        [this, source]() {
+            detach(source);
+        });
+    m_sources.append(entry);
+}
+
+/**
+ * @brief Stops recording a telemetry source
+ * @param source The source to detach
+ */
+void FlightRecorder::detach(TelemetryData* source)
+{
+    m_sources.removeIf([this, source](const Source& entry) {
+        if (entry.data != source) {
+            return false;
+        }
+        disconnect(entry.frameConnection);
+        disconnect(entry.stateConnection);
+        disconnect(entry.destroyedConnection);
+        return true;
+    });
+}
+
+void FlightRecorder::recordFrame(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state)
+{
+    recordFrame(vehicleId, frame, state, elapsed());
+}
+
+void FlightRecorder::recordFrame(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state, qint64 time)
+{
+    FlightLog::Record record;
+    record.time = time;
+    record.vehicleId = vehicleId;
+    record.type = FlightLog::Telemetry;
+    record.state = state;
+    record.frame = frame;
+    append(record);
+}
+
+void FlightRecorder::recordStateChange(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state)
+{
+    recordStateChange(vehicleId, frame, state, elapsed());
+}
+
+void FlightRecorder::recordStateChange(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state, qint64 time)
+{
+    FlightLog::Record record;
+    record.time = time;
+    record.vehicleId = vehicleId;
+    record.type = FlightLog::StateChange;
+    record.state = state;
+    record.frame = frame;
+    record.frame.dirty = TelemetryFrame::NoFields;
+    append(record);
+}
+
+/**
+ * @brief Hands all pending records to the writer thread
+ *
+ * The filled batch is moved to the writer and a fresh one is allocated, so
+ * recording continues while the previous batch is written.
+ */
+void FlightRecorder::flush()
+{
+    if (m_pendingCount == 0) {
+        return;
+    }
+
+    QByteArray batch = std::move(m_pending);
+    batch.truncate(m_pendingCount * FlightLog::RECORD_SIZE);
+    m_pending = QByteArray(BATCH_SIZE * FlightLog::RECORD_SIZE, Qt::Uninitialized);
+    m_pendingCount = 0;
+
+    QMetaObject::invokeMethod(m_writerContext, [this, batch]() {
+        writeBatch(batch);
+    }, Qt::QueuedConnection);
+}
+
+quint64 FlightRecorder::recordsWritten() const
+{
+    return m_recordsWritten.load(std::memory_order_relaxed);
+}
+
+qint64 FlightRecorder::elapsed() const
+{
+    return m_clock.isValid() ? m_clock.elapsed() : 0;
+}
+
+/**
+ * @brief Appends a record to the pending batch
+ * @param record The record
+ *
+ * Records arriving while no log is open are dropped. The log time is kept
+ * from decreasing, so a record given an earlier log time than the previous
+ * one is stored at the previous log time; the frame is stored unchanged.
+ */
+void FlightRecorder::append(FlightLog::Record record)
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    record.time = qMax(record.time, m_lastTime);
+    m_lastTime = record.time;
+    FlightLog::encodeRecord(record, m_pending.data() + m_pendingCount * FlightLog::RECORD_SIZE);
+    if (++m_pendingCount == BATCH_SIZE) {
+        flush();
+    }
+}
+
+/**
+ * @brief Writes a batch and its index entries (writer thread)
+ * @param batch Encoded records
+ *
+ * An index entry is added for the first record at or after each
+ * INDEX_INTERVAL of log time, so a seek never scans more than one interval
+ * of records. The log is written before the index, so the index never
+ * points past the end of the log.
+ */
+void FlightRecorder::writeBatch(const QByteArray& batch)
+{
+    if (!m_file) {
+        return;
+    }
+
+    m_file->write(batch);
+    m_file->flush();
+
+    char entries[FlightRecorder::BATCH_SIZE * FlightLog::INDEX_ENTRY_SIZE];
+    int entryCount = 0;
+
+    const int count = batch.size() / FlightLog::RECORD_SIZE;
+    const uchar* records = reinterpret_cast<const uchar*>(batch.constData());
+    for (int i = 0; i < count; ++i, ++m_recordCount) {
+        const qint64 time = FlightLog::recordTime(records + i * FlightLog::RECORD_SIZE);
+        if (time >= m_nextIndexTime) {
+            char* entry = entries + entryCount++ * FlightLog::INDEX_ENTRY_SIZE;
+            qToLittleEndian<qint64>(time, entry);
+            qToLittleEndian<quint64>(m_recordCount, entry + 8);
+            m_nextIndexTime = time + FlightLog::INDEX_INTERVAL;
+        }
+    }
+
+    if (entryCount > 0) {
+        m_indexFile->write(entries, entryCount * FlightLog::INDEX_ENTRY_SIZE);
+        m_indexFile->flush();
+    }
+
+    m_recordsWritten.fetch_add(count, std::memory_order_relaxed);
+}
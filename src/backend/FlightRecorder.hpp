@@ -0,0 +1,227 @@
+#ifndef FLIGHTRECORDER_HPP
+#define FLIGHTRECORDER_HPP
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include "FlightLog.hpp"
+
+class QFile;
+class QThread;
+class QTimer;
+class TelemetryData;
+
+/**
+ * @class FlightRecorder
+ * @brief Records telemetry frames and state transitions into a flight log
+ *
+ * Attached TelemetryData sources are recorded on every published frame and
+ * every state change. Records are encoded into a batch on the calling
+ * thread and handed to a writer thread once the batch is full or the flush
+ * interval has passed, so the GUI thread never touches the disk. The writer
+ * also maintains the time index used by FlightLogReader to seek.
+ *
+ * Frames are stored with the timestamps their sources stamped, which may
+ * use different time bases, e.g. simulated time from 0 and milliseconds
+ * since epoch. Every record is additionally stamped with the log time, the
+ * milliseconds since open() on the recorder's monotonic clock, which the
+ * index and seeks use.
+ *
+ * See FlightLog for the file format.
+ */
+class FlightRecorder : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool recording READ isRecording NOTIFY recordingChanged)
+
+public:
+    /** @brief Number of records per batch handed to the writer thread */
+    static constexpr int BATCH_SIZE = 1024;
+
+    /** @brief Maximum time a record waits before its batch is written, in ms */
+    static constexpr int FLUSH_INTERVAL = 250;
+
+    /**
+     * @brief Constructs an idle recorder
+     * @param parent The parent QObject
+     */
+    explicit FlightRecorder(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Closes the log, writing all pending records.
+     */
+    virtual ~FlightRecorder();
+
+    /**
+     * @brief Creates a new log and starts recording
+     * @param path The log file; its index is written next to it
+     * @return True if both files could be created
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Writes all pending records and closes the log
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a log is open
+     * @return True while recording
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief Gets the path of the open log
+     * @return The log file path, or an empty string if not recording
+     */
+    QString path() const;
+
+    /**
+     * @brief Records all frames and state changes of a telemetry source
+     * @param source The source to record
+     * @param vehicleId The vehicle id stored with its records
+     *
+     * Sources stay attached across open() and close() until they are
+     * detached or destroyed.
+     */
+    void attach(TelemetryData* source, quint16 vehicleId);
+
+    /**
+     * @brief Stops recording a telemetry source
+     * @param source The source to detach
+     */
+    void detach(TelemetryData* source);
+
+    /**
+     * @brief Records a telemetry frame at the current log time
+     * @param vehicleId The vehicle the frame belongs to
+     * @param frame The frame; its dirty mask is stored as the changed fields
+     * @param state The vehicle state at the time of the frame
+     */
+    void recordFrame(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state);
+
+    /**
+     * @brief Records a telemetry frame at a given log time
+     * @param vehicleId The vehicle the frame belongs to
+     * @param frame The frame; its dirty mask is stored as the changed fields
+     * @param state The vehicle state at the time of the frame
+     * @param time Milliseconds since open(), e.g. when converting a log
+     */
+    void recordFrame(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state, qint64 time);
+
+    /**
+     * @brief Records a state transition at the current log time
+     * @param vehicleId The vehicle that changed state
+     * @param frame The vehicle's telemetry at the time of the transition
+     * @param state The new state
+     */
+    void recordStateChange(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state);
+
+    /**
+     * @brief Records a state transition at a given log time
+     * @param vehicleId The vehicle that changed state
+     * @param frame The vehicle's telemetry at the time of the transition
+     * @param state The new state
+     * @param time Milliseconds since open(), e.g. when converting a log
+     */
+    void recordStateChange(quint16 vehicleId, const TelemetryFrame& frame, UASState::State state, qint64 time);
+
+    /**
+     * @brief Gets the current log time
+     * @return Milliseconds since open(), or 0 while not recording
+     */
+    qint64 elapsed() const;
+
+    /**
+     * @brief Hands all pending records to the writer thread
+     */
+    void flush();
+
+    /**
+     * @brief Gets the number of records written to disk
+     * @return The record count of the open or last log
+     */
+    quint64 recordsWritten() const;
+
+signals:
+    /**
+     * @brief Emitted when recording starts or stops
+     * @param recording True if a log is open
+     */
+    void recordingChanged(bool recording);
+
+private:
+    /**
+     * @struct Source
+     * @brief An attached telemetry source and its connections
+     */
+    struct Source
+    {
+        TelemetryData* data;
+        QMetaObject::Connection frameConnection;
+        QMetaObject::Connection stateConnection;
+        QMetaObject::Connection destroyedConnection;
+    };
+
+    /**
+     * @brief Appends a record to the pending batch
+     * @param record The record
+     */
+    void append(FlightLog::Record record);
+
+    /**
+     * @brief Writes a batch and its index entries (writer thread)
+     * @param batch Encoded records
+     */
+    void writeBatch(const QByteArray& batch);
+
+    /** @brief Thread writing to disk */
+    QThread* m_writerThread;
+
+    /** @brief Context object living on the writer thread */
+    QObject* m_writerContext;
+
+    /** @brief The log file, owned by the writer thread */
+    QFile* m_file;
+
+    /** @brief The index file, owned by the writer thread */
+    QFile* m_indexFile;
+
+    /** @brief Timer handing partial batches to the writer */
+    QTimer* m_flushTimer;
+
+    /** @brief Path of the open log */
+    QString m_path;
+
+    /** @brief Batch being filled, preallocated to BATCH_SIZE records */
+    QByteArray m_pending;
+
+    /** @brief Number of records in m_pending */
+    int m_pendingCount;
+
+    /** @brief Monotonic clock of the log time, started by open() */
+    QElapsedTimer m_clock;
+
+    /** @brief Log time of the latest appended record, the lower bound of the next one */
+    qint64 m_lastTime;
+
+    /** @brief Attached sources */
+    QVector<Source> m_sources;
+
+    /** @brief Number of records written to the log (writer thread) */
+    quint64 m_recordCount;
+
+    /** @brief Log time at which the next index entry is due (writer thread) */
+    qint64 m_nextIndexTime;
+
+    /** @brief Number of records written, readable from any thread */
+    std::atomic<quint64> m_recordsWritten;
+};
+
+#endif // FLIGHTRECORDER_HPP
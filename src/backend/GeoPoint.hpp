@@ -0,0 +1,161 @@
+#ifndef GEOPOINT_HPP
+#define GEOPOINT_HPP
+
+#include <QtGlobal>
+#include <QtMath>
+#include <QGeoCoordinate>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @struct GeoPoint
+ * @brief A plain latitude/longitude/altitude value for simulation and ingest math
+ *
+ * QGeoCoordinate is an implicitly shared type that allocates its private
+ * data on construction. GeoPoint is trivially copyable and lives entirely on
+ * the stack or inside the owning object, so positions can be updated on
+ * every tick without any heap traffic. Convert to QGeoCoordinate only where
+ * a position is handed to QML.
+ *
+ * distanceTo(), azimuthTo() and atDistanceAndAzimuth() use the same
+ * formulas and earth radius as QGeoCoordinate, so results match it to
+ * rounding. For many points at once see the Geodesy batch kernels.
+ */
+struct GeoPoint
+{
+    /** @brief Mean earth radius in meters, as used by QGeoCoordinate */
+    static constexpr double EARTH_MEAN_RADIUS = 6371007.2;
+
+    /** @brief Latitude in degrees, NaN if unset */
+    double latitude = std::numeric_limits<double>::quiet_NaN();
+
+    /** @brief Longitude in degrees, NaN if unset */
+    double longitude = std::numeric_limits<double>::quiet_NaN();
+
+    /** @brief Altitude in meters, NaN if unknown */
+    double altitude = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * @brief Constructs an invalid point
+     */
+    GeoPoint() = default;
+
+    /**
+     * @brief Constructs a point
+     * @param lat Latitude in degrees
+     * @param lon Longitude in degrees
+     * @param alt Altitude in meters
+     */
+    GeoPoint(double lat, double lon, double alt = std::numeric_limits<double>::quiet_NaN())
+        : latitude(lat)
+        , longitude(lon)
+        , altitude(alt)
+    {
+    }
+
+    /**
+     * @brief Converts a QGeoCoordinate
+     * @param coordinate The coordinate
+     * @return The point
+     */
+    static GeoPoint fromCoordinate(const QGeoCoordinate& coordinate)
+    {
+        return GeoPoint(coordinate.latitude(), coordinate.longitude(), coordinate.altitude());
+    }
+
+    /**
+     * @brief Converts to a QGeoCoordinate, for the QML boundary
+     * @return The coordinate; its altitude is only set if known
+     */
+    QGeoCoordinate toCoordinate() const
+    {
+        return std::isnan(altitude) ? QGeoCoordinate(latitude, longitude)
+                                    : QGeoCoordinate(latitude, longitude, altitude);
+    }
+
+    /**
+     * @brief Checks whether latitude and longitude are set and in range
+     * @return True if the point is valid
+     */
+    bool isValid() const
+    {
+        return latitude >= -90.0 && latitude <= 90.0 && longitude >= -180.0 && longitude <= 180.0;
+    }
+
+    /**
+     * @brief Gets the great circle distance to another point (haversine)
+     * @param other The other point
+     * @return Distance in meters
+     */
+    double distanceTo(const GeoPoint& other) const
+    {
+        const double dlat = qDegreesToRadians(other.latitude - latitude);
+        const double dlon = qDegreesToRadians(other.longitude - longitude);
+        double haversineDlat = std::sin(dlat / 2.0);
+        haversineDlat *= haversineDlat;
+        double haversineDlon = std::sin(dlon / 2.0);
+        haversineDlon *= haversineDlon;
+        const double y = haversineDlat
+                         + std::cos(qDegreesToRadians(latitude))
+                               * std::cos(qDegreesToRadians(other.latitude))
+                               * haversineDlon;
+        return 2.0 * std::asin(std::sqrt(y)) * EARTH_MEAN_RADIUS;
+    }
+
+    /**
+     * @brief Gets the initial bearing towards another point
+     * @param other The other point
+     * @return Bearing in degrees clockwise from north, in [0, 360)
+     */
+    double azimuthTo(const GeoPoint& other) const
+    {
+        const double dlon = qDegreesToRadians(other.longitude - longitude);
+        const double lat1 = qDegreesToRadians(latitude);
+        const double lat2 = qDegreesToRadians(other.latitude);
+
+        const double y = std::sin(dlon) * std::cos(lat2);
+        const double x = std::cos(lat1) * std::sin(lat2) - std::sin(lat1) * std::cos(lat2) * std::cos(dlon);
+
+        const double azimuth = qRadiansToDegrees(std::atan2(y, x)) + 360.0;
+        double whole;
+        const double fraction = std::modf(azimuth, &whole);
+        return (static_cast<int>(whole + 360.0) % 360) + fraction;
+    }
+
+    /**
+     * @brief Gets the point reached by travelling along a great circle
+     * @param distance Distance to travel in meters
+     * @param azimuth Initial bearing in degrees clockwise from north
+     * @return The point reached, with the same altitude
+     */
+    GeoPoint atDistanceAndAzimuth(double distance, double azimuth) const
+    {
+        const double lat1 = qDegreesToRadians(latitude);
+        const double lon1 = qDegreesToRadians(longitude);
+        const double bearing = qDegreesToRadians(azimuth);
+        const double ratio = distance / EARTH_MEAN_RADIUS;
+
+        const double sinLat1 = std::sin(lat1);
+        const double cosLat1 = std::cos(lat1);
+        const double sinRatio = std::sin(ratio);
+        const double cosRatio = std::cos(ratio);
+
+        const double lat2 = std::asin(sinLat1 * cosRatio + cosLat1 * sinRatio * std::cos(bearing));
+        const double lon2 = lon1 + std::atan2(std::sin(bearing) * sinRatio * cosLat1,
+                                              cosRatio - sinLat1 * std::sin(lat2));
+
+        double resultLongitude = qRadiansToDegrees(lon2);
+        if (resultLongitude > 180.0) {
+            resultLongitude -= 360.0;
+        } else if (resultLongitude < -180.0) {
+            resultLongitude += 360.0;
+        }
+
+        return GeoPoint(qRadiansToDegrees(lat2), resultLongitude, altitude);
+    }
+};
+
+static_assert(std::is_trivially_copyable<GeoPoint>::value, "GeoPoint must stay trivially copyable");
+
+#endif // GEOPOINT_HPP
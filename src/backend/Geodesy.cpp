@@ -0,0 +1,137 @@
+#include "Geodesy.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double RADIANS_PER_DEGREE = M_PI / 180.0;
+    constexpr double DEGREES_PER_RADIAN = 180.0 / M_PI;
+
+    /**
+     * @brief Number of elements processed per block
+     *
+     * Cosines are computed in a separate pass over each block. Computing the
+     * sine and cosine of the same angle in one loop lets the compiler fuse
+     * them into a sincos() call, which has no vector variant and stops the
+     * loop from being vectorized.
+     */
+    constexpr int BLOCK_SIZE = 128;
+}
+
+namespace Geodesy
+{
+
+/**
+ * @brief Computes great circle distances between pairs of points (haversine)
+ *
+ * Same formula as QGeoCoordinate::distanceTo().
+ */
+void distance(const double* __restrict lat1, const double* __restrict lon1,
+              const double* __restrict lat2, const double* __restrict lon2,
+              double* __restrict meters, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const double phi1 = lat1[i] * RADIANS_PER_DEGREE;
+        const double phi2 = lat2[i] * RADIANS_PER_DEGREE;
+        const double sinDlat = std::sin((phi2 - phi1) * 0.5);
+        const double sinDlon = std::sin((lon2[i] - lon1[i]) * RADIANS_PER_DEGREE * 0.5);
+        const double y = sinDlat * sinDlat + std::cos(phi1) * std::cos(phi2) * sinDlon * sinDlon;
+        meters[i] = 2.0 * EARTH_MEAN_RADIUS * std::asin(std::sqrt(y));
+    }
+}
+
+/**
+ * @brief Computes initial bearings between pairs of points
+ *
+ * Same formula as QGeoCoordinate::azimuthTo(). The result is normalized
+ * with selects instead of fmod so the loop stays branch-free.
+ */
+void bearing(const double* __restrict lat1, const double* __restrict lon1,
+             const double* __restrict lat2, const double* __restrict lon2,
+             double* __restrict degrees, int count)
+{
+    double cosPhi1[BLOCK_SIZE];
+    double cosPhi2[BLOCK_SIZE];
+    double cosDlon[BLOCK_SIZE];
+
+    for (int begin = 0; begin < count; begin += BLOCK_SIZE) {
+        const int size = std::min(BLOCK_SIZE, count - begin);
+        const double* blockLat1 = lat1 + begin;
+        const double* blockLon1 = lon1 + begin;
+        const double* blockLat2 = lat2 + begin;
+        const double* blockLon2 = lon2 + begin;
+        double* blockDegrees = degrees + begin;
+
+        for (int i = 0; i < size; ++i) {
+            cosPhi1[i] = std::cos(blockLat1[i] * RADIANS_PER_DEGREE);
+            cosPhi2[i] = std::cos(blockLat2[i] * RADIANS_PER_DEGREE);
+            cosDlon[i] = std::cos((blockLon2[i] - blockLon1[i]) * RADIANS_PER_DEGREE);
+        }
+
+        for (int i = 0; i < size; ++i) {
+            const double sinPhi1 = std::sin(blockLat1[i] * RADIANS_PER_DEGREE);
+            const double sinPhi2 = std::sin(blockLat2[i] * RADIANS_PER_DEGREE);
+            const double sinDlon = std::sin((blockLon2[i] - blockLon1[i]) * RADIANS_PER_DEGREE);
+
+            const double y = sinDlon * cosPhi2[i];
+            const double x = cosPhi1[i] * sinPhi2 - sinPhi1 * cosPhi2[i] * cosDlon[i];
+
+            double result = std::atan2(y, x) * DEGREES_PER_RADIAN;
+            result = result < 0.0 ? result + 360.0 : result;
+            blockDegrees[i] = result >= 360.0 ? result - 360.0 : result;
+        }
+    }
+}
+
+/**
+ * @brief Computes the points reached from start points along great circles
+ *
+ * Same formula as QGeoCoordinate::atDistanceAndAzimuth(). Each block is
+ * read completely before it is written, so the output may be the input.
+ */
+void destination(const double* lat, const double* lon,
+                 const double* bearing, const double* meters,
+                 double* outLat, double* outLon, int count)
+{
+    double cosPhi[BLOCK_SIZE];
+    double cosDelta[BLOCK_SIZE];
+    double cosTheta[BLOCK_SIZE];
+    double resultLat[BLOCK_SIZE];
+    double resultLon[BLOCK_SIZE];
+
+    for (int begin = 0; begin < count; begin += BLOCK_SIZE) {
+        const int size = std::min(BLOCK_SIZE, count - begin);
+        const double* __restrict blockLat = lat + begin;
+        const double* __restrict blockLon = lon + begin;
+        const double* __restrict blockBearing = bearing + begin;
+        const double* __restrict blockMeters = meters + begin;
+
+        for (int i = 0; i < size; ++i) {
+            cosPhi[i] = std::cos(blockLat[i] * RADIANS_PER_DEGREE);
+            cosDelta[i] = std::cos(blockMeters[i] / EARTH_MEAN_RADIUS);
+            cosTheta[i] = std::cos(blockBearing[i] * RADIANS_PER_DEGREE);
+        }
+
+        for (int i = 0; i < size; ++i) {
+            const double sinPhi = std::sin(blockLat[i] * RADIANS_PER_DEGREE);
+            const double sinDelta = std::sin(blockMeters[i] / EARTH_MEAN_RADIUS);
+            const double sinTheta = std::sin(blockBearing[i] * RADIANS_PER_DEGREE);
+
+            const double sinPhi2 = sinPhi * cosDelta[i] + cosPhi[i] * sinDelta * cosTheta[i];
+            const double lambda2 = blockLon[i] * RADIANS_PER_DEGREE
+                                   + std::atan2(sinTheta * sinDelta * cosPhi[i], cosDelta[i] - sinPhi * sinPhi2);
+
+            double longitude = lambda2 * DEGREES_PER_RADIAN;
+            longitude = longitude > 180.0 ? longitude - 360.0 : longitude;
+            longitude = longitude < -180.0 ? longitude + 360.0 : longitude;
+
+            resultLat[i] = std::asin(sinPhi2) * DEGREES_PER_RADIAN;
+            resultLon[i] = longitude;
+        }
+
+        std::copy(resultLat, resultLat + size, outLat + begin);
+        std::copy(resultLon, resultLon + size, outLon + begin);
+    }
+}
+
+}
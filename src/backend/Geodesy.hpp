@@ -0,0 +1,76 @@
+#ifndef GEODESY_HPP
+#define GEODESY_HPP
+
+/**
+ * @namespace Geodesy
+ * @brief Batch great circle kernels over arrays of positions
+ *
+ * Each kernel processes structure-of-arrays input (separate latitude and
+ * longitude arrays, in degrees) in one branch-free loop that the compiler
+ * turns into SIMD code. Geodesy.cpp is compiled with relaxed floating point
+ * rules so that the trigonometric calls are vectorized as well (libmvec on
+ * glibc, SVML with MSVC).
+ *
+ * The formulas and earth radius are those of QGeoCoordinate. Because of
+ * the relaxed floating point rules, results differ from QGeoCoordinate by at
+ * most DISTANCE_TOLERANCE meters and ANGLE_TOLERANCE degrees for points
+ * that are not antipodal.
+ *
+ * The outputs of distance() and bearing() must not overlap their inputs,
+ * which lets the compiler keep the loops vectorized. Only destination()
+ * accepts outputs identical to its inputs, e.g. to update positions in
+ * place.
+ */
+namespace Geodesy
+{
+    /** @brief Mean earth radius in meters, as used by QGeoCoordinate */
+    constexpr double EARTH_MEAN_RADIUS = 6371007.2;
+
+    /** @brief Maximum deviation of distances from QGeoCoordinate, in meters */
+    constexpr double DISTANCE_TOLERANCE = 1e-3;
+
+    /** @brief Maximum deviation of bearings and coordinates from QGeoCoordinate, in degrees */
+    constexpr double ANGLE_TOLERANCE = 1e-7;
+
+    /**
+     * @brief Computes great circle distances between pairs of points (haversine)
+     * @param lat1 Latitudes of the start points
+     * @param lon1 Longitudes of the start points
+     * @param lat2 Latitudes of the end points
+     * @param lon2 Longitudes of the end points
+     * @param meters Receives the distances in meters, not overlapping the inputs
+     * @param count Number of pairs
+     */
+    void distance(const double* lat1, const double* lon1,
+                  const double* lat2, const double* lon2,
+                  double* meters, int count);
+
+    /**
+     * @brief Computes initial bearings between pairs of points
+     * @param lat1 Latitudes of the start points
+     * @param lon1 Longitudes of the start points
+     * @param lat2 Latitudes of the end points
+     * @param lon2 Longitudes of the end points
+     * @param degrees Receives the bearings in degrees clockwise from north, in [0, 360), not overlapping the inputs
+     * @param count Number of pairs
+     */
+    void bearing(const double* lat1, const double* lon1,
+                 const double* lat2, const double* lon2,
+                 double* degrees, int count);
+
+    /**
+     * @brief Computes the points reached from start points along great circles
+     * @param lat Latitudes of the start points
+     * @param lon Longitudes of the start points
+     * @param bearing Initial bearings in degrees clockwise from north
+     * @param meters Distances to travel in meters
+     * @param outLat Receives the latitudes reached, may be lat
+     * @param outLon Receives the longitudes reached, wrapped to [-180, 180], may be lon
+     * @param count Number of points
+     */
+    void destination(const double* lat, const double* lon,
+                     const double* bearing, const double* meters,
+                     double* outLat, double* outLon, int count);
+}
+
+#endif // GEODESY_HPP
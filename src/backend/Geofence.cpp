@@ -0,0 +1,597 @@
+#include "Geofence.hpp"
+#include <QFile>
+#include <QStringList>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/** @brief Slack in cell units that keeps rounding from dropping an edge touching a cell */
+constexpr double CELL_EPSILON = 1e-9;
+
+/**
+ * @brief Gets on which side of the line through a and b a point lies
+ * @return Positive left of the line, negative right of it, zero on it
+ */
+inline double orientation(double ax, double ay, double bx, double by, double px, double py)
+{
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+/**
+ * @brief Checks whether segment pq crosses segment ab
+ *
+ * A point on a line counts as lying left of it. Both edges meeting at a
+ * polygon corner classify the corner alike, so a segment through the
+ * corner crosses one of them or, if it only touches the polygon there,
+ * both or none, and the crossing parity stays right.
+ */
+inline bool crosses(double px, double py, double qx, double qy, double ax, double ay, double bx, double by)
+{
+    if ((orientation(px, py, qx, qy, ax, ay) >= 0.0) == (orientation(px, py, qx, qy, bx, by) >= 0.0)) {
+        return false;
+    }
+    return (orientation(ax, ay, bx, by, px, py) >= 0.0) != (orientation(ax, ay, bx, by, qx, qy) >= 0.0);
+}
+
+/**
+ * @struct IndexItem
+ * @brief A zone edge crossing a cell, or a zone containing a cell center, while building the index
+ */
+struct IndexItem
+{
+    qint32 cell;
+    qint32 zone;
+    qint32 edge; ///< -1 if the zone contains the cell center
+};
+
+} // namespace
+
+/**
+ * @brief Calls a function for every grid cell a line segment passes through
+ * @param segment The segment
+ * @param visit Called as visit(cell) for every cell, row by row
+ *
+ * Works in cell units: the segment is clipped to each row it spans, and
+ * every column its clipped part covers is visited. Parts outside the grid
+ * are skipped.
+ */
+template <typename Visit>
+void Geofence::visitCells(const Segment& segment, Visit&& visit) const
+{
+    const double x1 = (segment.x1 - m_originX) / m_cellWidth;
+    const double y1 = (segment.y1 - m_originY) / m_cellHeight;
+    const double x2 = (segment.x2 - m_originX) / m_cellWidth;
+    const double y2 = (segment.y2 - m_originY) / m_cellHeight;
+    const double low = std::min(y1, y2);
+    const double high = std::max(y1, y2);
+
+    if (!(high >= -CELL_EPSILON && low <= m_rows + CELL_EPSILON)) {
+        return;
+    }
+
+    const int firstRow = static_cast<int>(std::max(0.0, std::floor(low - CELL_EPSILON)));
+    const int lastRow = static_cast<int>(std::min(m_rows - 1.0, std::floor(high + CELL_EPSILON)));
+    const double slope = y1 != y2 ? (x2 - x1) / (y2 - y1) : 0.0;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        double left = x1;
+        double right = x2;
+        if (y1 != y2) {
+            left = x1 + (std::max(low, double(row)) - y1) * slope;
+            right = x1 + (std::min(high, row + 1.0) - y1) * slope;
+        }
+        if (left > right) {
+            std::swap(left, right);
+        }
+        if (!(right >= -CELL_EPSILON && left <= m_columns + CELL_EPSILON)) {
+            continue;
+        }
+
+        const int firstColumn = static_cast<int>(std::max(0.0, std::floor(left - CELL_EPSILON)));
+        const int lastColumn = static_cast<int>(std::min(m_columns - 1.0, std::floor(right + CELL_EPSILON)));
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            visit(row * m_columns + column);
+        }
+    }
+}
+
+/**
+ * @brief Constructs an empty fence that permits every position
+ */
+Geofence::Geofence()
+    : m_breachAction(Report)
+    , m_edgeCount(0)
+    , m_hasInclusion(false)
+    , m_originX(0.0)
+    , m_originY(0.0)
+    , m_cellWidth(1.0)
+    , m_cellHeight(1.0)
+    , m_columns(0)
+    , m_rows(0)
+{
+}
+
+/**
+ * @brief Loads zones from a fence file
+ * @param path The fence file
+ * @return False if the file cannot be read or parsed; see errorString()
+ */
+bool Geofence::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_errorString = QStringLiteral("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+    return parse(QString::fromUtf8(file.readAll()));
+}
+
+/**
+ * @brief Parses zones from fence text
+ * @param text The fence text
+ * @return False if the text is invalid; see errorString()
+ *
+ * The text must define at least one zone, and every zone needs at least
+ * three vertices. Without an action statement breaches are only reported.
+ * On failure the previous zones are kept.
+ */
+bool Geofence::parse(const QString& text)
+{
+    std::vector<Zone> zones;
+    BreachAction action = Report;
+    int zoneLine = 0;
+
+    auto failAt = [this](int number, const QString& message) {
+        m_errorString = QStringLiteral("line %1: %2").arg(number).arg(message);
+        return false;
+    };
+    auto zoneComplete = [&zones]() {
+        return zones.empty() || zones.back().vertices.size() >= 3;
+    };
+
+    const QStringList lines = text.split('\n');
+    for (int number = 1; number <= lines.size(); ++number) {
+        QString line = lines[number - 1];
+        const int comment = line.indexOf('#');
+        if (comment >= 0) {
+            line.truncate(comment);
+        }
+
+        const QStringList words = line.simplified().split(' ', Qt::SkipEmptyParts);
+        if (words.isEmpty()) {
+            continue;
+        }
+
+        const QString& keyword = words[0];
+
+        if (keyword == QLatin1String("action")) {
+            if (words.size() == 2 && words[1] == QLatin1String("report")) {
+                action = Report;
+            } else if (words.size() == 2 && words[1] == QLatin1String("land")) {
+                action = Land;
+            } else {
+                return failAt(number, QStringLiteral("expected action report|land"));
+            }
+        } else if (keyword == QLatin1String("inclusion") || keyword == QLatin1String("exclusion")) {
+            if (!zoneComplete()) {
+                return failAt(zoneLine, QStringLiteral("zone needs at least three vertices"));
+            }
+            Zone zone;
+            zone.type = keyword == QLatin1String("inclusion") ? Inclusion : Exclusion;
+            zone.name = words.mid(1).join(' ');
+            zones.push_back(zone);
+            zoneLine = number;
+        } else {
+            bool latOk = false;
+            bool lonOk = false;
+            const GeoPoint vertex(keyword.toDouble(&latOk), words.value(1).toDouble(&lonOk));
+            if (!latOk) {
+                return failAt(number, QStringLiteral("unknown statement \"%1\"").arg(keyword));
+            }
+            if (zones.empty()) {
+                return failAt(number, QStringLiteral("vertex outside of a zone"));
+            }
+            if (words.size() != 2 || !lonOk || !vertex.isValid()) {
+                return failAt(number, QStringLiteral("invalid vertex"));
+            }
+            zones.back().vertices.push_back(vertex);
+        }
+    }
+
+    if (zones.empty()) {
+        m_errorString = QStringLiteral("missing zone statement");
+        return false;
+    }
+    if (!zoneComplete()) {
+        return failAt(zoneLine, QStringLiteral("zone needs at least three vertices"));
+    }
+
+    m_errorString.clear();
+    m_breachAction = action;
+    setZones(std::move(zones));
+    return true;
+}
+
+QString Geofence::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief Replaces all zones and rebuilds the index
+ * @param zones The new zones; zones with fewer than three vertices are ignored
+ *
+ * The index is built in one pass over all edges, so loading many zones at
+ * once is much cheaper than adding them one by one.
+ */
+void Geofence::setZones(std::vector<Zone> zones)
+{
+    zones.erase(std::remove_if(zones.begin(), zones.end(), [](const Zone& zone) {
+        return zone.vertices.size() < 3;
+    }), zones.end());
+
+    m_zones = std::move(zones);
+    buildIndex();
+}
+
+const std::vector<Geofence::Zone>& Geofence::zones() const
+{
+    return m_zones;
+}
+
+int Geofence::edgeCount() const
+{
+    return m_edgeCount;
+}
+
+int Geofence::cellCount() const
+{
+    return m_columns * m_rows;
+}
+
+Geofence::BreachAction Geofence::breachAction() const
+{
+    return m_breachAction;
+}
+
+void Geofence::setBreachAction(BreachAction action)
+{
+    m_breachAction = action;
+}
+
+/**
+ * @brief Checks a position against the fence
+ * @param latitude Latitude in degrees
+ * @param longitude Longitude in degrees
+ * @return NO_BREACH, OUTSIDE_INCLUSION or the index of an exclusion zone containing the position
+ *
+ * Only the zones touching the position's cell are looked at. For each of
+ * them, the crossings of the line from the cell center to the position with
+ * the zone's edges in the cell flip the cell center's inside flag. If
+ * several exclusion zones contain the position, the first one found is
+ * returned.
+ */
+int Geofence::breach(double latitude, double longitude) const
+{
+    const int cell = cellAt(longitude, latitude);
+    if (cell < 0) {
+        return m_hasInclusion ? OUTSIDE_INCLUSION : NO_BREACH;
+    }
+
+    double centerX = 0.0;
+    double centerY = 0.0;
+    cellCenter(cell, centerX, centerY);
+
+    bool included = false;
+    for (qint32 i = m_cellEntries[cell]; i < m_cellEntries[cell + 1]; ++i) {
+        const Entry& entry = m_entries[i];
+        if (!insideEntry(entry, centerX, centerY, longitude, latitude)) {
+            continue;
+        }
+        if (entry.exclusion) {
+            return entry.zone;
+        }
+        included = true;
+    }
+
+    return included || !m_hasInclusion ? NO_BREACH : OUTSIDE_INCLUSION;
+}
+
+/**
+ * @brief Checks many positions against the fence
+ * @param latitude Latitudes in degrees
+ * @param longitude Longitudes in degrees
+ * @param zones Receives one breach() result per position
+ * @param count Number of positions
+ */
+void Geofence::breach(const double* latitude, const double* longitude, int* zones, int count) const
+{
+    for (int i = 0; i < count; ++i) {
+        zones[i] = breach(latitude[i], longitude[i]);
+    }
+}
+
+bool Geofence::permits(double latitude, double longitude) const
+{
+    return breach(latitude, longitude) == NO_BREACH;
+}
+
+/**
+ * @brief Checks whether a straight flight between two positions is permitted
+ * @param fromLatitude Latitude of the start in degrees
+ * @param fromLongitude Longitude of the start in degrees
+ * @param toLatitude Latitude of the destination in degrees
+ * @param toLongitude Longitude of the destination in degrees
+ * @return True if the destination is permitted and the path enters no exclusion zone
+ *
+ * The path is tested against the exclusion zone edges in the cells it
+ * passes through. A vehicle that is inside an exclusion zone may leave it,
+ * and one outside every inclusion zone may return to a permitted
+ * destination. Inclusion zones are only checked at the destination.
+ */
+bool Geofence::permitsPath(double fromLatitude, double fromLongitude, double toLatitude, double toLongitude) const
+{
+    if (!permits(toLatitude, toLongitude)) {
+        return false;
+    }
+
+    const Segment path{fromLongitude, fromLatitude, toLongitude, toLatitude};
+    bool permitted = true;
+    visitCells(path, [&](int cell) {
+        for (qint32 i = m_cellEntries[cell]; permitted && i < m_cellEntries[cell + 1]; ++i) {
+            const Entry& entry = m_entries[i];
+            if (!entry.exclusion) {
+                continue;
+            }
+            for (qint32 s = entry.firstSegment; s < entry.firstSegment + entry.segmentCount; ++s) {
+                const Segment& edge = m_segments[s];
+                if (crosses(path.x1, path.y1, path.x2, path.y2, edge.x1, edge.y1, edge.x2, edge.y2)) {
+                    permitted = insideZone(entry.zone, fromLongitude, fromLatitude);
+                    break;
+                }
+            }
+        }
+    });
+    return permitted;
+}
+
+/**
+ * @brief Rebuilds the grid from m_zones
+ *
+ * The grid covers the bounding box of all zones, padded by an odd fraction
+ * so that cell centers do not line up with round fence coordinates. Its
+ * cells are about square on the ground. Each edge is entered into every
+ * cell it passes through, and a scanline through each row of cell centers
+ * finds the zones containing them.
+ */
+void Geofence::buildIndex()
+{
+    m_edgeCount = 0;
+    m_hasInclusion = false;
+    m_columns = 0;
+    m_rows = 0;
+    m_cellEntries.clear();
+    m_entries.clear();
+    m_segments.clear();
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    std::vector<Segment> edges;
+    std::vector<qint32> edgeZones;
+    for (int zone = 0; zone < static_cast<int>(m_zones.size()); ++zone) {
+        const std::vector<GeoPoint>& vertices = m_zones[zone].vertices;
+        m_hasInclusion = m_hasInclusion || m_zones[zone].type == Inclusion;
+
+        for (size_t k = 0; k < vertices.size(); ++k) {
+            const GeoPoint& a = vertices[k];
+            const GeoPoint& b = vertices[(k + 1) % vertices.size()];
+            edges.push_back(Segment{a.longitude, a.latitude, b.longitude, b.latitude});
+            edgeZones.push_back(zone);
+
+            minX = std::min(minX, a.longitude);
+            maxX = std::max(maxX, a.longitude);
+            minY = std::min(minY, a.latitude);
+            maxY = std::max(maxY, a.latitude);
+        }
+    }
+
+    m_edgeCount = static_cast<int>(edges.size());
+    if (m_edgeCount == 0) {
+        return;
+    }
+
+    const double padX = (maxX - minX) * 0.0137 + 1e-6;
+    const double padY = (maxY - minY) * 0.0137 + 1e-6;
+    m_originX = minX - padX;
+    m_originY = minY - padY;
+    const double width = maxX - minX + 2.0 * padX;
+    const double height = maxY - minY + 2.0 * padY;
+
+    // Size the cells in latitude degrees; a longitude degree is shorter by the cosine
+    const double scale = std::max(0.01, std::cos(qDegreesToRadians((minY + maxY) / 2.0)));
+    const double cells = qBound(1.0, double(m_edgeCount) * CELLS_PER_EDGE, double(MAX_CELLS));
+    const double size = std::sqrt(width * scale * height / cells);
+    m_columns = static_cast<int>(qBound(1.0, std::ceil(width * scale / size), double(MAX_CELLS)));
+    m_rows = static_cast<int>(qBound(1.0, std::ceil(height / size), double(MAX_CELLS / m_columns)));
+    m_cellWidth = width / m_columns;
+    m_cellHeight = height / m_rows;
+
+    std::vector<IndexItem> items;
+    items.reserve(edges.size() * 4);
+
+    // Bucket the edges by the rows of cell centers they span
+    std::vector<qint32> rowStart(m_rows + 1, 0);
+    std::vector<qint32> rowEdges;
+    auto centerRows = [this](const Segment& edge, int& first, int& last) {
+        const double low = (std::min(edge.y1, edge.y2) - m_originY) / m_cellHeight - 0.5;
+        const double high = (std::max(edge.y1, edge.y2) - m_originY) / m_cellHeight - 0.5;
+        first = static_cast<int>(qBound(0.0, std::floor(low), double(m_rows - 1)));
+        last = static_cast<int>(qBound(0.0, std::ceil(high), double(m_rows - 1)));
+    };
+
+    for (int e = 0; e < m_edgeCount; ++e) {
+        visitCells(edges[e], [&](int cell) {
+            items.push_back(IndexItem{cell, edgeZones[e], e});
+        });
+
+        int first = 0;
+        int last = 0;
+        centerRows(edges[e], first, last);
+        for (int row = first; row <= last; ++row) {
+            ++rowStart[row + 1];
+        }
+    }
+    for (int row = 0; row < m_rows; ++row) {
+        rowStart[row + 1] += rowStart[row];
+    }
+    rowEdges.resize(rowStart[m_rows]);
+    std::vector<qint32> rowFill(rowStart.begin(), rowStart.end() - 1);
+    for (int e = 0; e < m_edgeCount; ++e) {
+        int first = 0;
+        int last = 0;
+        centerRows(edges[e], first, last);
+        for (int row = first; row <= last; ++row) {
+            rowEdges[rowFill[row]++] = e;
+        }
+    }
+
+    // Scan each row of cell centers; between pairs of crossings of a zone lie its inside cells
+    std::vector<std::pair<qint32, double>> crossings;
+    for (int row = 0; row < m_rows; ++row) {
+        const double y = m_originY + (row + 0.5) * m_cellHeight;
+
+        crossings.clear();
+        for (qint32 i = rowStart[row]; i < rowStart[row + 1]; ++i) {
+            const Segment& edge = edges[rowEdges[i]];
+            if ((edge.y1 > y) != (edge.y2 > y)) {
+                const double x = edge.x1 + (y - edge.y1) * (edge.x2 - edge.x1) / (edge.y2 - edge.y1);
+                crossings.emplace_back(edgeZones[rowEdges[i]], x);
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+            const double enter = (crossings[k].second - m_originX) / m_cellWidth - 0.5;
+            const double leave = (crossings[k + 1].second - m_originX) / m_cellWidth - 0.5;
+            const int first = static_cast<int>(qBound(0.0, std::ceil(enter), double(m_columns)));
+            const int last = static_cast<int>(qBound(-1.0, std::ceil(leave) - 1.0, double(m_columns - 1)));
+            for (int column = first; column <= last; ++column) {
+                items.push_back(IndexItem{row * m_columns + column, crossings[k].first, -1});
+            }
+        }
+    }
+
+    std::sort(items.begin(), items.end(), [](const IndexItem& a, const IndexItem& b) {
+        if (a.cell != b.cell) {
+            return a.cell < b.cell;
+        }
+        if (a.zone != b.zone) {
+            return a.zone < b.zone;
+        }
+        return a.edge < b.edge;
+    });
+
+    // Lay the items out cell by cell, one entry per zone
+    m_cellEntries.assign(cellCount() + 1, 0);
+    m_segments.reserve(items.size());
+    for (size_t i = 0; i < items.size();) {
+        const IndexItem& first = items[i];
+
+        Entry entry;
+        entry.zone = first.zone;
+        entry.firstSegment = static_cast<qint32>(m_segments.size());
+        entry.segmentCount = 0;
+        entry.exclusion = m_zones[first.zone].type == Exclusion;
+        entry.centerInside = false;
+
+        for (; i < items.size() && items[i].cell == first.cell && items[i].zone == first.zone; ++i) {
+            if (items[i].edge < 0) {
+                entry.centerInside = true;
+            } else {
+                m_segments.push_back(edges[items[i].edge]);
+                ++entry.segmentCount;
+            }
+        }
+
+        m_entries.push_back(entry);
+        ++m_cellEntries[first.cell + 1];
+    }
+    for (int cell = 0; cell < cellCount(); ++cell) {
+        m_cellEntries[cell + 1] += m_cellEntries[cell];
+    }
+}
+
+/**
+ * @brief Gets the cell containing a position
+ * @param x Longitude in degrees
+ * @param y Latitude in degrees
+ * @return The cell index, or -1 outside the grid or for an empty fence
+ */
+int Geofence::cellAt(double x, double y) const
+{
+    const double column = (x - m_originX) / m_cellWidth;
+    const double row = (y - m_originY) / m_cellHeight;
+    if (!(column >= 0.0 && column < m_columns && row >= 0.0 && row < m_rows)) {
+        return -1;
+    }
+    return static_cast<int>(row) * m_columns + static_cast<int>(column);
+}
+
+void Geofence::cellCenter(int cell, double& x, double& y) const
+{
+    x = m_originX + (cell % m_columns + 0.5) * m_cellWidth;
+    y = m_originY + (cell / m_columns + 0.5) * m_cellHeight;
+}
+
+/**
+ * @brief Checks whether a position lies inside the zone of a cell entry
+ * @param entry The entry of the cell containing the position
+ * @param centerX Longitude of the cell center in degrees
+ * @param centerY Latitude of the cell center in degrees
+ * @param x Longitude in degrees
+ * @param y Latitude in degrees
+ * @return True if inside
+ */
+bool Geofence::insideEntry(const Entry& entry, double centerX, double centerY, double x, double y) const
+{
+    bool inside = entry.centerInside;
+    const Segment* segment = m_segments.data() + entry.firstSegment;
+    for (qint32 s = 0; s < entry.segmentCount; ++s, ++segment) {
+        if (crosses(centerX, centerY, x, y, segment->x1, segment->y1, segment->x2, segment->y2)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief Checks whether a position lies inside a zone
+ * @param zone The zone index
+ * @param x Longitude in degrees
+ * @param y Latitude in degrees
+ * @return True if inside
+ */
+bool Geofence::insideZone(int zone, double x, double y) const
+{
+    const int cell = cellAt(x, y);
+    if (cell < 0) {
+        return false;
+    }
+
+    double centerX = 0.0;
+    double centerY = 0.0;
+    cellCenter(cell, centerX, centerY);
+
+    for (qint32 i = m_cellEntries[cell]; i < m_cellEntries[cell + 1]; ++i) {
+        if (m_entries[i].zone == zone) {
+            return insideEntry(m_entries[i], centerX, centerY, x, y);
+        }
+    }
+    return false;
+}
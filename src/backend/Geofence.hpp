@@ -0,0 +1,303 @@
+#ifndef GEOFENCE_HPP
+#define GEOFENCE_HPP
+
+#include <QString>
+#include <vector>
+#include "GeoPoint.hpp"
+
+/**
+ * @class Geofence
+ * @brief Inclusion and exclusion zones with a uniform grid index
+ *
+ * A position is permitted if it lies inside at least one inclusion zone
+ * (or no inclusion zones are defined) and outside every exclusion zone.
+ * Zones are simple polygons whose edges are straight lines in latitude and
+ * longitude; they must not cross the antimeridian.
+ *
+ * Zones are loaded in bulk, from a text file or with setZones(), and the
+ * index is built once per load. It covers the bounding box of all zones
+ * with a grid of roughly square cells, about CELLS_PER_EDGE cells per
+ * polygon edge. Every cell stores, per zone touching it, whether the cell
+ * center lies inside the zone and a copy of the zone's edges crossing the
+ * cell. A query only counts the crossings of the line from the cell center
+ * to the position with those few edges, so checking a position costs the
+ * same for ten edges as for a million.
+ *
+ * The fence text format has one statement per line; '#' starts a comment:
+ *
+ *     action report|land
+ *     inclusion [name]
+ *     exclusion [name]
+ *     <latitude> <longitude>
+ *
+ * A zone statement starts a new polygon, and each coordinate line that
+ * follows adds one vertex to it. The polygon is closed implicitly.
+ *
+ * After loading, a Geofence is only read, so one instance may be queried
+ * from any number of threads.
+ */
+class Geofence
+{
+public:
+    /**
+     * @enum ZoneType
+     * @brief Whether a zone must be entered or avoided
+     */
+    enum ZoneType : quint8 {
+        Inclusion, ///< Vehicles must stay inside
+        Exclusion  ///< Vehicles must stay outside
+    };
+
+    /**
+     * @enum BreachAction
+     * @brief How vehicles that breach the fence are handled
+     */
+    enum BreachAction : quint8 {
+        Report, ///< Only report the breach
+        Land    ///< Land the vehicle, overriding its current command
+    };
+
+    /**
+     * @struct Zone
+     * @brief One polygon of the fence
+     */
+    struct Zone
+    {
+        /** @brief Name shown to the operator */
+        QString name;
+
+        /** @brief Whether the zone must be entered or avoided */
+        ZoneType type = Exclusion;
+
+        /** @brief Corners in order, at least three; the last connects to the first */
+        std::vector<GeoPoint> vertices;
+    };
+
+    /** @brief Result of breach() for a permitted position */
+    static constexpr int NO_BREACH = -1;
+
+    /** @brief Result of breach() for a position outside every inclusion zone */
+    static constexpr int OUTSIDE_INCLUSION = -2;
+
+    /** @brief Grid cells per polygon edge */
+    static constexpr int CELLS_PER_EDGE = 2;
+
+    /** @brief Upper bound on the number of grid cells */
+    static constexpr int MAX_CELLS = 1 << 20;
+
+    /**
+     * @brief Constructs an empty fence that permits every position
+     */
+    Geofence();
+
+    /**
+     * @brief Loads zones from a fence file
+     * @param path The fence file
+     * @return False if the file cannot be read or parsed; see errorString()
+     */
+    bool load(const QString& path);
+
+    /**
+     * @brief Parses zones from fence text
+     * @param text The fence text
+     * @return False if the text is invalid; see errorString()
+     */
+    bool parse(const QString& text);
+
+    /**
+     * @brief Gets the reason the last load() or parse() failed
+     * @return The error, including the line number
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Replaces all zones and rebuilds the index
+     * @param zones The new zones; zones with fewer than three vertices are ignored
+     */
+    void setZones(std::vector<Zone> zones);
+
+    /**
+     * @brief Gets the zones of the fence
+     * @return The zones, in load order
+     */
+    const std::vector<Zone>& zones() const;
+
+    /**
+     * @brief Gets the total number of polygon edges
+     * @return The edge count
+     */
+    int edgeCount() const;
+
+    /**
+     * @brief Gets the number of cells of the index
+     * @return The cell count, 0 for an empty fence
+     */
+    int cellCount() const;
+
+    /**
+     * @brief Gets how breaching vehicles are handled
+     * @return The breach action
+     */
+    BreachAction breachAction() const;
+
+    /**
+     * @brief Sets how breaching vehicles are handled
+     * @param action The breach action
+     */
+    void setBreachAction(BreachAction action);
+
+    /**
+     * @brief Checks a position against the fence
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @return NO_BREACH, OUTSIDE_INCLUSION or the index of an exclusion zone containing the position
+     */
+    int breach(double latitude, double longitude) const;
+
+    /**
+     * @brief Checks many positions against the fence
+     * @param latitude Latitudes in degrees
+     * @param longitude Longitudes in degrees
+     * @param zones Receives one breach() result per position
+     * @param count Number of positions
+     */
+    void breach(const double* latitude, const double* longitude, int* zones, int count) const;
+
+    /**
+     * @brief Checks whether a position is permitted
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @return True if the position does not breach the fence
+     */
+    bool permits(double latitude, double longitude) const;
+
+    /**
+     * @brief Checks whether a straight flight between two positions is permitted
+     * @param fromLatitude Latitude of the start in degrees
+     * @param fromLongitude Longitude of the start in degrees
+     * @param toLatitude Latitude of the destination in degrees
+     * @param toLongitude Longitude of the destination in degrees
+     * @return True if the destination is permitted and the path enters no exclusion zone
+     */
+    bool permitsPath(double fromLatitude, double fromLongitude, double toLatitude, double toLongitude) const;
+
+private:
+    /**
+     * @struct Segment
+     * @brief A polygon edge in longitude (x) and latitude (y)
+     */
+    struct Segment
+    {
+        double x1;
+        double y1;
+        double x2;
+        double y2;
+    };
+
+    /**
+     * @struct Entry
+     * @brief A zone touching a grid cell
+     */
+    struct Entry
+    {
+        /** @brief Index of the zone */
+        qint32 zone;
+
+        /** @brief First of the zone's edges crossing the cell in m_segments */
+        qint32 firstSegment;
+
+        /** @brief Number of the zone's edges crossing the cell */
+        qint32 segmentCount;
+
+        /** @brief True for an exclusion zone */
+        bool exclusion;
+
+        /** @brief True if the cell center lies inside the zone */
+        bool centerInside;
+    };
+
+    /**
+     * @brief Rebuilds the grid from m_zones
+     */
+    void buildIndex();
+
+    /**
+     * @brief Gets the cell containing a position
+     * @param x Longitude in degrees
+     * @param y Latitude in degrees
+     * @return The cell index, or -1 outside the grid
+     */
+    int cellAt(double x, double y) const;
+
+    /**
+     * @brief Gets the center of a cell
+     * @param cell The cell index
+     * @param x Receives the longitude in degrees
+     * @param y Receives the latitude in degrees
+     */
+    void cellCenter(int cell, double& x, double& y) const;
+
+    /**
+     * @brief Checks whether a position lies inside the zone of a cell entry
+     * @param entry The entry of the cell containing the position
+     * @param centerX Longitude of the cell center in degrees
+     * @param centerY Latitude of the cell center in degrees
+     * @param x Longitude in degrees
+     * @param y Latitude in degrees
+     * @return True if inside
+     */
+    bool insideEntry(const Entry& entry, double centerX, double centerY, double x, double y) const;
+
+    /**
+     * @brief Checks whether a position lies inside a zone
+     * @param zone The zone index
+     * @param x Longitude in degrees
+     * @param y Latitude in degrees
+     * @return True if inside
+     */
+    bool insideZone(int zone, double x, double y) const;
+
+    /**
+     * @brief Calls a function for every grid cell a line segment passes through
+     * @param segment The segment
+     * @param visit Called as visit(cell) for every cell, row by row
+     */
+    template <typename Visit>
+    void visitCells(const Segment& segment, Visit&& visit) const;
+
+    /** @brief The zones, in load order */
+    std::vector<Zone> m_zones;
+
+    /** @brief How breaching vehicles are handled */
+    BreachAction m_breachAction;
+
+    /** @brief Reason the last load() or parse() failed */
+    QString m_errorString;
+
+    /** @brief Total number of polygon edges */
+    int m_edgeCount;
+
+    /** @brief True if at least one inclusion zone exists */
+    bool m_hasInclusion;
+
+    /** @name Grid geometry, in degrees */
+    ///@{
+    double m_originX;
+    double m_originY;
+    double m_cellWidth;
+    double m_cellHeight;
+    int m_columns;
+    int m_rows;
+    ///@}
+
+    /** @brief Offset of every cell's first entry in m_entries, one extra at the end */
+    std::vector<qint32> m_cellEntries;
+
+    /** @brief Zones touching each cell, grouped by cell */
+    std::vector<Entry> m_entries;
+
+    /** @brief Edges crossing each cell, grouped by cell and zone */
+    std::vector<Segment> m_segments;
+};
+
+#endif // GEOFENCE_HPP
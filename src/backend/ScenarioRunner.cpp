@@ -0,0 +1,378 @@
+#include "ScenarioRunner.hpp"
+#include "FleetSimulator.hpp"
+#include <QElapsedTimer>
+#include <QFile>
+#include <algorithm>
+
+namespace {
+
+/** @brief Simulated time run past the last command if no duration is scripted */
+constexpr qint64 DEFAULT_TAIL = 60000;
+
+/**
+ * @brief Converts scripted seconds to milliseconds
+ */
+qint64 toMilliseconds(double seconds)
+{
+    return qRound64(seconds * 1000.0);
+}
+
+} // namespace
+
+double ScenarioRunner::Stats::realTimeFactor() const
+{
+    return wallTime > 0 ? simulatedTime * 1.0e6 / wallTime : 0.0;
+}
+
+double ScenarioRunner::Stats::vehicleStepsPerSecond() const
+{
+    return wallTime > 0 ? double(ticks) * vehicleCount * 1.0e9 / wallTime : 0.0;
+}
+
+/**
+ * @brief Constructs a runner with an empty scenario
+ */
+ScenarioRunner::ScenarioRunner()
+    : m_vehicleCount(0)
+    , m_spacing(50.0)
+    , m_tickInterval(FleetSimulator::TICK_INTERVAL)
+    , m_duration(0)
+{
+}
+
+/**
+ * @brief Loads a scenario script from a file
+ * @param path The script file
+ * @return False if the file cannot be read or parsed; see errorString()
+ */
+bool ScenarioRunner::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_errorString = QStringLiteral("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+    return parse(QString::fromUtf8(file.readAll()));
+}
+
+/**
+ * @brief Parses a scenario script
+ * @param script The script text
+ * @return False if the script is invalid; see errorString()
+ *
+ * A script must contain a fleet statement. Without a duration statement
+ * the scenario runs until 60 s after its last command. On failure the
+ * previous scenario is kept.
+ */
+bool ScenarioRunner::parse(const QString& script)
+{
+    int vehicleCount = 0;
+    QGeoCoordinate origin;
+    double spacing = 50.0;
+    int tickInterval = FleetSimulator::TICK_INTERVAL;
+    qint64 duration = -1;
+    QVector<Action> actions;
+    QVector<int> actionLines;
+
+    const QStringList lines = script.split('\n');
+    for (int number = 1; number <= lines.size(); ++number) {
+        QString line = lines[number - 1];
+        const int comment = line.indexOf('#');
+        if (comment >= 0) {
+            line.truncate(comment);
+        }
+
+        const QStringList words = line.simplified().split(' ', Qt::SkipEmptyParts);
+        if (words.isEmpty()) {
+            continue;
+        }
+
+        auto fail = [this, number](const QString& message) {
+            m_errorString = QStringLiteral("line %1: %2").arg(number).arg(message);
+            return false;
+        };
+
+        bool ok = true;
+        const QString& keyword = words[0];
+
+        if (keyword == QLatin1String("fleet")) {
+            if (words.size() < 4 || words.size() > 5) {
+                return fail(QStringLiteral("expected fleet <count> <latitude> <longitude> [spacing]"));
+            }
+            vehicleCount = words[1].toInt(&ok);
+            if (!ok || vehicleCount <= 0) {
+                return fail(QStringLiteral("invalid vehicle count"));
+            }
+            bool latOk = false;
+            bool lonOk = false;
+            origin = QGeoCoordinate(words[2].toDouble(&latOk), words[3].toDouble(&lonOk));
+            if (!latOk || !lonOk || !origin.isValid()) {
+                return fail(QStringLiteral("invalid origin"));
+            }
+            if (words.size() == 5) {
+                spacing = words[4].toDouble(&ok);
+                if (!ok || spacing <= 0.0) {
+                    return fail(QStringLiteral("invalid spacing"));
+                }
+            }
+        } else if (keyword == QLatin1String("tick")) {
+            tickInterval = words.size() == 2 ? words[1].toInt(&ok) : 0;
+            if (!ok || tickInterval <= 0) {
+                return fail(QStringLiteral("expected tick <milliseconds>"));
+            }
+        } else if (keyword == QLatin1String("duration")) {
+            const double seconds = words.size() == 2 ? words[1].toDouble(&ok) : 0.0;
+            if (!ok || seconds <= 0.0) {
+                return fail(QStringLiteral("expected duration <seconds>"));
+            }
+            duration = toMilliseconds(seconds);
+        } else if (keyword == QLatin1String("at")) {
+            if (words.size() < 4) {
+                return fail(QStringLiteral("expected at <seconds> <command> <vehicles>"));
+            }
+
+            Action action;
+            const double seconds = words[1].toDouble(&ok);
+            if (!ok || seconds < 0.0) {
+                return fail(QStringLiteral("invalid time"));
+            }
+            action.time = toMilliseconds(seconds);
+
+            if (!parseSelection(words[3], action)) {
+                return fail(QStringLiteral("invalid vehicles \"%1\"").arg(words[3]));
+            }
+
+            const QString& command = words[2];
+            if (command == QLatin1String("takeoff") && words.size() == 4) {
+                action.type = Action::TakeOff;
+            } else if (command == QLatin1String("land") && words.size() == 4) {
+                action.type = Action::Land;
+            } else if (command == QLatin1String("goto") && words.size() >= 6 && words.size() <= 8) {
+                action.type = Action::GoTo;
+                bool latOk = false;
+                bool lonOk = false;
+                action.destination = QGeoCoordinate(words[4].toDouble(&latOk), words[5].toDouble(&lonOk));
+                if (!latOk || !lonOk || !action.destination.isValid()) {
+                    return fail(QStringLiteral("invalid destination"));
+                }
+                if (words.size() >= 7) {
+                    action.loiterRadius = words[6].toInt(&ok);
+                    if (!ok || action.loiterRadius <= 0) {
+                        return fail(QStringLiteral("invalid loiter radius"));
+                    }
+                }
+                if (words.size() == 8) {
+                    if (words[7] != QLatin1String("cw") && words[7] != QLatin1String("ccw")) {
+                        return fail(QStringLiteral("expected cw or ccw"));
+                    }
+                    action.loiterClockwise = words[7] == QLatin1String("cw");
+                }
+            } else {
+                return fail(QStringLiteral("invalid command \"%1\"").arg(words.mid(2).join(' ')));
+            }
+
+            actions.append(action);
+            actionLines.append(number);
+        } else {
+            return fail(QStringLiteral("unknown statement \"%1\"").arg(keyword));
+        }
+    }
+
+    if (vehicleCount == 0) {
+        m_errorString = QStringLiteral("missing fleet statement");
+        return false;
+    }
+
+    qint64 lastTime = 0;
+    for (int i = 0; i < actions.size(); ++i) {
+        if (actions[i].first >= vehicleCount || actions[i].last >= vehicleCount) {
+            m_errorString = QStringLiteral("line %1: vehicle out of range").arg(actionLines[i]);
+            return false;
+        }
+        lastTime = qMax(lastTime, actions[i].time);
+    }
+
+    std::stable_sort(actions.begin(), actions.end(), [](const Action& a, const Action& b) {
+        return a.time < b.time;
+    });
+
+    m_vehicleCount = vehicleCount;
+    m_origin = origin;
+    m_spacing = spacing;
+    m_tickInterval = tickInterval;
+    m_duration = duration >= 0 ? duration : lastTime + DEFAULT_TAIL;
+    m_actions = actions;
+    m_errorString.clear();
+    return true;
+}
+
+QString ScenarioRunner::errorString() const
+{
+    return m_errorString;
+}
+
+int ScenarioRunner::vehicleCount() const
+{
+    return m_vehicleCount;
+}
+
+qint64 ScenarioRunner::duration() const
+{
+    return m_duration;
+}
+
+int ScenarioRunner::tickInterval() const
+{
+    return m_tickInterval;
+}
+
+int ScenarioRunner::actionCount() const
+{
+    return m_actions.size();
+}
+
+/**
+ * @brief Runs the scenario
+ * @param fleet An empty fleet; the scenario's vehicles are added to it
+ * @return The measurements
+ *
+ * The fleet's clock is not used; the fleet is stepped back to back until
+ * the scenario's duration is covered. Commands scheduled past the
+ * duration are never issued.
+ */
+ScenarioRunner::Stats ScenarioRunner::run(FleetSimulator* fleet) const
+{
+    Stats stats;
+    fleet->addVehicles(m_vehicleCount, m_origin, m_spacing);
+    stats.vehicleCount = fleet->vehicleCount();
+
+    const qint64 ticks = (m_duration + m_tickInterval - 1) / m_tickInterval;
+    std::vector<qint64> tickTimes;
+    tickTimes.reserve(ticks);
+    std::vector<qint64> commandTimes;
+    commandTimes.reserve(m_actions.size());
+
+    int next = 0;
+    qint64 simulatedTime = 0;
+
+    QElapsedTimer wall;
+    wall.start();
+
+    for (qint64 tick = 0; tick < ticks; ++tick) {
+        while (next < m_actions.size() && m_actions[next].time <= simulatedTime) {
+            const qint64 begin = wall.nsecsElapsed();
+            apply(fleet, m_actions[next], stats);
+            commandTimes.push_back(wall.nsecsElapsed() - begin);
+            ++next;
+        }
+
+        const qint64 begin = wall.nsecsElapsed();
+        fleet->step(m_tickInterval);
+        tickTimes.push_back(wall.nsecsElapsed() - begin);
+
+        simulatedTime += m_tickInterval;
+    }
+
+    stats.wallTime = wall.nsecsElapsed();
+    stats.ticks = ticks;
+    stats.simulatedTime = simulatedTime;
+    stats.commandBatches = next;
+    stats.tickLatency = summarize(tickTimes);
+    stats.commandLatency = summarize(commandTimes);
+    return stats;
+}
+
+/**
+ * @brief Summarizes measured durations
+ * @param samples The durations in nanoseconds; reordered
+ * @return The distribution, all zero for no samples
+ *
+ * Percentiles are the nearest-rank values; finding them partially sorts
+ * the samples.
+ */
+ScenarioRunner::Latency ScenarioRunner::summarize(std::vector<qint64>& samples)
+{
+    Latency latency;
+    if (samples.empty()) {
+        return latency;
+    }
+
+    const auto rank = [&samples](double fraction) {
+        const size_t index = qMin(samples.size() - 1, size_t(fraction * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    };
+
+    qint64 total = 0;
+    latency.min = samples.front();
+    latency.max = samples.front();
+    for (qint64 sample : samples) {
+        total += sample;
+        latency.min = qMin(latency.min, sample);
+        latency.max = qMax(latency.max, sample);
+    }
+    latency.mean = total / qint64(samples.size());
+    latency.median = rank(0.5);
+    latency.p99 = rank(0.99);
+    return latency;
+}
+
+/**
+ * @brief Parses a vehicle selection
+ * @param text "all", an index or an inclusive range
+ * @param action Receives the selection
+ * @return False if the text is not a selection
+ */
+bool ScenarioRunner::parseSelection(const QString& text, Action& action)
+{
+    if (text == QLatin1String("all")) {
+        action.first = 0;
+        action.last = -1;
+        return true;
+    }
+
+    bool firstOk = false;
+    bool lastOk = true;
+    const int dash = text.indexOf('-');
+    if (dash < 0) {
+        action.first = text.toInt(&firstOk);
+        action.last = action.first;
+    } else {
+        action.first = text.left(dash).toInt(&firstOk);
+        action.last = text.mid(dash + 1).toInt(&lastOk);
+    }
+    return firstOk && lastOk && action.first >= 0 && action.last >= action.first;
+}
+
+/**
+ * @brief Issues a scripted command to the fleet
+ * @param fleet The fleet
+ * @param action The command
+ * @param stats Receives the command counts
+ */
+void ScenarioRunner::apply(FleetSimulator* fleet, const Action& action, Stats& stats)
+{
+    const int last = action.last < 0 ? fleet->vehicleCount() - 1 : qMin(action.last, fleet->vehicleCount() - 1);
+
+    QVector<int> indices;
+    indices.reserve(qMax(0, last - action.first + 1));
+    for (int i = action.first; i <= last; ++i) {
+        indices.append(i);
+    }
+
+    int accepted = 0;
+    switch (action.type) {
+    case Action::TakeOff:
+        accepted = fleet->takeOff(indices);
+        break;
+    case Action::Land:
+        accepted = fleet->land(indices);
+        break;
+    case Action::GoTo:
+        accepted = fleet->goTo(indices, {action.destination}, action.loiterRadius, action.loiterClockwise);
+        break;
+    }
+
+    stats.commandsRequested += indices.size();
+    stats.commandsAccepted += accepted;
+}
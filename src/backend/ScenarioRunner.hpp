@@ -0,0 +1,217 @@
+#ifndef SCENARIORUNNER_HPP
+#define SCENARIORUNNER_HPP
+
+#include <QGeoCoordinate>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+class FleetSimulator;
+
+/**
+ * @class ScenarioRunner
+ * @brief Runs a scripted fleet scenario as fast as possible and measures it
+ *
+ * A scenario is a text script with one statement per line; '#' starts a
+ * comment:
+ *
+ *     fleet <count> <latitude> <longitude> [spacing]
+ *     tick <milliseconds>
+ *     duration <seconds>
+ *     at <seconds> takeoff <vehicles>
+ *     at <seconds> land <vehicles>
+ *     at <seconds> goto <vehicles> <latitude> <longitude> [radius] [cw|ccw]
+ *
+ * Vehicles are selected as "all", a single index or an inclusive range
+ * "first-last". Commands are issued as batches at the first tick at or
+ * after their time.
+ *
+ * run() steps the fleet directly, without a clock or an event loop, and
+ * records the wall time of every tick and every command batch.
+ */
+class ScenarioRunner
+{
+public:
+    /**
+     * @struct Latency
+     * @brief Distribution of measured durations, in nanoseconds
+     */
+    struct Latency
+    {
+        qint64 min = 0;
+        qint64 mean = 0;
+        qint64 median = 0;
+        qint64 p99 = 0;
+        qint64 max = 0;
+    };
+
+    /**
+     * @struct Stats
+     * @brief Measurements of one run
+     */
+    struct Stats
+    {
+        /** @brief Number of simulated vehicles */
+        int vehicleCount = 0;
+
+        /** @brief Number of ticks stepped */
+        quint64 ticks = 0;
+
+        /** @brief Simulated time in milliseconds */
+        qint64 simulatedTime = 0;
+
+        /** @brief Wall time of the run in nanoseconds */
+        qint64 wallTime = 0;
+
+        /** @brief Wall time of fleet steps */
+        Latency tickLatency;
+
+        /** @brief Wall time of command batches */
+        Latency commandLatency;
+
+        /** @brief Number of command batches issued */
+        int commandBatches = 0;
+
+        /** @brief Number of vehicles commanded */
+        qint64 commandsRequested = 0;
+
+        /** @brief Number of vehicle commands accepted */
+        qint64 commandsAccepted = 0;
+
+        /**
+         * @brief Gets the speed of the run relative to real time
+         * @return Simulated time per wall time
+         */
+        double realTimeFactor() const;
+
+        /**
+         * @brief Gets the throughput of the run
+         * @return Vehicles stepped per wall-clock second
+         */
+        double vehicleStepsPerSecond() const;
+    };
+
+    /**
+     * @brief Constructs a runner with an empty scenario
+     */
+    ScenarioRunner();
+
+    /**
+     * @brief Loads a scenario script from a file
+     * @param path The script file
+     * @return False if the file cannot be read or parsed; see errorString()
+     */
+    bool load(const QString& path);
+
+    /**
+     * @brief Parses a scenario script
+     * @param script The script text
+     * @return False if the script is invalid; see errorString()
+     */
+    bool parse(const QString& script);
+
+    /**
+     * @brief Gets the reason the last load() or parse() failed
+     * @return The error, including the line number
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Gets the fleet size of the scenario
+     * @return The number of vehicles
+     */
+    int vehicleCount() const;
+
+    /**
+     * @brief Gets the length of the scenario
+     * @return Simulated milliseconds
+     */
+    qint64 duration() const;
+
+    /**
+     * @brief Gets the tick interval of the scenario
+     * @return Simulated milliseconds per tick
+     */
+    int tickInterval() const;
+
+    /**
+     * @brief Gets the number of scripted commands
+     * @return The command count
+     */
+    int actionCount() const;
+
+    /**
+     * @brief Runs the scenario
+     * @param fleet An empty fleet; the scenario's vehicles are added to it
+     * @return The measurements
+     */
+    Stats run(FleetSimulator* fleet) const;
+
+    /**
+     * @brief Summarizes measured durations
+     * @param samples The durations in nanoseconds; reordered
+     * @return The distribution, all zero for no samples
+     */
+    static Latency summarize(std::vector<qint64>& samples);
+
+private:
+    /**
+     * @struct Action
+     * @brief A scripted command
+     */
+    struct Action
+    {
+        enum Type : quint8 {
+            TakeOff,
+            Land,
+            GoTo
+        };
+
+        /** @brief Simulated time at which the command is issued, in milliseconds */
+        qint64 time = 0;
+
+        Type type = TakeOff;
+
+        /** @brief First commanded vehicle */
+        int first = 0;
+
+        /** @brief Last commanded vehicle, -1 for the last of the fleet */
+        int last = -1;
+
+        QGeoCoordinate destination;
+        int loiterRadius = DEFAULT_LOITER_RADIUS;
+        bool loiterClockwise = true;
+    };
+
+    /**
+     * @brief Parses a vehicle selection
+     * @param text "all", an index or an inclusive range
+     * @param action Receives the selection
+     * @return False if the text is not a selection
+     */
+    static bool parseSelection(const QString& text, Action& action);
+
+    /**
+     * @brief Issues a scripted command to the fleet
+     * @param fleet The fleet
+     * @param action The command
+     * @param stats Receives the command counts
+     */
+    static void apply(FleetSimulator* fleet, const Action& action, Stats& stats);
+
+    /** @brief Loiter radius of goto commands without one, in meters */
+    static constexpr int DEFAULT_LOITER_RADIUS = 200;
+
+    int m_vehicleCount;
+    QGeoCoordinate m_origin;
+    double m_spacing;
+    int m_tickInterval;
+    qint64 m_duration;
+
+    /** @brief Scripted commands, ordered by time */
+    QVector<Action> m_actions;
+
+    QString m_errorString;
+};
+
+#endif // SCENARIORUNNER_HPP
@@ -0,0 +1,330 @@
+#include "SharedTelemetryExport.hpp"
+#include "TelemetrySubscriber.hpp"
+#include <cerrno>
+#include <cstring>
+
+#if GCS_SHARED_TELEMETRY
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if GCS_SHARED_TELEMETRY
+/**
+ * @brief Checks whether an existing object was left behind by a writer that no longer runs
+ * @param path The object name
+ * @return True if the object holds no valid export or its writer process is gone
+ *
+ * An object too small for the header or without the magic was left by a
+ * writer that died before publishing it, since open() stores the magic
+ * right after creating the object.
+ */
+bool isStale(const char* path)
+{
+    const int fd = ::shm_open(path, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool stale = false;
+    struct stat status;
+    if (::fstat(fd, &status) == 0) {
+        stale = status.st_size < static_cast<off_t>(sizeof(SharedTelemetry::Header));
+        if (!stale) {
+            void* mapping = ::mmap(nullptr, sizeof(SharedTelemetry::Header), PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED) {
+                const auto* header = static_cast<const SharedTelemetry::Header*>(mapping);
+                if (header->magic.load(std::memory_order_acquire) != SharedTelemetry::MAGIC) {
+                    stale = true;
+                } else {
+                    const pid_t writer = static_cast<pid_t>(header->writerPid);
+                    stale = writer > 0 && ::kill(writer, 0) != 0 && errno == ESRCH;
+                }
+                ::munmap(mapping, sizeof(SharedTelemetry::Header));
+            }
+        }
+    }
+    ::close(fd);
+    return stale;
+}
+#endif
+
+} // namespace
+
+/**
+ * @brief Constructs a closed export
+ * @param parent The parent QObject
+ */
+SharedTelemetryExport::SharedTelemetryExport(QObject* parent)
+    : QObject(parent)
+    , m_header(nullptr)
+    , m_size(0)
+    , m_slots(nullptr)
+    , m_ring(nullptr)
+    , m_frameCount(0)
+    , m_droppedFrames(0)
+    , m_subscriber(nullptr)
+{
+}
+
+/**
+ * @brief Destructor
+ *
+ * Closes the export.
+ */
+SharedTelemetryExport::~SharedTelemetryExport()
+{
+    close();
+}
+
+/**
+ * @brief Creates the shared memory object
+ * @param name The object name, a slash followed by up to 250 characters
+ * @param vehicleCapacity Number of vehicle table slots
+ * @param ringCapacity Number of recent frames kept, a power of two
+ * @return False if the object could not be created; see errorString()
+ *
+ * The object is created exclusively. If the name exists, the header of
+ * the existing object is checked, and only an object without a valid
+ * header or whose writer process no longer runs is removed and created
+ * again; otherwise open() fails.
+ *
+ * The new object is zero-filled by ftruncate(), which leaves every record
+ * at sequence 0, i.e. complete and empty. The magic is stored last, so a
+ * reader opening the object early rejects it instead of reading a
+ * half-initialized header.
+ */
+bool SharedTelemetryExport::open(const QString& name, int vehicleCapacity, int ringCapacity)
+{
+    close();
+
+    if (vehicleCapacity <= 0 || ringCapacity < 2 || (ringCapacity & (ringCapacity - 1)) != 0) {
+        m_errorString = QStringLiteral("%1: invalid capacity").arg(name);
+        return false;
+    }
+
+#if GCS_SHARED_TELEMETRY
+    const QByteArray path = name.toLocal8Bit();
+    int fd = ::shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST && isStale(path.constData())) {
+        ::shm_unlink(path.constData());
+        fd = ::shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            m_errorString = QStringLiteral("%1: already exported by a running process").arg(name);
+        } else {
+            m_errorString = QStringLiteral("%1: %2").arg(name, QString::fromLocal8Bit(std::strerror(errno)));
+        }
+        return false;
+    }
+
+    const size_t size = SharedTelemetry::objectSize(vehicleCapacity, ringCapacity);
+    void* mapping = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        m_errorString = QStringLiteral("%1: %2").arg(name, QString::fromLocal8Bit(std::strerror(errno)));
+        ::close(fd);
+        ::shm_unlink(path.constData());
+        return false;
+    }
+    ::close(fd);
+
+    m_header = static_cast<SharedTelemetry::Header*>(mapping);
+    m_header->version = SharedTelemetry::VERSION;
+    m_header->vehicleCapacity = static_cast<quint32>(vehicleCapacity);
+    m_header->ringCapacity = static_cast<quint32>(ringCapacity);
+    m_header->writerPid = static_cast<quint32>(::getpid());
+    m_header->magic.store(SharedTelemetry::MAGIC, std::memory_order_release);
+
+    m_size = size;
+    m_slots = SharedTelemetry::table(m_header);
+    m_ring = SharedTelemetry::ring(m_header);
+    m_name = name;
+    m_errorString.clear();
+    m_latest.reserve(vehicleCapacity);
+    m_frameCount = 0;
+    m_droppedFrames = 0;
+    return true;
+#else
+    m_errorString = QStringLiteral("%1: shared memory is not supported on this platform").arg(name);
+    return false;
+#endif
+}
+
+void SharedTelemetryExport::close()
+{
+#if GCS_SHARED_TELEMETRY
+    if (m_header) {
+        ::munmap(m_header, m_size);
+        ::shm_unlink(m_name.toLocal8Bit().constData());
+    }
+#endif
+    m_header = nullptr;
+    m_size = 0;
+    m_slots = nullptr;
+    m_ring = nullptr;
+    m_name.clear();
+    m_slotIndex.clear();
+    m_latest.clear();
+}
+
+bool SharedTelemetryExport::isOpen() const
+{
+    return m_header != nullptr;
+}
+
+QString SharedTelemetryExport::name() const
+{
+    return m_name;
+}
+
+QString SharedTelemetryExport::errorString() const
+{
+    return m_errorString;
+}
+
+void SharedTelemetryExport::attach(TelemetryBus* bus)
+{
+    delete m_subscriber;
+    m_subscriber = nullptr;
+
+    if (bus) {
+        m_subscriber = new TelemetrySubscriber(TelemetryBus::AllTopics, 0.0, this);
+        connect(m_subscriber, &TelemetrySubscriber::framesReceived, this,
+            [this](const TelemetryBus::FrameBatchPointer& batch) {
+                write(*batch);
+            });
+        connect(m_subscriber, &TelemetrySubscriber::transitionsReceived, this,
+            [this](const TelemetryBus::TransitionBatchPointer& transitions) {
+                write(*transitions);
+            });
+        bus->subscribe(m_subscriber);
+    }
+}
+
+/**
+ * @brief Writes a batch of frames into the table and the ring
+ * @param batch The frames
+ *
+ * Each frame updates its vehicle's slot and takes the next ring entry.
+ * The frame count is published once per batch, after all its entries are
+ * complete.
+ */
+void SharedTelemetryExport::write(const TelemetryBus::FrameBatch& batch)
+{
+    if (!m_header) {
+        return;
+    }
+
+    const quint64 mask = m_header->ringCapacity - 1;
+    for (const TelemetryBus::VehicleFrame& entry : batch.frames) {
+        const int index = slot(entry.vehicle);
+        if (index < 0) {
+            ++m_droppedFrames;
+            continue;
+        }
+
+        SharedTelemetry::Snapshot& snapshot = m_latest[index];
+        snapshot.timestamp = entry.frame.timestamp;
+        snapshot.latitude = entry.frame.latitude;
+        snapshot.longitude = entry.frame.longitude;
+        snapshot.altitude = entry.frame.altitude;
+        snapshot.speed = entry.frame.speed;
+        snapshot.battery = entry.frame.battery;
+        writeSlot(index, snapshot);
+
+        SharedTelemetry::write(m_ring[m_frameCount & mask], 2 * m_frameCount + 1, snapshot);
+        ++m_frameCount;
+    }
+
+    m_header->frameCount.store(m_frameCount, std::memory_order_release);
+    m_header->updateCount.store(m_header->updateCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void SharedTelemetryExport::write(const std::vector<TelemetryBus::Transition>& transitions)
+{
+    if (!m_header) {
+        return;
+    }
+
+    for (const TelemetryBus::Transition& transition : transitions) {
+        const int index = slot(transition.vehicle);
+        if (index < 0) {
+            continue;
+        }
+
+        SharedTelemetry::Snapshot& snapshot = m_latest[index];
+        snapshot.state = static_cast<quint8>(transition.state);
+        snapshot.timestamp = qMax<qint64>(snapshot.timestamp, transition.timestamp);
+        writeSlot(index, snapshot);
+    }
+
+    m_header->updateCount.store(m_header->updateCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+int SharedTelemetryExport::vehicleCount() const
+{
+    return static_cast<int>(m_latest.size());
+}
+
+quint64 SharedTelemetryExport::frameCount() const
+{
+    return m_frameCount;
+}
+
+quint64 SharedTelemetryExport::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+/**
+ * @brief Finds or assigns the table slot of a vehicle
+ * @param vehicle The vehicle id
+ * @return The slot, or -1 if the table is full
+ *
+ * A new vehicle starts landed, at the next free slot. Readers see the slot
+ * once it has been written.
+ */
+int SharedTelemetryExport::slot(quint32 vehicle)
+{
+    const auto found = m_slotIndex.constFind(vehicle);
+    if (found != m_slotIndex.constEnd()) {
+        return found.value();
+    }
+    if (m_latest.size() >= m_header->vehicleCapacity) {
+        return -1;
+    }
+
+    SharedTelemetry::Snapshot snapshot = {};
+    snapshot.vehicle = vehicle;
+    snapshot.state = UASState::Landed;
+    m_latest.push_back(snapshot);
+
+    const int index = static_cast<int>(m_latest.size()) - 1;
+    m_slotIndex.insert(vehicle, index);
+    return index;
+}
+
+/**
+ * @brief Stores a snapshot into a table slot
+ * @param slot The slot
+ * @param snapshot The snapshot
+ *
+ * Only this process writes the slot, so its sequence can be read relaxed.
+ */
+void SharedTelemetryExport::writeSlot(int slot, const SharedTelemetry::Snapshot& snapshot)
+{
+    SharedTelemetry::Record& record = m_slots[slot].record;
+    SharedTelemetry::write(record, record.sequence.load(std::memory_order_relaxed) + 1, snapshot);
+
+    if (static_cast<quint32>(slot) >= m_header->vehicleCount.load(std::memory_order_relaxed)) {
+        m_header->vehicleCount.store(static_cast<quint32>(slot) + 1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef SHAREDTELEMETRYEXPORT_HPP
+#define SHAREDTELEMETRYEXPORT_HPP
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <vector>
+#include "SharedTelemetry.hpp"
+#include "TelemetryBus.hpp"
+
+class TelemetrySubscriber;
+
+/**
+ * @class SharedTelemetryExport
+ * @brief Exports telemetry into POSIX shared memory for co-located processes
+ *
+ * Keeps a table with the latest snapshot of every vehicle and a ring of the
+ * most recent frames in a shared memory object, laid out as described in
+ * SharedTelemetry. Other processes on the same host read it with
+ * SharedTelemetryReader, without system calls or deserialization, and
+ * without ever blocking the export.
+ *
+ * The export subscribes to a TelemetryBus and writes every batch it is
+ * delivered; it can also be written directly. Vehicles get a table slot
+ * the first time they are written, in order, until the table is full.
+ *
+ * Android and Windows lack POSIX shared memory; there open() fails.
+ */
+class SharedTelemetryExport : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a closed export
+     * @param parent The parent QObject
+     */
+    explicit SharedTelemetryExport(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Closes the export.
+     */
+    virtual ~SharedTelemetryExport();
+
+    /**
+     * @brief Creates the shared memory object
+     * @param name The object name, a slash followed by up to 250 characters
+     * @param vehicleCapacity Number of vehicle table slots
+     * @param ringCapacity Number of recent frames kept, a power of two
+     * @return False if the object could not be created; see errorString()
+     *
+     * Fails if another process exports under the same name. An object
+     * left behind by a writer that no longer runs, e.g. after a crash, or
+     * that never received a valid header is replaced; readers still mapping it keep the old contents and have to
+     * open the name again.
+     */
+    bool open(const QString& name = QString::fromLatin1(SharedTelemetry::DEFAULT_NAME),
+              int vehicleCapacity = SharedTelemetry::DEFAULT_VEHICLE_CAPACITY,
+              int ringCapacity = SharedTelemetry::DEFAULT_RING_CAPACITY);
+
+    /**
+     * @brief Unmaps and removes the shared memory object
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the export is open
+     * @return True if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the name of the shared memory object
+     * @return The name, empty if closed
+     */
+    QString name() const;
+
+    /**
+     * @brief Gets the reason the last open() failed
+     * @return The error message
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Writes everything published on a bus
+     * @param bus The bus, or nullptr to stop
+     *
+     * Batches are written on the export's thread as they are delivered.
+     */
+    void attach(TelemetryBus* bus);
+
+    /**
+     * @brief Writes a batch of frames into the table and the ring
+     * @param batch The frames
+     */
+    void write(const TelemetryBus::FrameBatch& batch);
+
+    /**
+     * @brief Writes the new states of vehicles into the table
+     * @param transitions The transitions
+     */
+    void write(const std::vector<TelemetryBus::Transition>& transitions);
+
+    /**
+     * @brief Gets the number of vehicles in the table
+     * @return The vehicle count
+     */
+    int vehicleCount() const;
+
+    /**
+     * @brief Gets the number of frames written to the ring
+     * @return The frame count
+     */
+    quint64 frameCount() const;
+
+    /**
+     * @brief Gets the number of frames dropped because the table was full
+     * @return The count since open()
+     */
+    quint64 droppedFrames() const;
+
+private:
+    /**
+     * @brief Finds or assigns the table slot of a vehicle
+     * @param vehicle The vehicle id
+     * @return The slot, or -1 if the table is full
+     */
+    int slot(quint32 vehicle);
+
+    /**
+     * @brief Stores a snapshot into a table slot
+     * @param slot The slot
+     * @param snapshot The snapshot
+     */
+    void writeSlot(int slot, const SharedTelemetry::Snapshot& snapshot);
+
+    /** @brief The mapped object, nullptr if closed */
+    SharedTelemetry::Header* m_header;
+
+    /** @brief Size of the mapping in bytes */
+    size_t m_size;
+
+    /** @brief The vehicle table */
+    SharedTelemetry::Slot* m_slots;
+
+    /** @brief The frame ring */
+    SharedTelemetry::Record* m_ring;
+
+    /** @brief Name of the shared memory object */
+    QString m_name;
+
+    /** @brief Reason the last open() failed */
+    QString m_errorString;
+
+    /** @brief Table slot of every vehicle id */
+    QHash<quint32, int> m_slotIndex;
+
+    /** @brief Copy of the table, to update single fields */
+    std::vector<SharedTelemetry::Snapshot> m_latest;
+
+    /** @brief Frames written to the ring */
+    quint64 m_frameCount;
+
+    /** @brief Frames dropped because the table was full */
+    quint64 m_droppedFrames;
+
+    /** @brief Receives the batches of the attached bus */
+    TelemetrySubscriber* m_subscriber;
+};
+
+#endif // SHAREDTELEMETRYEXPORT_HPP
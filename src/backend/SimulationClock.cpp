@@ -0,0 +1,196 @@
+#include "SimulationClock.hpp"
+#include <QtMath>
+#include <climits>
+
+/**
+ * @brief Constructs a real-time SimulationClock
+ * @param parent The parent QObject
+ *
+ * The clock ticks every 250 ms of simulated time at a time warp of 1.0,
+ * which matches the timers previously used by the simulators. It does not
+ * start ticking until start() is called.
+ */
+SimulationClock::SimulationClock(QObject* parent)
+    : SimulationClock(RealTime, parent)
+{
+}
+
+/**
+ * @brief Constructs a SimulationClock in the given mode
+ * @param mode The clock mode
+ * @param parent The parent QObject
+ */
+SimulationClock::SimulationClock(Mode mode, QObject* parent)
+    : QObject(parent)
+    , m_mode(mode)
+    , m_timer(new QTimer(this))
+    , m_now(0)
+    , m_pacingOrigin(0)
+    , m_tickInterval(250)
+    , m_timeWarp(1.0)
+{
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &SimulationClock::catchUp);
+}
+
+/**
+ * @brief Destructor
+ */
+SimulationClock::~SimulationClock()
+{
+}
+
+SimulationClock::Mode SimulationClock::mode() const
+{
+    return m_mode;
+}
+
+qint64 SimulationClock::now() const
+{
+    return m_now;
+}
+
+int SimulationClock::tickInterval() const
+{
+    return m_tickInterval;
+}
+
+void SimulationClock::setTickInterval(int interval)
+{
+    m_tickInterval = qMax(1, interval);
+    resetPacing();
+}
+
+double SimulationClock::timeWarp() const
+{
+    return m_timeWarp;
+}
+
+/**
+ * @brief Sets the time warp factor of a real-time clock
+ * @param warp The ratio of simulated time to wall time
+ *
+ * Negative values are treated as Unbounded. Pacing restarts from the current
+ * simulated time so a change never causes a burst of catch-up ticks.
+ */
+void SimulationClock::setTimeWarp(double warp)
+{
+    warp = qMax(Unbounded, warp);
+    if (!qFuzzyCompare(warp, m_timeWarp))
+    {
+        m_timeWarp = warp;
+        resetPacing();
+        emit timeWarpChanged(m_timeWarp);
+    }
+}
+
+bool SimulationClock::isRunning() const
+{
+    return m_timer->isActive();
+}
+
+/**
+ * @brief Starts pacing ticks against the wall clock
+ */
+void SimulationClock::start()
+{
+    if (m_mode != RealTime || isRunning())
+    {
+        return;
+    }
+
+    m_timer->start();
+    resetPacing();
+    emit runningChanged(true);
+}
+
+/**
+ * @brief Stops a real-time clock
+ *
+ * Simulated time is preserved, so a subsequent start() resumes where the
+ * clock left off.
+ */
+void SimulationClock::stop()
+{
+    if (isRunning())
+    {
+        m_timer->stop();
+        emit runningChanged(false);
+    }
+}
+
+/**
+ * @brief Synchronously emits a number of ticks
+ * @param count The number of ticks to emit
+ *
+ * Each tick advances simulated time by tickInterval() before tick() is
+ * emitted, so handlers observe the time at the end of the tick.
+ */
+void SimulationClock::step(int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        m_now += m_tickInterval;
+        emit tick(m_tickInterval);
+    }
+}
+
+/**
+ * @brief Synchronously emits enough ticks to cover a span of simulated time
+ * @param duration The simulated time to advance in milliseconds
+ *
+ * The duration is rounded up to a whole number of ticks.
+ */
+void SimulationClock::advance(qint64 duration)
+{
+    step(static_cast<int>((duration + m_tickInterval - 1) / m_tickInterval));
+}
+
+/**
+ * @brief Emits the ticks that are due according to the wall clock
+ *
+ * With an unbounded warp one tick is emitted per timer event. Otherwise the
+ * number of ticks due is derived from the scaled wall time, so late timer
+ * events are caught up rather than lost. At most MAX_CATCH_UP_TICKS are
+ * emitted per event to keep the event loop responsive.
+ */
+void SimulationClock::catchUp()
+{
+    if (m_timeWarp <= Unbounded)
+    {
+        step();
+        return;
+    }
+
+    const double simulated = m_wallClock.nsecsElapsed() / 1e6 * m_timeWarp;
+    const qint64 target = m_pacingOrigin + static_cast<qint64>(simulated);
+    const int due = static_cast<int>((target - m_now) / m_tickInterval);
+
+    if (due > MAX_CATCH_UP_TICKS)
+    {
+        // Drop the backlog instead of spiralling further behind
+        step(MAX_CATCH_UP_TICKS);
+        resetPacing();
+        return;
+    }
+
+    step(due);
+}
+
+/**
+ * @brief Restarts wall-clock pacing from the current simulated time
+ *
+ * Also adjusts the timer interval so it fires roughly once per tick, or
+ * whenever the event loop is idle for an unbounded warp.
+ */
+void SimulationClock::resetPacing()
+{
+    m_pacingOrigin = m_now;
+    m_wallClock.start();
+
+    // Clamped before the conversion, which overflows for tiny warps
+    const int interval = m_timeWarp <= Unbounded
+                             ? 0
+                             : qFloor(qBound(1.0, m_tickInterval / m_timeWarp, double(INT_MAX)));
+    m_timer->setInterval(interval);
+}
@@ -0,0 +1,189 @@
+#ifndef SIMULATIONCLOCK_HPP
+#define SIMULATIONCLOCK_HPP
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/**
+ * @class SimulationClock
+ * @brief Drives simulations with fixed ticks of simulated time
+ *
+ * The clock emits tick() signals, each representing tickInterval()
+ * milliseconds of simulated time. It can run in one of two modes:
+ *
+ * - RealTime: ticks are paced against the wall clock, scaled by timeWarp().
+ *   A warp of 1.0 is real time, 10.0 runs ten times faster, and a warp of
+ *   0 (Unbounded) ticks as fast as the event loop allows.
+ * - Manual: nothing happens until step() or advance() is called, which emit
+ *   the requested ticks synchronously. This makes simulations fully
+ *   deterministic and as fast as the CPU allows, which is what tests use.
+ *
+ * Simulators take a SimulationClock instead of creating their own QTimers
+ * so that the same scenario can run live, time-warped or stepped.
+ */
+class SimulationClock : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(double timeWarp READ timeWarp WRITE setTimeWarp NOTIFY timeWarpChanged)
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+
+public:
+    /**
+     * @enum Mode
+     * @brief How the clock advances
+     *
+     * @value RealTime Ticks are paced against the wall clock scaled by the time warp
+     * @value Manual Ticks are only emitted by step() and advance()
+     */
+    enum Mode {
+        RealTime,
+        Manual
+    };
+    Q_ENUM(Mode)
+
+    /** @brief Time warp value that runs a real-time clock as fast as possible */
+    static constexpr double Unbounded = 0.0;
+
+    /**
+     * @brief Constructs a real-time SimulationClock with a time warp of 1.0
+     * @param parent The parent QObject
+     */
+    explicit SimulationClock(QObject* parent = nullptr);
+
+    /**
+     * @brief Constructs a SimulationClock in the given mode
+     * @param mode The clock mode
+     * @param parent The parent QObject
+     */
+    explicit SimulationClock(Mode mode, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~SimulationClock();
+
+    /**
+     * @brief Gets the clock mode
+     * @return The mode the clock was created with
+     */
+    Mode mode() const;
+
+    /**
+     * @brief Gets the simulated time elapsed since the clock was created
+     * @return Simulated time in milliseconds
+     */
+    qint64 now() const;
+
+    /**
+     * @brief Gets the amount of simulated time represented by one tick
+     * @return Tick interval in milliseconds
+     */
+    int tickInterval() const;
+
+    /**
+     * @brief Sets the amount of simulated time represented by one tick
+     * @param interval Tick interval in milliseconds (at least 1)
+     */
+    void setTickInterval(int interval);
+
+    /**
+     * @brief Gets the time warp factor of a real-time clock
+     * @return The ratio of simulated time to wall time, or Unbounded
+     */
+    double timeWarp() const;
+
+    /**
+     * @brief Sets the time warp factor of a real-time clock
+     * @param warp The ratio of simulated time to wall time; 0 (Unbounded)
+     * ticks as fast as the event loop allows
+     */
+    void setTimeWarp(double warp);
+
+    /**
+     * @brief Gets whether a real-time clock is currently ticking
+     * @return True if running, false otherwise
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Starts pacing ticks against the wall clock
+     *
+     * Has no effect on a manual clock.
+     */
+    void start();
+
+    /**
+     * @brief Stops a real-time clock
+     */
+    void stop();
+
+    /**
+     * @brief Synchronously emits a number of ticks
+     * @param count The number of ticks to emit
+     */
+    void step(int count = 1);
+
+    /**
+     * @brief Synchronously emits enough ticks to cover a span of simulated time
+     * @param duration The simulated time to advance in milliseconds
+     */
+    void advance(qint64 duration);
+
+signals:
+    /**
+     * @brief Emitted for every tick of simulated time
+     * @param dtMs The simulated time covered by this tick in milliseconds
+     */
+    void tick(int dtMs);
+
+    /**
+     * @brief Emitted when the time warp changes
+     * @param warp The new time warp
+     */
+    void timeWarpChanged(double warp);
+
+    /**
+     * @brief Emitted when a real-time clock starts or stops
+     * @param running The new running state
+     */
+    void runningChanged(bool running);
+
+private:
+    /**
+     * @brief Emits the ticks that are due according to the wall clock
+     */
+    void catchUp();
+
+    /**
+     * @brief Restarts wall-clock pacing from the current simulated time
+     */
+    void resetPacing();
+
+    /** @brief The clock mode */
+    Mode m_mode;
+
+    /** @brief Timer pacing a real-time clock */
+    QTimer* m_timer;
+
+    /** @brief Wall time since pacing was last reset */
+    QElapsedTimer m_wallClock;
+
+    /** @brief Simulated time in milliseconds */
+    qint64 m_now;
+
+    /** @brief Simulated time at which pacing was last reset */
+    qint64 m_pacingOrigin;
+
+    /** @brief Simulated milliseconds per tick */
+    int m_tickInterval;
+
+    /** @brief Ratio of simulated time to wall time */
+    double m_timeWarp;
+
+    /** @brief Maximum number of ticks emitted per timer event to avoid spiralling */
+    static constexpr int MAX_CATCH_UP_TICKS = 1000;
+};
+
+#endif // SIMULATIONCLOCK_HPP
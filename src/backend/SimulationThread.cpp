@@ -0,0 +1,93 @@
+#include "SimulationThread.hpp"
+#include "SimulationClock.hpp"
+#include <QThread>
+
+/**
+ * @brief Constructs the thread and its clock
+ * @param parent The parent QObject
+ *
+ * The clock has no parent so it can be moved to the worker thread; its
+ * timer is a child of the clock and moves along with it.
+ */
+SimulationThread::SimulationThread(QObject* parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_clock(new SimulationClock)
+{
+    m_thread->setObjectName(QStringLiteral("SimulationThread"));
+    m_clock->moveToThread(m_thread);
+}
+
+/**
+ * @brief Destructor
+ *
+ * The clock is deleted after the thread has finished, so nothing can be
+ * ticking any more.
+ */
+SimulationThread::~SimulationThread()
+{
+    stop();
+    delete m_clock;
+}
+
+SimulationClock* SimulationThread::clock() const
+{
+    return m_clock;
+}
+
+/**
+ * @brief Sets the time warp of the clock
+ * @param warp The ratio of simulated time to wall time
+ *
+ * The clock is only touched on its own thread once that thread runs.
+ */
+void SimulationThread::setTimeWarp(double warp)
+{
+    if (!m_thread->isRunning()) {
+        m_clock->setTimeWarp(warp);
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_clock, [this, warp]() {
+        m_clock->setTimeWarp(warp);
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Starts the worker thread and the clock
+ */
+void SimulationThread::start()
+{
+    if (m_thread->isRunning()) {
+        return;
+    }
+
+    m_thread->start();
+    QMetaObject::invokeMethod(m_clock, [this]() {
+        m_clock->start();
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Stops the clock and joins the worker thread
+ *
+ * Blocks until the tick in progress, if any, has finished.
+ */
+void SimulationThread::stop()
+{
+    if (!m_thread->isRunning()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_clock, [this]() {
+        m_clock->stop();
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread->quit();
+    m_thread->wait();
+}
+
+bool SimulationThread::isRunning() const
+{
+    return m_thread->isRunning();
+}
@@ -0,0 +1,69 @@
+#ifndef SIMULATIONTHREAD_HPP
+#define SIMULATIONTHREAD_HPP
+
+#include <QObject>
+
+class QThread;
+class SimulationClock;
+
+/**
+ * @class SimulationThread
+ * @brief Runs a real-time SimulationClock on a dedicated worker thread
+ *
+ * A TelemetryDataSimulator driven by clock() steps its physics on the
+ * worker thread and hands the results to the GUI thread without locks, so
+ * a busy render loop never delays the simulation and vice versa.
+ */
+class SimulationThread : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs the thread and its clock; nothing runs until start()
+     * @param parent The parent QObject
+     */
+    explicit SimulationThread(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor, stops the thread
+     */
+    virtual ~SimulationThread();
+
+    /**
+     * @brief Gets the clock living on the worker thread
+     * @return The clock, owned by this object
+     */
+    SimulationClock* clock() const;
+
+    /**
+     * @brief Sets the time warp of the clock
+     * @param warp The ratio of simulated time to wall time
+     */
+    void setTimeWarp(double warp);
+
+    /**
+     * @brief Starts the worker thread and the clock
+     */
+    void start();
+
+    /**
+     * @brief Stops the clock and joins the worker thread
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the worker thread is running
+     * @return True if running
+     */
+    bool isRunning() const;
+
+private:
+    /** @brief The worker thread */
+    QThread* m_thread;
+
+    /** @brief The clock, moved to the worker thread */
+    SimulationClock* m_clock;
+};
+
+#endif // SIMULATIONTHREAD_HPP
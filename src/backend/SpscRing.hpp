@@ -0,0 +1,101 @@
+#ifndef SPSCRING_HPP
+#define SPSCRING_HPP
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @class SpscRing
+ * @brief Bounded lock-free queue between one producer and one consumer
+ *
+ * Unlike TripleBuffer, every pushed value is delivered, in order. The ring
+ * has a fixed capacity and never allocates; push() fails instead of
+ * blocking when the ring is full.
+ *
+ * Exactly one thread may call push() and exactly one thread pop().
+ *
+ * @tparam T The value type; it is copied into preallocated slots
+ * @tparam Capacity Number of slots, a power of two
+ */
+template <typename T, int Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructs an empty ring
+     */
+    SpscRing()
+        : m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    /**
+     * @brief Appends a value (producer)
+     * @param value The value
+     * @return False if the ring is full and the value was not added
+     */
+    bool push(const T& value)
+    {
+        const quint32 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == static_cast<quint32>(Capacity)) {
+            return false;
+        }
+
+        m_slots[head & MASK] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest value (consumer)
+     * @param out Receives the value
+     * @return False if the ring is empty
+     */
+    bool pop(T& out)
+    {
+        const quint32 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        out = m_slots[tail & MASK];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the ring is empty
+     * @return True if there is nothing to pop; exact only on the consumer thread
+     */
+    bool isEmpty() const
+    {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the number of slots
+     * @return The ring capacity
+     */
+    static constexpr int capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    /** @brief Mask mapping a position to its slot */
+    static constexpr quint32 MASK = Capacity - 1;
+
+    /** @brief Position of the next push, written by the producer */
+    alignas(64) std::atomic<quint32> m_head;
+
+    /** @brief Position of the next pop, written by the consumer */
+    alignas(64) std::atomic<quint32> m_tail;
+
+    /** @brief The slots */
+    alignas(64) T m_slots[Capacity];
+};
+
+#endif // SPSCRING_HPP
@@ -0,0 +1,320 @@
+#include "TelemetryBus.hpp"
+#include "TelemetrySubscriber.hpp"
+#include "TelemetryData.hpp"
+#include "FleetSimulator.hpp"
+#include "FleetStateStore.hpp"
+#include <QMutexLocker>
+#include <algorithm>
+
+/**
+ * @brief Constructs a bus without subscribers
+ * @param parent The parent QObject
+ */
+TelemetryBus::TelemetryBus(QObject* parent)
+    : QObject(parent)
+    , m_mailboxes(std::make_shared<const std::vector<std::shared_ptr<Mailbox>>>())
+    , m_frameSubscribers(0)
+    , m_transitionSubscribers(0)
+{
+    qRegisterMetaType<TelemetryBus::FrameBatchPointer>();
+    qRegisterMetaType<TelemetryBus::TransitionBatchPointer>();
+}
+
+/**
+ * @brief Destructor
+ *
+ * Must run on the thread that subscribes and destroys the subscribers.
+ * Deliveries already posted find no mailbox and do nothing.
+ */
+TelemetryBus::~TelemetryBus()
+{
+    for (const std::shared_ptr<Mailbox>& mailbox : *mailboxes()) {
+        QMutexLocker locker(&mailbox->mutex);
+        if (mailbox->subscriber) {
+            mailbox->subscriber->m_bus = nullptr;
+            mailbox->subscriber->m_mailbox.reset();
+            mailbox->subscriber = nullptr;
+        }
+        mailbox->frames.reset();
+        mailbox->transitions.clear();
+    }
+}
+
+void TelemetryBus::subscribe(TelemetrySubscriber* subscriber)
+{
+    if (subscriber->m_bus) {
+        subscriber->m_bus->unsubscribe(subscriber);
+    }
+
+    auto mailbox = std::make_shared<Mailbox>();
+    mailbox->subscriber = subscriber;
+    mailbox->topics = subscriber->topics();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto list = std::make_shared<std::vector<std::shared_ptr<Mailbox>>>(*m_mailboxes);
+        list->push_back(mailbox);
+        m_mailboxes = list;
+        m_frameSubscribers += mailbox->topics.testFlag(Frames) ? 1 : 0;
+        m_transitionSubscribers += mailbox->topics.testFlag(Transitions) ? 1 : 0;
+    }
+
+    subscriber->m_bus = this;
+    subscriber->m_mailbox = mailbox;
+}
+
+/**
+ * @brief Stops delivering to a subscriber
+ * @param subscriber The subscriber
+ *
+ * Producers publishing concurrently either still see the mailbox and find
+ * it closed, or no longer see it at all.
+ */
+void TelemetryBus::unsubscribe(TelemetrySubscriber* subscriber)
+{
+    if (subscriber->m_bus != this) {
+        return;
+    }
+
+    const std::shared_ptr<Mailbox> mailbox = subscriber->m_mailbox;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto list = std::make_shared<std::vector<std::shared_ptr<Mailbox>>>(*m_mailboxes);
+        list->erase(std::remove(list->begin(), list->end(), mailbox), list->end());
+        m_mailboxes = list;
+        m_frameSubscribers -= mailbox->topics.testFlag(Frames) ? 1 : 0;
+        m_transitionSubscribers -= mailbox->topics.testFlag(Transitions) ? 1 : 0;
+    }
+
+    FrameBatchPointer frames;
+    std::vector<TransitionBatchPointer> transitions;
+    {
+        QMutexLocker locker(&mailbox->mutex);
+        mailbox->subscriber = nullptr;
+        frames.swap(mailbox->frames);
+        transitions.swap(mailbox->transitions);
+    }
+
+    subscriber->m_bus = nullptr;
+    subscriber->m_mailbox.reset();
+}
+
+int TelemetryBus::subscriberCount() const
+{
+    return static_cast<int>(mailboxes()->size());
+}
+
+bool TelemetryBus::hasSubscribers(Topic topic) const
+{
+    switch (topic) {
+    case Frames:
+        return m_frameSubscribers.load(std::memory_order_relaxed) > 0;
+    case Transitions:
+        return m_transitionSubscribers.load(std::memory_order_relaxed) > 0;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Publishes a frame batch to the Frames topic
+ * @param batch The batch; it must not be modified afterwards
+ *
+ * A batch still waiting in a mailbox is replaced and counted as dropped.
+ * It is released after the mailbox is unlocked, so freeing a large batch
+ * never holds up the subscriber.
+ */
+void TelemetryBus::publishFrames(const FrameBatchPointer& batch)
+{
+    for (const std::shared_ptr<Mailbox>& mailbox : *mailboxes()) {
+        if (!mailbox->topics.testFlag(Frames)) {
+            continue;
+        }
+
+        FrameBatchPointer replaced = batch;
+        QMutexLocker locker(&mailbox->mutex);
+        if (mailbox->frames) {
+            ++mailbox->droppedFrames;
+        }
+        mailbox->frames.swap(replaced);
+        schedule(*mailbox);
+    }
+}
+
+/**
+ * @brief Publishes transitions to the Transitions topic
+ * @param transitions The transitions, ordered by time; they must not be modified afterwards
+ *
+ * Transitions are not replaced like frames. A mailbox that already holds
+ * MAX_PENDING_TRANSITIONS batches drops its oldest one, so a stalled
+ * subscriber holds on to a bounded amount of memory.
+ */
+void TelemetryBus::publishTransitions(const TransitionBatchPointer& transitions)
+{
+    for (const std::shared_ptr<Mailbox>& mailbox : *mailboxes()) {
+        if (!mailbox->topics.testFlag(Transitions)) {
+            continue;
+        }
+
+        TransitionBatchPointer dropped;
+        QMutexLocker locker(&mailbox->mutex);
+        if (mailbox->transitions.size() >= static_cast<size_t>(MAX_PENDING_TRANSITIONS)) {
+            dropped.swap(mailbox->transitions.front());
+            mailbox->transitions.erase(mailbox->transitions.begin());
+            ++mailbox->droppedTransitions;
+        }
+        mailbox->transitions.push_back(transitions);
+        schedule(*mailbox);
+    }
+}
+
+/**
+ * @brief Publishes every frame and state change of a telemetry source
+ * @param source The source; it is detached when destroyed
+ * @param vehicle The vehicle id to publish under
+ *
+ * Publishing runs directly on the source's thread. Nothing is allocated
+ * for topics without subscribers.
+ */
+void TelemetryBus::attach(TelemetryData* source, quint32 vehicle)
+{
+    detach(source);
+
+    auto entry = std::make_unique<Source>();
+    entry->object = source;
+    entry->connections.append(connect(source, &TelemetryData::frameChanged, this,
+        [this, vehicle](const TelemetryFrame& frame) {
+            if (!hasSubscribers(Frames)) {
+                return;
+            }
+            auto batch = std::make_shared<FrameBatch>();
+            batch->timestamp = frame.timestamp;
+            batch->frames.push_back({vehicle, frame});
+            publishFrames(batch);
+        }, Qt::DirectConnection));
+    entry->connections.append(connect(source, &TelemetryData::stateChanged, this,
+        [this, source, vehicle](UASState::State state) {
+            if (!hasSubscribers(Transitions)) {
+                return;
+            }
+            publishTransitions(std::make_shared<const std::vector<Transition>>(
+                1, Transition{vehicle, state, source->frame().timestamp}));
+        }, Qt::DirectConnection));
+    entry->connections.append(connect(source, &QObject::destroyed, this,
+        [this, source]() {
+            detach(source);
+        }));
+    m_sources.push_back(std::move(entry));
+}
+
+/**
+ * @brief Publishes all vehicles of a fleet after every tick
+ * @param fleet The fleet; it is detached when destroyed
+ *
+ * Publishing runs directly within the tick, after the fleet has stepped.
+ */
+void TelemetryBus::attach(FleetSimulator* fleet)
+{
+    detach(fleet);
+
+    auto entry = std::make_unique<Source>();
+    entry->object = fleet;
+    const quint8* states = fleet->stateStore()->states();
+    entry->states.assign(states, states + fleet->vehicleCount());
+
+    std::vector<quint8>* lastStates = &entry->states;
+    entry->connections.append(connect(fleet, &FleetSimulator::stepped, this,
+        [this, fleet, lastStates]() {
+            publishFleet(fleet, *lastStates);
+        }, Qt::DirectConnection));
+    entry->connections.append(connect(fleet, &QObject::destroyed, this,
+        [this, fleet]() {
+            detach(fleet);
+        }));
+    m_sources.push_back(std::move(entry));
+}
+
+void TelemetryBus::detach(QObject* source)
+{
+    m_sources.erase(std::remove_if(m_sources.begin(), m_sources.end(),
+        [this, source](const std::unique_ptr<Source>& entry) {
+            if (entry->object != source) {
+                return false;
+            }
+            for (const QMetaObject::Connection& connection : entry->connections) {
+                disconnect(connection);
+            }
+            return true;
+        }), m_sources.end());
+}
+
+/**
+ * @brief Builds and publishes the batches of one fleet tick
+ * @param fleet The fleet
+ * @param states States of the previous tick, updated to the current ones
+ *
+ * The states are compared on every tick, even without subscribers, so that
+ * a subscriber joining later is not sent the changes of all earlier ticks.
+ * Vehicles added since the previous tick start without a transition.
+ */
+void TelemetryBus::publishFleet(FleetSimulator* fleet, std::vector<quint8>& states)
+{
+    const int count = fleet->vehicleCount();
+    const qint64 timestamp = fleet->simulatedTime();
+    const quint8* current = fleet->stateStore()->states();
+
+    if (hasSubscribers(Transitions)) {
+        auto transitions = std::make_shared<std::vector<Transition>>();
+        const int known = std::min(count, static_cast<int>(states.size()));
+        for (int i = 0; i < known; ++i) {
+            if (current[i] != states[i]) {
+                transitions->push_back({static_cast<quint32>(i), static_cast<UASState::State>(current[i]), timestamp});
+            }
+        }
+        if (!transitions->empty()) {
+            publishTransitions(transitions);
+        }
+    }
+    states.assign(current, current + count);
+
+    if (hasSubscribers(Frames)) {
+        auto batch = std::make_shared<FrameBatch>();
+        batch->timestamp = timestamp;
+        batch->frames.resize(count);
+        for (int i = 0; i < count; ++i) {
+            VehicleFrame& entry = batch->frames[i];
+            entry.vehicle = static_cast<quint32>(i);
+            entry.frame.timestamp = timestamp;
+            entry.frame.setBattery(qRound(fleet->battery(i)));
+            entry.frame.setAltitude(qRound(fleet->altitude(i)));
+            entry.frame.setSpeed(qRound(fleet->speed(i)));
+            entry.frame.setPosition(fleet->latitude(i), fleet->longitude(i));
+        }
+        publishFrames(batch);
+    }
+}
+
+/**
+ * @brief Posts a delivery to a mailbox's subscriber unless one is pending
+ * @param mailbox The mailbox, locked by the caller
+ *
+ * The delivery is always queued, even on the subscriber's own thread, so
+ * the producer never runs subscriber code. At most one delivery per
+ * subscriber is queued at a time, however much is published meanwhile.
+ */
+void TelemetryBus::schedule(Mailbox& mailbox)
+{
+    if (mailbox.scheduled || !mailbox.subscriber) {
+        return;
+    }
+
+    mailbox.scheduled = true;
+    TelemetrySubscriber* subscriber = mailbox.subscriber;
+    QMetaObject::invokeMethod(subscriber, [subscriber]() { subscriber->deliver(); }, Qt::QueuedConnection);
+}
+
+std::shared_ptr<const std::vector<std::shared_ptr<TelemetryBus::Mailbox>>> TelemetryBus::mailboxes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_mailboxes;
+}
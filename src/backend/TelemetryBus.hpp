@@ -0,0 +1,259 @@
+#ifndef TELEMETRYBUS_HPP
+#define TELEMETRYBUS_HPP
+
+#include <QObject>
+#include <QMutex>
+#include <QVector>
+#include <QMetaType>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "TelemetryFrame.hpp"
+#include "UASStateMachine.hpp"
+
+class FleetSimulator;
+class TelemetryData;
+class TelemetrySubscriber;
+
+/**
+ * @class TelemetryBus
+ * @brief In-process publish/subscribe bus for telemetry frames and state transitions
+ *
+ * Producers publish batches, one per tick: all frames of the tick on the
+ * Frames topic and all state transitions on the Transitions topic. A batch
+ * is allocated once and shared read-only by every subscriber, so the cost
+ * of publishing does not grow with the size of the batch times the number
+ * of subscribers.
+ *
+ * Each TelemetrySubscriber has a mailbox on the bus. Publishing only swaps
+ * the batch into the mailboxes under a short lock and posts a single
+ * delivery event to subscribers that have none pending; it never waits
+ * for a subscriber to run. A subscriber that falls behind, or whose
+ * maximum rate is lower than the tick rate, only sees the latest frame
+ * batch, while transition batches are kept in order up to a limit. Slow
+ * subscribers therefore neither stall the producer nor each other.
+ *
+ * Publishing is thread-safe; subscribers are delivered on their own thread.
+ */
+class TelemetryBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Topic
+     * @brief Bit flags identifying what a subscriber receives
+     */
+    enum Topic {
+        NoTopics = 0,
+        Frames = 1 << 0,
+        Transitions = 1 << 1,
+        AllTopics = Frames | Transitions
+    };
+    Q_DECLARE_FLAGS(Topics, Topic)
+
+    /**
+     * @struct VehicleFrame
+     * @brief The telemetry frame of one vehicle
+     */
+    struct VehicleFrame
+    {
+        /** @brief Vehicle id, e.g. the fleet index */
+        quint32 vehicle;
+
+        /** @brief The frame */
+        TelemetryFrame frame;
+    };
+
+    /**
+     * @struct FrameBatch
+     * @brief Frames published together in one tick
+     */
+    struct FrameBatch
+    {
+        /** @brief Source time of the tick in milliseconds */
+        qint64 timestamp = 0;
+
+        /** @brief One frame per vehicle that reported in the tick */
+        std::vector<VehicleFrame> frames;
+    };
+
+    /**
+     * @struct Transition
+     * @brief A state change of one vehicle
+     */
+    struct Transition
+    {
+        /** @brief Vehicle id, e.g. the fleet index */
+        quint32 vehicle;
+
+        /** @brief The state entered */
+        UASState::State state;
+
+        /** @brief Source time of the change in milliseconds */
+        qint64 timestamp;
+    };
+
+    /** @brief A published frame batch, shared by all subscribers */
+    using FrameBatchPointer = std::shared_ptr<const FrameBatch>;
+
+    /** @brief Published transitions, shared by all subscribers */
+    using TransitionBatchPointer = std::shared_ptr<const std::vector<Transition>>;
+
+    /** @brief Transition batches a mailbox holds before dropping the oldest */
+    static constexpr int MAX_PENDING_TRANSITIONS = 256;
+
+    /**
+     * @brief Constructs a bus without subscribers
+     * @param parent The parent QObject
+     */
+    explicit TelemetryBus(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Detaches the remaining subscribers; they stay valid but receive nothing.
+     */
+    virtual ~TelemetryBus();
+
+    /**
+     * @brief Delivers published batches to a subscriber
+     * @param subscriber The subscriber; it unsubscribes itself when destroyed
+     *
+     * A subscriber belongs to at most one bus; subscribing to another one
+     * moves it.
+     */
+    void subscribe(TelemetrySubscriber* subscriber);
+
+    /**
+     * @brief Stops delivering to a subscriber
+     * @param subscriber The subscriber
+     *
+     * Batches already in its mailbox are discarded.
+     */
+    void unsubscribe(TelemetrySubscriber* subscriber);
+
+    /**
+     * @brief Gets the number of subscribers
+     * @return The subscriber count
+     */
+    int subscriberCount() const;
+
+    /**
+     * @brief Checks whether any subscriber receives a topic
+     * @param topic The topic
+     * @return True if publishing on the topic reaches someone
+     *
+     * Producers use this to skip building batches nobody receives.
+     */
+    bool hasSubscribers(Topic topic) const;
+
+    /**
+     * @brief Publishes a frame batch to the Frames topic
+     * @param batch The batch; it must not be modified afterwards
+     */
+    void publishFrames(const FrameBatchPointer& batch);
+
+    /**
+     * @brief Publishes transitions to the Transitions topic
+     * @param transitions The transitions, ordered by time; they must not be modified afterwards
+     */
+    void publishTransitions(const TransitionBatchPointer& transitions);
+
+    /**
+     * @brief Publishes every frame and state change of a telemetry source
+     * @param source The source; it is detached when destroyed
+     * @param vehicle The vehicle id to publish under
+     */
+    void attach(TelemetryData* source, quint32 vehicle);
+
+    /**
+     * @brief Publishes all vehicles of a fleet after every tick
+     * @param fleet The fleet; it is detached when destroyed
+     *
+     * Vehicles are identified by their fleet index. Transitions are found
+     * by comparing the states with those of the previous tick.
+     */
+    void attach(FleetSimulator* fleet);
+
+    /**
+     * @brief Stops publishing a source or fleet
+     * @param source The source or fleet
+     */
+    void detach(QObject* source);
+
+private:
+    friend class TelemetrySubscriber;
+
+    /**
+     * @struct Mailbox
+     * @brief Batches waiting for one subscriber
+     *
+     * Shared between the bus and the subscriber so that neither has to
+     * outlive the other. The subscriber pointer is cleared under the lock
+     * before the subscriber goes away, so producers never post to a
+     * destroyed object.
+     */
+    struct Mailbox
+    {
+        QMutex mutex;
+        TelemetrySubscriber* subscriber = nullptr;
+        Topics topics;
+        FrameBatchPointer frames;
+        std::vector<TransitionBatchPointer> transitions;
+        quint64 droppedFrames = 0;
+        quint64 droppedTransitions = 0;
+        bool scheduled = false;
+    };
+
+    /**
+     * @struct Source
+     * @brief An attached source or fleet and its connections
+     */
+    struct Source
+    {
+        QObject* object;
+        QVector<QMetaObject::Connection> connections;
+        std::vector<quint8> states;
+    };
+
+    /**
+     * @brief Builds and publishes the batches of one fleet tick
+     * @param fleet The fleet
+     * @param states States of the previous tick, updated to the current ones
+     */
+    void publishFleet(FleetSimulator* fleet, std::vector<quint8>& states);
+
+    /**
+     * @brief Posts a delivery to a mailbox's subscriber unless one is pending
+     * @param mailbox The mailbox, locked by the caller
+     */
+    static void schedule(Mailbox& mailbox);
+
+    /**
+     * @brief Gets a snapshot of the mailboxes to publish to
+     * @return The mailboxes
+     */
+    std::shared_ptr<const std::vector<std::shared_ptr<Mailbox>>> mailboxes() const;
+
+    /** @brief Guards the mailbox list and the topic counts */
+    mutable QMutex m_mutex;
+
+    /** @brief Mailboxes of the subscribers, replaced on every change */
+    std::shared_ptr<const std::vector<std::shared_ptr<Mailbox>>> m_mailboxes;
+
+    /** @brief Number of subscribers receiving frames */
+    std::atomic<int> m_frameSubscribers;
+
+    /** @brief Number of subscribers receiving transitions */
+    std::atomic<int> m_transitionSubscribers;
+
+    /** @brief Attached sources and fleets */
+    std::vector<std::unique_ptr<Source>> m_sources;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TelemetryBus::Topics)
+Q_DECLARE_METATYPE(TelemetryBus::FrameBatchPointer)
+Q_DECLARE_METATYPE(TelemetryBus::TransitionBatchPointer)
+
+#endif // TELEMETRYBUS_HPP
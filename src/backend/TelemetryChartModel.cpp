@@ -0,0 +1,222 @@
+#include "TelemetryChartModel.hpp"
+
+/**
+ * @brief Constructs an empty model
+ * @param history The history to read, or nullptr
+ * @param parent The parent QObject
+ */
+TelemetryChartModel::TelemetryChartModel(TelemetryHistory* history, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_vehicle(0)
+    , m_resolution(DEFAULT_RESOLUTION)
+    , m_rows(DEFAULT_CAPACITY)
+    , m_first(0)
+    , m_count(0)
+    , m_end(TelemetryHistory::NO_TIMESTAMP)
+{
+    setHistory(history);
+}
+
+TelemetryHistory* TelemetryChartModel::history() const
+{
+    return m_history;
+}
+
+void TelemetryChartModel::setHistory(TelemetryHistory* history)
+{
+    if (m_history == history) {
+        return;
+    }
+
+    if (m_history) {
+        disconnect(m_history, nullptr, this, nullptr);
+    }
+    m_history = history;
+    if (m_history) {
+        connect(m_history, &TelemetryHistory::updated, this, &TelemetryChartModel::refresh);
+    }
+    reload();
+}
+
+quint32 TelemetryChartModel::vehicle() const
+{
+    return m_vehicle;
+}
+
+void TelemetryChartModel::setVehicle(quint32 vehicle)
+{
+    if (m_vehicle == vehicle) {
+        return;
+    }
+
+    m_vehicle = vehicle;
+    emit vehicleChanged();
+    reload();
+}
+
+qint64 TelemetryChartModel::resolution() const
+{
+    return m_resolution;
+}
+
+void TelemetryChartModel::setResolution(qint64 resolution)
+{
+    if (resolution <= 0 || m_resolution == resolution) {
+        return;
+    }
+
+    m_resolution = resolution;
+    emit resolutionChanged();
+    reload();
+}
+
+int TelemetryChartModel::capacity() const
+{
+    return static_cast<int>(m_rows.size());
+}
+
+void TelemetryChartModel::setCapacity(int capacity)
+{
+    if (capacity <= 0 || this->capacity() == capacity) {
+        return;
+    }
+
+    beginResetModel();
+    m_rows.assign(capacity, Row());
+    m_first = 0;
+    m_count = 0;
+    m_end = TelemetryHistory::NO_TIMESTAMP;
+    endResetModel();
+    emit capacityChanged();
+    emit countChanged();
+    refresh();
+}
+
+qint64 TelemetryChartModel::end() const
+{
+    return m_end;
+}
+
+const TelemetryChartModel::Row& TelemetryChartModel::row(int row) const
+{
+    return m_rows[position(row)];
+}
+
+int TelemetryChartModel::position(int row) const
+{
+    return (m_first + row) % capacity();
+}
+
+int TelemetryChartModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant TelemetryChartModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const Row& entry = row(index.row());
+    switch (role) {
+    case TimestampRole:
+        return entry.timestamp;
+    case AltitudeRole:
+        return entry.values[TelemetryHistory::Altitude];
+    case SpeedRole:
+        return entry.values[TelemetryHistory::Speed];
+    case BatteryRole:
+        return entry.values[TelemetryHistory::Battery];
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TelemetryChartModel::roleNames() const
+{
+    return {
+        {TimestampRole, "timestamp"},
+        {AltitudeRole, "altitude"},
+        {SpeedRole, "speed"},
+        {BatteryRole, "battery"}
+    };
+}
+
+/**
+ * @brief Appends the intervals the history completed since the last call
+ *
+ * The interval of the latest sample is still filling and is appended once
+ * a later sample starts the next one. Each channel is queried once for all
+ * new intervals, so a refresh costs the number of new rows, not the
+ * capacity. Rows pushed out of the ring are removed first, in one range,
+ * and the new rows are then inserted at the end, in one range. A history
+ * that started over, e.g. after seeking a replay back, resets the model.
+ */
+void TelemetryChartModel::refresh()
+{
+    if (!m_history) {
+        return;
+    }
+
+    const qint64 latest = m_history->latestTimestamp(m_vehicle);
+    if (latest == TelemetryHistory::NO_TIMESTAMP || (m_end != TelemetryHistory::NO_TIMESTAMP && latest < m_end)) {
+        if (m_count > 0 || m_end != TelemetryHistory::NO_TIMESTAMP) {
+            reload();
+        }
+        return;
+    }
+
+    const qint64 remainder = latest % m_resolution;
+    const qint64 end = latest - (remainder < 0 ? remainder + m_resolution : remainder);
+    const qint64 window = capacity() * m_resolution;
+    qint64 from = (m_end == TelemetryHistory::NO_TIMESTAMP) ? end - window : m_end;
+    from = qMax(from, end - window);
+    if (from >= end) {
+        return;
+    }
+
+    std::array<std::vector<TelemetryHistory::Point>, TelemetryHistory::ChannelCount> points;
+    const int intervals = static_cast<int>((end - from) / m_resolution);
+    for (int channel = 0; channel < TelemetryHistory::ChannelCount; ++channel) {
+        points[channel] = m_history->query(m_vehicle, static_cast<TelemetryHistory::Channel>(channel), from, end, intervals);
+    }
+    m_end = end;
+
+    // Every sample carries all channels, so all channels have the same intervals
+    const int added = static_cast<int>(points[TelemetryHistory::Altitude].size());
+    if (added == 0) {
+        return;
+    }
+
+    const int overflow = m_count + added - capacity();
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_first = (m_first + overflow) % capacity();
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + added - 1);
+    for (int index = 0; index < added; ++index) {
+        Row& entry = m_rows[position(m_count)];
+        entry.timestamp = points[TelemetryHistory::Altitude][index].timestamp;
+        for (int channel = 0; channel < TelemetryHistory::ChannelCount; ++channel) {
+            entry.values[channel] = points[channel][index].average;
+        }
+        ++m_count;
+    }
+    endInsertRows();
+    emit countChanged();
+}
+
+void TelemetryChartModel::reload()
+{
+    beginResetModel();
+    m_first = 0;
+    m_count = 0;
+    m_end = TelemetryHistory::NO_TIMESTAMP;
+    endResetModel();
+    emit countChanged();
+    refresh();
+}
@@ -0,0 +1,218 @@
+#ifndef TELEMETRYCHARTMODEL_HPP
+#define TELEMETRYCHARTMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <array>
+#include <vector>
+#include "TelemetryHistory.hpp"
+
+/**
+ * @class TelemetryChartModel
+ * @brief List model of the recent trend of one vehicle, for charts
+ *
+ * Each row is one interval of the resolution, with the average altitude,
+ * speed and battery of the vehicle over it. Rows are read from a
+ * TelemetryHistory when it is updated, one per completed interval, and are
+ * kept in a ring of fixed capacity: the model only ever appends rows at
+ * the end and removes the oldest rows from the front, and announces both
+ * as row ranges. Views therefore never rebuild the whole series; see
+ * TelemetrySeriesItem for a chart that only writes the new vertices.
+ *
+ * Changing the vehicle, the resolution or the capacity resets the model.
+ */
+class TelemetryChartModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(quint32 vehicle READ vehicle WRITE setVehicle NOTIFY vehicleChanged)
+    Q_PROPERTY(qint64 resolution READ resolution WRITE setResolution NOTIFY resolutionChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    /**
+     * @enum Role
+     * @brief The data roles of a row
+     */
+    enum Role {
+        TimestampRole = Qt::UserRole + 1,
+        AltitudeRole,
+        SpeedRole,
+        BatteryRole
+    };
+
+    /**
+     * @struct Row
+     * @brief One interval of the trend
+     */
+    struct Row
+    {
+        /** @brief Start of the interval in milliseconds */
+        qint64 timestamp;
+
+        /** @brief Average of every channel, indexed by TelemetryHistory::Channel */
+        std::array<float, TelemetryHistory::ChannelCount> values;
+    };
+
+    /** @brief Default length of an interval in milliseconds */
+    static constexpr qint64 DEFAULT_RESOLUTION = 1000;
+
+    /** @brief Default number of rows kept */
+    static constexpr int DEFAULT_CAPACITY = 300;
+
+    /**
+     * @brief Constructs an empty model
+     * @param history The history to read, or nullptr
+     * @param parent The parent QObject
+     */
+    explicit TelemetryChartModel(TelemetryHistory* history = nullptr, QObject* parent = nullptr);
+
+    /**
+     * @brief Gets the history the rows are read from
+     * @return The history, or nullptr
+     */
+    TelemetryHistory* history() const;
+
+    /**
+     * @brief Sets the history the rows are read from
+     * @param history The history, or nullptr
+     */
+    void setHistory(TelemetryHistory* history);
+
+    /**
+     * @brief Gets the vehicle whose trend is shown
+     * @return The vehicle id
+     */
+    quint32 vehicle() const;
+
+    /**
+     * @brief Sets the vehicle whose trend is shown
+     * @param vehicle The vehicle id
+     */
+    void setVehicle(quint32 vehicle);
+
+    /**
+     * @brief Gets the length of the interval of a row
+     * @return The resolution in milliseconds
+     */
+    qint64 resolution() const;
+
+    /**
+     * @brief Sets the length of the interval of a row
+     * @param resolution The resolution in milliseconds, positive
+     */
+    void setResolution(qint64 resolution);
+
+    /**
+     * @brief Gets the number of rows kept
+     * @return The capacity
+     */
+    int capacity() const;
+
+    /**
+     * @brief Sets the number of rows kept
+     * @param capacity The capacity, positive
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief Gets the end of the latest row's interval
+     * @return The end in milliseconds, or TelemetryHistory::NO_TIMESTAMP if there are no rows
+     */
+    qint64 end() const;
+
+    /**
+     * @brief Gets a row
+     * @param row The row index, in [0, rowCount())
+     * @return The row
+     */
+    const Row& row(int row) const;
+
+    /**
+     * @brief Gets the ring position of a row
+     * @param row The row index, in [0, rowCount())
+     * @return The position in [0, capacity())
+     *
+     * A row keeps its position until it is removed, and a new row takes
+     * the position of the row it pushes out, so views can keep per-row
+     * data in a ring of the same capacity.
+     */
+    int position(int row) const;
+
+    /**
+     * @brief Gets the number of rows
+     * @param parent Unused; the model is a flat list
+     * @return The row count
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Gets the data of a row
+     * @param index The row
+     * @param role A Role
+     * @return The data, or an invalid QVariant
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Gets the QML names of the roles
+     * @return The role names
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+public slots:
+    /**
+     * @brief Appends the intervals the history completed since the last call
+     */
+    void refresh();
+
+signals:
+    /**
+     * @brief Emitted when the vehicle changes
+     */
+    void vehicleChanged();
+
+    /**
+     * @brief Emitted when the resolution changes
+     */
+    void resolutionChanged();
+
+    /**
+     * @brief Emitted when the capacity changes
+     */
+    void capacityChanged();
+
+    /**
+     * @brief Emitted when rows were appended, removed or reset
+     */
+    void countChanged();
+
+private:
+    /**
+     * @brief Removes all rows and reads the history again
+     */
+    void reload();
+
+    /** @brief History the rows are read from */
+    QPointer<TelemetryHistory> m_history;
+
+    /** @brief Vehicle whose trend is shown */
+    quint32 m_vehicle;
+
+    /** @brief Length of a row's interval in milliseconds */
+    qint64 m_resolution;
+
+    /** @brief Ring of rows, allocated at the capacity */
+    std::vector<Row> m_rows;
+
+    /** @brief Ring position of the first row */
+    int m_first;
+
+    /** @brief Number of rows */
+    int m_count;
+
+    /** @brief End of the latest row's interval */
+    qint64 m_end;
+};
+
+#endif // TELEMETRYCHARTMODEL_HPP
@@ -1,4 +1,6 @@
 #include "TelemetryData.hpp"
+#include "EventLog.hpp"
+#include "Geofence.hpp"
 
 /**
  * @brief Constructs a TelemetryData object and creates the state machine
@@ -10,6 +12,10 @@
 TelemetryData::TelemetryData(QObject *parent)
     : QObject(parent)
     , m_stateMachine(new UASStateMachine(this))
+    , m_remainingFlightTime(-1)
+    , m_remainingRange(-1)
+    , m_geofence(nullptr)
+    , m_geofenceBreached(false)
 {
     // Connect state machine signals
     connect(m_stateMachine, &UASStateMachine::currentStateChanged,
@@ -27,6 +33,10 @@ TelemetryData::TelemetryData(QObject *parent)
 TelemetryData::TelemetryData(UASStateMachine* stateMachine, QObject *parent)
     : QObject(parent)
     , m_stateMachine(stateMachine)
+    , m_remainingFlightTime(-1)
+    , m_remainingRange(-1)
+    , m_geofence(nullptr)
+    , m_geofenceBreached(false)
 {
     // Connect state machine signals
     connect(m_stateMachine, &UASStateMachine::currentStateChanged,
@@ -40,6 +50,243 @@ TelemetryData::~TelemetryData()
 {
 }
 
+/**
+ * @brief Gets the current battery percentage
+ * @return The battery level of the last published frame
+ */
+int TelemetryData::battery() const
+{
+    return m_frame.battery;
+}
+
+/**
+ * @brief Gets the current altitude
+ * @return The altitude of the last published frame in meters
+ */
+int TelemetryData::altitude() const
+{
+    return m_frame.altitude;
+}
+
+/**
+ * @brief Gets the current speed
+ * @return The speed of the last published frame in meters per second
+ */
+int TelemetryData::speed() const
+{
+    return m_frame.speed;
+}
+
+/**
+ * @brief Gets the current position
+ * @return The position of the last published frame
+ */
+QGeoCoordinate TelemetryData::position() const
+{
+    return m_frame.position();
+}
+
+/**
+ * @brief Gets the estimated remaining flight time
+ * @return The last published estimate in seconds, or -1 if the source has no energy model
+ */
+int TelemetryData::remainingFlightTime() const
+{
+    return m_remainingFlightTime;
+}
+
+/**
+ * @brief Gets the estimated remaining range
+ * @return The last published estimate in meters, or -1 if the source has no energy model
+ */
+int TelemetryData::remainingRange() const
+{
+    return m_remainingRange;
+}
+
+bool TelemetryData::geofenceBreached() const
+{
+    return m_geofenceBreached;
+}
+
+const Geofence* TelemetryData::geofence() const
+{
+    return m_geofence;
+}
+
+/**
+ * @brief Sets the geofence positions are checked against
+ * @param geofence The geofence, or nullptr to stop checking; the caller keeps ownership
+ *
+ * The current position is checked right away. Without a geofence the
+ * vehicle is never in breach.
+ */
+void TelemetryData::setGeofence(const Geofence* geofence)
+{
+    m_geofence = geofence;
+    if (m_geofence) {
+        checkGeofence();
+    } else {
+        publishGeofenceBreach(false);
+    }
+}
+
+/**
+ * @brief Gets the last published telemetry frame
+ * @return The frame, whose dirty mask holds the fields changed by the last publication
+ */
+const TelemetryFrame& TelemetryData::frame() const
+{
+    return m_frame;
+}
+
+/**
+ * @brief Publishes a new telemetry frame
+ * @param frame The frame; only fields flagged in its dirty mask are applied
+ *
+ * Compares each dirty field against the last published value. If nothing
+ * changed no signal is emitted at all; otherwise frameChanged() is emitted
+ * once and the NOTIFY signal of each changed property follows, so QML
+ * bindings are only re-evaluated for values that actually moved.
+ */
+void TelemetryData::publishFrame(const TelemetryFrame& frame)
+{
+    quint8 changed = TelemetryFrame::NoFields;
+
+    if (frame.isDirty(TelemetryFrame::Battery) && frame.battery != m_frame.battery) {
+        m_frame.battery = frame.battery;
+        changed |= TelemetryFrame::Battery;
+    }
+
+    if (frame.isDirty(TelemetryFrame::Altitude) && frame.altitude != m_frame.altitude) {
+        m_frame.altitude = frame.altitude;
+        changed |= TelemetryFrame::Altitude;
+    }
+
+    if (frame.isDirty(TelemetryFrame::Speed) && frame.speed != m_frame.speed) {
+        m_frame.speed = frame.speed;
+        changed |= TelemetryFrame::Speed;
+    }
+
+    if (frame.isDirty(TelemetryFrame::Position) &&
+        (frame.latitude != m_frame.latitude || frame.longitude != m_frame.longitude)) {
+        m_frame.latitude = frame.latitude;
+        m_frame.longitude = frame.longitude;
+        changed |= TelemetryFrame::Position;
+    }
+
+    m_frame.timestamp = frame.timestamp;
+    m_frame.dirty = changed;
+
+    if (changed == TelemetryFrame::NoFields) {
+        return;
+    }
+
+    emit frameChanged(m_frame);
+
+    if (changed & TelemetryFrame::Battery) {
+        emit batteryChanged(m_frame.battery);
+    }
+    if (changed & TelemetryFrame::Altitude) {
+        emit altitudeChanged(m_frame.altitude);
+    }
+    if (changed & TelemetryFrame::Speed) {
+        emit speedChanged(m_frame.speed);
+    }
+    if (changed & TelemetryFrame::Position) {
+        emit positionChanged(m_frame.position());
+        if (m_geofence) {
+            checkGeofence();
+        }
+    }
+}
+
+/**
+ * @brief Publishes new endurance estimates
+ * @param flightTime Remaining flight time in seconds, -1 if unknown
+ * @param range Remaining range in meters, -1 if unknown
+ *
+ * The estimates are not part of TelemetryFrame, so they are neither
+ * recorded nor sent over the telemetry link. As with publishFrame(), only
+ * values that changed are signalled.
+ */
+void TelemetryData::publishEndurance(int flightTime, int range)
+{
+    if (flightTime != m_remainingFlightTime) {
+        m_remainingFlightTime = flightTime;
+        emit remainingFlightTimeChanged(flightTime);
+    }
+    if (range != m_remainingRange) {
+        m_remainingRange = range;
+        emit remainingRangeChanged(range);
+    }
+}
+
+void TelemetryData::publishGeofenceBreach(bool breached)
+{
+    if (breached != m_geofenceBreached) {
+        m_geofenceBreached = breached;
+        emit geofenceBreachedChanged(breached);
+    }
+}
+
+/**
+ * @brief Checks a command against the geofence
+ * @param state The state the command requests
+ * @param destination The destination of a goTo() command
+ * @return True if the command may be executed
+ *
+ * Takeoffs must start from a permitted position, and flights to a waypoint
+ * need a permitted destination reached without entering an exclusion zone.
+ * Other commands, landing in particular, are always permitted. Commands
+ * the transition rules reject anyway are left to the state machine. A
+ * command rejected here is recorded in the state machine's audit.
+ */
+bool TelemetryData::geofencePermits(UASState::State state, const QGeoCoordinate& destination)
+{
+    if (!m_geofence || !UASStateMachine::isValidTransition(this->state(), state)) {
+        return true;
+    }
+
+    bool permitted = true;
+    if (state == UASState::TakingOff) {
+        permitted = m_geofence->permits(m_frame.latitude, m_frame.longitude);
+    } else if (state == UASState::FlyingToWaypoint) {
+        permitted = m_geofence->permitsPath(m_frame.latitude, m_frame.longitude,
+                                            destination.latitude(), destination.longitude());
+    }
+
+    if (!permitted) {
+        m_stateMachine->recordRejection(state, UASState::GeofenceViolation);
+        EventLog::info(EventLog::GeofenceRejected, -1, state);
+    }
+    return permitted;
+}
+
+/**
+ * @brief Checks the last published position against the geofence
+ *
+ * With the Land breach action, a breaching vehicle is landed as soon as
+ * its state allows, overriding whatever it was commanded to do.
+ */
+void TelemetryData::checkGeofence()
+{
+    const int zone = m_geofence->breach(m_frame.latitude, m_frame.longitude);
+    const bool breached = zone != Geofence::NO_BREACH;
+
+    if (breached && !m_geofenceBreached) {
+        EventLog::info(EventLog::GeofenceBreached, -1, zone, m_frame.latitude, m_frame.longitude);
+    } else if (!breached && m_geofenceBreached) {
+        EventLog::info(EventLog::GeofenceCleared, -1, m_frame.latitude, m_frame.longitude);
+    }
+    publishGeofenceBreach(breached);
+
+    if (breached && m_geofence->breachAction() == Geofence::Land &&
+        UASStateMachine::isValidTransition(state(), UASState::Landing)) {
+        land();
+    }
+}
+
 /**
  * @brief Gets the current UAS state
  * @return The current state of the UAS state machine
@@ -5,6 +5,9 @@
 #include <QGeoCoordinate>
 #include <QtQml/qqmlregistration.h>
 #include "UASStateMachine.hpp"
+#include "TelemetryFrame.hpp"
+
+class Geofence;
 
 /**
  * @class TelemetryData
@@ -13,6 +16,18 @@
  * This abstract class defines the interface for accessing and controlling
  * the UAS telemetry data. It serves as a base class for concrete implementations
  * like TelemetryDataSimulator.
+ *
+ * Implementations publish telemetry as a TelemetryFrame once per update with
+ * publishFrame(). The frame is announced with a single frameChanged() signal
+ * and the per-property signals only fire for fields whose value changed.
+ *
+ * Sources that model the vehicle's energy also publish endurance estimates
+ * with publishEndurance(); for all others they stay unknown (-1).
+ *
+ * With setGeofence(), every published position is checked against a
+ * Geofence. Breaches are signalled and handled by the fence's breach
+ * action through the source's own land() command; sources that accept
+ * commands also check them with geofencePermits() before executing them.
  */
 class TelemetryData : public QObject
 {
@@ -24,6 +39,9 @@ class TelemetryData : public QObject
     Q_PROPERTY(QGeoCoordinate position READ position NOTIFY positionChanged)
     Q_PROPERTY(UASState::State state READ state NOTIFY stateChanged)
     Q_PROPERTY(int targetAltitude READ targetAltitude WRITE setTargetAltitude NOTIFY targetAltitudeChanged)
+    Q_PROPERTY(int remainingFlightTime READ remainingFlightTime NOTIFY remainingFlightTimeChanged)
+    Q_PROPERTY(int remainingRange READ remainingRange NOTIFY remainingRangeChanged)
+    Q_PROPERTY(bool geofenceBreached READ geofenceBreached NOTIFY geofenceBreachedChanged)
 
 public:
     /**
@@ -48,25 +66,61 @@ public:
      * @brief Gets the current battery percentage
      * @return Battery level as a percentage (0-100)
      */
-    virtual int battery() const = 0;
+    virtual int battery() const;
     
     /**
      * @brief Gets the current altitude
      * @return Altitude in meters
      */
-    virtual int altitude() const = 0;
+    virtual int altitude() const;
     
     /**
      * @brief Gets the current speed
      * @return Speed in meters per second
      */
-    virtual int speed() const = 0;
+    virtual int speed() const;
     
     /**
      * @brief Gets the current position
      * @return The current geographical coordinates
      */
-    virtual QGeoCoordinate position() const = 0;
+    virtual QGeoCoordinate position() const;
+
+    /**
+     * @brief Gets the estimated remaining flight time
+     * @return Seconds until the battery is empty, or -1 if unknown
+     */
+    int remainingFlightTime() const;
+
+    /**
+     * @brief Gets the estimated remaining range
+     * @return Meters until the battery is empty, or -1 if unknown
+     */
+    int remainingRange() const;
+
+    /**
+     * @brief Gets whether the vehicle breaches the geofence
+     * @return True if the last published position is not permitted
+     */
+    bool geofenceBreached() const;
+
+    /**
+     * @brief Gets the geofence positions are checked against
+     * @return The geofence, or nullptr if none is set
+     */
+    const Geofence* geofence() const;
+
+    /**
+     * @brief Sets the geofence positions are checked against
+     * @param geofence The geofence, or nullptr to stop checking; the caller keeps ownership
+     */
+    void setGeofence(const Geofence* geofence);
+
+    /**
+     * @brief Gets the last published telemetry frame
+     * @return The frame, whose dirty mask holds the fields changed by the last publication
+     */
+    const TelemetryFrame& frame() const;
 
     /**
      * @brief Gets the current UAS state
@@ -106,6 +160,12 @@ public:
     Q_INVOKABLE virtual void goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise);
 
 signals:
+    /**
+     * @brief Emitted once per published frame in which at least one field changed
+     * @param frame The published frame; its dirty mask holds the changed fields
+     */
+    void frameChanged(const TelemetryFrame& frame);
+
     /**
      * @brief Emitted when battery level changes
      * @param battery The new battery level
@@ -153,9 +213,83 @@ signals:
      * @param altitude The new target altitude
      */
     void targetAltitudeChanged(int altitude);
+
+    /**
+     * @brief Emitted when the remaining flight time estimate changes
+     * @param seconds The new estimate
+     */
+    void remainingFlightTimeChanged(int seconds);
+
+    /**
+     * @brief Emitted when the remaining range estimate changes
+     * @param meters The new estimate
+     */
+    void remainingRangeChanged(int meters);
+
+    /**
+     * @brief Emitted when the vehicle breaches the geofence or returns inside it
+     * @param breached True if the vehicle is in breach
+     */
+    void geofenceBreachedChanged(bool breached);
 protected:
+    /**
+     * @brief Publishes a new telemetry frame
+     * @param frame The frame; only fields flagged in its dirty mask are applied
+     *
+     * Emits frameChanged() once, followed by the per-property signals of the
+     * fields whose value actually changed. Nothing is emitted if no field
+     * changed.
+     */
+    void publishFrame(const TelemetryFrame& frame);
+
+    /**
+     * @brief Publishes new endurance estimates
+     * @param flightTime Remaining flight time in seconds, -1 if unknown
+     * @param range Remaining range in meters, -1 if unknown
+     *
+     * Emits the change signal of each estimate whose value changed.
+     */
+    void publishEndurance(int flightTime, int range);
+
+    /**
+     * @brief Publishes whether the vehicle breaches the geofence
+     * @param breached True if the vehicle is in breach
+     *
+     * Emits geofenceBreachedChanged() if the value changed.
+     */
+    void publishGeofenceBreach(bool breached);
+
+    /**
+     * @brief Checks a command against the geofence
+     * @param state The state the command requests
+     * @param destination The destination of a goTo() command
+     * @return True if the command may be executed
+     */
+    bool geofencePermits(UASState::State state, const QGeoCoordinate& destination = QGeoCoordinate());
+
     /** @brief The UAS state machine instance */
     UASStateMachine* m_stateMachine;
+
+private:
+    /**
+     * @brief Checks the last published position against the geofence
+     */
+    void checkGeofence();
+
+    /** @brief The last published telemetry frame */
+    TelemetryFrame m_frame;
+
+    /** @brief Remaining flight time in seconds, -1 if unknown */
+    int m_remainingFlightTime;
+
+    /** @brief Remaining range in meters, -1 if unknown */
+    int m_remainingRange;
+
+    /** @brief The geofence positions are checked against, not owned */
+    const Geofence* m_geofence;
+
+    /** @brief True if the vehicle breaches the geofence */
+    bool m_geofenceBreached;
 };
 
 #endif // TELEMETRYDATA_HPP
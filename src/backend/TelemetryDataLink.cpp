@@ -0,0 +1,273 @@
+#include "TelemetryDataLink.hpp"
+#include <QThread>
+#include <QTimer>
+#include <QUdpSocket>
+
+/**
+ * @brief Constructs a link for one vehicle
+ * @param vehicleId The vehicle whose frames are published
+ * @param parent The parent QObject
+ *
+ * The receive buffer is allocated here once; the I/O thread is only started
+ * by start().
+ */
+TelemetryDataLink::TelemetryDataLink(quint16 vehicleId, QObject* parent)
+    : TelemetryData(parent)
+    , m_vehicleId(vehicleId)
+    , m_ioThread(new QThread(this))
+    , m_ioContext(new QObject)
+    , m_socket(nullptr)
+    , m_receiveBuffer(RECEIVE_BUFFER_SIZE, Qt::Uninitialized)
+    , m_publishTimer(new QTimer(this))
+    , m_publishRate(DEFAULT_PUBLISH_RATE)
+    , m_localPort(0)
+    , m_targetAltitude(120)
+    , m_sequenceValid(false)
+    , m_lastSequence(0)
+    , m_framesReceived(0)
+    , m_malformedDatagrams(0)
+    , m_staleFrames(0)
+{
+    m_ioContext->moveToThread(m_ioThread);
+
+    m_publishTimer->setInterval(1000 / m_publishRate);
+    connect(m_publishTimer, &QTimer::timeout, this, &TelemetryDataLink::publishLatest);
+}
+
+/**
+ * @brief Destructor
+ *
+ * Closes the socket and joins the I/O thread before the context is deleted.
+ */
+TelemetryDataLink::~TelemetryDataLink()
+{
+    stop();
+    delete m_ioContext;
+}
+
+quint16 TelemetryDataLink::vehicleId() const
+{
+    return m_vehicleId;
+}
+
+/**
+ * @brief Binds the socket and starts receiving
+ * @param port The UDP port to listen on, 0 to pick a free one
+ * @param address The address to bind to
+ * @return True if the socket was bound
+ *
+ * The socket is created and bound on the I/O thread; this call blocks until
+ * binding has finished so the result and localPort() are known on return.
+ */
+bool TelemetryDataLink::start(quint16 port, const QHostAddress& address)
+{
+    if (isRunning()) {
+        return true;
+    }
+
+    m_ioThread->start();
+
+    bool bound = false;
+    QMetaObject::invokeMethod(m_ioContext, [this, port, address, &bound]() {
+        m_socket = new QUdpSocket(m_ioContext);
+        m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, SOCKET_BUFFER_SIZE);
+
+        if (!m_socket->bind(address, port)) {
+            qWarning() << "Cannot bind telemetry link:" << m_socket->errorString();
+            delete m_socket;
+            m_socket = nullptr;
+            return;
+        }
+
+        connect(m_socket, &QUdpSocket::readyRead, m_ioContext, [this]() {
+            readPendingDatagrams();
+        });
+        m_localPort = m_socket->localPort();
+        bound = true;
+    }, Qt::BlockingQueuedConnection);
+
+    if (!bound) {
+        m_ioThread->quit();
+        m_ioThread->wait();
+        return false;
+    }
+
+    m_publishTimer->start();
+    return true;
+}
+
+/**
+ * @brief Stops receiving and closes the socket
+ *
+ * Frames received but not yet published are discarded.
+ */
+void TelemetryDataLink::stop()
+{
+    m_publishTimer->stop();
+
+    if (!m_ioThread->isRunning()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_ioContext, [this]() {
+        delete m_socket;
+        m_socket = nullptr;
+    }, Qt::BlockingQueuedConnection);
+
+    m_ioThread->quit();
+    m_ioThread->wait();
+
+    m_localPort = 0;
+    m_sequenceValid = false;
+
+    // The I/O thread has stopped, so the consumer may drain the handoff
+    m_latest.update();
+}
+
+bool TelemetryDataLink::isRunning() const
+{
+    return m_localPort != 0;
+}
+
+quint16 TelemetryDataLink::localPort() const
+{
+    return m_localPort;
+}
+
+int TelemetryDataLink::publishRate() const
+{
+    return m_publishRate;
+}
+
+/**
+ * @brief Sets the publish rate
+ * @param rate The maximum number of frames published per second
+ *
+ * The rate is bounded to 1-1000 Hz.
+ */
+void TelemetryDataLink::setPublishRate(int rate)
+{
+    rate = qBound(1, rate, 1000);
+    if (rate != m_publishRate) {
+        m_publishRate = rate;
+        m_publishTimer->setInterval(1000 / m_publishRate);
+        emit publishRateChanged(m_publishRate);
+    }
+}
+
+quint64 TelemetryDataLink::framesReceived() const
+{
+    return m_framesReceived.load(std::memory_order_relaxed);
+}
+
+quint64 TelemetryDataLink::malformedDatagrams() const
+{
+    return m_malformedDatagrams.load(std::memory_order_relaxed);
+}
+
+quint64 TelemetryDataLink::staleFrames() const
+{
+    return m_staleFrames.load(std::memory_order_relaxed);
+}
+
+int TelemetryDataLink::targetAltitude() const
+{
+    return m_targetAltitude;
+}
+
+void TelemetryDataLink::setTargetAltitude(const int altitude)
+{
+    if (altitude != m_targetAltitude)
+    {
+        m_targetAltitude = altitude;
+        emit targetAltitudeChanged(altitude);
+    }
+}
+
+void TelemetryDataLink::takeOff()
+{
+    qWarning() << "Cannot send commands over a receive-only telemetry link";
+}
+
+void TelemetryDataLink::land()
+{
+    qWarning() << "Cannot send commands over a receive-only telemetry link";
+}
+
+void TelemetryDataLink::goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise)
+{
+    Q_UNUSED(destination);
+    Q_UNUSED(loiterRadius);
+    Q_UNUSED(loiterClockwise);
+    qWarning() << "Cannot send commands over a receive-only telemetry link";
+}
+
+/**
+ * @brief Reads and decodes all pending datagrams (I/O thread)
+ *
+ * Every datagram is read into the same preallocated buffer. A datagram
+ * larger than the buffer is truncated, fails validation and is counted as
+ * malformed.
+ */
+void TelemetryDataLink::readPendingDatagrams()
+{
+    char* buffer = m_receiveBuffer.data();
+
+    while (m_socket->hasPendingDatagrams()) {
+        const qint64 size = m_socket->readDatagram(buffer, RECEIVE_BUFFER_SIZE);
+        if (size < 0) {
+            break;
+        }
+
+        const int count = TelemetryProtocol::parseDatagram(buffer, size,
+            [this](const TelemetryProtocol::WireFrame& frame) {
+                receiveFrame(frame);
+            });
+
+        if (count < 0) {
+            m_malformedDatagrams.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Stores a decoded frame if it belongs to the vehicle (I/O thread)
+ * @param frame The decoded frame
+ *
+ * Frames older than the newest accepted one are dropped. Sequence numbers
+ * are compared with wrap-around, so the stream may run indefinitely.
+ */
+void TelemetryDataLink::receiveFrame(const TelemetryProtocol::WireFrame& frame)
+{
+    if (frame.vehicleId != m_vehicleId) {
+        return;
+    }
+
+    m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_sequenceValid && static_cast<qint32>(frame.sequence - m_lastSequence) <= 0) {
+        m_staleFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_sequenceValid = true;
+    m_lastSequence = frame.sequence;
+
+    m_latest.write(frame);
+}
+
+/**
+ * @brief Publishes the newest received frame, if any (GUI thread)
+ *
+ * Frames that were superseded before this tick are never published, which
+ * bounds the GUI update rate to the publish rate.
+ */
+void TelemetryDataLink::publishLatest()
+{
+    if (!m_latest.update()) {
+        return;
+    }
+
+    const TelemetryProtocol::WireFrame& frame = m_latest.readBuffer();
+    publishFrame(TelemetryProtocol::toTelemetryFrame(frame));
+    m_stateMachine->syncState(frame.state);
+}
@@ -0,0 +1,216 @@
+#ifndef TELEMETRYDATALINK_HPP
+#define TELEMETRYDATALINK_HPP
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <atomic>
+#include "TelemetryData.hpp"
+#include "TelemetryProtocol.hpp"
+#include "TripleBuffer.hpp"
+
+class QThread;
+class QTimer;
+class QUdpSocket;
+
+/**
+ * @class TelemetryDataLink
+ * @brief TelemetryData backed by a binary telemetry stream received over UDP
+ *
+ * Datagrams are read on a dedicated I/O thread into a receive buffer that is
+ * allocated once, and their frames are decoded in place (see
+ * TelemetryProtocol), so no heap allocation happens per packet. Only the
+ * newest frame of the configured vehicle is kept, handed to the GUI thread
+ * through a lock-free TripleBuffer.
+ *
+ * The GUI thread picks that frame up at a bounded publish rate, no matter
+ * how fast frames arrive, and publishes it with publishFrame(). The vehicle
+ * reports its own state, which the state machine mirrors.
+ */
+class TelemetryDataLink : public TelemetryData
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int publishRate READ publishRate WRITE setPublishRate NOTIFY publishRateChanged)
+
+public:
+    /** @brief Default rate at which received telemetry is published, in Hz */
+    static constexpr int DEFAULT_PUBLISH_RATE = 20;
+
+    /** @brief Size of the preallocated receive buffer in bytes */
+    static constexpr int RECEIVE_BUFFER_SIZE = TelemetryProtocol::MAX_DATAGRAM_SIZE + 1;
+
+    /** @brief Socket receive buffer size requested from the OS, in bytes */
+    static constexpr int SOCKET_BUFFER_SIZE = 1 << 20;
+
+    /**
+     * @brief Constructs a link for one vehicle
+     * @param vehicleId The vehicle whose frames are published
+     * @param parent The parent QObject
+     */
+    explicit TelemetryDataLink(quint16 vehicleId, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TelemetryDataLink();
+
+    /**
+     * @brief Gets the vehicle whose frames are published
+     * @return The vehicle id
+     */
+    quint16 vehicleId() const;
+
+    /**
+     * @brief Binds the socket and starts receiving
+     * @param port The UDP port to listen on, 0 to pick a free one
+     * @param address The address to bind to
+     * @return True if the socket was bound
+     */
+    bool start(quint16 port, const QHostAddress& address = QHostAddress::Any);
+
+    /**
+     * @brief Stops receiving and closes the socket
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the link is receiving
+     * @return True if the socket is bound
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Gets the port the socket is bound to
+     * @return The local port, or 0 if the link is not running
+     */
+    quint16 localPort() const;
+
+    /**
+     * @brief Gets the publish rate
+     * @return The maximum number of frames published per second
+     */
+    int publishRate() const;
+
+    /**
+     * @brief Sets the publish rate
+     * @param rate The maximum number of frames published per second
+     */
+    void setPublishRate(int rate);
+
+    /**
+     * @brief Gets the number of frames received for this vehicle
+     * @return The frame count
+     */
+    quint64 framesReceived() const;
+
+    /**
+     * @brief Gets the number of datagrams rejected as malformed
+     * @return The datagram count
+     */
+    quint64 malformedDatagrams() const;
+
+    /**
+     * @brief Gets the number of frames dropped because they arrived out of order
+     * @return The frame count
+     */
+    quint64 staleFrames() const;
+
+    // TelemetryData interface implementation
+    int targetAltitude() const override;
+    void setTargetAltitude(const int altitude) override;
+
+    /**
+     * @brief Command the vehicle to take off
+     *
+     * The link is receive-only; commands are rejected.
+     */
+    Q_INVOKABLE virtual void takeOff() override;
+
+    /**
+     * @brief Command the vehicle to land
+     *
+     * The link is receive-only; commands are rejected.
+     */
+    Q_INVOKABLE virtual void land() override;
+
+    /**
+     * @brief Command the vehicle to fly to a specific destination
+     * @param destination The geographical coordinates to fly to
+     * @param loiterRadius The radius size for loitering
+     * @param loiterClockwise True if the UAS should loiter clockwise, false if it should loiter counterclockwise
+     *
+     * The link is receive-only; commands are rejected.
+     */
+    Q_INVOKABLE virtual void goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise) override;
+
+signals:
+    /**
+     * @brief Emitted when the publish rate changes
+     * @param rate The new publish rate in Hz
+     */
+    void publishRateChanged(int rate);
+
+private:
+    /**
+     * @brief Reads and decodes all pending datagrams (I/O thread)
+     */
+    void readPendingDatagrams();
+
+    /**
+     * @brief Stores a decoded frame if it belongs to the vehicle (I/O thread)
+     * @param frame The decoded frame
+     */
+    void receiveFrame(const TelemetryProtocol::WireFrame& frame);
+
+    /**
+     * @brief Publishes the newest received frame, if any (GUI thread)
+     */
+    void publishLatest();
+
+    /** @brief Vehicle whose frames are published */
+    quint16 m_vehicleId;
+
+    /** @brief Thread running the socket */
+    QThread* m_ioThread;
+
+    /** @brief Context object living on the I/O thread */
+    QObject* m_ioContext;
+
+    /** @brief The UDP socket, owned by m_ioContext */
+    QUdpSocket* m_socket;
+
+    /** @brief Receive buffer, allocated once */
+    QByteArray m_receiveBuffer;
+
+    /** @brief Timer pacing publication on the GUI thread */
+    QTimer* m_publishTimer;
+
+    /** @brief Publish rate in Hz */
+    int m_publishRate;
+
+    /** @brief Port the socket is bound to */
+    quint16 m_localPort;
+
+    /** @brief Target altitude requested by the operator */
+    int m_targetAltitude;
+
+    /** @brief Newest frame received for the vehicle, written by the I/O thread */
+    TripleBuffer<TelemetryProtocol::WireFrame> m_latest;
+
+    /** @brief True once any frame was received, enables the ordering check */
+    bool m_sequenceValid;
+
+    /** @brief Sequence number of the newest accepted frame (I/O thread) */
+    quint32 m_lastSequence;
+
+    /** @brief Number of frames received for the vehicle */
+    std::atomic<quint64> m_framesReceived;
+
+    /** @brief Number of malformed datagrams */
+    std::atomic<quint64> m_malformedDatagrams;
+
+    /** @brief Number of out of order frames */
+    std::atomic<quint64> m_staleFrames;
+};
+
+#endif // TELEMETRYDATALINK_HPP
@@ -0,0 +1,258 @@
+#include "TelemetryDataReplay.hpp"
+#include <QTimer>
+
+/**
+ * @brief Constructs a replay with no log open
+ * @param vehicleId The vehicle to replay
+ * @param parent The parent QObject
+ */
+TelemetryDataReplay::TelemetryDataReplay(quint16 vehicleId, QObject* parent)
+    : TelemetryData(parent)
+    , m_vehicleId(vehicleId)
+    , m_displayTimer(new QTimer(this))
+    , m_playbackRate(MIN_PLAYBACK_RATE)
+    , m_currentTime(0)
+    , m_cursor(0)
+    , m_firstRecord(0)
+    , m_targetAltitude(120)
+{
+    m_displayTimer->setInterval(DISPLAY_INTERVAL);
+    m_displayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_displayTimer, &QTimer::timeout, this, [this]() {
+        advance(m_wallClock.restart());
+    });
+}
+
+/**
+ * @brief Destructor
+ */
+TelemetryDataReplay::~TelemetryDataReplay()
+{
+}
+
+/**
+ * @brief Opens a flight log and shows its first frame
+ * @param path The log file
+ * @return True if the log could be opened
+ *
+ * Playback is paused and the playhead placed at the start of the log.
+ */
+bool TelemetryDataReplay::open(const QString& path)
+{
+    setPlaying(false);
+
+    if (!m_reader.open(path)) {
+        return false;
+    }
+
+    // Locate the vehicle's first record once, so seeks before it need no search
+    m_firstRecord = 0;
+    while (m_firstRecord < m_reader.recordCount() && m_reader.record(m_firstRecord).vehicleId != m_vehicleId) {
+        ++m_firstRecord;
+    }
+
+    m_currentTime = m_reader.firstTime();
+    m_cursor = 0;
+    present(0);
+
+    emit logChanged();
+    emit currentTimeChanged(m_currentTime);
+    return true;
+}
+
+quint16 TelemetryDataReplay::vehicleId() const
+{
+    return m_vehicleId;
+}
+
+double TelemetryDataReplay::playbackRate() const
+{
+    return m_playbackRate;
+}
+
+void TelemetryDataReplay::setPlaybackRate(double rate)
+{
+    rate = qBound(MIN_PLAYBACK_RATE, rate, MAX_PLAYBACK_RATE);
+    if (!qFuzzyCompare(rate, m_playbackRate)) {
+        m_playbackRate = rate;
+        emit playbackRateChanged(m_playbackRate);
+    }
+}
+
+bool TelemetryDataReplay::isPlaying() const
+{
+    return m_displayTimer->isActive();
+}
+
+qint64 TelemetryDataReplay::currentTime() const
+{
+    return m_currentTime;
+}
+
+qint64 TelemetryDataReplay::startTime() const
+{
+    return m_reader.firstTime();
+}
+
+qint64 TelemetryDataReplay::endTime() const
+{
+    return m_reader.lastTime();
+}
+
+/**
+ * @brief Starts or resumes playback; restarts from the beginning at the end of the log
+ */
+void TelemetryDataReplay::play()
+{
+    if (!m_reader.isOpen()) {
+        return;
+    }
+
+    if (m_currentTime >= endTime()) {
+        seek(startTime());
+    }
+
+    setPlaying(true);
+}
+
+void TelemetryDataReplay::pause()
+{
+    setPlaying(false);
+}
+
+/**
+ * @brief Moves the playhead and shows the frame at that time
+ * @param time Log time in milliseconds, bounded to the log
+ *
+ * The log is searched through its time index, so seeking costs the same
+ * anywhere in the log. Playback continues from the new position if it was
+ * running.
+ */
+void TelemetryDataReplay::seek(qint64 time)
+{
+    if (!m_reader.isOpen()) {
+        return;
+    }
+
+    m_currentTime = qBound(startTime(), time, endTime());
+    present(0);
+    emit currentTimeChanged(m_currentTime);
+}
+
+/**
+ * @brief Advances the playhead by an amount of wall time
+ * @param elapsed Wall time in milliseconds, scaled by the playback rate
+ *
+ * Only the records passed since the previous call are searched and only the
+ * newest of them is published, so the cost per call is bounded by the
+ * playback rate rather than by the number of frames skipped. Playback stops
+ * at the end of the log.
+ */
+void TelemetryDataReplay::advance(qint64 elapsed)
+{
+    if (!m_reader.isOpen()) {
+        return;
+    }
+
+    m_currentTime = qMin(endTime(), m_currentTime + qRound64(elapsed * m_playbackRate));
+    present(m_cursor);
+    emit currentTimeChanged(m_currentTime);
+
+    if (m_currentTime >= endTime()) {
+        setPlaying(false);
+    }
+}
+
+int TelemetryDataReplay::targetAltitude() const
+{
+    return m_targetAltitude;
+}
+
+void TelemetryDataReplay::setTargetAltitude(const int altitude)
+{
+    if (altitude != m_targetAltitude)
+    {
+        m_targetAltitude = altitude;
+        emit targetAltitudeChanged(altitude);
+    }
+}
+
+void TelemetryDataReplay::takeOff()
+{
+    qWarning() << "Cannot command a replayed vehicle";
+}
+
+void TelemetryDataReplay::land()
+{
+    qWarning() << "Cannot command a replayed vehicle";
+}
+
+void TelemetryDataReplay::goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise)
+{
+    Q_UNUSED(destination);
+    Q_UNUSED(loiterRadius);
+    Q_UNUSED(loiterClockwise);
+    qWarning() << "Cannot command a replayed vehicle";
+}
+
+/**
+ * @brief Publishes the vehicle's newest record at or before the playhead
+ * @param searchFrom First record that may hold it; earlier records are skipped
+ *
+ * Records are searched backwards from the playhead. Every record holds the
+ * complete telemetry and state of its vehicle, so one record is enough to
+ * show the vehicle as it was at that time. The search never passes the
+ * vehicle's first record; a seek to before it shows no data, so scrubbing
+ * backwards never keeps a frame from later in the log.
+ */
+void TelemetryDataReplay::present(qint64 searchFrom)
+{
+    const qint64 end = m_reader.seek(m_currentTime + 1);
+    m_cursor = end;
+    if (end <= m_firstRecord) {
+        presentNoData();
+        return;
+    }
+
+    for (qint64 i = end - 1; i >= qMax(searchFrom, m_firstRecord); --i) {
+        const FlightLog::Record record = m_reader.record(i);
+        if (record.vehicleId != m_vehicleId) {
+            continue;
+        }
+
+        TelemetryFrame frame = record.frame;
+        frame.dirty = TelemetryFrame::AllFields;
+        publishFrame(frame);
+        m_stateMachine->syncState(record.state);
+        break;
+    }
+}
+
+void TelemetryDataReplay::presentNoData()
+{
+    TelemetryFrame frame;
+    frame.timestamp = m_currentTime;
+    frame.dirty = TelemetryFrame::AllFields;
+    publishFrame(frame);
+    m_stateMachine->syncState(UASState::Landed);
+}
+
+/**
+ * @brief Sets the playing flag
+ * @param playing The new value
+ */
+void TelemetryDataReplay::setPlaying(bool playing)
+{
+    if (playing == isPlaying()) {
+        return;
+    }
+
+    if (playing) {
+        m_wallClock.start();
+        m_displayTimer->start();
+    } else {
+        m_displayTimer->stop();
+    }
+
+    emit playingChanged(playing);
+}
@@ -0,0 +1,223 @@
+#ifndef TELEMETRYDATAREPLAY_HPP
+#define TELEMETRYDATAREPLAY_HPP
+
+#include <QElapsedTimer>
+#include "TelemetryData.hpp"
+#include "FlightLogReader.hpp"
+
+class QTimer;
+
+/**
+ * @class TelemetryDataReplay
+ * @brief TelemetryData played back from a recorded flight log
+ *
+ * Replays one vehicle of a log written by FlightRecorder at 1x to 100x
+ * speed, with pause and random-access seeking. Playback is driven by a
+ * timer at display rate: on every tick the playhead advances by the elapsed
+ * wall time times the playback rate and only the vehicle's newest record at
+ * the playhead is published. However fast the playback, the GUI receives at
+ * most one frame per display tick.
+ *
+ * Before the vehicle's first record, the replay shows no data: an empty
+ * frame and the Landed state, as before a log was opened.
+ *
+ * Commands are ignored; the replayed vehicle follows its recording.
+ */
+class TelemetryDataReplay : public TelemetryData
+{
+    Q_OBJECT
+
+    Q_PROPERTY(double playbackRate READ playbackRate WRITE setPlaybackRate NOTIFY playbackRateChanged)
+    Q_PROPERTY(bool playing READ isPlaying NOTIFY playingChanged)
+    Q_PROPERTY(qint64 currentTime READ currentTime NOTIFY currentTimeChanged)
+    Q_PROPERTY(qint64 startTime READ startTime NOTIFY logChanged)
+    Q_PROPERTY(qint64 endTime READ endTime NOTIFY logChanged)
+
+public:
+    /** @brief Slowest playback rate */
+    static constexpr double MIN_PLAYBACK_RATE = 1.0;
+
+    /** @brief Fastest playback rate */
+    static constexpr double MAX_PLAYBACK_RATE = 100.0;
+
+    /** @brief Interval between published frames during playback, in ms */
+    static constexpr int DISPLAY_INTERVAL = 33;
+
+    /**
+     * @brief Constructs a replay with no log open
+     * @param vehicleId The vehicle to replay
+     * @param parent The parent QObject
+     */
+    explicit TelemetryDataReplay(quint16 vehicleId, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TelemetryDataReplay();
+
+    /**
+     * @brief Opens a flight log and shows its first frame
+     * @param path The log file
+     * @return True if the log could be opened
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Gets the vehicle being replayed
+     * @return The vehicle id
+     */
+    quint16 vehicleId() const;
+
+    /**
+     * @brief Gets the playback rate
+     * @return Log time per wall time
+     */
+    double playbackRate() const;
+
+    /**
+     * @brief Sets the playback rate
+     * @param rate Log time per wall time, bounded to MIN_PLAYBACK_RATE-MAX_PLAYBACK_RATE
+     */
+    void setPlaybackRate(double rate);
+
+    /**
+     * @brief Checks whether playback is running
+     * @return True while playing
+     */
+    bool isPlaying() const;
+
+    /**
+     * @brief Gets the playhead position
+     * @return Log time in milliseconds
+     */
+    qint64 currentTime() const;
+
+    /**
+     * @brief Gets the time of the first record
+     * @return Log time in milliseconds
+     */
+    qint64 startTime() const;
+
+    /**
+     * @brief Gets the time of the last record
+     * @return Log time in milliseconds
+     */
+    qint64 endTime() const;
+
+    /**
+     * @brief Starts or resumes playback; restarts from the beginning at the end of the log
+     */
+    Q_INVOKABLE void play();
+
+    /**
+     * @brief Pauses playback
+     */
+    Q_INVOKABLE void pause();
+
+    /**
+     * @brief Moves the playhead and shows the frame at that time
+     * @param time Log time in milliseconds, bounded to the log
+     */
+    Q_INVOKABLE void seek(qint64 time);
+
+    /**
+     * @brief Advances the playhead by an amount of wall time
+     * @param elapsed Wall time in milliseconds, scaled by the playback rate
+     *
+     * Called by the display timer during playback.
+     */
+    void advance(qint64 elapsed);
+
+    // TelemetryData interface implementation
+    int targetAltitude() const override;
+    void setTargetAltitude(const int altitude) override;
+
+    /**
+     * @brief Command the vehicle to take off; ignored during replay
+     */
+    Q_INVOKABLE virtual void takeOff() override;
+
+    /**
+     * @brief Command the vehicle to land; ignored during replay
+     */
+    Q_INVOKABLE virtual void land() override;
+
+    /**
+     * @brief Command the vehicle to fly to a destination; ignored during replay
+     * @param destination The geographical coordinates to fly to
+     * @param loiterRadius The radius size for loitering
+     * @param loiterClockwise True if the UAS should loiter clockwise, false if it should loiter counterclockwise
+     */
+    Q_INVOKABLE virtual void goTo(const QGeoCoordinate& destination, const int loiterRadius, const bool loiterClockwise) override;
+
+signals:
+    /**
+     * @brief Emitted when the playback rate changes
+     * @param rate The new playback rate
+     */
+    void playbackRateChanged(double rate);
+
+    /**
+     * @brief Emitted when playback starts or stops
+     * @param playing True while playing
+     */
+    void playingChanged(bool playing);
+
+    /**
+     * @brief Emitted when the playhead moves
+     * @param time The new playhead position
+     */
+    void currentTimeChanged(qint64 time);
+
+    /**
+     * @brief Emitted when a log was opened
+     */
+    void logChanged();
+
+private:
+    /**
+     * @brief Publishes the vehicle's newest record at or before the playhead
+     * @param searchFrom First record that may hold it; earlier records are skipped
+     */
+    void present(qint64 searchFrom);
+
+    /**
+     * @brief Shows the vehicle without data, as before its first record
+     */
+    void presentNoData();
+
+    /**
+     * @brief Sets the playing flag
+     * @param playing The new value
+     */
+    void setPlaying(bool playing);
+
+    /** @brief Vehicle being replayed */
+    quint16 m_vehicleId;
+
+    /** @brief The open log */
+    FlightLogReader m_reader;
+
+    /** @brief Timer driving playback at display rate */
+    QTimer* m_displayTimer;
+
+    /** @brief Wall time since the last display tick */
+    QElapsedTimer m_wallClock;
+
+    /** @brief Log time per wall time */
+    double m_playbackRate;
+
+    /** @brief Playhead position in log time */
+    qint64 m_currentTime;
+
+    /** @brief Number of the record after the last one presented */
+    qint64 m_cursor;
+
+    /** @brief Number of the vehicle's first record, the record count if it has none */
+    qint64 m_firstRecord;
+
+    /** @brief Target altitude requested by the operator */
+    int m_targetAltitude;
+};
+
+#endif // TELEMETRYDATAREPLAY_HPP
@@ -1,5 +1,6 @@
 #include "TelemetryDataSimulator.hpp"
-#include <QDebug>
+#include "EventLog.hpp"
+#include <QThread>
 #include <QtMath>
 
 /**
@@ -14,17 +15,45 @@
  * - Direction: 45 degrees
  * - Loiter radius: 100 meters
  * - Loiter direction: Clockwise
+ *
+ * The simulation is driven by a real-time clock owned by the simulator.
  */
 TelemetryDataSimulator::TelemetryDataSimulator(QObject* parent)
     : TelemetryData(parent)
+    , m_clock(nullptr)
+    , m_ownClock(new SimulationClock(this))
+    , m_engineContext(nullptr)
+    , m_sameThread(true)
+    , m_snapshotPending(false)
+    , m_commandsIssued(0)
+    , m_commandsApplied(0)
+    , m_publishedSequence(0)
+    , m_phase(UASState::Landed)
+    , m_publishedPhase(UASState::Landed)
+    , m_syncingState(false)
+    , m_accumulator(0)
+    , m_phaseElapsed(0)
+    , m_takeOffAltitude(120)
+    , m_loiterRadius(100)
+    , m_loiterClockwise(true)
+    , m_loiterIndex(0)
     , m_random(QRandomGenerator::global()->generate())
     , m_battery(100)
+    , m_energy(m_energyModel.capacity())
+    , m_averagePower(0.0)
+    , m_averageSpeed(0.0)
+    , m_lastAltitude(0)
+    , m_lastDirection(45)
+    , m_remainingFlightTime(qRound(m_energyModel.remainingFlightTime(m_energy, 0.0)))
+    , m_remainingRange(qRound(m_energyModel.remainingRange(m_energy, 0.0, 0.0)))
+    , m_enduranceChanged(false)
     , m_altitude(0)
     , m_target_altitude(120)
     , m_speed(0)
     , m_position(42.3314, -83.0458) // Default position: Detroit, MI
     , m_direction(45)
 {
+    initialize();
 }
 
 /**
@@ -42,60 +71,144 @@ TelemetryDataSimulator::TelemetryDataSimulator(QObject* parent)
  * - Loiter direction: Clockwise
  */
 TelemetryDataSimulator::TelemetryDataSimulator(UASStateMachine* stateMachine, QObject* parent)
-    : TelemetryData(parent)
+    : TelemetryData(stateMachine, parent)
+    , m_clock(nullptr)
+    , m_ownClock(new SimulationClock(this))
+    , m_engineContext(nullptr)
+    , m_sameThread(true)
+    , m_snapshotPending(false)
+    , m_commandsIssued(0)
+    , m_commandsApplied(0)
+    , m_publishedSequence(0)
+    , m_phase(UASState::Landed)
+    , m_publishedPhase(UASState::Landed)
+    , m_syncingState(false)
+    , m_accumulator(0)
+    , m_phaseElapsed(0)
+    , m_takeOffAltitude(120)
+    , m_loiterRadius(100)
+    , m_loiterClockwise(true)
+    , m_loiterIndex(0)
     , m_random(QRandomGenerator::global()->generate())
     , m_battery(100)
+    , m_energy(m_energyModel.capacity())
+    , m_averagePower(0.0)
+    , m_averageSpeed(0.0)
+    , m_lastAltitude(0)
+    , m_lastDirection(45)
+    , m_remainingFlightTime(qRound(m_energyModel.remainingFlightTime(m_energy, 0.0)))
+    , m_remainingRange(qRound(m_energyModel.remainingRange(m_energy, 0.0, 0.0)))
+    , m_enduranceChanged(false)
     , m_altitude(0)
     , m_target_altitude(120)
     , m_speed(0)
     , m_position(42.3314, -83.0458) // Default position: Detroit, MI
     , m_direction(45)
 {
-    // Use the provided state machine
-    m_stateMachine = stateMachine;
+    initialize();
 }
 
 /**
  * @brief Destructor
+ *
+ * Waits for a tick running on another thread to finish before the
+ * simulation state goes away.
  */
 TelemetryDataSimulator::~TelemetryDataSimulator()
 {
+    releaseEngine();
 }
 
 /**
- * @brief Gets the current simulated battery level
- * @return Battery percentage (0-100)
+ * @brief Publishes the initial state and starts the default clock
  */
-int TelemetryDataSimulator::battery() const
+void TelemetryDataSimulator::initialize()
 {
-    return m_battery;
+    m_phase = m_stateMachine->currentState();
+    m_publishedPhase = m_phase;
+
+    m_pendingFrame.setBattery(m_battery);
+    m_pendingFrame.setAltitude(m_altitude);
+    m_pendingFrame.setSpeed(m_speed);
+    m_pendingFrame.setPosition(m_position.latitude, m_position.longitude);
+    publishFrame(m_pendingFrame);
+    publishEndurance(m_remainingFlightTime, m_remainingRange);
+    m_pendingFrame.dirty = TelemetryFrame::NoFields;
+
+    connect(m_stateMachine, &UASStateMachine::currentStateChanged,
+            this, &TelemetryDataSimulator::forwardStateChange);
+
+    setClock(m_ownClock);
+    m_clock->start();
 }
 
 /**
- * @brief Gets the current simulated altitude
- * @return Altitude in meters
+ * @brief Gets the clock driving the simulation
+ * @return The simulation clock
  */
-int TelemetryDataSimulator::altitude() const
+SimulationClock* TelemetryDataSimulator::clock() const
 {
-    return m_altitude;
+    return m_clock;
 }
 
 /**
- * @brief Gets the current simulated speed
- * @return Speed in meters per second
+ * @brief Replaces the clock driving the simulation
+ * @param clock The clock to use; the caller keeps ownership
+ *
+ * The ticks are received by a context object living on the clock's thread,
+ * so the simulation runs wherever the clock runs. The default real-time
+ * clock is released once another clock is injected.
  */
-int TelemetryDataSimulator::speed() const
+void TelemetryDataSimulator::setClock(SimulationClock* clock)
 {
-    return m_speed;
+    if (!clock || clock == m_clock)
+    {
+        return;
+    }
+
+    releaseEngine();
+
+    m_clock = clock;
+    m_sameThread = m_clock->thread() == thread();
+    m_engineContext = new QObject;
+    m_engineContext->moveToThread(m_clock->thread());
+    m_tickConnection = connect(m_clock, &SimulationClock::tick, m_engineContext, [this](int dtMs) {
+        onClockTick(dtMs);
+    });
+
+    if (m_ownClock && m_ownClock != m_clock)
+    {
+        delete m_ownClock;
+        m_ownClock = nullptr;
+    }
 }
 
 /**
- * @brief Gets the current simulated position
- * @return The current geographical coordinates
+ * @brief Deletes the context running the simulation on the clock's thread
+ *
+ * After the tick is disconnected, a blocking no-op on the clock's thread
+ * makes sure no tick is still running there.
  */
-QGeoCoordinate TelemetryDataSimulator::position() const
+void TelemetryDataSimulator::releaseEngine()
 {
-    return m_position;
+    if (!m_engineContext)
+    {
+        return;
+    }
+
+    disconnect(m_tickConnection);
+
+    QThread* engineThread = m_engineContext->thread();
+    if (engineThread != QThread::currentThread() && engineThread && engineThread->isRunning())
+    {
+        QMetaObject::invokeMethod(m_engineContext, []() {}, Qt::BlockingQueuedConnection);
+        m_engineContext->deleteLater();
+    }
+    else
+    {
+        delete m_engineContext;
+    }
+    m_engineContext = nullptr;
 }
 
 int TelemetryDataSimulator::targetAltitude() const
@@ -113,241 +226,521 @@ void TelemetryDataSimulator::setTargetAltitude(const int altitude)
 }
 
 /**
- * @brief Simulates the take off sequence
+ * @brief Command the UAS to take off
  *
- * When complete, the UAS transitions to the Flying state.
+ * The transition is validated right away; the takeoff sequence starts on the
+ * next tick. When complete, the UAS transitions to the Flying state. A
+ * takeoff from a position the geofence does not permit is rejected.
  */
 void TelemetryDataSimulator::takeOff()
 {
-    if (!m_stateMachine->setCurrentState(UASState::TakingOff))
+    if (!geofencePermits(UASState::TakingOff) || !requestState(UASState::TakingOff))
     {
         return;
     }
 
-    qDebug() << "Taking off...";
-
-    // pick a random direction
-    m_direction = m_random.bounded(360);
+    EventLog::info(EventLog::TakeOffStarted, -1, m_target_altitude);
 
-    // Setup takeoff timer
-    QTimer* takeoffTimer = createSimTimer();
+    Command command;
+    command.type = Command::TakeOff;
+    command.state = UASState::TakingOff;
+    command.targetAltitude = m_target_altitude;
+    sendCommand(command);
+}
 
-    // Initialize takeoff parameters
-    int elapsedTime = 0;
+/**
+ * @brief Command the UAS to land
+ *
+ * The transition is validated right away; the landing sequence starts on the
+ * next tick. When complete, the UAS transitions to the Landed state.
+ */
+void TelemetryDataSimulator::land()
+{
+    if (!requestState(UASState::Landing))
+    {
+        return;
+    }
 
-    // Connect timer to lambda function
-    connect(takeoffTimer, &QTimer::timeout, this, [=]() mutable {
-        // Update elapsed time
-        elapsedTime += 250;
+    EventLog::info(EventLog::LandingStarted);
 
-        // Calculate progress
-        double progress = static_cast<double>(elapsedTime) / TAKEOFF_LANDING_DURATION;
+    Command command;
+    command.type = Command::Land;
+    command.state = UASState::Landing;
+    sendCommand(command);
+}
 
-        // Update speed - gradually accelerate to takeoff speed
-        updateSpeed(m_speed, 40, progress);
+/**
+ * @brief Command the UAS to fly to a specific destination
+ * @param destination The geographical coordinates to fly to
+ * @param loiterRadius The radius size for loitering
+ * @param loiterClockwise True if the UAS should loiter clockwise, false if it should loiter counterclockwise
+ *
+ * When the destination is reached (within 50 meters), the UAS transitions to
+ * the Loitering state. Destinations the geofence does not permit, or that
+ * can only be reached through an exclusion zone, are rejected.
+ */
+void TelemetryDataSimulator::goTo(const QGeoCoordinate &destination, const int loiterRadius, const bool loiterClockwise)
+{
+    if (!geofencePermits(UASState::FlyingToWaypoint, destination) || !requestState(UASState::FlyingToWaypoint))
+    {
+        return;
+    }
 
-        // Begin altitude increase after rotation speed
-        if (m_speed > 10) {
-            updateAltitude(m_altitude, m_target_altitude, progress);
-        }
+    EventLog::info(EventLog::WaypointSet, -1, destination.latitude(), destination.longitude());
 
-        // Drain battery and update position
-        drainBattery();
-        updatePosition();
+    Command command;
+    command.type = Command::GoTo;
+    command.state = UASState::FlyingToWaypoint;
+    command.loiterRadius = loiterRadius;
+    command.loiterClockwise = loiterClockwise;
+    command.destination = GeoPoint::fromCoordinate(destination);
+    sendCommand(command);
+}
 
-        // End takeoff sequence after duration
-        if (elapsedTime >= TAKEOFF_LANDING_DURATION) {
-            takeoffTimer->stop();
-            takeoffTimer->deleteLater();
+/**
+ * @brief Validates a state change on the state machine without forwarding it
+ * @param state The requested state
+ * @return True if the transition was accepted
+ */
+bool TelemetryDataSimulator::requestState(UASState::State state)
+{
+    m_syncingState = true;
+    const bool accepted = m_stateMachine->setCurrentState(state);
+    m_syncingState = false;
+    return accepted;
+}
 
-            qDebug() << "Takeoff sequence completed - Altitude:" << m_altitude
-                     << "Speed:" << m_speed
-                     << "Position:" << m_position.latitude() << m_position.longitude();
+/**
+ * @brief Passes a command to the simulation
+ * @param command The command
+ *
+ * The ring only fills up if the simulation stopped ticking; further commands
+ * are dropped then.
+ */
+void TelemetryDataSimulator::sendCommand(const Command& command)
+{
+    if (!m_commands.push(command))
+    {
+        EventLog::warning(EventLog::CommandDropped);
+        return;
+    }
+    m_commandsIssued++;
+}
 
-            simulateFlying();
-        }
-    });
+/**
+ * @brief Forwards state changes made directly on the state machine
+ * @param state The new state
+ *
+ * Changes made by the simulator itself are not forwarded.
+ */
+void TelemetryDataSimulator::forwardStateChange(UASState::State state)
+{
+    if (m_syncingState)
+    {
+        return;
+    }
 
-    takeoffTimer->start();
+    Command command;
+    command.type = Command::SyncState;
+    command.state = state;
+    sendCommand(command);
 }
 
 /**
- * @brief Simulates the landing sequence
+ * @brief Applies all queued commands (simulation thread)
  *
- * Initiates a simulation of the UAS landing on the ground.
- * The sequence includes gradual deceleration and altitude decrease
- * over the defined TAKEOFF_LANDING_DURATION. When complete, the UAS
- * transitions to the Landed state.
+ * A command replaces the active flight phase; nothing is allocated.
  */
-void TelemetryDataSimulator::land()
+void TelemetryDataSimulator::applyCommands()
 {
-    if (!m_stateMachine->setCurrentState(UASState::Landing))
+    Command command;
+    while (m_commands.pop(command))
     {
-        return;
+        m_commandsApplied++;
+
+        switch (command.type)
+        {
+        case Command::TakeOff:
+            // pick a random direction
+            m_direction = m_random.bounded(360);
+            m_lastDirection = m_direction;
+            m_takeOffAltitude = command.targetAltitude;
+            enterPhase(UASState::TakingOff);
+            break;
+        case Command::Land:
+            enterPhase(UASState::Landing);
+            break;
+        case Command::GoTo:
+            m_destination = command.destination;
+            m_loiterRadius = command.loiterRadius;
+            m_loiterClockwise = command.loiterClockwise;
+            enterPhase(UASState::FlyingToWaypoint);
+            break;
+        case Command::SyncState:
+            if (command.state == m_phase) {
+                break;
+            }
+            if (command.state == UASState::TakingOff) {
+                m_takeOffAltitude = command.targetAltitude;
+            }
+            if (command.state == UASState::Loitering) {
+                startLoitering(m_position);
+            } else {
+                enterPhase(command.state);
+            }
+            break;
+        }
     }
+}
 
-    qDebug() << "Landing...";
+/**
+ * @brief Makes a flight phase the active one (simulation thread)
+ * @param phase The new phase
+ *
+ * The progress of the previous phase is discarded.
+ */
+void TelemetryDataSimulator::enterPhase(UASState::State phase)
+{
+    m_phase = phase;
+    m_phaseElapsed = 0;
+}
 
-    // Create landing timer
-    QTimer* landingTimer = createSimTimer();
+/**
+ * @brief Advances the active flight phase by one fixed step (simulation thread)
+ */
+void TelemetryDataSimulator::stepPhase()
+{
+    m_phaseElapsed += FIXED_STEP;
 
-    int elapsedTime = 0;
+    switch (m_phase)
+    {
+    case UASState::TakingOff:
+        stepTakeOff();
+        break;
+    case UASState::Flying:
+        stepFlying();
+        break;
+    case UASState::FlyingToWaypoint:
+        stepToWaypoint();
+        break;
+    case UASState::Loitering:
+        stepLoitering();
+        break;
+    case UASState::Landing:
+        stepLanding();
+        break;
+    default:
+        break;
+    }
 
-    connect(landingTimer, &QTimer::timeout, this, [=]() mutable {
-        // Update elapsed time
-        elapsedTime += 250;
+    drainBattery();
+}
 
-        // Calculate progress as a percentage (0.0 to 1.0)
-        double progress = static_cast<double>(elapsedTime) / TAKEOFF_LANDING_DURATION;
+/**
+ * @brief Simulates one step of the take off sequence
+ *
+ * When complete, the UAS transitions to the Flying state.
+ */
+void TelemetryDataSimulator::stepTakeOff()
+{
+    // Calculate progress
+    double progress = static_cast<double>(m_phaseElapsed) / TAKEOFF_LANDING_DURATION;
 
-        updateSpeed(m_speed, 0, progress);
-        updateAltitude(m_altitude, 0, progress);
-        updatePosition();
-        drainBattery();
+    // Update speed - gradually accelerate to takeoff speed
+    updateSpeed(m_speed, 40, progress);
 
-        // Complete landing when done
-        if (elapsedTime >= TAKEOFF_LANDING_DURATION) {
-            // Ensure values are exactly zero
-            m_speed = 0;
-            m_altitude = 0;
-            emit speedChanged(m_speed);
-            emit altitudeChanged(m_altitude);
+    // Begin altitude increase after rotation speed
+    if (m_speed > 10) {
+        updateAltitude(m_altitude, m_takeOffAltitude, progress);
+    }
 
-            // Stop the landing timer
-            landingTimer->stop();
-            landingTimer->deleteLater();
+    // Update position
+    updatePosition();
 
-            // Transition to Landed state
-            m_stateMachine->setCurrentState(UASState::Landed);
-        }
-    });
+    // End takeoff sequence after duration
+    if (m_phaseElapsed >= TAKEOFF_LANDING_DURATION) {
+        EventLog::info(EventLog::TakeOffCompleted, -1, m_altitude, m_speed);
 
-    // Start the landing timer
-    landingTimer->start();
+        enterPhase(UASState::Flying);
+    }
 }
 
- /**
- * @brief Command the UAS to fly to a specific destination
- * @param destination The geographical coordinates to fly to
- * @param loiterRadius The radius size for loitering
- * @param loiterClockwise True if the UAS should loiter clockwise, false if it should loiter counterclockwise
+/**
+ * @brief Simulates one step of the landing sequence
  *
- * Sets up a timer that continuously updates the UAS position as it
- * flies towards the destination. When the destination is reached
- * (within 50 meters), the UAS will transition to loitering state.
+ * The sequence includes gradual deceleration and altitude decrease
+ * over the defined TAKEOFF_LANDING_DURATION. When complete, the UAS
+ * transitions to the Landed state.
  */
+void TelemetryDataSimulator::stepLanding()
+{
+    // Calculate progress as a percentage (0.0 to 1.0)
+    double progress = static_cast<double>(m_phaseElapsed) / TAKEOFF_LANDING_DURATION;
+
+    updateSpeed(m_speed, 0, progress);
+    updateAltitude(m_altitude, 0, progress);
+    updatePosition();
+
+    // Complete landing when done
+    if (m_phaseElapsed >= TAKEOFF_LANDING_DURATION) {
+        // Ensure values are exactly zero
+        m_speed = 0;
+        m_altitude = 0;
+        m_pendingFrame.setSpeed(m_speed);
+        m_pendingFrame.setAltitude(m_altitude);
+
+        // Transition to Landed state
+        EventLog::info(EventLog::Landed);
+        enterPhase(UASState::Landed);
+    }
+}
 
-void TelemetryDataSimulator::goTo(const QGeoCoordinate &destination, const int loiterRadius, const bool loiterClockwise)
+/**
+ * @brief Simulates one step of normal flying behavior
+ *
+ * The speed and altitude are maintained within standard cruise ranges
+ * with small random variations to simulate realistic flight behavior.
+ */
+void TelemetryDataSimulator::stepFlying()
 {
-    if (!m_stateMachine->setCurrentState(UASState::FlyingToWaypoint))
-    {
+    applyFlightVariations();
+
+    // Update position
+    updatePosition();
+}
+
+/**
+ * @brief Simulates one step of flying to the destination
+ *
+ * Flies at cruise speed towards the destination. When the destination is
+ * reached (within 50 meters), the UAS transitions to the Loitering state.
+ */
+void TelemetryDataSimulator::stepToWaypoint()
+{
+    if (!m_destination.isValid()) {
+        stepFlying();
         return;
     }
 
-    qDebug() << "Flying to:" << destination.latitude() << destination.longitude();
+    // Calculate bearing to the destination
+    double bearing = m_position.azimuthTo(m_destination);
 
-    m_destinationCoordinate = destination;
+    // Calculate distance to the destination
+    double distance = m_position.distanceTo(m_destination);
 
-    QTimer* flyToWaypointTimer = createSimTimer();
+    // Set the direction towards the destination
+    m_direction = bearing;
 
-    connect(flyToWaypointTimer, &QTimer::timeout, this, [=]() mutable {
-        // Check if we're still in a valid navigation state
-        UASState::State currentState = m_stateMachine->currentState();
-        if (currentState != UASState::Flying &&
-            currentState != UASState::FlyingToWaypoint &&
-            currentState != UASState::Loitering) {
-            flyToWaypointTimer->stop();
-            flyToWaypointTimer->deleteLater();
-            flyToWaypointTimer = nullptr;
-            qDebug() << "Navigation interrupted due to state change";
-            return;
-        }
+    // Check if we've reached the destination (within 50 meters)
+    if (distance < 50) {
+        EventLog::info(EventLog::WaypointReached, -1, m_destination.latitude, m_destination.longitude);
 
-        // Calculate bearing to the destination
-        double bearing = m_position.azimuthTo(m_destinationCoordinate);
+        // Switch to loitering state when destination reached
+        startLoitering(m_destination);
+        return;
+    }
 
-        // Calculate distance to the destination
-        double distance = m_position.distanceTo(m_destinationCoordinate);
+    stepFlying();
+}
 
-        // Set the direction towards the destination
-        m_direction = bearing;
+/**
+ * @brief Starts loitering around a center point (simulation thread)
+ * @param centerPoint The center point of the loiter pattern
+ *
+ * All points of the circle are precalculated into the fixed loiter table.
+ * The radius and direction of the loiter pattern are determined by
+ * m_loiterRadius and m_loiterClockwise.
+ */
+void TelemetryDataSimulator::startLoitering(const GeoPoint& centerPoint)
+{
+    // Convert radius in meters to degrees
+    double lat = centerPoint.latitude;
+    double lon = centerPoint.longitude;
+    double latRadius = m_loiterRadius / 111000.0; // 1 degree lat is about 111km
+    double lonRadius = m_loiterRadius / (111000.0 * cos(lat * M_PI / 180.0)); // Adjust for longitude
 
-        // Check if we've reached the destination (within 50 meters)
-        if (distance < 50) {
-            qDebug() << "Reached destination:" << m_destinationCoordinate.latitude() << m_destinationCoordinate.longitude();
+    // Direction is tangent to the circle
+    // If clockwise, add 90 degrees, if counterclockwise, subtract 90
+    int directionOffset = m_loiterClockwise ? 90 : -90;
 
-            // Switch to loitering state when destination reached
-            simulateLoitering(destination, loiterRadius, loiterClockwise);
+    // Calculate one point per degree around the circle
+    for (int angle = 0; angle < LOITER_POINTS; angle++) {
+        double radians = angle * M_PI / 180.0;
 
-            // Stop the navigation timer
-            flyToWaypointTimer->stop();
-            flyToWaypointTimer->deleteLater();
-            return;
-        }
+        LoiterPoint& point = m_loiterPoints[angle];
+        point.latitude = lat + latRadius * cos(radians);
+        point.longitude = lon + lonRadius * sin(radians);
+        point.direction = static_cast<int>(fmod(angle + directionOffset, 360.0));
+    }
 
-        // Update position
-        updatePosition();
+    m_loiterIndex = 0;
+    enterPhase(UASState::Loitering);
+}
 
-        // Drain battery
-        drainBattery();
-    });
+/**
+ * @brief Simulates one step of loitering around the center point
+ *
+ * The UAS maintains a lower speed while loitering and keeps a more
+ * consistent altitude than during normal flight.
+ */
+void TelemetryDataSimulator::stepLoitering()
+{
+    // Get pre-calculated position and direction
+    const LoiterPoint& point = m_loiterPoints[m_loiterIndex];
+    m_position.latitude = point.latitude;
+    m_position.longitude = point.longitude;
+    m_direction = point.direction;
+
+    // Update index for next point (circular)
+    // Direction depends on the loiter direction
+    if (m_loiterClockwise) {
+        m_loiterIndex = (m_loiterIndex + 1) % LOITER_POINTS;
+    } else {
+        m_loiterIndex = (m_loiterIndex - 1 + LOITER_POINTS) % LOITER_POINTS;
+    }
+
+    // Record position change
+    m_pendingFrame.setPosition(point.latitude, point.longitude);
 
-    flyToWaypointTimer->start();
+    // Maintain altitude within a tighter range
+    int altAdjust = static_cast<int>((m_random.generateDouble() * 2.0 - 1.0) * 1.0);
+    m_altitude = qMax(100, qMin(110, m_altitude + altAdjust));
+    m_pendingFrame.setAltitude(m_altitude);
+
+    // Maintain lower speed for loitering
+    int speedAdjust = static_cast<int>((m_random.generateDouble() * 2.0 - 1.0) * 1.0);
+    m_speed = qMax(15, qMin(20, m_speed + speedAdjust));
+    m_pendingFrame.setSpeed(m_speed);
 }
 
 /**
- * @brief Creates a simulation timer with the specified interval
- * @param interval The timer interval in milliseconds
- * @return A configured QTimer pointer
+ * @brief Advances the simulation by the time covered by a tick (simulation thread)
+ * @param dtMs The simulated time covered by the tick in milliseconds
+ *
+ * Queued commands are applied first. The measured tick duration is then
+ * accumulated and the active flight phase is advanced in FIXED_STEP
+ * increments, so the flight does not depend on the clock's tick interval.
+ * Every step only records the fields it updates in the pending frame. If
+ * anything changed, the complete state is handed over as one snapshot, so
+ * the frame is published at most once per tick.
  */
-QTimer* TelemetryDataSimulator::createSimTimer(int interval)
+void TelemetryDataSimulator::onClockTick(int dtMs)
 {
-    QTimer* timer = new QTimer(this);
-    timer->setInterval(interval);
-    return timer;
+    applyCommands();
+
+    m_accumulator += dtMs;
+    while (m_accumulator >= FIXED_STEP) {
+        m_accumulator -= FIXED_STEP;
+        stepPhase();
+    }
+
+    if (m_pendingFrame.dirty == TelemetryFrame::NoFields &&
+        !m_enduranceChanged &&
+        m_phase == m_publishedPhase &&
+        m_commandsApplied == m_publishedSequence) {
+        return;
+    }
+
+    Snapshot& snapshot = m_snapshots.writeBuffer();
+    snapshot.frame.setBattery(m_battery);
+    snapshot.frame.setAltitude(m_altitude);
+    snapshot.frame.setSpeed(m_speed);
+    snapshot.frame.setPosition(m_position.latitude, m_position.longitude);
+    snapshot.frame.timestamp = m_clock->now();
+    snapshot.state = m_phase;
+    snapshot.remainingFlightTime = m_remainingFlightTime;
+    snapshot.remainingRange = m_remainingRange;
+    snapshot.commandSequence = m_commandsApplied;
+    m_snapshots.publish();
+
+    m_pendingFrame.dirty = TelemetryFrame::NoFields;
+    m_enduranceChanged = false;
+    m_publishedPhase = m_phase;
+    m_publishedSequence = m_commandsApplied;
+
+    if (m_sameThread) {
+        consumeSnapshot();
+    } else if (!m_snapshotPending.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() {
+            consumeSnapshot();
+        }, Qt::QueuedConnection);
+    }
 }
 
 /**
- * @brief Updates the simulated position based on current direction and speed
- * 
- * The position is updated by calculating the movement in both latitude and
- * longitude based on the current speed and direction.
+ * @brief Publishes the latest snapshot (simulator thread)
+ *
+ * Snapshots taken before all issued commands were applied still carry
+ * telemetry, but their state is already outdated and is not mirrored.
  */
-void TelemetryDataSimulator::updatePosition()
+void TelemetryDataSimulator::consumeSnapshot()
 {
-    double radians = m_direction * M_PI / 180.0;
-    double latChange = MOVEMENT_STEP * m_speed * cos(radians);
-    double lonChange = MOVEMENT_STEP * m_speed * sin(radians);
+    m_snapshotPending.store(false, std::memory_order_release);
+    if (!m_snapshots.update()) {
+        return;
+    }
 
-    // Calculate new position
-    double newLat = m_position.latitude() + latChange;
-    double newLon = m_position.longitude() + lonChange;
-    QGeoCoordinate newPosition(newLat, newLon);
+    const Snapshot& snapshot = m_snapshots.readBuffer();
+    publishFrame(snapshot.frame);
+    publishEndurance(snapshot.remainingFlightTime, snapshot.remainingRange);
 
-    m_position = newPosition;
-    emit positionChanged(m_position);
+    if (snapshot.commandSequence == m_commandsIssued) {
+        m_syncingState = true;
+        m_stateMachine->syncState(snapshot.state);
+        m_syncingState = false;
+    }
 }
 
 /**
- * @brief Simulates random battery drain
+ * @brief Updates the simulated position based on current direction and speed
  * 
- * There is a 2% chance on each call that the battery will drain by 1%.
- * This is used to simulate gradual battery usage during flight.
+ * The position moves along a great circle in the current direction. The
+ * distance covered per step is MOVEMENT_STEP degrees of arc per m/s of
+ * speed, so east-west movement is no longer distorted by latitude.
+ */
+void TelemetryDataSimulator::updatePosition()
+{
+    const double distance = qDegreesToRadians(MOVEMENT_STEP * m_speed) * GeoPoint::EARTH_MEAN_RADIUS;
+    m_position = m_position.atDistanceAndAzimuth(distance, m_direction);
+    m_pendingFrame.setPosition(m_position.latitude, m_position.longitude);
+}
+
+/**
+ * @brief Drains the battery by the power drawn during one step
+ *
+ * Called once per fixed step in every phase. Climb and turn rates are the
+ * altitude and direction changes made by the step; direction changes are
+ * wrapped to the shorter turn. The battery level and the endurance
+ * estimates are only marked for publication when their rounded values
+ * change.
  */
 void TelemetryDataSimulator::drainBattery()
 {
-    // Exit early if battery is already at 0
-    if (m_battery <= 0) {
-        return;
+    const double dt = FIXED_STEP / 1000.0;
+    const double climbRate = (m_altitude - m_lastAltitude) / dt;
+    const int turn = (m_direction - m_lastDirection + 540) % 360 - 180;
+    m_lastAltitude = m_altitude;
+    m_lastDirection = m_direction;
+
+    const double power = m_energyModel.power(m_speed, climbRate, qDegreesToRadians(turn / dt));
+    m_energy = qMax(0.0, m_energy - power * dt);
+
+    const double smoothing = EnergyModel::smoothing(dt);
+    m_averagePower += (power - m_averagePower) * smoothing;
+    m_averageSpeed += (m_speed - m_averageSpeed) * smoothing;
+
+    const int battery = qRound(m_energy * 100.0 / m_energyModel.capacity());
+    if (battery != m_battery) {
+        m_battery = battery;
+        m_pendingFrame.setBattery(m_battery);
     }
 
-    // Generate a random number between 0.0 and 1.0
-    double randomValue = m_random.generateDouble();
-
-    // 2 percent chance of battery drain
-    if (randomValue < 0.02) {
-        m_battery--;
-        emit batteryChanged(m_battery);
+    const int flightTime = qRound(m_energyModel.remainingFlightTime(m_energy, m_averagePower));
+    const int range = qRound(m_energyModel.remainingRange(m_energy, m_averagePower, m_averageSpeed));
+    if (flightTime != m_remainingFlightTime || range != m_remainingRange) {
+        m_remainingFlightTime = flightTime;
+        m_remainingRange = range;
+        m_enduranceChanged = true;
     }
 }
 
@@ -360,7 +753,7 @@ void TelemetryDataSimulator::drainBattery()
 void TelemetryDataSimulator::updateSpeed(int initialSpeed, int targetSpeed, double progress)
 {
     m_speed = initialSpeed + static_cast<int>((targetSpeed - initialSpeed) * progress);
-    emit speedChanged(m_speed);
+    m_pendingFrame.setSpeed(m_speed);
 }
 
 /**
@@ -372,7 +765,7 @@ void TelemetryDataSimulator::updateSpeed(int initialSpeed, int targetSpeed, doub
 void TelemetryDataSimulator::updateAltitude(int initialAltitude, int targetAltitude, double progress)
 {
     m_altitude = initialAltitude + static_cast<int>((targetAltitude - initialAltitude) * progress);
-    emit altitudeChanged(m_altitude);
+    m_pendingFrame.setAltitude(m_altitude);
 }
 
 /**
@@ -386,137 +779,5 @@ void TelemetryDataSimulator::applyFlightVariations()
     // Small speed variation
     int speedAdjust = static_cast<int>((m_random.generateDouble() * 2.0 - 1.0) * 2.0);
     m_speed = qMax(38, qMin(42, m_speed + speedAdjust));
-    emit speedChanged(m_speed);
-}
-
-/**
- * @brief Simulates loitering around a center point
- * @param centerPoint The center point of the loiter pattern
- * 
- * Initiates a simulation of the UAS loitering (circling) around the
- * specified center point. The radius and direction of the loiter pattern
- * are determined by the m_loiterRadius and m_loiterClockwise properties.
- * 
- * The UAS maintains a lower speed while loitering and keeps a more
- * consistent altitude than during normal flight.
- */
-void TelemetryDataSimulator::simulateLoitering(const QGeoCoordinate& centerPoint, const int loiterRadius, const bool loiterClockwise)
-{
-    m_stateMachine->setCurrentState(UASState::Loitering);
-
-    // Pre-calculate all points on the circle
-    QVector<QGeoCoordinate> circlePoints;
-    QVector<int> directions;
-
-    // Convert radius in meters to degrees
-    double lat = centerPoint.latitude();
-    double lon = centerPoint.longitude();
-    double latRadius = loiterRadius / 111000.0; // 1 degree lat is about 111km
-    double lonRadius = loiterRadius / (111000.0 * cos(lat * M_PI / 180.0)); // Adjust for longitude
-
-    // Calculate 360 points around the circle
-    for (int angle = 0; angle < 360; angle++) {
-        double radians = angle * M_PI / 180.0;
-
-        // Calculate position on the circle
-        double newLat = lat + latRadius * cos(radians);
-        double newLon = lon + lonRadius * sin(radians);
-
-        // Add point to the vector
-        circlePoints.append(QGeoCoordinate(newLat, newLon));
-
-        // Direction is tangent to the circle
-        // If clockwise, add 90 degrees, if counterclockwise, subtract 90
-        int directionOffset = loiterClockwise ? 90 : -90;
-        int tangentDirection = static_cast<int>(fmod(angle + directionOffset, 360.0));
-        directions.append(tangentDirection);
-    }
-
-    // Create loiter timer
-    QTimer* loiterTimer = createSimTimer();
-    int currentPointIndex = 0;
-
-    connect(loiterTimer, &QTimer::timeout, this, [=]() mutable {
-        // Check if we're still loitering
-        if (m_stateMachine->currentState() != UASState::Loitering) {
-            loiterTimer->stop();
-            loiterTimer->deleteLater();
-            return;
-        }
-
-        // Get pre-calculated position and direction
-        m_position = circlePoints[currentPointIndex];
-        m_direction = directions[currentPointIndex];
-
-        // Update index for next point (circular)
-        // Direction depends on the loiter direction
-        if (loiterClockwise) {
-            currentPointIndex = (currentPointIndex + 1) % 360;
-        } else {
-            currentPointIndex = (currentPointIndex - 1 + 360) % 360;
-        }
-
-        // Emit position change
-        emit positionChanged(m_position);
-
-        // Maintain altitude within a tighter range
-        int altAdjust = static_cast<int>((m_random.generateDouble() * 2.0 - 1.0) * 1.0);
-        m_altitude = qMax(100, qMin(110, m_altitude + altAdjust));
-        emit altitudeChanged(m_altitude);
-
-        // Maintain lower speed for loitering
-        int speedAdjust = static_cast<int>((m_random.generateDouble() * 2.0 - 1.0) * 1.0);
-        m_speed = qMax(15, qMin(20, m_speed + speedAdjust));
-        emit speedChanged(m_speed);
-
-        // Drain battery
-        drainBattery();
-    });
-
-    // Start loitering
-    loiterTimer->start();
-}
-
-/**
- * @brief Simulates normal flying behavior
- * 
- * Initiates a simulation of the UAS flying in normal cruise mode.
- * The speed and altitude are maintained within standard cruise ranges
- * with small random variations to simulate realistic flight behavior.
- * This simulation continues until the UAS state changes.
- */
-void TelemetryDataSimulator::simulateFlying()
-{
-    m_stateMachine->setCurrentState(UASState::Flying);
-
-    // Create flight timer
-    QTimer* flightTimer = createSimTimer();
-
-    // Setup transition duration
-    int elapsedTime = 0;
-    const int TRANSITION_DURATION = 3000; // 3 seconds to stabilize at cruise
-
-    connect(flightTimer, &QTimer::timeout, this, [=]() mutable {
-
-        // Check if state has changed to landing - interrupt if so
-        if (m_stateMachine->currentState() == UASState::Landing)
-        {
-            flightTimer->stop();
-            flightTimer->deleteLater();
-            qDebug() << "Flight interrupted - transitioning to landing";
-            return;
-        }
-
-        // Update elapsed time
-        elapsedTime += 250;
-
-        applyFlightVariations();
-
-        // Update position and battery
-        updatePosition();
-        drainBattery();
-    });
-
-    // Start the flight timer
-    flightTimer->start();
+    m_pendingFrame.setSpeed(m_speed);
 }
@@ -2,8 +2,13 @@
 #define TELEMETRYDATASIMULATOR_HPP
 
 #include "TelemetryData.hpp"
-#include <QTimer>
+#include "EnergyModel.hpp"
+#include "SimulationClock.hpp"
+#include "GeoPoint.hpp"
+#include "SpscRing.hpp"
+#include "TripleBuffer.hpp"
 #include <QRandomGenerator>
+#include <atomic>
 
 /**
  * @class TelemetryDataSimulator
@@ -12,7 +17,25 @@
  * This class provides a simulated implementation of the TelemetryData interface.
  * It generates realistic telemetry data including position, altitude, speed,
  * and battery levels, and simulates different flight behaviors such as takeoff,
- * landing, flying to waypoints, and loitering.
+ * landing, flying to waypoints, and loitering. The battery is drained by an
+ * EnergyModel from the speed, climb and turn of every step, which also
+ * yields the remaining flight time and range.
+ *
+ * The flight is driven by the ticks of a SimulationClock. By default the
+ * simulator owns a real-time clock; tests and scenario runners can inject a
+ * manual or time-warped clock with setClock() to run faster than real time.
+ * Exactly one flight phase is active at a time; it is advanced in fixed
+ * steps of simulated time, and a new command simply replaces it. The fields
+ * updated during a tick are collected in one TelemetryFrame, which is
+ * published once at the end of the tick.
+ *
+ * The simulation runs on the thread the clock lives on. Commands are
+ * validated against the state machine on the simulator's own (GUI) thread
+ * and passed to the simulation through a lock-free SpscRing; the latest
+ * frame and state come back through a lock-free TripleBuffer. Driven by a
+ * clock on a worker thread (see SimulationThread), physics and rendering
+ * never wait for each other. Driven by a clock on the simulator's thread,
+ * every tick is published synchronously.
  */
 class TelemetryDataSimulator : public TelemetryData
 {
@@ -37,31 +60,21 @@ public:
      */
     virtual ~TelemetryDataSimulator();
 
-    // TelemetryData interface implementation
     /**
-     * @brief Gets the simulated battery level
-     * @return Battery percentage (0-100)
-     */
-    int battery() const override;
-    
-    /**
-     * @brief Gets the simulated altitude
-     * @return Altitude in meters
+     * @brief Gets the clock driving the simulation
+     * @return The simulation clock
      */
-    int altitude() const override;
-    
-    /**
-     * @brief Gets the simulated speed
-     * @return Speed in meters per second
-     */
-    int speed() const override;
-    
+    SimulationClock* clock() const;
+
     /**
-     * @brief Gets the simulated position
-     * @return Current geographical coordinates
+     * @brief Replaces the clock driving the simulation
+     * @param clock The clock to use; the caller keeps ownership
+     *
+     * Running flight phases continue on the new clock, on the clock's thread.
      */
-    QGeoCoordinate position() const override;
+    void setClock(SimulationClock* clock);
 
+    // TelemetryData interface implementation
     /**
      * @brief Gets the target altitude
      * @return Altitude in meters
@@ -95,22 +108,149 @@ public:
 
 private:
     /**
-     * @brief Simulates loitering around a center point
+     * @struct Command
+     * @brief An operator command or state change passed to the simulation
+     */
+    struct Command
+    {
+        /**
+         * @enum Type
+         * @brief Kind of command
+         */
+        enum Type : quint8 {
+            TakeOff,  ///< Start the takeoff sequence
+            Land,     ///< Start the landing sequence
+            GoTo,     ///< Fly to a destination and loiter there
+            SyncState ///< Adopt a state set on the state machine directly
+        };
+
+        Type type = SyncState;
+        UASState::State state = UASState::Landed;
+        int targetAltitude = 0;
+        int loiterRadius = 0;
+        bool loiterClockwise = true;
+        GeoPoint destination;
+    };
+
+    /**
+     * @struct Snapshot
+     * @brief The simulation state handed to the simulator's thread
+     */
+    struct Snapshot
+    {
+        /** @brief Complete telemetry with all fields flagged dirty */
+        TelemetryFrame frame;
+
+        /** @brief Flight phase of the simulation */
+        UASState::State state = UASState::Landed;
+
+        /** @brief Remaining flight time in seconds */
+        int remainingFlightTime = -1;
+
+        /** @brief Remaining range in meters */
+        int remainingRange = -1;
+
+        /** @brief Number of commands applied before the snapshot was taken */
+        quint32 commandSequence = 0;
+    };
+
+    /**
+     * @brief Publishes the initial state and starts the default clock
+     */
+    void initialize();
+
+    /**
+     * @brief Validates a state change on the state machine without forwarding it
+     * @param state The requested state
+     * @return True if the transition was accepted
+     */
+    bool requestState(UASState::State state);
+
+    /**
+     * @brief Passes a command to the simulation
+     * @param command The command
+     */
+    void sendCommand(const Command& command);
+
+    /**
+     * @brief Forwards state changes made directly on the state machine
+     * @param state The new state
+     */
+    void forwardStateChange(UASState::State state);
+
+    /**
+     * @brief Applies all queued commands (simulation thread)
+     */
+    void applyCommands();
+
+    /**
+     * @brief Publishes the latest snapshot (simulator thread)
+     */
+    void consumeSnapshot();
+
+    /**
+     * @brief Deletes the context running the simulation on the clock's thread
+     */
+    void releaseEngine();
+
+    /**
+     * @struct LoiterPoint
+     * @brief A precalculated point of the loiter circle
+     */
+    struct LoiterPoint
+    {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        int direction = 0;
+    };
+
+    /**
+     * @brief Makes a flight phase the active one (simulation thread)
+     * @param phase The new phase
+     */
+    void enterPhase(UASState::State phase);
+
+    /**
+     * @brief Advances the active flight phase by one fixed step (simulation thread)
+     */
+    void stepPhase();
+
+    /**
+     * @brief Simulates one step of the take off sequence
+     */
+    void stepTakeOff();
+
+    /**
+     * @brief Simulates one step of the landing sequence
+     */
+    void stepLanding();
+
+    /**
+     * @brief Simulates one step of normal flying behavior
+     */
+    void stepFlying();
+
+    /**
+     * @brief Simulates one step of flying to the destination
+     */
+    void stepToWaypoint();
+
+    /**
+     * @brief Starts loitering around a center point (simulation thread)
      * @param centerPoint The center of the loiter pattern
      */
-    void simulateLoitering(const QGeoCoordinate& centerPoint, const int loiterRadius, const bool loiterClockwise);
-    
+    void startLoitering(const GeoPoint& centerPoint);
+
     /**
-     * @brief Simulates normal flying behavior
+     * @brief Simulates one step of loitering around the center point
      */
-    void simulateFlying();
+    void stepLoitering();
 
     /**
-     * @brief Creates a simulation timer
-     * @param interval The timer interval in milliseconds
-     * @return A configured QTimer pointer
+     * @brief Advances the simulation by the time covered by a tick (simulation thread)
+     * @param dtMs The simulated time covered by the tick in milliseconds
      */
-    QTimer* createSimTimer(int interval = 250);
+    void onClockTick(int dtMs);
     
     /**
      * @brief Updates the simulated position based on speed and direction
@@ -118,7 +258,7 @@ private:
     void updatePosition();
     
     /**
-     * @brief Simulates random battery drain
+     * @brief Drains the battery by the power drawn during one step
      */
     void drainBattery();
     
@@ -143,14 +283,110 @@ private:
      */
     void applyFlightVariations();
     
+    /** @brief The clock driving all flight phases */
+    SimulationClock* m_clock;
+
+    /** @brief The default real-time clock, owned by the simulator */
+    SimulationClock* m_ownClock;
+
+    /** @brief Connection from the clock tick to onClockTick() */
+    QMetaObject::Connection m_tickConnection;
+
+    /** @brief Context object living on the clock's thread, receives the ticks */
+    QObject* m_engineContext;
+
+    /** @brief True if the clock lives on the simulator's thread */
+    bool m_sameThread;
+
+    /** @brief Commands from the simulator's thread to the simulation */
+    SpscRing<Command, 64> m_commands;
+
+    /** @brief Latest simulation state for the simulator's thread */
+    TripleBuffer<Snapshot> m_snapshots;
+
+    /** @brief Set while a snapshot notification is queued */
+    std::atomic<bool> m_snapshotPending;
+
+    /** @brief Number of commands sent (simulator thread) */
+    quint32 m_commandsIssued;
+
+    /** @brief Number of commands applied (simulation thread) */
+    quint32 m_commandsApplied;
+
+    /** @brief Command count of the last published snapshot (simulation thread) */
+    quint32 m_publishedSequence;
+
+    /** @brief Flight phase as seen by the simulation (simulation thread) */
+    UASState::State m_phase;
+
+    /** @brief Flight phase of the last published snapshot (simulation thread) */
+    UASState::State m_publishedPhase;
+
+    /** @brief Set while the simulator itself changes the state machine */
+    bool m_syncingState;
+
+    /** @brief Simulated time not yet covered by a fixed step, in milliseconds */
+    int m_accumulator;
+
+    /** @brief Simulated time spent in the active phase, in milliseconds */
+    int m_phaseElapsed;
+
+    /** @brief Altitude the current takeoff climbs to, in meters */
+    int m_takeOffAltitude;
+
+    /** @brief Radius of the loiter circle in meters */
+    int m_loiterRadius;
+
+    /** @brief True to loiter clockwise */
+    bool m_loiterClockwise;
+
+    /** @brief Index of the next loiter point */
+    int m_loiterIndex;
+
+    /** @brief Number of precalculated loiter points, one per degree */
+    static constexpr int LOITER_POINTS = 360;
+
+    /** @brief Precalculated loiter circle, reused by every loiter */
+    LoiterPoint m_loiterPoints[LOITER_POINTS];
+
+    /** @brief Fields updated during the current tick, published at its end */
+    TelemetryFrame m_pendingFrame;
+
     /** @brief The destination coordinates for navigation */
-    QGeoCoordinate m_destinationCoordinate;
+    GeoPoint m_destination;
 
     /** @brief Random number generator for simulation variations */
     QRandomGenerator m_random;
     
+    /** @brief Power draw of the simulated airframe */
+    EnergyModel m_energyModel;
+
     /** @brief Simulated battery level (percentage) */
     int m_battery;
+
+    /** @brief Energy left in the battery in joules */
+    double m_energy;
+
+    /** @brief Power draw in watts, averaged over EnergyModel::AVERAGING_TIME */
+    double m_averagePower;
+
+    /** @brief Speed in meters per second, averaged likewise */
+    double m_averageSpeed;
+
+    /** @brief Altitude at the end of the previous step, in meters */
+    int m_lastAltitude;
+
+    /** @brief Direction at the end of the previous step, in degrees */
+    int m_lastDirection;
+
+    /** @brief Remaining flight time in whole seconds */
+    int m_remainingFlightTime;
+
+    /** @brief Remaining range in whole meters */
+    int m_remainingRange;
+
+    /** @brief True if the endurance estimates changed since the last snapshot */
+    bool m_enduranceChanged;
     
     /** @brief Simulated altitude (meters) */
     int m_altitude;
@@ -162,16 +398,19 @@ private:
     int m_speed;
     
     /** @brief Simulated position */
-    QGeoCoordinate m_position;
+    GeoPoint m_position;
     
     /** @brief Current direction in degrees (0-359) */
     int m_direction;
     
-    /** @brief Movement step size in degrees per update */
+    /** @brief Movement step size in degrees of arc per m/s of speed and step */
     const double MOVEMENT_STEP = 0.00001;
     
-    /** @brief Duration of takeoff and landing sequences in milliseconds */
+    /** @brief Duration of takeoff and landing sequences in simulated milliseconds */
     const int TAKEOFF_LANDING_DURATION = 7000;
+
+    /** @brief Fixed simulation timestep in simulated milliseconds */
+    const int FIXED_STEP = 250;
 };
 
 #endif // TELEMETRYDATASIMULATOR_HPP
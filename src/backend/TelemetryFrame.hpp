@@ -0,0 +1,124 @@
+#ifndef TELEMETRYFRAME_HPP
+#define TELEMETRYFRAME_HPP
+
+#include <QtGlobal>
+#include <QMetaType>
+#include <QGeoCoordinate>
+#include <type_traits>
+
+/**
+ * @struct TelemetryFrame
+ * @brief A packed snapshot of all telemetry fields at one point in time
+ *
+ * Producers fill a frame over the course of a tick and publish it once with
+ * TelemetryData::publishFrame(). The dirty mask records which fields were
+ * written by the producer; after publication it records which fields
+ * actually changed, so consumers can skip work for untouched fields.
+ *
+ * The frame is trivially copyable and 32 bytes wide so it can be passed by
+ * value, queued across threads and stored in bulk without allocations.
+ */
+struct TelemetryFrame
+{
+    /**
+     * @enum Field
+     * @brief Bit flags identifying the fields of a frame
+     */
+    enum Field : quint8 {
+        NoFields = 0,
+        Battery = 1 << 0,
+        Altitude = 1 << 1,
+        Speed = 1 << 2,
+        Position = 1 << 3,
+        AllFields = Battery | Altitude | Speed | Position
+    };
+
+    /** @brief Time the frame refers to, in milliseconds of source time */
+    qint64 timestamp = 0;
+
+    /** @brief Latitude in degrees */
+    double latitude = 0.0;
+
+    /** @brief Longitude in degrees */
+    double longitude = 0.0;
+
+    /** @brief Altitude in meters */
+    qint32 altitude = 0;
+
+    /** @brief Speed in meters per second */
+    qint16 speed = 0;
+
+    /** @brief Battery level as a percentage (0-100) */
+    quint8 battery = 0;
+
+    /** @brief Combination of Field flags */
+    quint8 dirty = NoFields;
+
+    /**
+     * @brief Sets the battery level and marks it dirty
+     * @param value Battery percentage
+     */
+    void setBattery(int value)
+    {
+        battery = static_cast<quint8>(qBound(0, value, 100));
+        dirty |= Battery;
+    }
+
+    /**
+     * @brief Sets the altitude and marks it dirty
+     * @param value Altitude in meters
+     */
+    void setAltitude(int value)
+    {
+        altitude = value;
+        dirty |= Altitude;
+    }
+
+    /**
+     * @brief Sets the speed and marks it dirty
+     * @param value Speed in meters per second
+     */
+    void setSpeed(int value)
+    {
+        speed = static_cast<qint16>(value);
+        dirty |= Speed;
+    }
+
+    /**
+     * @brief Sets the position and marks it dirty
+     * @param lat Latitude in degrees
+     * @param lon Longitude in degrees
+     */
+    void setPosition(double lat, double lon)
+    {
+        latitude = lat;
+        longitude = lon;
+        dirty |= Position;
+    }
+
+    /**
+     * @brief Checks whether a field is flagged in the dirty mask
+     * @param field The field to check
+     * @return True if the field is dirty
+     */
+    bool isDirty(Field field) const
+    {
+        return (dirty & field) != 0;
+    }
+
+    /**
+     * @brief Gets the position as a QGeoCoordinate
+     * @return The frame position
+     */
+    QGeoCoordinate position() const
+    {
+        return QGeoCoordinate(latitude, longitude);
+    }
+};
+
+static_assert(std::is_trivially_copyable<TelemetryFrame>::value, "TelemetryFrame must stay trivially copyable");
+static_assert(sizeof(TelemetryFrame) == 32, "TelemetryFrame is expected to be packed into 32 bytes");
+
+Q_DECLARE_METATYPE(TelemetryFrame)
+
+#endif // TELEMETRYFRAME_HPP
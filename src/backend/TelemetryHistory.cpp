@@ -0,0 +1,369 @@
+#include "TelemetryHistory.hpp"
+#include "TelemetrySubscriber.hpp"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Divides rounding towards negative infinity
+ * @param value The dividend
+ * @param divisor The divisor, positive
+ * @return The quotient
+ */
+qint64 floorDiv(qint64 value, qint64 divisor)
+{
+    const qint64 quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+/**
+ * @brief Gets the ring index of a bucket
+ * @param bucket The bucket number, i.e. its start divided by its duration
+ * @return The index in [0, BUCKET_CAPACITY)
+ */
+size_t bucketSlot(qint64 bucket)
+{
+    const qint64 slot = bucket % TelemetryHistory::BUCKET_CAPACITY;
+    return static_cast<size_t>(slot < 0 ? slot + TelemetryHistory::BUCKET_CAPACITY : slot);
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty history
+ * @param vehicleCapacity Number of vehicles kept; frames of further vehicles are dropped
+ * @param parent The parent QObject
+ */
+TelemetryHistory::TelemetryHistory(int vehicleCapacity, QObject* parent)
+    : QObject(parent)
+    , m_vehicleCapacity(qMax(0, vehicleCapacity))
+    , m_droppedFrames(0)
+    , m_subscriber(nullptr)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TelemetryHistory::~TelemetryHistory()
+{
+}
+
+/**
+ * @brief Gets the memory allocated per vehicle
+ * @return The size in bytes
+ *
+ * About 110 KB with the default capacities.
+ */
+qint64 TelemetryHistory::bytesPerVehicle()
+{
+    const qint64 raw = RAW_CAPACITY * (sizeof(qint64) + ChannelCount * sizeof(float));
+    const qint64 bucket = sizeof(qint64) + sizeof(quint32) + ChannelCount * (2 * sizeof(float) + sizeof(double));
+    return sizeof(Series) + raw + LEVEL_COUNT * BUCKET_CAPACITY * bucket;
+}
+
+void TelemetryHistory::attach(TelemetryBus* bus)
+{
+    delete m_subscriber;
+    m_subscriber = nullptr;
+
+    if (bus) {
+        m_subscriber = new TelemetrySubscriber(TelemetryBus::Frames, 0.0, this);
+        connect(m_subscriber, &TelemetrySubscriber::framesReceived, this,
+            [this](const TelemetryBus::FrameBatchPointer& batch) {
+                append(*batch);
+            });
+        bus->subscribe(m_subscriber);
+    }
+}
+
+/**
+ * @brief Appends a sample
+ * @param vehicle The vehicle id
+ * @param frame The frame; its timestamp is the sample time
+ *
+ * Stores the sample in the raw ring and folds it into the current bucket
+ * of every rollup. A bucket whose start does not match is stale and is
+ * started over, so no pass over old buckets is ever needed.
+ */
+void TelemetryHistory::append(quint32 vehicle, const TelemetryFrame& frame)
+{
+    Series* entry = series(vehicle);
+    if (!entry) {
+        ++m_droppedFrames;
+        return;
+    }
+
+    const qint64 timestamp = frame.timestamp;
+    if (entry->sampleCount > 0 && timestamp < entry->latest) {
+        reset(*entry);
+    }
+    if (entry->sampleCount == 0) {
+        entry->first = timestamp;
+    }
+    entry->latest = timestamp;
+
+    const std::array<float, ChannelCount> values = {
+        static_cast<float>(frame.altitude),
+        static_cast<float>(frame.speed),
+        static_cast<float>(frame.battery)
+    };
+
+    const size_t raw = entry->sampleCount % RAW_CAPACITY;
+    entry->times[raw] = timestamp;
+    for (int channel = 0; channel < ChannelCount; ++channel) {
+        entry->values[channel][raw] = values[channel];
+    }
+    ++entry->sampleCount;
+
+    for (int index = 0; index < LEVEL_COUNT; ++index) {
+        Level& level = entry->levels[index];
+        const qint64 duration = LEVEL_DURATIONS[index];
+        const qint64 bucket = floorDiv(timestamp, duration);
+        const size_t slot = bucketSlot(bucket);
+
+        if (level.starts[slot] != bucket * duration) {
+            level.starts[slot] = bucket * duration;
+            level.counts[slot] = 1;
+            for (int channel = 0; channel < ChannelCount; ++channel) {
+                level.minimum[channel][slot] = values[channel];
+                level.maximum[channel][slot] = values[channel];
+                level.sum[channel][slot] = values[channel];
+            }
+            continue;
+        }
+
+        ++level.counts[slot];
+        for (int channel = 0; channel < ChannelCount; ++channel) {
+            level.minimum[channel][slot] = qMin(level.minimum[channel][slot], values[channel]);
+            level.maximum[channel][slot] = qMax(level.maximum[channel][slot], values[channel]);
+            level.sum[channel][slot] += values[channel];
+        }
+    }
+}
+
+void TelemetryHistory::append(const TelemetryBus::FrameBatch& batch)
+{
+    for (const TelemetryBus::VehicleFrame& entry : batch.frames) {
+        append(entry.vehicle, entry.frame);
+    }
+    emit updated();
+}
+
+void TelemetryHistory::clear()
+{
+    m_index.clear();
+    m_series.clear();
+    m_droppedFrames = 0;
+    emit updated();
+}
+
+int TelemetryHistory::vehicleCount() const
+{
+    return static_cast<int>(m_series.size());
+}
+
+int TelemetryHistory::vehicleCapacity() const
+{
+    return m_vehicleCapacity;
+}
+
+bool TelemetryHistory::contains(quint32 vehicle) const
+{
+    return m_index.contains(vehicle);
+}
+
+qint64 TelemetryHistory::latestTimestamp(quint32 vehicle) const
+{
+    const Series* entry = find(vehicle);
+    return entry ? entry->latest : NO_TIMESTAMP;
+}
+
+quint64 TelemetryHistory::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+/**
+ * @brief Downsamples a channel of a vehicle over a time window
+ * @param vehicle The vehicle id
+ * @param channel The channel
+ * @param from Start of the window in milliseconds
+ * @param to End of the window in milliseconds, exclusive
+ * @param points Number of equal intervals the window is divided into
+ * @return One point per interval with samples, in time order
+ *
+ * Reads the coarsest rollup whose buckets are no longer than an interval,
+ * or the raw samples if even the finest rollup is too coarse. If the
+ * source no longer holds the start of the window, the next coarser rollup
+ * that does is read instead, so the result has fewer points rather than a
+ * gap. Buckets are merged into the interval their start falls in; a bucket
+ * straddling the start of the window counts towards the first interval.
+ */
+std::vector<TelemetryHistory::Point> TelemetryHistory::query(quint32 vehicle, Channel channel, qint64 from, qint64 to, int points) const
+{
+    std::vector<Point> result;
+    const Series* entry = find(vehicle);
+    if (!entry || entry->sampleCount == 0 || channel < 0 || channel >= ChannelCount || points <= 0 || to <= from) {
+        return result;
+    }
+
+    const qint64 span = to - from;
+    std::vector<Point> intervals(points, Point{0, std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f});
+    std::vector<double> sums(points, 0.0);
+    std::vector<quint32> counts(points, 0);
+    auto merge = [&](qint64 timestamp, quint32 count, float minimum, float maximum, double sum) {
+        const int index = timestamp <= from ? 0 : static_cast<int>(qMin<qint64>((timestamp - from) * points / span, points - 1));
+        intervals[index].minimum = qMin(intervals[index].minimum, minimum);
+        intervals[index].maximum = qMax(intervals[index].maximum, maximum);
+        sums[index] += sum;
+        counts[index] += count;
+    };
+
+    // Pick the source: raw samples, or the coarsest rollup still resolving an interval
+    const qint64 resolution = span / points;
+    const qint64 needed = qMax(from, entry->first);
+    const quint64 kept = qMin<quint64>(entry->sampleCount, RAW_CAPACITY);
+    const quint64 oldest = entry->sampleCount - kept;
+    int source = -1;
+    for (int index = 0; index < LEVEL_COUNT && LEVEL_DURATIONS[index] <= resolution; ++index) {
+        source = index;
+    }
+    if (source < 0 && entry->times[oldest % RAW_CAPACITY] > needed) {
+        source = 0;
+    }
+    while (source >= 0 && source < LEVEL_COUNT - 1 && retainedFrom(*entry, source) > needed) {
+        ++source;
+    }
+
+    if (source < 0) {
+        // Binary search for the first sample in the window; the ring is in time order
+        quint64 low = oldest;
+        quint64 high = entry->sampleCount;
+        while (low < high) {
+            const quint64 middle = low + (high - low) / 2;
+            if (entry->times[middle % RAW_CAPACITY] < from) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        const std::vector<float>& values = entry->values[channel];
+        for (quint64 sample = low; sample < entry->sampleCount; ++sample) {
+            const qint64 timestamp = entry->times[sample % RAW_CAPACITY];
+            if (timestamp >= to) {
+                break;
+            }
+            const float value = values[sample % RAW_CAPACITY];
+            merge(timestamp, 1, value, value, value);
+        }
+    } else {
+        const Level& level = entry->levels[source];
+        const qint64 duration = LEVEL_DURATIONS[source];
+        const qint64 end = qMin(to, floorDiv(entry->latest, duration) * duration + duration);
+        for (qint64 start = qMax(floorDiv(from, duration) * duration, retainedFrom(*entry, source)); start < end; start += duration) {
+            const size_t slot = bucketSlot(start / duration);
+            if (level.starts[slot] == start) {
+                merge(start, level.counts[slot], level.minimum[channel][slot], level.maximum[channel][slot], level.sum[channel][slot]);
+            }
+        }
+    }
+
+    for (int index = 0; index < points; ++index) {
+        if (counts[index] > 0) {
+            Point point = intervals[index];
+            point.timestamp = from + index * span / points;
+            point.average = static_cast<float>(sums[index] / counts[index]);
+            result.push_back(point);
+        }
+    }
+    return result;
+}
+
+std::vector<TelemetryHistory::Point> TelemetryHistory::queryLast(quint32 vehicle, Channel channel, qint64 duration, int points) const
+{
+    const qint64 latest = latestTimestamp(vehicle);
+    if (latest == NO_TIMESTAMP) {
+        return std::vector<Point>();
+    }
+    return query(vehicle, channel, latest + 1 - duration, latest + 1, points);
+}
+
+/**
+ * @brief Finds or allocates the series of a vehicle
+ * @param vehicle The vehicle id
+ * @return The series, or nullptr if the history is full
+ *
+ * All columns are allocated at their full capacity here, so appending
+ * never allocates.
+ */
+TelemetryHistory::Series* TelemetryHistory::series(quint32 vehicle)
+{
+    const auto found = m_index.constFind(vehicle);
+    if (found != m_index.constEnd()) {
+        return &m_series[found.value()];
+    }
+    if (static_cast<int>(m_series.size()) >= m_vehicleCapacity) {
+        return nullptr;
+    }
+
+    m_series.emplace_back();
+    Series& entry = m_series.back();
+    entry.vehicle = vehicle;
+    entry.times.resize(RAW_CAPACITY);
+    for (std::vector<float>& column : entry.values) {
+        column.resize(RAW_CAPACITY);
+    }
+    for (Level& level : entry.levels) {
+        level.starts.resize(BUCKET_CAPACITY);
+        level.counts.resize(BUCKET_CAPACITY);
+        for (int channel = 0; channel < ChannelCount; ++channel) {
+            level.minimum[channel].resize(BUCKET_CAPACITY);
+            level.maximum[channel].resize(BUCKET_CAPACITY);
+            level.sum[channel].resize(BUCKET_CAPACITY);
+        }
+    }
+    reset(entry);
+
+    m_index.insert(vehicle, static_cast<int>(m_series.size()) - 1);
+    return &entry;
+}
+
+const TelemetryHistory::Series* TelemetryHistory::find(quint32 vehicle) const
+{
+    const auto found = m_index.constFind(vehicle);
+    return found != m_index.constEnd() ? &m_series[found.value()] : nullptr;
+}
+
+/**
+ * @brief Empties a series without releasing its memory
+ * @param series The series
+ *
+ * NO_TIMESTAMP is not a multiple of any bucket duration, so it marks every
+ * bucket as stale.
+ */
+void TelemetryHistory::reset(Series& series)
+{
+    series.sampleCount = 0;
+    series.first = NO_TIMESTAMP;
+    series.latest = NO_TIMESTAMP;
+    for (Level& level : series.levels) {
+        std::fill(level.starts.begin(), level.starts.end(), NO_TIMESTAMP);
+    }
+}
+
+/**
+ * @brief Gets the start of the oldest bucket of a rollup still kept
+ * @param series The series
+ * @param level The rollup index
+ * @return The start in milliseconds
+ *
+ * The ring holds the bucket of the latest sample and the
+ * BUCKET_CAPACITY - 1 buckets before it.
+ */
+qint64 TelemetryHistory::retainedFrom(const Series& series, int level)
+{
+    const qint64 duration = LEVEL_DURATIONS[level];
+    return (floorDiv(series.latest, duration) - (BUCKET_CAPACITY - 1)) * duration;
+}
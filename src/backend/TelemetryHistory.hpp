@@ -0,0 +1,269 @@
+#ifndef TELEMETRYHISTORY_HPP
+#define TELEMETRYHISTORY_HPP
+
+#include <QObject>
+#include <QHash>
+#include <array>
+#include <limits>
+#include <vector>
+#include "TelemetryBus.hpp"
+#include "TelemetryFrame.hpp"
+
+class TelemetrySubscriber;
+
+/**
+ * @class TelemetryHistory
+ * @brief In-memory time series of the telemetry of many vehicles
+ *
+ * Every vehicle keeps its samples in columns: one array of timestamps and
+ * one array per channel, in a ring of the most recent RAW_CAPACITY samples.
+ * Each sample is also folded into rollups at the resolutions of
+ * LEVEL_DURATIONS, rings of BUCKET_CAPACITY buckets with the minimum,
+ * maximum and sum of every channel. The memory of a vehicle is allocated
+ * once, when it is first appended, and never grows: with the defaults it
+ * holds the last minutes of samples and about 60 hours of 10-minute
+ * rollups.
+ *
+ * A query for a window at M points reads the coarsest rollup that still
+ * resolves the window into M intervals, i.e. fewer than ten buckets per
+ * point, so its cost depends on M and not on the number of samples in the
+ * window. Only windows shorter than M seconds read raw samples.
+ *
+ * Timestamps of a vehicle must not decrease; a sample older than the
+ * previous one, e.g. after seeking a replay back, starts its history over.
+ */
+class TelemetryHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Channel
+     * @brief The telemetry fields kept per sample
+     */
+    enum Channel {
+        Altitude,
+        Speed,
+        Battery,
+        ChannelCount
+    };
+    Q_ENUM(Channel)
+
+    /**
+     * @struct Point
+     * @brief The samples of one query interval
+     */
+    struct Point
+    {
+        /** @brief Start of the interval in milliseconds */
+        qint64 timestamp;
+
+        /** @brief Smallest value in the interval */
+        float minimum;
+
+        /** @brief Largest value in the interval */
+        float maximum;
+
+        /** @brief Mean value in the interval */
+        float average;
+    };
+
+    /** @brief Raw samples kept per vehicle */
+    static constexpr int RAW_CAPACITY = 1200;
+
+    /** @brief Buckets kept per vehicle and rollup */
+    static constexpr int BUCKET_CAPACITY = 360;
+
+    /** @brief Number of rollups */
+    static constexpr int LEVEL_COUNT = 4;
+
+    /** @brief Bucket durations of the rollups in milliseconds, finest first */
+    static constexpr std::array<qint64, LEVEL_COUNT> LEVEL_DURATIONS = {1000, 10000, 60000, 600000};
+
+    /** @brief Vehicles kept by default */
+    static constexpr int DEFAULT_VEHICLE_CAPACITY = 256;
+
+    /** @brief Returned by latestTimestamp() for vehicles without samples */
+    static constexpr qint64 NO_TIMESTAMP = std::numeric_limits<qint64>::min();
+
+    /**
+     * @brief Constructs an empty history
+     * @param vehicleCapacity Number of vehicles kept; frames of further vehicles are dropped
+     * @param parent The parent QObject
+     */
+    explicit TelemetryHistory(int vehicleCapacity = DEFAULT_VEHICLE_CAPACITY, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TelemetryHistory();
+
+    /**
+     * @brief Gets the memory allocated per vehicle
+     * @return The size in bytes
+     */
+    static qint64 bytesPerVehicle();
+
+    /**
+     * @brief Appends every frame published on a bus
+     * @param bus The bus, or nullptr to stop
+     */
+    void attach(TelemetryBus* bus);
+
+    /**
+     * @brief Appends a sample
+     * @param vehicle The vehicle id
+     * @param frame The frame; its timestamp is the sample time
+     */
+    void append(quint32 vehicle, const TelemetryFrame& frame);
+
+    /**
+     * @brief Appends a batch of frames
+     * @param batch The frames
+     *
+     * Emits updated() once for the batch.
+     */
+    void append(const TelemetryBus::FrameBatch& batch);
+
+    /**
+     * @brief Forgets all vehicles and samples
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of vehicles with a history
+     * @return The vehicle count
+     */
+    int vehicleCount() const;
+
+    /**
+     * @brief Gets the maximum number of vehicles
+     * @return The vehicle capacity
+     */
+    int vehicleCapacity() const;
+
+    /**
+     * @brief Checks whether a vehicle has a history
+     * @param vehicle The vehicle id
+     * @return True if samples were appended for it
+     */
+    bool contains(quint32 vehicle) const;
+
+    /**
+     * @brief Gets the time of a vehicle's latest sample
+     * @param vehicle The vehicle id
+     * @return The timestamp in milliseconds, or NO_TIMESTAMP
+     */
+    qint64 latestTimestamp(quint32 vehicle) const;
+
+    /**
+     * @brief Gets the number of frames dropped because the history was full
+     * @return The dropped frame count
+     */
+    quint64 droppedFrames() const;
+
+    /**
+     * @brief Downsamples a channel of a vehicle over a time window
+     * @param vehicle The vehicle id
+     * @param channel The channel
+     * @param from Start of the window in milliseconds
+     * @param to End of the window in milliseconds, exclusive
+     * @param points Number of equal intervals the window is divided into
+     * @return One point per interval with samples, in time order
+     */
+    std::vector<Point> query(quint32 vehicle, Channel channel, qint64 from, qint64 to, int points) const;
+
+    /**
+     * @brief Downsamples the most recent part of a channel
+     * @param vehicle The vehicle id
+     * @param channel The channel
+     * @param duration Length of the window in milliseconds, ending with the latest sample
+     * @param points Number of equal intervals the window is divided into
+     * @return One point per interval with samples, in time order
+     */
+    std::vector<Point> queryLast(quint32 vehicle, Channel channel, qint64 duration, int points) const;
+
+signals:
+    /**
+     * @brief Emitted after a batch of frames has been appended
+     */
+    void updated();
+
+private:
+    /**
+     * @struct Level
+     * @brief A ring of rollup buckets, one column per aggregate and channel
+     *
+     * A bucket covers [start, start + duration) and lives at index
+     * (start / duration) % BUCKET_CAPACITY; a stale start marks a bucket
+     * that has been overwritten or never written.
+     */
+    struct Level
+    {
+        std::vector<qint64> starts;
+        std::vector<quint32> counts;
+        std::array<std::vector<float>, ChannelCount> minimum;
+        std::array<std::vector<float>, ChannelCount> maximum;
+        std::array<std::vector<double>, ChannelCount> sum;
+    };
+
+    /**
+     * @struct Series
+     * @brief The history of one vehicle
+     */
+    struct Series
+    {
+        quint32 vehicle;
+        quint64 sampleCount;
+        qint64 first;
+        qint64 latest;
+        std::vector<qint64> times;
+        std::array<std::vector<float>, ChannelCount> values;
+        std::array<Level, LEVEL_COUNT> levels;
+    };
+
+    /**
+     * @brief Finds or allocates the series of a vehicle
+     * @param vehicle The vehicle id
+     * @return The series, or nullptr if the history is full
+     */
+    Series* series(quint32 vehicle);
+
+    /**
+     * @brief Finds the series of a vehicle
+     * @param vehicle The vehicle id
+     * @return The series, or nullptr if the vehicle has no history
+     */
+    const Series* find(quint32 vehicle) const;
+
+    /**
+     * @brief Empties a series without releasing its memory
+     * @param series The series
+     */
+    static void reset(Series& series);
+
+    /**
+     * @brief Gets the start of the oldest bucket of a rollup still kept
+     * @param series The series
+     * @param level The rollup index
+     * @return The start in milliseconds
+     */
+    static qint64 retainedFrom(const Series& series, int level);
+
+    /** @brief Maximum number of vehicles */
+    int m_vehicleCapacity;
+
+    /** @brief Series index of every vehicle id */
+    QHash<quint32, int> m_index;
+
+    /** @brief Series of all vehicles, in the order they were first appended */
+    std::vector<Series> m_series;
+
+    /** @brief Frames dropped because the history was full */
+    quint64 m_droppedFrames;
+
+    /** @brief Receives the frames of the attached bus */
+    TelemetrySubscriber* m_subscriber;
+};
+
+#endif // TELEMETRYHISTORY_HPP
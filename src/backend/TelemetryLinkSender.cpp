@@ -0,0 +1,173 @@
+#include "TelemetryLinkSender.hpp"
+#include <QElapsedTimer>
+#include <QThread>
+#include <QUdpSocket>
+
+/**
+ * @brief Constructs an idle sender
+ * @param parent The parent QObject
+ */
+TelemetryLinkSender::TelemetryLinkSender(QObject* parent)
+    : QObject(parent)
+    , m_thread(nullptr)
+    , m_address(QHostAddress::LocalHost)
+    , m_port(0)
+    , m_rate(1000)
+    , m_framesPerDatagram(1)
+    , m_stopRequested(false)
+    , m_framesSent(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TelemetryLinkSender::~TelemetryLinkSender()
+{
+    stop();
+}
+
+void TelemetryLinkSender::setDestination(const QHostAddress& address, quint16 port)
+{
+    m_address = address;
+    m_port = port;
+}
+
+void TelemetryLinkSender::setFrames(const QVector<TelemetryProtocol::WireFrame>& frames)
+{
+    m_frames = frames;
+}
+
+void TelemetryLinkSender::setRate(int rate)
+{
+    m_rate = qBound(1, rate, MAX_RATE);
+}
+
+int TelemetryLinkSender::rate() const
+{
+    return m_rate;
+}
+
+void TelemetryLinkSender::setFramesPerDatagram(int count)
+{
+    m_framesPerDatagram = qBound(1, count, TelemetryProtocol::MAX_FRAMES_PER_DATAGRAM);
+}
+
+/**
+ * @brief Starts replaying on the sender thread
+ * @return False if a replay is already running or nothing is configured
+ *
+ * The configuration must not be changed while a replay is running.
+ */
+bool TelemetryLinkSender::start()
+{
+    if (isRunning() || m_port == 0 || m_frames.isEmpty()) {
+        return false;
+    }
+
+    stop();
+
+    m_stopRequested = false;
+    m_framesSent = 0;
+    m_thread = QThread::create([this]() { run(); });
+    connect(m_thread, &QThread::finished, this, &TelemetryLinkSender::finished);
+    m_thread->start();
+    return true;
+}
+
+/**
+ * @brief Stops the replay and waits for the sender thread
+ */
+void TelemetryLinkSender::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    m_stopRequested = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+bool TelemetryLinkSender::isRunning() const
+{
+    return m_thread && m_thread->isRunning();
+}
+
+quint64 TelemetryLinkSender::framesSent() const
+{
+    return m_framesSent.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Creates a synthetic flight for replay
+ * @param vehicleId The vehicle id stamped on every frame
+ * @param count The number of frames
+ * @param origin The position of the first frame
+ * @return Frames climbing and heading north-east with increasing sequence numbers
+ *
+ * Each frame moves about one meter and drains the battery linearly, so
+ * consecutive frames are always distinguishable.
+ */
+QVector<TelemetryProtocol::WireFrame> TelemetryLinkSender::syntheticFlight(quint16 vehicleId, int count, const QGeoCoordinate& origin)
+{
+    QVector<TelemetryProtocol::WireFrame> frames;
+    frames.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        TelemetryProtocol::WireFrame frame;
+        frame.vehicleId = vehicleId;
+        frame.state = UASState::Flying;
+        frame.battery = static_cast<quint8>(100 - (i * 100) / qMax(1, count));
+        frame.sequence = static_cast<quint32>(i);
+        frame.timestamp = i;
+        frame.latitude = origin.latitude() + i * 1e-5;
+        frame.longitude = origin.longitude() + i * 1e-5;
+        frame.altitude = i / 10;
+        frame.speed = 40;
+        frames.append(frame);
+    }
+
+    return frames;
+}
+
+/**
+ * @brief Sends all frames at the configured rate (sender thread)
+ *
+ * Each datagram has a deadline derived from its index, so a late datagram
+ * does not shift the ones after it. The thread sleeps while it is well
+ * ahead of schedule and yields for the last stretch, which keeps pacing
+ * accurate at rates above the scheduler's sleep granularity.
+ */
+void TelemetryLinkSender::run()
+{
+    QUdpSocket socket;
+    char datagram[TelemetryProtocol::MAX_DATAGRAM_SIZE];
+
+    const qint64 datagramPeriodNs = 1000000000LL * m_framesPerDatagram / m_rate;
+    const int total = m_frames.size();
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    for (int first = 0, index = 0; first < total && !m_stopRequested; first += m_framesPerDatagram, ++index) {
+        const qint64 deadline = index * datagramPeriodNs;
+        qint64 remaining = deadline - elapsed.nsecsElapsed();
+        while (remaining > 0 && !m_stopRequested) {
+            if (remaining > 2000000) {
+                QThread::usleep(1000);
+            } else {
+                QThread::yieldCurrentThread();
+            }
+            remaining = deadline - elapsed.nsecsElapsed();
+        }
+
+        const int count = qMin(m_framesPerDatagram, total - first);
+        const int size = TelemetryProtocol::encodeDatagram(m_frames.constData() + first, count,
+                                                           datagram, sizeof(datagram));
+        if (socket.writeDatagram(datagram, size, m_address, m_port) == size) {
+            m_framesSent.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef TELEMETRYLINKSENDER_HPP
+#define TELEMETRYLINKSENDER_HPP
+
+#include <QObject>
+#include <QGeoCoordinate>
+#include <QHostAddress>
+#include <QVector>
+#include <atomic>
+#include "TelemetryProtocol.hpp"
+
+class QThread;
+
+/**
+ * @class TelemetryLinkSender
+ * @brief Replays telemetry frames over UDP at a fixed rate
+ *
+ * Stand-in for a vehicle on the other end of a TelemetryDataLink, used for
+ * loopback testing and bench runs. Frames are sent from a dedicated thread
+ * and paced against a monotonic clock, so rates of up to MAX_RATE frames
+ * per second are held without drift.
+ */
+class TelemetryLinkSender : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief Highest supported replay rate in frames per second */
+    static constexpr int MAX_RATE = 10000;
+
+    /**
+     * @brief Constructs an idle sender
+     * @param parent The parent QObject
+     */
+    explicit TelemetryLinkSender(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TelemetryLinkSender();
+
+    /**
+     * @brief Sets where frames are sent to
+     * @param address The destination address
+     * @param port The destination port
+     */
+    void setDestination(const QHostAddress& address, quint16 port);
+
+    /**
+     * @brief Sets the frames to replay
+     * @param frames The frames, sent in order
+     */
+    void setFrames(const QVector<TelemetryProtocol::WireFrame>& frames);
+
+    /**
+     * @brief Sets the replay rate
+     * @param rate Frames per second, bounded to 1-MAX_RATE
+     */
+    void setRate(int rate);
+
+    /**
+     * @brief Gets the replay rate
+     * @return Frames per second
+     */
+    int rate() const;
+
+    /**
+     * @brief Sets how many frames are batched into one datagram
+     * @param count Frames per datagram, bounded to 1-MAX_FRAMES_PER_DATAGRAM
+     */
+    void setFramesPerDatagram(int count);
+
+    /**
+     * @brief Starts replaying on the sender thread
+     * @return False if a replay is already running or nothing is configured
+     */
+    bool start();
+
+    /**
+     * @brief Stops the replay and waits for the sender thread
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether a replay is running
+     * @return True if the sender thread is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Gets the number of frames sent by the current or last replay
+     * @return The frame count
+     */
+    quint64 framesSent() const;
+
+    /**
+     * @brief Creates a synthetic flight for replay
+     * @param vehicleId The vehicle id stamped on every frame
+     * @param count The number of frames
+     * @param origin The position of the first frame
+     * @return Frames climbing and heading north-east with increasing sequence numbers
+     */
+    static QVector<TelemetryProtocol::WireFrame> syntheticFlight(quint16 vehicleId, int count, const QGeoCoordinate& origin);
+
+signals:
+    /**
+     * @brief Emitted when a replay has finished or was stopped
+     */
+    void finished();
+
+private:
+    /**
+     * @brief Sends all frames at the configured rate (sender thread)
+     */
+    void run();
+
+    /** @brief Thread running the current replay */
+    QThread* m_thread;
+
+    /** @brief Destination address */
+    QHostAddress m_address;
+
+    /** @brief Destination port */
+    quint16 m_port;
+
+    /** @brief Frames to replay */
+    QVector<TelemetryProtocol::WireFrame> m_frames;
+
+    /** @brief Frames per second */
+    int m_rate;
+
+    /** @brief Frames per datagram */
+    int m_framesPerDatagram;
+
+    /** @brief Set to request the sender thread to stop */
+    std::atomic<bool> m_stopRequested;
+
+    /** @brief Number of frames sent */
+    std::atomic<quint64> m_framesSent;
+};
+
+#endif // TELEMETRYLINKSENDER_HPP
@@ -0,0 +1,264 @@
+#include "TelemetryPresenter.hpp"
+#include "TelemetrySubscriber.hpp"
+#include "WebMercator.hpp"
+#include <cmath>
+
+/**
+ * @brief Constructs a presenter without samples
+ * @param positions The positions to place the presented markers into, or nullptr
+ * @param parent The parent QObject
+ */
+TelemetryPresenter::TelemetryPresenter(VehiclePositions* positions, QObject* parent)
+    : QObject(parent)
+    , m_positions(positions)
+    , m_vehicle(0)
+    , m_animating(false)
+    , m_anchored(false)
+    , m_anchorSourceTime(0)
+    , m_anchorTime(0.0)
+    , m_rate(1.0)
+    , m_subscriber(nullptr)
+{
+    m_clock.start();
+}
+
+/**
+ * @brief Destructor
+ */
+TelemetryPresenter::~TelemetryPresenter()
+{
+}
+
+void TelemetryPresenter::attach(TelemetryBus* bus)
+{
+    delete m_subscriber;
+    m_subscriber = nullptr;
+
+    if (bus) {
+        m_subscriber = new TelemetrySubscriber(TelemetryBus::Frames, 0.0, this);
+        connect(m_subscriber, &TelemetrySubscriber::framesReceived, this,
+            [this](const TelemetryBus::FrameBatchPointer& batch) {
+                append(*batch, elapsed());
+            });
+        bus->subscribe(m_subscriber);
+    }
+}
+
+/**
+ * @brief Buffers the positions of a batch of frames
+ * @param batch The frames
+ * @param time Wall time of the arrival in milliseconds, see elapsed()
+ *
+ * Anchors the source clock on the batch and updates the rate from the
+ * previous anchor. For every vehicle, the position presented just before
+ * the sample is kept as a correction, so the presented position
+ * continues from where it was and converges onto the new extrapolation
+ * within BLEND_INTERVAL. A sample older than the previous one, e.g. after
+ * seeking a replay backwards, moves the vehicle there without blending.
+ */
+void TelemetryPresenter::append(const TelemetryBus::FrameBatch& batch, double time)
+{
+    const double before = m_anchored ? sourceTime(time) : static_cast<double>(batch.timestamp);
+    if (m_anchored) {
+        const qint64 elapsedSource = batch.timestamp - m_anchorSourceTime;
+        const double elapsedWall = time - m_anchorTime;
+        if (elapsedSource >= 0 && elapsedWall >= MIN_RATE_INTERVAL && elapsedWall <= MAX_RATE_INTERVAL) {
+            m_rate += RATE_SMOOTHING * (elapsedSource / elapsedWall - m_rate);
+        }
+    }
+    m_anchored = true;
+    m_anchorSourceTime = batch.timestamp;
+    m_anchorTime = time;
+    const double after = static_cast<double>(batch.timestamp);
+
+    for (const TelemetryBus::VehicleFrame& entry : batch.frames) {
+        const double x = WebMercator::x(entry.frame.longitude);
+        const double y = WebMercator::y(entry.frame.latitude);
+        const qint64 timestamp = entry.frame.timestamp;
+
+        const auto found = m_index.constFind(entry.vehicle);
+        if (found == m_index.constEnd()) {
+            m_index.insert(entry.vehicle, static_cast<int>(m_motions.size()));
+            m_motions.push_back({entry.vehicle, x, y, 0.0, 0.0, timestamp, 0, 0.0, 0.0, time, 0.0f});
+            continue;
+        }
+
+        Motion& motion = m_motions[found.value()];
+        if (timestamp <= motion.time) {
+            if (timestamp < motion.time) {
+                motion = {entry.vehicle, x, y, 0.0, 0.0, timestamp, 0, 0.0, 0.0, time, motion.heading};
+            }
+            continue;
+        }
+
+        double presentedX = 0.0;
+        double presentedY = 0.0;
+        locate(motion, before, time, presentedX, presentedY);
+
+        // Movements across the antimeridian take the short way around
+        double dx = x - motion.x;
+        dx -= std::floor(dx + 0.5);
+        const double dy = y - motion.y;
+        if (std::abs(dx) > VehiclePositions::HEADING_THRESHOLD || std::abs(dy) > VehiclePositions::HEADING_THRESHOLD) {
+            motion.heading = static_cast<float>(std::atan2(dx, -dy));
+        }
+        motion.interval = timestamp - motion.time;
+        motion.velocityX = dx / motion.interval;
+        motion.velocityY = dy / motion.interval;
+        motion.x = x;
+        motion.y = y;
+        motion.time = timestamp;
+        motion.correctionX = 0.0;
+        motion.correctionY = 0.0;
+
+        double extrapolatedX = 0.0;
+        double extrapolatedY = 0.0;
+        locate(motion, after, time, extrapolatedX, extrapolatedY);
+        motion.correctionX = presentedX - extrapolatedX;
+        motion.correctionX -= std::floor(motion.correctionX + 0.5);
+        motion.correctionY = presentedY - extrapolatedY;
+        motion.arrival = time;
+    }
+
+    if (!batch.frames.empty()) {
+        setAnimating(true);
+    }
+}
+
+/**
+ * @brief Places the positions of all vehicles at a time
+ * @param time Wall time in milliseconds, see elapsed()
+ *
+ * Places every marker and commits them once, publishes the position of
+ * the vehicle and stops animating once no position changes anymore.
+ */
+void TelemetryPresenter::present(double time)
+{
+    const double now = sourceTime(time);
+    bool moving = false;
+    QGeoCoordinate position;
+    for (const Motion& motion : m_motions) {
+        double x = 0.0;
+        double y = 0.0;
+        moving |= locate(motion, now, time, x, y);
+        if (m_positions) {
+            m_positions->place(motion.vehicle, x, y, motion.heading);
+        }
+        if (motion.vehicle == m_vehicle) {
+            position = QGeoCoordinate(WebMercator::latitude(y), WebMercator::longitude(x));
+        }
+    }
+    if (m_positions) {
+        m_positions->commit();
+    }
+
+    if (position != m_position) {
+        m_position = position;
+        emit positionChanged();
+    }
+    setAnimating(moving);
+}
+
+void TelemetryPresenter::present()
+{
+    present(elapsed());
+}
+
+void TelemetryPresenter::clear()
+{
+    m_index.clear();
+    m_motions.clear();
+    m_anchored = false;
+    m_rate = 1.0;
+    if (m_positions) {
+        m_positions->clear();
+    }
+    if (m_position.isValid()) {
+        m_position = QGeoCoordinate();
+        emit positionChanged();
+    }
+    setAnimating(false);
+}
+
+double TelemetryPresenter::elapsed() const
+{
+    return m_clock.nsecsElapsed() / 1e6;
+}
+
+double TelemetryPresenter::sourceTime(double time) const
+{
+    return m_anchorSourceTime + (time - m_anchorTime) * m_rate;
+}
+
+double TelemetryPresenter::rate() const
+{
+    return m_rate;
+}
+
+quint32 TelemetryPresenter::vehicle() const
+{
+    return m_vehicle;
+}
+
+void TelemetryPresenter::setVehicle(quint32 vehicle)
+{
+    if (m_vehicle == vehicle) {
+        return;
+    }
+
+    m_vehicle = vehicle;
+    emit vehicleChanged();
+    setAnimating(true);
+}
+
+QGeoCoordinate TelemetryPresenter::position() const
+{
+    return m_position;
+}
+
+bool TelemetryPresenter::animating() const
+{
+    return m_animating;
+}
+
+/**
+ * @brief Computes the presented position of a vehicle
+ * @param motion The vehicle
+ * @param sourceTime Source time to extrapolate to
+ * @param time Wall time to blend the correction at
+ * @param x Receives the world x coordinate
+ * @param y Receives the world y coordinate
+ * @return True if the position still changes after this time
+ *
+ * Source times before the latest sample interpolate between it and the
+ * previous one, so a presentation clock running slightly behind the
+ * samples still moves the vehicle along its path.
+ */
+bool TelemetryPresenter::locate(const Motion& motion, double sourceTime, double time, double& x, double& y)
+{
+    const double limit = MAX_EXTRAPOLATION * motion.interval;
+    const double ahead = qBound(-static_cast<double>(motion.interval), sourceTime - motion.time, limit);
+    x = motion.x + motion.velocityX * ahead;
+    y = motion.y + motion.velocityY * ahead;
+
+    const double weight = 1.0 - (time - motion.arrival) / BLEND_INTERVAL;
+    const bool blending = weight > 0.0 && (motion.correctionX != 0.0 || motion.correctionY != 0.0);
+    if (blending) {
+        x += motion.correctionX * qMin(weight, 1.0);
+        y += motion.correctionY * qMin(weight, 1.0);
+    }
+    x -= std::floor(x);
+
+    const bool extrapolating = ahead < limit && (motion.velocityX != 0.0 || motion.velocityY != 0.0);
+    return blending || extrapolating;
+}
+
+void TelemetryPresenter::setAnimating(bool animating)
+{
+    if (m_animating == animating) {
+        return;
+    }
+
+    m_animating = animating;
+    emit animatingChanged();
+}
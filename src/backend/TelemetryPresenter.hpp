@@ -0,0 +1,257 @@
+#ifndef TELEMETRYPRESENTER_HPP
+#define TELEMETRYPRESENTER_HPP
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QGeoCoordinate>
+#include <QHash>
+#include <QPointer>
+#include <vector>
+#include "TelemetryBus.hpp"
+#include "VehiclePositions.hpp"
+
+class TelemetrySubscriber;
+
+/**
+ * @class TelemetryPresenter
+ * @brief Presents vehicle positions at the display rate, decoupled from the telemetry rate
+ *
+ * Telemetry arrives a few times per second, but the map is drawn at the
+ * refresh rate of the display. Instead of animating from one sample to
+ * the next, which lags behind by the animation length and restarts on
+ * every sample, the presenter keeps the latest sample of every vehicle
+ * and the velocity since the previous one, both in WebMercator world
+ * coordinates, and computes the positions at the time of each rendered
+ * frame with present(). A frame between two samples is therefore at most
+ * one frame behind the extrapolated reality.
+ *
+ * Samples are stamped in source time, which can run faster or slower than
+ * the wall clock under a time warp or a playback rate. The presenter maps
+ * source time onto its own clock from the arrival times of the batches,
+ * with a smoothed rate. Extrapolation stops MAX_EXTRAPOLATION sample
+ * intervals past the latest sample, so a vehicle that stops reporting
+ * stops moving. When a sample disagrees with the extrapolation, the
+ * difference is blended out over BLEND_INTERVAL instead of jumping.
+ *
+ * The presented markers are placed into a VehiclePositions, and the
+ * position of one vehicle is published for auto-centering the map.
+ */
+class TelemetryPresenter : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(quint32 vehicle READ vehicle WRITE setVehicle NOTIFY vehicleChanged)
+    Q_PROPERTY(QGeoCoordinate position READ position NOTIFY positionChanged)
+    Q_PROPERTY(bool animating READ animating NOTIFY animatingChanged)
+
+public:
+    /** @brief Milliseconds over which the correction of a new sample fades out */
+    static constexpr double BLEND_INTERVAL = 100.0;
+
+    /** @brief Sample intervals past the latest sample that a vehicle is extrapolated */
+    static constexpr double MAX_EXTRAPOLATION = 2.0;
+
+    /** @brief Weight of the latest batch in the smoothed source time rate */
+    static constexpr double RATE_SMOOTHING = 0.2;
+
+    /** @brief Shortest wall time between two batches to estimate the rate from, in milliseconds */
+    static constexpr double MIN_RATE_INTERVAL = 10.0;
+
+    /** @brief Longest wall time between two batches to estimate the rate from, e.g. across a pause */
+    static constexpr double MAX_RATE_INTERVAL = 2000.0;
+
+    /**
+     * @brief Constructs a presenter without samples
+     * @param positions The positions to place the presented markers into, or nullptr
+     * @param parent The parent QObject
+     */
+    explicit TelemetryPresenter(VehiclePositions* positions = nullptr, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TelemetryPresenter();
+
+    /**
+     * @brief Buffers every frame published on a bus
+     * @param bus The bus, or nullptr to stop
+     */
+    void attach(TelemetryBus* bus);
+
+    /**
+     * @brief Buffers the positions of a batch of frames
+     * @param batch The frames
+     * @param time Wall time of the arrival in milliseconds, see elapsed()
+     */
+    void append(const TelemetryBus::FrameBatch& batch, double time);
+
+    /**
+     * @brief Places the positions of all vehicles at a time
+     * @param time Wall time in milliseconds, see elapsed()
+     */
+    void present(double time);
+
+    /**
+     * @brief Places the positions of all vehicles now, once per rendered frame
+     */
+    Q_INVOKABLE void present();
+
+    /**
+     * @brief Forgets all samples
+     */
+    void clear();
+
+    /**
+     * @brief Gets the wall time of the presenter's clock
+     * @return Milliseconds since construction
+     */
+    double elapsed() const;
+
+    /**
+     * @brief Maps a wall time onto source time
+     * @param time Wall time in milliseconds, see elapsed()
+     * @return Source time in milliseconds
+     */
+    double sourceTime(double time) const;
+
+    /**
+     * @brief Gets the smoothed rate of source time
+     * @return Source milliseconds per wall millisecond
+     */
+    double rate() const;
+
+    /**
+     * @brief Gets the vehicle whose position is published
+     * @return The vehicle id
+     */
+    quint32 vehicle() const;
+
+    /**
+     * @brief Sets the vehicle whose position is published
+     * @param vehicle The vehicle id
+     */
+    void setVehicle(quint32 vehicle);
+
+    /**
+     * @brief Gets the presented position of the vehicle
+     * @return The coordinate, invalid until the vehicle was presented
+     */
+    QGeoCoordinate position() const;
+
+    /**
+     * @brief Checks whether the presented positions still change over time
+     * @return True while a vehicle is extrapolated or blended, or samples wait to be presented
+     */
+    bool animating() const;
+
+signals:
+    /**
+     * @brief Emitted when the vehicle changes
+     */
+    void vehicleChanged();
+
+    /**
+     * @brief Emitted when the presented position of the vehicle changes
+     */
+    void positionChanged();
+
+    /**
+     * @brief Emitted when animating() changes
+     */
+    void animatingChanged();
+
+private:
+    /**
+     * @struct Motion
+     * @brief The latest sample of one vehicle and its velocity
+     */
+    struct Motion
+    {
+        /** @brief The vehicle id */
+        quint32 vehicle;
+
+        /** @brief World x coordinate of the latest sample */
+        double x;
+
+        /** @brief World y coordinate of the latest sample */
+        double y;
+
+        /** @brief World x units per source millisecond */
+        double velocityX;
+
+        /** @brief World y units per source millisecond */
+        double velocityY;
+
+        /** @brief Source time of the latest sample in milliseconds */
+        qint64 time;
+
+        /** @brief Source milliseconds since the previous sample, 0 for none */
+        qint64 interval;
+
+        /** @brief World x offset of the presented position when the sample arrived */
+        double correctionX;
+
+        /** @brief World y offset of the presented position when the sample arrived */
+        double correctionY;
+
+        /** @brief Wall time the sample arrived in milliseconds */
+        double arrival;
+
+        /** @brief Radians clockwise from north of the last movement */
+        float heading;
+    };
+
+    /**
+     * @brief Computes the presented position of a vehicle
+     * @param motion The vehicle
+     * @param sourceTime Source time to extrapolate to
+     * @param time Wall time to blend the correction at
+     * @param x Receives the world x coordinate
+     * @param y Receives the world y coordinate
+     * @return True if the position still changes after this time
+     */
+    static bool locate(const Motion& motion, double sourceTime, double time, double& x, double& y);
+
+    /**
+     * @brief Sets whether the presented positions still change
+     * @param animating The new state
+     */
+    void setAnimating(bool animating);
+
+    /** @brief The positions the markers are placed into */
+    QPointer<VehiclePositions> m_positions;
+
+    /** @brief Vehicle whose position is published */
+    quint32 m_vehicle;
+
+    /** @brief Presented position of the vehicle */
+    QGeoCoordinate m_position;
+
+    /** @brief Whether the presented positions still change */
+    bool m_animating;
+
+    /** @brief Wall clock of arrivals and presentations */
+    QElapsedTimer m_clock;
+
+    /** @brief Whether a batch arrived since construction or clear() */
+    bool m_anchored;
+
+    /** @brief Source time of the latest batch in milliseconds */
+    qint64 m_anchorSourceTime;
+
+    /** @brief Wall time the latest batch arrived in milliseconds */
+    double m_anchorTime;
+
+    /** @brief Smoothed source milliseconds per wall millisecond */
+    double m_rate;
+
+    /** @brief Motion index of every vehicle id */
+    QHash<quint32, int> m_index;
+
+    /** @brief Motions of all vehicles, in the order they were first seen */
+    std::vector<Motion> m_motions;
+
+    /** @brief Receives the frames of the attached bus */
+    TelemetrySubscriber* m_subscriber;
+};
+
+#endif // TELEMETRYPRESENTER_HPP
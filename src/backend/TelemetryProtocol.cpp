@@ -0,0 +1,122 @@
+#include "TelemetryProtocol.hpp"
+#include <QtMath>
+#include <cstring>
+
+namespace TelemetryProtocol {
+
+/**
+ * @brief Encodes one frame record
+ * @param frame The frame to encode
+ * @param out Destination of at least FRAME_SIZE bytes
+ *
+ * Coordinates are stored as fixed-point degrees * 1e7, which keeps roughly
+ * centimeter resolution.
+ */
+void encodeFrame(const WireFrame& frame, char* out)
+{
+    qToLittleEndian<quint16>(frame.vehicleId, out);
+    out[2] = static_cast<char>(frame.state);
+    out[3] = static_cast<char>(frame.battery);
+    qToLittleEndian<quint32>(frame.sequence, out + 4);
+    qToLittleEndian<qint64>(frame.timestamp, out + 8);
+    qToLittleEndian<qint32>(static_cast<qint32>(qRound64(frame.latitude * 1e7)), out + 16);
+    qToLittleEndian<qint32>(static_cast<qint32>(qRound64(frame.longitude * 1e7)), out + 20);
+    qToLittleEndian<qint32>(frame.altitude, out + 24);
+    qToLittleEndian<qint16>(frame.speed, out + 28);
+    qToLittleEndian<quint16>(0, out + 30);
+}
+
+/**
+ * @brief Decodes one frame record in place
+ * @param in Source of at least FRAME_SIZE bytes
+ * @return The decoded frame
+ *
+ * Unknown states are clamped to Landed rather than passed on as invalid
+ * enum values.
+ */
+WireFrame decodeFrame(const char* in)
+{
+    WireFrame frame;
+    frame.vehicleId = qFromLittleEndian<quint16>(in);
+
+    const quint8 state = static_cast<quint8>(in[2]);
+    frame.state = state <= UASState::Landing ? static_cast<UASState::State>(state) : UASState::Landed;
+
+    frame.battery = static_cast<quint8>(in[3]);
+    frame.sequence = qFromLittleEndian<quint32>(in + 4);
+    frame.timestamp = qFromLittleEndian<qint64>(in + 8);
+    frame.latitude = qFromLittleEndian<qint32>(in + 16) / 1e7;
+    frame.longitude = qFromLittleEndian<qint32>(in + 20) / 1e7;
+    frame.altitude = qFromLittleEndian<qint32>(in + 24);
+    frame.speed = qFromLittleEndian<qint16>(in + 28);
+    return frame;
+}
+
+/**
+ * @brief Encodes a datagram holding several frames
+ * @param frames The frames to encode
+ * @param count The number of frames (at most MAX_FRAMES_PER_DATAGRAM)
+ * @param out Destination buffer
+ * @param capacity Size of the destination buffer in bytes
+ * @return The datagram size in bytes, or 0 if it does not fit
+ */
+int encodeDatagram(const WireFrame* frames, int count, char* out, int capacity)
+{
+    const int size = HEADER_SIZE + count * FRAME_SIZE;
+    if (count < 0 || count > MAX_FRAMES_PER_DATAGRAM || size > capacity) {
+        return 0;
+    }
+
+    qToLittleEndian<quint32>(MAGIC, out);
+    out[4] = static_cast<char>(VERSION);
+    out[5] = static_cast<char>(count);
+    qToLittleEndian<quint16>(0, out + 6);
+
+    for (int i = 0; i < count; ++i) {
+        encodeFrame(frames[i], out + HEADER_SIZE + i * FRAME_SIZE);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Validates a datagram header
+ * @param data The datagram
+ * @param size The datagram size in bytes
+ * @return The number of frames in the datagram, or -1 if it is malformed
+ *
+ * A datagram is malformed if it is too short, carries the wrong magic or
+ * version, or if its size does not match the announced frame count.
+ */
+int validateDatagram(const char* data, qint64 size)
+{
+    if (size < HEADER_SIZE || qFromLittleEndian<quint32>(data) != MAGIC ||
+        static_cast<quint8>(data[4]) != VERSION) {
+        return -1;
+    }
+
+    const int count = static_cast<quint8>(data[5]);
+    if (size != HEADER_SIZE + static_cast<qint64>(count) * FRAME_SIZE) {
+        return -1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Converts a wire frame into a TelemetryFrame with all fields dirty
+ * @param frame The wire frame
+ * @return The telemetry frame
+ */
+TelemetryFrame toTelemetryFrame(const WireFrame& frame)
+{
+    TelemetryFrame telemetry;
+    telemetry.timestamp = frame.timestamp;
+    telemetry.setBattery(frame.battery);
+    telemetry.setAltitude(frame.altitude);
+    telemetry.setSpeed(frame.speed);
+    telemetry.setPosition(frame.latitude, frame.longitude);
+    return telemetry;
+}
+
+} // namespace TelemetryProtocol
@@ -0,0 +1,136 @@
+#ifndef TELEMETRYPROTOCOL_HPP
+#define TELEMETRYPROTOCOL_HPP
+
+#include <QtGlobal>
+#include <QtEndian>
+#include "TelemetryFrame.hpp"
+#include "UASStateMachine.hpp"
+
+/**
+ * @namespace TelemetryProtocol
+ * @brief Binary wire format of the vehicle telemetry link
+ *
+ * A datagram consists of an 8 byte header followed by up to 255 fixed-size
+ * 32 byte frame records. All values are little-endian:
+ *
+ * Header:
+ * | Offset | Size | Field                         |
+ * |--------|------|-------------------------------|
+ * | 0      | 4    | Magic "GCST"                  |
+ * | 4      | 1    | Protocol version              |
+ * | 5      | 1    | Number of frames              |
+ * | 6      | 2    | Reserved, must be zero        |
+ *
+ * Frame:
+ * | Offset | Size | Field                         |
+ * |--------|------|-------------------------------|
+ * | 0      | 2    | Vehicle id                    |
+ * | 2      | 1    | UASState::State               |
+ * | 3      | 1    | Battery (%)                   |
+ * | 4      | 4    | Sequence number               |
+ * | 8      | 8    | Timestamp (ms since epoch)    |
+ * | 16     | 4    | Latitude (degrees * 1e7)      |
+ * | 20     | 4    | Longitude (degrees * 1e7)     |
+ * | 24     | 4    | Altitude (m)                  |
+ * | 28     | 2    | Speed (m/s)                   |
+ * | 30     | 2    | Reserved, must be zero        |
+ *
+ * Frames are decoded field by field straight out of the receive buffer, so
+ * parsing never copies the datagram or allocates.
+ */
+namespace TelemetryProtocol {
+
+/** @brief Datagram magic, "GCST" when read as little-endian bytes */
+constexpr quint32 MAGIC = 0x54534347;
+
+/** @brief Current protocol version */
+constexpr quint8 VERSION = 1;
+
+/** @brief Size of the datagram header in bytes */
+constexpr int HEADER_SIZE = 8;
+
+/** @brief Size of one frame record in bytes */
+constexpr int FRAME_SIZE = 32;
+
+/** @brief Maximum number of frames carried by one datagram */
+constexpr int MAX_FRAMES_PER_DATAGRAM = 255;
+
+/** @brief Size of the largest valid datagram in bytes */
+constexpr int MAX_DATAGRAM_SIZE = HEADER_SIZE + FRAME_SIZE * MAX_FRAMES_PER_DATAGRAM;
+
+/**
+ * @struct WireFrame
+ * @brief A decoded frame record
+ */
+struct WireFrame
+{
+    quint16 vehicleId = 0;
+    UASState::State state = UASState::Landed;
+    quint8 battery = 0;
+    quint32 sequence = 0;
+    qint64 timestamp = 0;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    qint32 altitude = 0;
+    qint16 speed = 0;
+};
+
+/**
+ * @brief Encodes one frame record
+ * @param frame The frame to encode
+ * @param out Destination of at least FRAME_SIZE bytes
+ */
+void encodeFrame(const WireFrame& frame, char* out);
+
+/**
+ * @brief Decodes one frame record in place
+ * @param in Source of at least FRAME_SIZE bytes
+ * @return The decoded frame
+ */
+WireFrame decodeFrame(const char* in);
+
+/**
+ * @brief Encodes a datagram holding several frames
+ * @param frames The frames to encode
+ * @param count The number of frames (at most MAX_FRAMES_PER_DATAGRAM)
+ * @param out Destination buffer
+ * @param capacity Size of the destination buffer in bytes
+ * @return The datagram size in bytes, or 0 if it does not fit
+ */
+int encodeDatagram(const WireFrame* frames, int count, char* out, int capacity);
+
+/**
+ * @brief Validates a datagram header
+ * @param data The datagram
+ * @param size The datagram size in bytes
+ * @return The number of frames in the datagram, or -1 if it is malformed
+ */
+int validateDatagram(const char* data, qint64 size);
+
+/**
+ * @brief Decodes every frame of a datagram and passes it to a visitor
+ * @param data The datagram
+ * @param size The datagram size in bytes
+ * @param visit Callable taking a const WireFrame&
+ * @return The number of frames visited, or -1 if the datagram is malformed
+ */
+template <typename Visitor>
+int parseDatagram(const char* data, qint64 size, Visitor&& visit)
+{
+    const int count = validateDatagram(data, size);
+    for (int i = 0; i < count; ++i) {
+        visit(decodeFrame(data + HEADER_SIZE + i * FRAME_SIZE));
+    }
+    return count;
+}
+
+/**
+ * @brief Converts a wire frame into a TelemetryFrame with all fields dirty
+ * @param frame The wire frame
+ * @return The telemetry frame
+ */
+TelemetryFrame toTelemetryFrame(const WireFrame& frame);
+
+} // namespace TelemetryProtocol
+
+#endif // TELEMETRYPROTOCOL_HPP
@@ -0,0 +1,116 @@
+#include "TelemetrySubscriber.hpp"
+#include <QMutexLocker>
+#include <QTimer>
+#include <QtMath>
+
+/**
+ * @brief Constructs a subscriber
+ * @param topics The topics to receive
+ * @param maxRate Maximum deliveries per second, 0 for every publication
+ * @param parent The parent QObject
+ */
+TelemetrySubscriber::TelemetrySubscriber(TelemetryBus::Topics topics, double maxRate, QObject* parent)
+    : QObject(parent)
+    , m_topics(topics)
+    , m_minInterval(0)
+    , m_bus(nullptr)
+    , m_rateTimer(new QTimer(this))
+{
+    m_rateTimer->setSingleShot(true);
+    connect(m_rateTimer, &QTimer::timeout, this, &TelemetrySubscriber::deliver);
+    setMaxRate(maxRate);
+}
+
+/**
+ * @brief Destructor
+ *
+ * Unsubscribes from the bus, so no delivery is posted to the subscriber
+ * once it is gone.
+ */
+TelemetrySubscriber::~TelemetrySubscriber()
+{
+    if (m_bus) {
+        m_bus->unsubscribe(this);
+    }
+}
+
+TelemetryBus::Topics TelemetrySubscriber::topics() const
+{
+    return m_topics;
+}
+
+double TelemetrySubscriber::maxRate() const
+{
+    return m_minInterval > 0 ? 1000.0 / m_minInterval : 0.0;
+}
+
+void TelemetrySubscriber::setMaxRate(double rate)
+{
+    m_minInterval = rate > 0.0 ? qMax<qint64>(1, qRound64(1000.0 / rate)) : 0;
+}
+
+TelemetryBus* TelemetrySubscriber::bus() const
+{
+    return m_bus;
+}
+
+quint64 TelemetrySubscriber::droppedFrames() const
+{
+    if (!m_mailbox) {
+        return 0;
+    }
+    QMutexLocker locker(&m_mailbox->mutex);
+    return m_mailbox->droppedFrames;
+}
+
+quint64 TelemetrySubscriber::droppedTransitions() const
+{
+    if (!m_mailbox) {
+        return 0;
+    }
+    QMutexLocker locker(&m_mailbox->mutex);
+    return m_mailbox->droppedTransitions;
+}
+
+/**
+ * @brief Empties the mailbox and emits its batches, or waits for the rate limit
+ *
+ * While the rate limit holds the delivery back, the mailbox stays marked
+ * as scheduled, so producers keep replacing its frames without posting
+ * further deliveries. Transitions are emitted before the frames, which are
+ * at least as recent.
+ */
+void TelemetrySubscriber::deliver()
+{
+    const std::shared_ptr<TelemetryBus::Mailbox> mailbox = m_mailbox;
+    if (!mailbox) {
+        return;
+    }
+
+    if (m_minInterval > 0 && m_lastDelivery.isValid()) {
+        const qint64 wait = m_minInterval - m_lastDelivery.elapsed();
+        if (wait > 0) {
+            if (!m_rateTimer->isActive()) {
+                m_rateTimer->start(static_cast<int>(wait));
+            }
+            return;
+        }
+    }
+
+    TelemetryBus::FrameBatchPointer frames;
+    std::vector<TelemetryBus::TransitionBatchPointer> transitions;
+    {
+        QMutexLocker locker(&mailbox->mutex);
+        frames.swap(mailbox->frames);
+        transitions.swap(mailbox->transitions);
+        mailbox->scheduled = false;
+    }
+    m_lastDelivery.start();
+
+    for (const TelemetryBus::TransitionBatchPointer& batch : transitions) {
+        emit transitionsReceived(batch);
+    }
+    if (frames) {
+        emit framesReceived(frames);
+    }
+}
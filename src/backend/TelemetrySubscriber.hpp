@@ -0,0 +1,117 @@
+#ifndef TELEMETRYSUBSCRIBER_HPP
+#define TELEMETRYSUBSCRIBER_HPP
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <memory>
+#include "TelemetryBus.hpp"
+
+class QTimer;
+
+/**
+ * @class TelemetrySubscriber
+ * @brief Receives the topics of a TelemetryBus at a limited rate
+ *
+ * Deliveries run on the thread the subscriber lives in. At most one
+ * delivery per minimum interval is made; frame batches published in
+ * between replace each other, so a delivery always carries the latest
+ * frames, while transition batches are delivered in order. The received
+ * batches are shared with the other subscribers and must not be modified.
+ */
+class TelemetrySubscriber : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a subscriber
+     * @param topics The topics to receive
+     * @param maxRate Maximum deliveries per second, 0 for every publication
+     * @param parent The parent QObject
+     */
+    explicit TelemetrySubscriber(TelemetryBus::Topics topics, double maxRate = 0.0, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Unsubscribes from the bus.
+     */
+    virtual ~TelemetrySubscriber();
+
+    /**
+     * @brief Gets the topics received
+     * @return The topics
+     */
+    TelemetryBus::Topics topics() const;
+
+    /**
+     * @brief Gets the maximum delivery rate
+     * @return Deliveries per second, 0 if unlimited
+     */
+    double maxRate() const;
+
+    /**
+     * @brief Sets the maximum delivery rate
+     * @param rate Deliveries per second, 0 for every publication
+     */
+    void setMaxRate(double rate);
+
+    /**
+     * @brief Gets the bus delivering to the subscriber
+     * @return The bus, or nullptr if not subscribed
+     */
+    TelemetryBus* bus() const;
+
+    /**
+     * @brief Gets the number of frame batches replaced before delivery
+     * @return The count since subscribing
+     */
+    quint64 droppedFrames() const;
+
+    /**
+     * @brief Gets the number of transition batches dropped from a full mailbox
+     * @return The count since subscribing
+     */
+    quint64 droppedTransitions() const;
+
+signals:
+    /**
+     * @brief Emitted with the latest frame batch
+     * @param batch The batch
+     */
+    void framesReceived(const TelemetryBus::FrameBatchPointer& batch);
+
+    /**
+     * @brief Emitted for every transition batch, in publication order
+     * @param transitions The transitions
+     */
+    void transitionsReceived(const TelemetryBus::TransitionBatchPointer& transitions);
+
+private:
+    friend class TelemetryBus;
+
+    /**
+     * @brief Empties the mailbox and emits its batches, or waits for the rate limit
+     */
+    void deliver();
+
+    /** @brief Topics received */
+    TelemetryBus::Topics m_topics;
+
+    /** @brief Minimum time between deliveries in milliseconds */
+    qint64 m_minInterval;
+
+    /** @brief The bus delivering to the subscriber */
+    TelemetryBus* m_bus;
+
+    /** @brief The mailbox on m_bus */
+    std::shared_ptr<TelemetryBus::Mailbox> m_mailbox;
+
+    /** @brief Time since the last delivery */
+    QElapsedTimer m_lastDelivery;
+
+    /** @brief Delivers once the rate limit allows */
+    QTimer* m_rateTimer;
+};
+
+#endif // TELEMETRYSUBSCRIBER_HPP
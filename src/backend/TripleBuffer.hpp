@@ -0,0 +1,135 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ * @brief Lock-free latest-value handoff between one producer and one consumer
+ *
+ * The producer fills the write buffer and publishes it; the consumer picks
+ * up the most recently published buffer. Three buffers rotate so that
+ * neither side ever waits for the other or sees a half-written value:
+ * one is owned by the producer, one by the consumer, and the third holds
+ * the latest published value. Values published while the consumer is busy
+ * are overwritten, so the consumer always sees the newest one.
+ *
+ * Exactly one thread may call the producer functions (writeBuffer(),
+ * publish(), write()) and exactly one thread the consumer functions
+ * (update(), readBuffer(), read()).
+ *
+ * @tparam T The value type; it is copied, never allocated
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Constructs a triple buffer holding default-constructed values
+     */
+    TripleBuffer()
+        : m_middle(1)
+        , m_write(0)
+        , m_read(2)
+    {
+    }
+
+    /**
+     * @brief Gets the buffer owned by the producer
+     * @return The buffer to fill before calling publish()
+     */
+    T& writeBuffer()
+    {
+        return m_buffers[m_write].value;
+    }
+
+    /**
+     * @brief Publishes the write buffer as the latest value (producer)
+     *
+     * The producer continues with the buffer the consumer does not own.
+     */
+    void publish()
+    {
+        const quint8 previous = m_middle.exchange(m_write | FRESH, std::memory_order_acq_rel);
+        m_write = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Copies a value into the write buffer and publishes it (producer)
+     * @param value The value
+     */
+    void write(const T& value)
+    {
+        writeBuffer() = value;
+        publish();
+    }
+
+    /**
+     * @brief Takes ownership of the latest published value (consumer)
+     * @return True if a value was published since the last update
+     */
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+
+        const quint8 previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Gets the buffer owned by the consumer
+     * @return The value taken by the last successful update()
+     */
+    const T& readBuffer() const
+    {
+        return m_buffers[m_read].value;
+    }
+
+    /**
+     * @brief Copies out the latest published value, if any (consumer)
+     * @param out Receives the value
+     * @return True if a value was published since the last read
+     */
+    bool read(T& out)
+    {
+        if (!update()) {
+            return false;
+        }
+        out = readBuffer();
+        return true;
+    }
+
+private:
+    /** @brief Flag marking the middle buffer as not yet consumed */
+    static constexpr quint8 FRESH = 0x4;
+
+    /** @brief Mask extracting the buffer index */
+    static constexpr quint8 INDEX_MASK = 0x3;
+
+    /**
+     * @struct Slot
+     * @brief A buffer on its own cache line, so producer and consumer never share one
+     */
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    /** @brief The three buffers */
+    Slot m_buffers[3];
+
+    /** @brief Index of the latest published buffer plus the FRESH flag */
+    alignas(64) std::atomic<quint8> m_middle;
+
+    /** @brief Index of the producer's buffer */
+    alignas(64) quint8 m_write;
+
+    /** @brief Index of the consumer's buffer */
+    alignas(64) quint8 m_read;
+};
+
+#endif // TRIPLEBUFFER_HPP
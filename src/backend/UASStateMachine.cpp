@@ -1,4 +1,18 @@
 #include "UASStateMachine.hpp"
+#include "EventLog.hpp"
+
+namespace {
+
+/**
+ * @brief Reads the time stamped into audit records
+ * @return Milliseconds of the monotonic event log clock
+ */
+qint64 auditTime()
+{
+    return EventLog::now() / 1000000;
+}
+
+} // namespace
 
 /**
  * @brief Constructs the UASStateMachine with default state Landed
@@ -26,58 +40,75 @@ UASState::State UASStateMachine::currentState() const
     return m_currentState;
 }
 
+/**
+ * @brief Gets the recent transitions of the UAS
+ * @return The audit ring, timestamped in milliseconds since epoch
+ */
+const TransitionAudit& UASStateMachine::audit() const
+{
+    return m_audit;
+}
+
 /**
  * @brief Directly sets the current state of the UAS
  * @param state The new state to set
  * @return true If the state change was successful, false otherwise.
  * 
- * Updates the state if it's different from the current state,
- * logs the change, and emits the currentStateChanged signal.
+ * Validates the transition with one lookup in the transition table. An
+ * accepted request for the current state is a no-op; every other request
+ * is recorded in the audit ring, and accepted ones emit the
+ * currentStateChanged signal.
  */
 bool UASStateMachine::setCurrentState(UASState::State state)
 {
-    bool acceptStateChange = true;
+    const UASState::TransitionResult result = transitionResult(m_currentState, state);
 
-    if (m_currentState != state)
+    if (result == UASState::Accepted && state == m_currentState)
+    {
+        return true;
+    }
+
+    m_audit.record(auditTime(), m_currentState, state, result);
+
+    if (result != UASState::Accepted)
     {
-        switch (state) {
-        case UASState::Landing:
-            if (UASState::Flying != m_currentState &&
-                UASState::FlyingToWaypoint != m_currentState &&
-                UASState::Loitering != m_currentState)
-            {
-                qWarning() << "Cannot land unless in a valid flying state";
-                acceptStateChange = false;
-            }
-            break;
-        case UASState::TakingOff:
-            if (UASState::Landed != m_currentState)
-            {
-                qWarning() << "Cannot takeoff unless in a landed state";
-                acceptStateChange = false;
-            }
-            break;
-        case UASState::FlyingToWaypoint:
-            if (UASState::Flying != m_currentState &&
-                UASState::FlyingToWaypoint != m_currentState &&
-                UASState::Loitering != m_currentState)
-            {
-                qWarning() << "Cannot fly to waypoint unless already in a valid flying state";
-                acceptStateChange = false;
-            }
-            break;
-        default:
-            // all other states intentionally accepted
-            break;
-        }
+        return false;
     }
 
-    if (acceptStateChange)
+    EventLog::debug(EventLog::StateChanged, -1, m_currentState, state);
+    m_currentState = state;
+    emit currentStateChanged(m_currentState);
+
+    return true;
+}
+
+/**
+ * @brief Adopts a state decided by an external authority
+ * @param state The state to mirror
+ *
+ * Unlike setCurrentState(), no transition validation is performed. This is
+ * used by backends whose vehicle state is owned elsewhere (e.g. the fleet
+ * simulator) so the mirror can never diverge from the source of truth.
+ * currentStateChanged is only emitted, and the change only recorded as
+ * accepted, if the state actually differs.
+ */
+void UASStateMachine::syncState(UASState::State state)
+{
+    if (m_currentState != state)
     {
+        m_audit.record(auditTime(), m_currentState, state, UASState::Accepted);
+        EventLog::debug(EventLog::StateChanged, -1, m_currentState, state);
         m_currentState = state;
-        qDebug() << "UAS State changed to:" << state;
         emit currentStateChanged(m_currentState);
     }
+}
 
-    return acceptStateChange;
+/**
+ * @brief Records a transition rejected by a rule outside the transition table
+ * @param state The requested state
+ * @param reason Why the request was rejected
+ */
+void UASStateMachine::recordRejection(UASState::State state, UASState::TransitionResult reason)
+{
+    m_audit.record(auditTime(), m_currentState, state, reason);
 }
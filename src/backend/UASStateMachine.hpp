@@ -37,6 +37,140 @@ public:
         Landing
     };
     Q_ENUM(State)
+
+    /** @brief Number of states */
+    static constexpr int STATE_COUNT = Landing + 1;
+
+    /**
+     * @enum TransitionResult
+     * @brief Outcome of a requested state transition
+     *
+     * @value Accepted The transition is permitted
+     * @value RequiresLanded The target state can only be entered while landed
+     * @value RequiresFlying The target state can only be entered while flying
+     * @value UnknownState One of the states is out of range
+     * @value GeofenceViolation The command would take the UAS into a breach of the geofence
+     */
+    enum TransitionResult : quint8 {
+        Accepted,
+        RequiresLanded,
+        RequiresFlying,
+        UnknownState,
+        GeofenceViolation
+    };
+    Q_ENUM(TransitionResult)
+};
+
+/**
+ * @struct TransitionRecord
+ * @brief One entry of a TransitionAudit
+ */
+struct TransitionRecord
+{
+    /** @brief Time of the request in milliseconds of the owner's time base */
+    qint64 timestamp = 0;
+
+    /** @brief State before the request */
+    UASState::State from = UASState::Landed;
+
+    /** @brief Requested state */
+    UASState::State to = UASState::Landed;
+
+    /** @brief Outcome, Accepted unless the request was rejected */
+    UASState::TransitionResult result = UASState::Accepted;
+};
+
+/**
+ * @class TransitionAudit
+ * @brief Fixed-size ring of the most recent state transitions of one vehicle
+ *
+ * Accepted and rejected transitions are recorded in place of log output, so
+ * broadcasting a command to a large fleet costs no I/O. Once full, the
+ * oldest record is overwritten. The ring never allocates and is not
+ * synchronized; it belongs to the thread that changes the vehicle's state.
+ */
+class TransitionAudit
+{
+public:
+    /** @brief Number of records kept */
+    static constexpr int CAPACITY = 8;
+
+    /**
+     * @brief Records a transition request
+     * @param timestamp Time of the request in milliseconds
+     * @param from State before the request
+     * @param to Requested state
+     * @param result Outcome of the request
+     */
+    void record(qint64 timestamp, UASState::State from, UASState::State to, UASState::TransitionResult result)
+    {
+        TransitionRecord& entry = m_records[m_total % CAPACITY];
+        entry.timestamp = timestamp;
+        entry.from = from;
+        entry.to = to;
+        entry.result = result;
+
+        ++m_total;
+        if (result != UASState::Accepted) {
+            ++m_rejected;
+        }
+    }
+
+    /**
+     * @brief Gets the number of records kept
+     * @return At most CAPACITY
+     */
+    int count() const
+    {
+        return static_cast<int>(qMin<quint32>(m_total, CAPACITY));
+    }
+
+    /**
+     * @brief Gets a kept record
+     * @param index 0 for the oldest kept record, count() - 1 for the newest
+     * @return The record
+     */
+    const TransitionRecord& at(int index) const
+    {
+        return m_records[(m_total - count() + index) % CAPACITY];
+    }
+
+    /**
+     * @brief Gets the newest record
+     * @return The record; only meaningful if count() is not 0
+     */
+    const TransitionRecord& last() const
+    {
+        return m_records[(m_total + CAPACITY - 1) % CAPACITY];
+    }
+
+    /**
+     * @brief Gets the number of transitions recorded since construction
+     * @return The total, including overwritten records
+     */
+    quint32 totalRecorded() const
+    {
+        return m_total;
+    }
+
+    /**
+     * @brief Gets the number of rejected transitions since construction
+     * @return The rejection count, including overwritten records
+     */
+    quint32 rejectedCount() const
+    {
+        return m_rejected;
+    }
+
+private:
+    /** @brief The ring */
+    TransitionRecord m_records[CAPACITY];
+
+    /** @brief Number of records written */
+    quint32 m_total = 0;
+
+    /** @brief Number of rejections written */
+    quint32 m_rejected = 0;
 };
 
 /**
@@ -46,6 +180,10 @@ public:
  * This class implements a state machine that controls the valid transitions
  * between different flight states of the UAS. It ensures that state transitions
  * follow a logical sequence (e.g., the UAS can only take off if it's landed).
+ *
+ * The rules are a compile-time table indexed by the current and requested
+ * state, so validating a transition is a single lookup. Transitions are
+ * recorded in a TransitionAudit instead of being logged.
  */
 class UASStateMachine : public QObject
 {
@@ -79,6 +217,58 @@ public:
      * update the state machine based on simulation events.
      */
     Q_INVOKABLE bool setCurrentState(UASState::State state);
+
+    /**
+     * @brief Mirrors a state owned by an external authority without validation
+     * @param state The state to adopt
+     *
+     * Used by backends such as FleetVehicle whose state is decided by another
+     * component that already enforced the transition rules.
+     */
+    void syncState(UASState::State state);
+
+    /**
+     * @brief Records a transition rejected by a rule outside the transition table
+     * @param state The requested state
+     * @param reason Why the request was rejected
+     *
+     * Used for commands blocked by the geofence, so they show up in the
+     * audit like any other rejection.
+     */
+    void recordRejection(UASState::State state, UASState::TransitionResult reason);
+
+    /**
+     * @brief Gets the recent transitions of the UAS
+     * @return The audit ring, timestamped in milliseconds of the monotonic EventLog::now() clock
+     */
+    const TransitionAudit& audit() const;
+
+    /**
+     * @brief Looks up the outcome of a state transition
+     * @param from The current state
+     * @param to The requested state
+     * @return Accepted, or the reason the transition is rejected
+     *
+     * Shared by the single-vehicle state machine and the fleet simulator so
+     * both enforce the same flight rules.
+     */
+    static constexpr UASState::TransitionResult transitionResult(UASState::State from, UASState::State to)
+    {
+        return static_cast<unsigned>(from) < UASState::STATE_COUNT && static_cast<unsigned>(to) < UASState::STATE_COUNT
+            ? TRANSITIONS[from][to]
+            : UASState::UnknownState;
+    }
+
+    /**
+     * @brief Checks whether a state transition is permitted
+     * @param from The current state
+     * @param to The requested state
+     * @return True if the transition is valid, false otherwise
+     */
+    static constexpr bool isValidTransition(UASState::State from, UASState::State to)
+    {
+        return transitionResult(from, to) == UASState::Accepted;
+    }
     
 signals:
     /**
@@ -88,8 +278,35 @@ signals:
     void currentStateChanged(UASState::State state);
     
 private:
+    /**
+     * @brief Transition rules, indexed by current and requested state
+     *
+     * Landing and flying to a waypoint require a flying state, and taking
+     * off requires the UAS to be landed, so a takeoff or landing that is
+     * already under way cannot be restarted. Flying to a waypoint again
+     * retargets the UAS. All other transitions are intentionally accepted.
+     */
+    static constexpr UASState::TransitionResult TRANSITIONS[UASState::STATE_COUNT][UASState::STATE_COUNT] = {
+        //                      Landed              TakingOff                 Flying              FlyingToWaypoint          Loitering           Landing
+        /* Landed */           {UASState::Accepted, UASState::Accepted,       UASState::Accepted, UASState::RequiresFlying, UASState::Accepted, UASState::RequiresFlying},
+        /* TakingOff */        {UASState::Accepted, UASState::RequiresLanded, UASState::Accepted, UASState::RequiresFlying, UASState::Accepted, UASState::RequiresFlying},
+        /* Flying */           {UASState::Accepted, UASState::RequiresLanded, UASState::Accepted, UASState::Accepted,       UASState::Accepted, UASState::Accepted},
+        /* FlyingToWaypoint */ {UASState::Accepted, UASState::RequiresLanded, UASState::Accepted, UASState::Accepted,       UASState::Accepted, UASState::Accepted},
+        /* Loitering */        {UASState::Accepted, UASState::RequiresLanded, UASState::Accepted, UASState::Accepted,       UASState::Accepted, UASState::Accepted},
+        /* Landing */          {UASState::Accepted, UASState::RequiresLanded, UASState::Accepted, UASState::RequiresFlying, UASState::Accepted, UASState::RequiresFlying}
+    };
+
     /** @brief The current state of the UAS */
     UASState::State m_currentState;
+
+    /** @brief Recent transition requests */
+    TransitionAudit m_audit;
 };
 
+static_assert(UASStateMachine::isValidTransition(UASState::Landed, UASState::TakingOff), "Takeoff from the ground");
+static_assert(!UASStateMachine::isValidTransition(UASState::Flying, UASState::TakingOff), "No takeoff in flight");
+static_assert(!UASStateMachine::isValidTransition(UASState::Landed, UASState::Landing), "No landing on the ground");
+static_assert(!UASStateMachine::isValidTransition(UASState::TakingOff, UASState::TakingOff), "No restarted takeoff");
+static_assert(UASStateMachine::isValidTransition(UASState::FlyingToWaypoint, UASState::FlyingToWaypoint), "Retarget en route");
+
 #endif // UASSTATEMACHINE_HPP
@@ -0,0 +1,151 @@
+#include "VehiclePositions.hpp"
+#include "TelemetrySubscriber.hpp"
+#include <cmath>
+
+/**
+ * @brief Constructs an empty array
+ * @param parent The parent QObject
+ */
+VehiclePositions::VehiclePositions(QObject* parent)
+    : QObject(parent)
+    , m_committedCount(0)
+    , m_subscriber(nullptr)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VehiclePositions::~VehiclePositions()
+{
+}
+
+void VehiclePositions::attach(TelemetryBus* bus)
+{
+    delete m_subscriber;
+    m_subscriber = nullptr;
+
+    if (bus) {
+        m_subscriber = new TelemetrySubscriber(TelemetryBus::Frames, 0.0, this);
+        connect(m_subscriber, &TelemetrySubscriber::framesReceived, this,
+            [this](const TelemetryBus::FrameBatchPointer& batch) {
+                update(*batch);
+            });
+        bus->subscribe(m_subscriber);
+    }
+}
+
+/**
+ * @brief Updates the position of a vehicle
+ * @param vehicle The vehicle id
+ * @param latitude Latitude in degrees
+ * @param longitude Longitude in degrees
+ *
+ * Web Mercator is conformal, so the direction of a short movement in world
+ * coordinates is its bearing on the ground. Movements across the
+ * antimeridian take the short way around.
+ */
+void VehiclePositions::update(quint32 vehicle, double latitude, double longitude)
+{
+    const double x = WebMercator::x(longitude);
+    const double y = WebMercator::y(latitude);
+
+    const auto found = m_index.constFind(vehicle);
+    if (found == m_index.constEnd()) {
+        m_index.insert(vehicle, static_cast<int>(m_markers.size()));
+        m_markers.push_back({x, y, 0.0f, vehicle});
+        return;
+    }
+
+    Marker& marker = m_markers[found.value()];
+    double dx = x - marker.x;
+    dx -= std::floor(dx + 0.5);
+    const double dy = y - marker.y;
+    if (std::abs(dx) > HEADING_THRESHOLD || std::abs(dy) > HEADING_THRESHOLD) {
+        marker.heading = static_cast<float>(std::atan2(dx, -dy));
+    }
+    marker.x = x;
+    marker.y = y;
+}
+
+void VehiclePositions::update(const TelemetryBus::FrameBatch& batch)
+{
+    for (const TelemetryBus::VehicleFrame& entry : batch.frames) {
+        update(entry.vehicle, entry.frame.latitude, entry.frame.longitude);
+    }
+    commit();
+}
+
+void VehiclePositions::place(quint32 vehicle, double x, double y, float heading)
+{
+    const auto found = m_index.constFind(vehicle);
+    if (found == m_index.constEnd()) {
+        m_index.insert(vehicle, static_cast<int>(m_markers.size()));
+        m_markers.push_back({x, y, heading, vehicle});
+        return;
+    }
+
+    Marker& marker = m_markers[found.value()];
+    marker.x = x;
+    marker.y = y;
+    marker.heading = heading;
+}
+
+void VehiclePositions::commit()
+{
+    if (count() != m_committedCount) {
+        m_committedCount = count();
+        emit countChanged();
+    }
+    emit updated();
+}
+
+void VehiclePositions::clear()
+{
+    const bool hadMarkers = !m_markers.empty();
+    m_index.clear();
+    m_markers.clear();
+    m_committedCount = 0;
+    if (hadMarkers) {
+        emit countChanged();
+    }
+    emit updated();
+}
+
+int VehiclePositions::count() const
+{
+    return static_cast<int>(m_markers.size());
+}
+
+const std::vector<VehiclePositions::Marker>& VehiclePositions::markers() const
+{
+    return m_markers;
+}
+
+int VehiclePositions::indexOf(quint32 vehicle) const
+{
+    return m_index.value(vehicle, -1);
+}
+
+/**
+ * @brief Collects the markers within a viewport
+ * @param viewport The viewport
+ * @param margin Distance in pixels a marker may lie outside the viewport
+ * @param visible Receives the indices of the visible markers, in order
+ * @return The number of visible markers
+ *
+ * The output keeps its capacity between calls, so culling every frame
+ * does not allocate once the largest visible set was seen.
+ */
+int VehiclePositions::cull(const WebMercator::Viewport& viewport, double margin, std::vector<int>& visible) const
+{
+    visible.clear();
+    const int markerCount = count();
+    for (int index = 0; index < markerCount; ++index) {
+        const Marker& marker = m_markers[index];
+        if (viewport.contains(viewport.screenX(marker.x), viewport.screenY(marker.y), margin)) {
+            visible.push_back(index);
+        }
+    }
+    return static_cast<int>(visible.size());
+}
@@ -0,0 +1,170 @@
+#ifndef VEHICLEPOSITIONS_HPP
+#define VEHICLEPOSITIONS_HPP
+
+#include <QObject>
+#include <QHash>
+#include <vector>
+#include "TelemetryBus.hpp"
+#include "TelemetryFrame.hpp"
+#include "WebMercator.hpp"
+
+class TelemetrySubscriber;
+
+/**
+ * @class VehiclePositions
+ * @brief Packed array of the latest projected position of every vehicle
+ *
+ * Map overlays drawing thousands of vehicles need every position on every
+ * frame, but positions only change when frames arrive. Each frame is
+ * therefore projected once on arrival into WebMercator world coordinates
+ * and stored in a contiguous array of Marker entries, one per vehicle in
+ * the order they were first seen. Placing a marker on the screen then
+ * takes a multiply-add per axis, and culling the array against a viewport
+ * is one linear pass.
+ *
+ * The heading of a marker is the direction of its last movement; vehicles
+ * that stand still keep the heading they had. A presenter may instead
+ * place() markers with headings of its own, e.g. once per rendered frame.
+ */
+class VehiclePositions : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    /**
+     * @struct Marker
+     * @brief The projected position of one vehicle
+     */
+    struct Marker
+    {
+        /** @brief World x coordinate */
+        double x;
+
+        /** @brief World y coordinate */
+        double y;
+
+        /** @brief Radians clockwise from north */
+        float heading;
+
+        /** @brief The vehicle id */
+        quint32 vehicle;
+    };
+
+    /** @brief World units a vehicle must move to update its heading, about 4 cm at the equator */
+    static constexpr double HEADING_THRESHOLD = 1e-9;
+
+    /**
+     * @brief Constructs an empty array
+     * @param parent The parent QObject
+     */
+    explicit VehiclePositions(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~VehiclePositions();
+
+    /**
+     * @brief Updates the positions from every frame published on a bus
+     * @param bus The bus, or nullptr to stop
+     */
+    void attach(TelemetryBus* bus);
+
+    /**
+     * @brief Updates the position of a vehicle
+     * @param vehicle The vehicle id
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     */
+    void update(quint32 vehicle, double latitude, double longitude);
+
+    /**
+     * @brief Updates the positions of a batch of frames
+     * @param batch The frames
+     *
+     * Emits updated() once for the batch.
+     */
+    void update(const TelemetryBus::FrameBatch& batch);
+
+    /**
+     * @brief Places the marker of a vehicle without notifying
+     * @param vehicle The vehicle id
+     * @param x World x coordinate
+     * @param y World y coordinate
+     * @param heading Radians clockwise from north
+     *
+     * For presenters that compute positions and headings themselves; call
+     * commit() after placing a batch.
+     */
+    void place(quint32 vehicle, double x, double y, float heading);
+
+    /**
+     * @brief Notifies of the markers placed or updated since the last notification
+     *
+     * Emits countChanged() if vehicles were added, then updated().
+     */
+    void commit();
+
+    /**
+     * @brief Forgets all vehicles
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of vehicles
+     * @return The vehicle count
+     */
+    int count() const;
+
+    /**
+     * @brief Gets the markers of all vehicles
+     * @return The markers, in the order the vehicles were first seen
+     */
+    const std::vector<Marker>& markers() const;
+
+    /**
+     * @brief Gets the marker index of a vehicle
+     * @param vehicle The vehicle id
+     * @return The index, or -1 if the vehicle has no position
+     */
+    int indexOf(quint32 vehicle) const;
+
+    /**
+     * @brief Collects the markers within a viewport
+     * @param viewport The viewport
+     * @param margin Distance in pixels a marker may lie outside the viewport
+     * @param visible Receives the indices of the visible markers, in order
+     * @return The number of visible markers
+     */
+    int cull(const WebMercator::Viewport& viewport, double margin, std::vector<int>& visible) const;
+
+signals:
+    /**
+     * @brief Emitted after a batch of positions was updated, or after clear()
+     */
+    void updated();
+
+    /**
+     * @brief Emitted when the number of vehicles changes
+     */
+    void countChanged();
+
+private:
+    /** @brief Marker index of every vehicle id */
+    QHash<quint32, int> m_index;
+
+    /** @brief Markers of all vehicles */
+    std::vector<Marker> m_markers;
+
+    /** @brief Number of markers at the last notification */
+    int m_committedCount;
+
+    /** @brief Receives the frames of the attached bus */
+    TelemetrySubscriber* m_subscriber;
+};
+
+static_assert(sizeof(VehiclePositions::Marker) == 24, "VehiclePositions::Marker is expected to be packed into 24 bytes");
+
+#endif // VEHICLEPOSITIONS_HPP
@@ -0,0 +1,279 @@
+#include "VehicleTracks.hpp"
+#include "TelemetrySubscriber.hpp"
+#include "WebMercator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Gets the squared tolerance of a level in Point units
+ * @param level The level index, 0 for VehicleTracks::MIN_ZOOM_LEVEL
+ * @return The squared distance
+ */
+double squaredTolerance(int level)
+{
+    const double pixel = 1.0 / (WebMercator::worldSize(VehicleTracks::MIN_ZOOM_LEVEL + level) * VehicleTracks::POINT_SCALE);
+    const double tolerance = VehicleTracks::TOLERANCE * pixel;
+    return tolerance * tolerance;
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty set of tracks
+ * @param vehicleCapacity Number of vehicles kept; frames of further vehicles are dropped
+ * @param parent The parent QObject
+ */
+VehicleTracks::VehicleTracks(int vehicleCapacity, QObject* parent)
+    : QObject(parent)
+    , m_vehicleCapacity(qMax(0, vehicleCapacity))
+    , m_droppedFrames(0)
+    , m_subscriber(nullptr)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VehicleTracks::~VehicleTracks()
+{
+}
+
+/**
+ * @brief Projects a coordinate
+ * @param latitude Latitude in degrees
+ * @param longitude Longitude in degrees
+ * @return The point
+ *
+ * The antimeridian maps to x 0 from both sides; latitudes beyond the map
+ * edges are clamped to them.
+ */
+VehicleTracks::Point VehicleTracks::project(double latitude, double longitude)
+{
+    const double x = std::floor(WebMercator::x(longitude) / POINT_SCALE);
+    const double y = std::floor(WebMercator::y(latitude) / POINT_SCALE);
+    return {
+        static_cast<quint32>(static_cast<qint64>(x)),
+        static_cast<quint32>(qBound(0.0, y, 4294967295.0))
+    };
+}
+
+int VehicleTracks::level(double zoomLevel)
+{
+    return qBound(MIN_ZOOM_LEVEL, qRound(zoomLevel), MAX_ZOOM_LEVEL);
+}
+
+void VehicleTracks::attach(TelemetryBus* bus)
+{
+    delete m_subscriber;
+    m_subscriber = nullptr;
+
+    if (bus) {
+        m_subscriber = new TelemetrySubscriber(TelemetryBus::Frames, 0.0, this);
+        connect(m_subscriber, &TelemetrySubscriber::framesReceived, this,
+            [this](const TelemetryBus::FrameBatchPointer& batch) {
+                append(*batch);
+            });
+        bus->subscribe(m_subscriber);
+    }
+}
+
+/**
+ * @brief Appends a position to the track of a vehicle
+ * @param vehicle The vehicle id
+ * @param latitude Latitude in degrees
+ * @param longitude Longitude in degrees
+ *
+ * Stores the point and simplifies the tails of the levels that gathered
+ * SETTLE_INTERVAL points since their last simplification. A position
+ * equal to the previous one, e.g. of a landed vehicle, is not stored.
+ */
+void VehicleTracks::append(quint32 vehicle, double latitude, double longitude)
+{
+    int index = m_index.value(vehicle, -1);
+    if (index < 0) {
+        if (vehicleCount() >= m_vehicleCapacity) {
+            ++m_droppedFrames;
+            return;
+        }
+        index = vehicleCount();
+        m_index.insert(vehicle, index);
+        m_tracks.emplace_back();
+    }
+
+    Track& track = m_tracks[index];
+    const Point point = project(latitude, longitude);
+    if (!track.points.empty() && track.points.back() == point) {
+        return;
+    }
+
+    track.points.push_back(point);
+    const quint32 last = static_cast<quint32>(track.points.size() - 1);
+    if (last == 0) {
+        for (Level& level : track.levels) {
+            level.vertices.push_back(0);
+            level.checked = 0;
+        }
+        return;
+    }
+
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        if (last - track.levels[level].checked >= SETTLE_INTERVAL) {
+            settle(track, level);
+        }
+    }
+}
+
+void VehicleTracks::append(const TelemetryBus::FrameBatch& batch)
+{
+    for (const TelemetryBus::VehicleFrame& entry : batch.frames) {
+        append(entry.vehicle, entry.frame.latitude, entry.frame.longitude);
+    }
+    emit updated();
+}
+
+void VehicleTracks::clear()
+{
+    m_index.clear();
+    m_tracks.clear();
+    m_droppedFrames = 0;
+    emit cleared();
+}
+
+int VehicleTracks::vehicleCount() const
+{
+    return static_cast<int>(m_tracks.size());
+}
+
+int VehicleTracks::vehicleCapacity() const
+{
+    return m_vehicleCapacity;
+}
+
+bool VehicleTracks::contains(quint32 vehicle) const
+{
+    return m_index.contains(vehicle);
+}
+
+quint64 VehicleTracks::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+const std::vector<VehicleTracks::Point>& VehicleTracks::points(quint32 vehicle) const
+{
+    static const std::vector<Point> empty;
+    const Track* track = find(vehicle);
+    return track ? track->points : empty;
+}
+
+/**
+ * @brief Gets the number of vertices of a simplified track
+ * @param vehicle The vehicle id
+ * @param level The level, in [MIN_ZOOM_LEVEL, MAX_ZOOM_LEVEL]
+ * @return The vertex count, settled vertices and tail
+ *
+ * The tail has the point checked by the last simplification, unless it
+ * settled, and every later point.
+ */
+int VehicleTracks::vertexCount(quint32 vehicle, int level) const
+{
+    const Track* track = find(vehicle);
+    if (!track) {
+        return 0;
+    }
+
+    const Level& entry = track->levels[level - MIN_ZOOM_LEVEL];
+    const quint32 tailStart = (entry.checked > entry.vertices.back()) ? entry.checked : entry.checked + 1;
+    return static_cast<int>(entry.vertices.size() + track->points.size() - tailStart);
+}
+
+int VehicleTracks::settledCount(quint32 vehicle, int level) const
+{
+    const Track* track = find(vehicle);
+    return track ? static_cast<int>(track->levels[level - MIN_ZOOM_LEVEL].vertices.size()) : 0;
+}
+
+VehicleTracks::Point VehicleTracks::vertex(quint32 vehicle, int level, int index) const
+{
+    const Track& track = *find(vehicle);
+    const Level& entry = track.levels[level - MIN_ZOOM_LEVEL];
+    const int settled = static_cast<int>(entry.vertices.size());
+    if (index < settled) {
+        return track.points[entry.vertices[index]];
+    }
+
+    const quint32 tailStart = (entry.checked > entry.vertices.back()) ? entry.checked : entry.checked + 1;
+    return track.points[tailStart + (index - settled)];
+}
+
+const VehicleTracks::Track* VehicleTracks::find(quint32 vehicle) const
+{
+    const auto found = m_index.constFind(vehicle);
+    return (found != m_index.constEnd()) ? &m_tracks[found.value()] : nullptr;
+}
+
+/**
+ * @brief Simplifies the tail of a level and settles its final vertices
+ * @param track The track
+ * @param level The level index, 0 for MIN_ZOOM_LEVEL
+ *
+ * Runs Douglas-Peucker over the points from the last settled vertex to
+ * the latest point, splitting at the point farthest from each segment
+ * until every point lies within the tolerance. All vertices found settle:
+ * the segments between them already hold every point they will cover.
+ * The segment from the last of them to the latest point stays open.
+ */
+void VehicleTracks::settle(Track& track, int level)
+{
+    Level& entry = track.levels[level];
+    const quint32 anchor = entry.vertices.back();
+    const quint32 end = static_cast<quint32>(track.points.size() - 1);
+    const double tolerance = squaredTolerance(level);
+
+    m_found.clear();
+    m_ranges.clear();
+    m_ranges.emplace_back(anchor, end);
+    while (!m_ranges.empty()) {
+        const auto [first, last] = m_ranges.back();
+        m_ranges.pop_back();
+        if (last - first < 2) {
+            continue;
+        }
+
+        // Differences as qint32 wrap across the antimeridian
+        const Point& start = track.points[first];
+        const double segmentX = static_cast<qint32>(track.points[last].x - start.x);
+        const double segmentY = static_cast<qint32>(track.points[last].y - start.y);
+        const double length = segmentX * segmentX + segmentY * segmentY;
+
+        double farthest = -1.0;
+        quint32 split = first;
+        for (quint32 index = first + 1; index < last; ++index) {
+            const double x = static_cast<qint32>(track.points[index].x - start.x);
+            const double y = static_cast<qint32>(track.points[index].y - start.y);
+            const double along = (length > 0.0) ? qBound(0.0, (x * segmentX + y * segmentY) / length, 1.0) : 0.0;
+            const double dx = x - along * segmentX;
+            const double dy = y - along * segmentY;
+            const double distance = dx * dx + dy * dy;
+            if (distance > farthest) {
+                farthest = distance;
+                split = index;
+            }
+        }
+
+        if (farthest > tolerance) {
+            m_found.push_back(split);
+            m_ranges.emplace_back(first, split);
+            m_ranges.emplace_back(split, last);
+        }
+    }
+
+    std::sort(m_found.begin(), m_found.end());
+    entry.vertices.insert(entry.vertices.end(), m_found.begin(), m_found.end());
+    entry.checked = end;
+    if (end - entry.vertices.back() >= MAX_TAIL) {
+        entry.vertices.push_back(end);
+    }
+}
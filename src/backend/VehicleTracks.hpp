@@ -0,0 +1,279 @@
+#ifndef VEHICLETRACKS_HPP
+#define VEHICLETRACKS_HPP
+
+#include <QObject>
+#include <QHash>
+#include <array>
+#include <vector>
+#include "TelemetryBus.hpp"
+#include "TelemetryFrame.hpp"
+
+class TelemetrySubscriber;
+
+/**
+ * @class VehicleTracks
+ * @brief Flown tracks of many vehicles, simplified for every map zoom level
+ *
+ * Every position is stored once, as a Point in 32-bit fixed-point
+ * WebMercator world coordinates: 8 bytes per point with a resolution of
+ * about a centimeter. On top of the points, each track keeps a
+ * Douglas-Peucker simplification for every zoom level from MIN_ZOOM_LEVEL
+ * to MAX_ZOOM_LEVEL, with a tolerance of TOLERANCE pixels at that zoom, as
+ * a list of point indices.
+ *
+ * A level is made of settled vertices, which never change once added, and
+ * a short tail. Every SETTLE_INTERVAL points the tail is simplified on its
+ * own: the segments between its interior vertices are final and settle,
+ * and the last segment stays open for later points. Appending therefore
+ * only ever touches the tail, and drawing a level costs its vertex count,
+ * which depends on the shape of the track on the screen rather than on
+ * its length. A tail that stays straight for MAX_TAIL points settles its
+ * end, which bounds the work of a simplification.
+ */
+class VehicleTracks : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Point
+     * @brief A position in fixed-point world coordinates
+     *
+     * The world square is 2^32 units wide. Differences of x taken as
+     * qint32 wrap around the antimeridian the short way.
+     */
+    struct Point
+    {
+        /** @brief World x coordinate, eastwards from the antimeridian */
+        quint32 x;
+
+        /** @brief World y coordinate, southwards from the northern map edge */
+        quint32 y;
+
+        /**
+         * @brief Checks whether two points are equal
+         * @param other The other point
+         * @return True if both coordinates are equal
+         */
+        bool operator==(const Point& other) const
+        {
+            return x == other.x && y == other.y;
+        }
+    };
+
+    /** @brief Coarsest zoom level simplified for */
+    static constexpr int MIN_ZOOM_LEVEL = 1;
+
+    /** @brief Finest zoom level simplified for */
+    static constexpr int MAX_ZOOM_LEVEL = 20;
+
+    /** @brief Number of simplified levels */
+    static constexpr int LEVEL_COUNT = MAX_ZOOM_LEVEL - MIN_ZOOM_LEVEL + 1;
+
+    /** @brief Largest distance in pixels of a point from the simplified track of its level */
+    static constexpr double TOLERANCE = 0.5;
+
+    /** @brief Points appended between two simplifications of a tail */
+    static constexpr int SETTLE_INTERVAL = 32;
+
+    /** @brief Points in a tail after which its end settles even if straight */
+    static constexpr int MAX_TAIL = 1024;
+
+    /** @brief World units per unit of a Point coordinate */
+    static constexpr double POINT_SCALE = 1.0 / 4294967296.0;
+
+    /** @brief Vehicles kept by default */
+    static constexpr int DEFAULT_VEHICLE_CAPACITY = 64;
+
+    /**
+     * @brief Constructs an empty set of tracks
+     * @param vehicleCapacity Number of vehicles kept; frames of further vehicles are dropped
+     * @param parent The parent QObject
+     */
+    explicit VehicleTracks(int vehicleCapacity = DEFAULT_VEHICLE_CAPACITY, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~VehicleTracks();
+
+    /**
+     * @brief Projects a coordinate
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     * @return The point
+     */
+    static Point project(double latitude, double longitude);
+
+    /**
+     * @brief Gets the level simplified for a zoom level
+     * @param zoomLevel The map zoom level
+     * @return The nearest level in [MIN_ZOOM_LEVEL, MAX_ZOOM_LEVEL]
+     */
+    static int level(double zoomLevel);
+
+    /**
+     * @brief Appends every frame published on a bus
+     * @param bus The bus, or nullptr to stop
+     */
+    void attach(TelemetryBus* bus);
+
+    /**
+     * @brief Appends a position to the track of a vehicle
+     * @param vehicle The vehicle id
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     *
+     * A position equal to the previous one is not stored.
+     */
+    void append(quint32 vehicle, double latitude, double longitude);
+
+    /**
+     * @brief Appends the positions of a batch of frames
+     * @param batch The frames
+     *
+     * Emits updated() once for the batch.
+     */
+    void append(const TelemetryBus::FrameBatch& batch);
+
+    /**
+     * @brief Forgets all tracks
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of vehicles with a track
+     * @return The vehicle count
+     */
+    int vehicleCount() const;
+
+    /**
+     * @brief Gets the maximum number of vehicles
+     * @return The vehicle capacity
+     */
+    int vehicleCapacity() const;
+
+    /**
+     * @brief Checks whether a vehicle has a track
+     * @param vehicle The vehicle id
+     * @return True if at least one position was appended
+     */
+    bool contains(quint32 vehicle) const;
+
+    /**
+     * @brief Gets the number of frames dropped because all vehicles were taken
+     * @return The count since construction or clear()
+     */
+    quint64 droppedFrames() const;
+
+    /**
+     * @brief Gets the stored points of a track
+     * @param vehicle The vehicle id
+     * @return The points in order, empty if the vehicle has no track
+     */
+    const std::vector<Point>& points(quint32 vehicle) const;
+
+    /**
+     * @brief Gets the number of vertices of a simplified track
+     * @param vehicle The vehicle id
+     * @param level The level, in [MIN_ZOOM_LEVEL, MAX_ZOOM_LEVEL]
+     * @return The vertex count, settled vertices and tail
+     */
+    int vertexCount(quint32 vehicle, int level) const;
+
+    /**
+     * @brief Gets the number of settled vertices of a simplified track
+     * @param vehicle The vehicle id
+     * @param level The level, in [MIN_ZOOM_LEVEL, MAX_ZOOM_LEVEL]
+     * @return The count of leading vertices that never change
+     */
+    int settledCount(quint32 vehicle, int level) const;
+
+    /**
+     * @brief Gets a vertex of a simplified track
+     * @param vehicle The vehicle id
+     * @param level The level, in [MIN_ZOOM_LEVEL, MAX_ZOOM_LEVEL]
+     * @param index The vertex index, in [0, vertexCount())
+     * @return The vertex
+     */
+    Point vertex(quint32 vehicle, int level, int index) const;
+
+signals:
+    /**
+     * @brief Emitted after a batch of positions was appended
+     */
+    void updated();
+
+    /**
+     * @brief Emitted after all tracks were forgotten
+     */
+    void cleared();
+
+private:
+    /**
+     * @struct Level
+     * @brief The simplification of a track for one zoom level
+     *
+     * The vertices are the settled ones, starting with the first point. The
+     * tail continues with a straight segment to the point checked by the
+     * last simplification and then with every later point.
+     */
+    struct Level
+    {
+        /** @brief Point indices of the settled vertices */
+        std::vector<quint32> vertices;
+
+        /** @brief Point index up to which the tail was simplified */
+        quint32 checked = 0;
+    };
+
+    /**
+     * @struct Track
+     * @brief The points and simplifications of one vehicle
+     */
+    struct Track
+    {
+        /** @brief The stored points */
+        std::vector<Point> points;
+
+        /** @brief One simplification per zoom level, coarsest first */
+        std::array<Level, LEVEL_COUNT> levels;
+    };
+
+    /**
+     * @brief Finds the track of a vehicle
+     * @param vehicle The vehicle id
+     * @return The track, or nullptr if the vehicle has no track
+     */
+    const Track* find(quint32 vehicle) const;
+
+    /**
+     * @brief Simplifies the tail of a level and settles its final vertices
+     * @param track The track
+     * @param level The level index, 0 for MIN_ZOOM_LEVEL
+     */
+    void settle(Track& track, int level);
+
+    /** @brief Maximum number of vehicles */
+    int m_vehicleCapacity;
+
+    /** @brief Track index of every vehicle id */
+    QHash<quint32, int> m_index;
+
+    /** @brief Tracks of all vehicles, in the order they were first appended */
+    std::vector<Track> m_tracks;
+
+    /** @brief Frames dropped because all vehicles were taken */
+    quint64 m_droppedFrames;
+
+    /** @brief Tail ranges still to be split by settle(), reused between calls */
+    std::vector<std::pair<quint32, quint32>> m_ranges;
+
+    /** @brief Interior vertices found by settle(), reused between calls */
+    std::vector<quint32> m_found;
+
+    /** @brief Receives the frames of the attached bus */
+    TelemetrySubscriber* m_subscriber;
+};
+
+#endif // VEHICLETRACKS_HPP
@@ -0,0 +1,157 @@
+#ifndef WEBMERCATOR_HPP
+#define WEBMERCATOR_HPP
+
+#include <QtGlobal>
+#include <QtMath>
+#include <cmath>
+
+/**
+ * @struct WebMercator
+ * @brief Spherical Web Mercator projection as used by slippy map tiles
+ *
+ * Coordinates are projected onto a world square of unit size: x grows
+ * eastwards from the antimeridian and y southwards from the northern edge
+ * of the map, both in [0, 1). At a zoom level the world is TILE_SIZE
+ * pixels wide times two to the zoom, which matches the zoom levels of the
+ * QtLocation Map item. Projecting once per position update lets overlays
+ * place thousands of points per frame with a multiply-add each.
+ */
+struct WebMercator
+{
+    /** @brief Width of one map tile in pixels */
+    static constexpr double TILE_SIZE = 256.0;
+
+    /** @brief Latitude of the top and bottom map edges in degrees */
+    static constexpr double MAX_LATITUDE = 85.05112878;
+
+    /**
+     * @brief Projects a longitude
+     * @param longitude Longitude in degrees
+     * @return The world x coordinate
+     */
+    static double x(double longitude)
+    {
+        return (longitude + 180.0) / 360.0;
+    }
+
+    /**
+     * @brief Projects a latitude
+     * @param latitude Latitude in degrees, clamped to the map edges
+     * @return The world y coordinate
+     */
+    static double y(double latitude)
+    {
+        const double sinLatitude = std::sin(qDegreesToRadians(qBound(-MAX_LATITUDE, latitude, MAX_LATITUDE)));
+        return 0.5 - std::log((1.0 + sinLatitude) / (1.0 - sinLatitude)) / (4.0 * M_PI);
+    }
+
+    /**
+     * @brief Unprojects a world x coordinate
+     * @param x The world x coordinate
+     * @return Longitude in degrees
+     */
+    static double longitude(double x)
+    {
+        return x * 360.0 - 180.0;
+    }
+
+    /**
+     * @brief Unprojects a world y coordinate
+     * @param y The world y coordinate
+     * @return Latitude in degrees
+     */
+    static double latitude(double y)
+    {
+        return qRadiansToDegrees(std::atan(std::sinh((1.0 - 2.0 * y) * M_PI)));
+    }
+
+    /**
+     * @brief Gets the width of the world in pixels
+     * @param zoomLevel The map zoom level
+     * @return Pixels per world unit
+     */
+    static double worldSize(double zoomLevel)
+    {
+        return TILE_SIZE * std::exp2(zoomLevel);
+    }
+
+    /**
+     * @struct Viewport
+     * @brief The part of the world shown by a north-up map item
+     */
+    struct Viewport
+    {
+        /** @brief World x coordinate at the center of the item */
+        double centerX = 0.5;
+
+        /** @brief World y coordinate at the center of the item */
+        double centerY = 0.5;
+
+        /** @brief Pixels per world unit */
+        double scale = TILE_SIZE;
+
+        /** @brief Item width in pixels */
+        double width = 0.0;
+
+        /** @brief Item height in pixels */
+        double height = 0.0;
+
+        /**
+         * @brief Constructs an empty viewport
+         */
+        Viewport() = default;
+
+        /**
+         * @brief Constructs the viewport of a map item
+         * @param latitude Latitude of the map center in degrees
+         * @param longitude Longitude of the map center in degrees
+         * @param zoomLevel The map zoom level
+         * @param itemWidth Item width in pixels
+         * @param itemHeight Item height in pixels
+         */
+        Viewport(double latitude, double longitude, double zoomLevel, double itemWidth, double itemHeight)
+            : centerX(WebMercator::x(longitude))
+            , centerY(WebMercator::y(latitude))
+            , scale(worldSize(zoomLevel))
+            , width(itemWidth)
+            , height(itemHeight)
+        {
+        }
+
+        /**
+         * @brief Maps a world x coordinate onto the item
+         * @param x The world x coordinate
+         * @return The item x coordinate of the copy of the world nearest the center
+         */
+        double screenX(double x) const
+        {
+            double dx = x - centerX;
+            dx -= std::floor(dx + 0.5);
+            return dx * scale + 0.5 * width;
+        }
+
+        /**
+         * @brief Maps a world y coordinate onto the item
+         * @param y The world y coordinate
+         * @return The item y coordinate
+         */
+        double screenY(double y) const
+        {
+            return (y - centerY) * scale + 0.5 * height;
+        }
+
+        /**
+         * @brief Checks whether a point on the item lies within its bounds
+         * @param x The item x coordinate
+         * @param y The item y coordinate
+         * @param margin Distance in pixels the point may lie outside the bounds
+         * @return True if the point is visible
+         */
+        bool contains(double x, double y, double margin) const
+        {
+            return x >= -margin && x <= width + margin && y >= -margin && y <= height + margin;
+        }
+    };
+};
+
+#endif // WEBMERCATOR_HPP
@@ -0,0 +1,233 @@
+#include "WorkStealingPool.hpp"
+#include <QThread>
+#include <QtGlobal>
+
+namespace {
+
+/**
+ * @brief Packs a range of task numbers into one word
+ */
+inline quint64 packRange(quint32 begin, quint32 end)
+{
+    return (static_cast<quint64>(end) << 32) | begin;
+}
+
+inline quint32 rangeBegin(quint64 bounds)
+{
+    return static_cast<quint32>(bounds);
+}
+
+inline quint32 rangeEnd(quint64 bounds)
+{
+    return static_cast<quint32>(bounds >> 32);
+}
+
+} // namespace
+
+/**
+ * @brief Constructs a pool and starts its workers
+ * @param threadCount Number of threads running tasks, including the caller of run()
+ *
+ * The count is raised to at least 1; a pool of one thread runs every batch
+ * on the caller without any synchronization.
+ */
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_threadCount(qMax(1, threadCount))
+    , m_invoke(nullptr)
+    , m_context(nullptr)
+    , m_generation(0)
+    , m_busyWorkers(0)
+    , m_stopping(false)
+    , m_stolenTasks(0)
+{
+    m_ranges.reset(new Range[m_threadCount]);
+
+    for (int worker = 1; worker < m_threadCount; ++worker) {
+        QThread* thread = QThread::create([this, worker]() {
+            workerLoop(worker);
+        });
+        thread->setObjectName(QStringLiteral("WorkStealingPool-%1").arg(worker));
+        thread->start();
+        m_threads.append(thread);
+    }
+}
+
+/**
+ * @brief Destructor, joins the workers
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_batchStarted.wakeAll();
+    }
+
+    for (QThread* thread : std::as_const(m_threads)) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+int WorkStealingPool::threadCount() const
+{
+    return m_threadCount;
+}
+
+quint64 WorkStealingPool::stolenTasks() const
+{
+    return m_stolenTasks.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Distributes a batch and runs it to completion
+ * @param taskCount Number of tasks
+ * @param invoke Entry point called with the context and a task number
+ * @param context The callable
+ *
+ * Every worker starts with an equal share of consecutive task numbers,
+ * which keeps neighbouring tasks on the same core when the load is even.
+ * Returns only once every worker has left the batch, so the next batch can
+ * safely reset the ranges.
+ */
+void WorkStealingPool::execute(int taskCount, Invoker invoke, void* context)
+{
+    if (taskCount <= 0) {
+        return;
+    }
+
+    if (m_threadCount == 1 || taskCount == 1) {
+        for (int task = 0; task < taskCount; ++task) {
+            invoke(context, task);
+        }
+        return;
+    }
+
+    const quint32 count = static_cast<quint32>(taskCount);
+    for (int worker = 0; worker < m_threadCount; ++worker) {
+        const quint32 begin = count * worker / m_threadCount;
+        const quint32 end = count * (worker + 1) / m_threadCount;
+        m_ranges[worker].bounds.store(packRange(begin, end), std::memory_order_relaxed);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_invoke = invoke;
+        m_context = context;
+        m_busyWorkers = m_threadCount - 1;
+        ++m_generation;
+        m_batchStarted.wakeAll();
+    }
+
+    drain(0);
+
+    QMutexLocker locker(&m_mutex);
+    while (m_busyWorkers > 0) {
+        m_batchFinished.wait(&m_mutex);
+    }
+}
+
+/**
+ * @brief Runs tasks until all ranges are empty
+ * @param worker The worker index
+ *
+ * No tasks are added during a batch, so once a full round of stealing
+ * finds nothing the worker is done.
+ */
+void WorkStealingPool::drain(int worker)
+{
+    for (;;) {
+        int task = takeOwn(worker);
+        if (task < 0) {
+            task = steal(worker);
+            if (task < 0) {
+                return;
+            }
+        }
+        m_invoke(m_context, task);
+    }
+}
+
+/**
+ * @brief Takes the next task from the front of a worker's own range
+ * @param worker The worker index
+ * @return The task number, or -1 if the range is empty
+ */
+int WorkStealingPool::takeOwn(int worker)
+{
+    std::atomic<quint64>& bounds = m_ranges[worker].bounds;
+    quint64 current = bounds.load(std::memory_order_relaxed);
+
+    for (;;) {
+        const quint32 begin = rangeBegin(current);
+        const quint32 end = rangeEnd(current);
+        if (begin >= end) {
+            return -1;
+        }
+        if (bounds.compare_exchange_weak(current, packRange(begin + 1, end), std::memory_order_relaxed)) {
+            return static_cast<int>(begin);
+        }
+    }
+}
+
+/**
+ * @brief Takes one task from the back of another worker's range
+ * @param worker The index of the stealing worker
+ * @return The task number, or -1 if every other range is empty
+ *
+ * Victims are visited starting with the next worker, so thieves spread
+ * over different ranges instead of all hitting the first one.
+ */
+int WorkStealingPool::steal(int worker)
+{
+    for (int offset = 1; offset < m_threadCount; ++offset) {
+        std::atomic<quint64>& bounds = m_ranges[(worker + offset) % m_threadCount].bounds;
+        quint64 current = bounds.load(std::memory_order_relaxed);
+
+        for (;;) {
+            const quint32 begin = rangeBegin(current);
+            const quint32 end = rangeEnd(current);
+            if (begin >= end) {
+                break;
+            }
+            if (bounds.compare_exchange_weak(current, packRange(begin, end - 1), std::memory_order_relaxed)) {
+                m_stolenTasks.fetch_add(1, std::memory_order_relaxed);
+                return static_cast<int>(end - 1);
+            }
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Waits for batches and runs them (worker threads)
+ * @param worker The worker index
+ *
+ * The mutex hand-off orders the range setup and the caller's data before
+ * the tasks, and the tasks before the caller's return from run().
+ */
+void WorkStealingPool::workerLoop(int worker)
+{
+    quint64 seenGeneration = 0;
+
+    for (;;) {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_stopping && m_generation == seenGeneration) {
+                m_batchStarted.wait(&m_mutex);
+            }
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        drain(worker);
+
+        QMutexLocker locker(&m_mutex);
+        if (--m_busyWorkers == 0) {
+            m_batchFinished.wakeOne();
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+class QThread;
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed set of worker threads running batches of independent tasks
+ *
+ * run() hands a batch of numbered tasks to the pool and blocks until all of
+ * them have finished, so every batch is a barrier. The calling thread takes
+ * part in the work as one of the workers.
+ *
+ * Each batch is split into one contiguous range of task numbers per worker.
+ * A worker takes tasks from the front of its own range and, once that is
+ * empty, steals single tasks from the back of the other ranges. Ranges are
+ * claimed with one compare-and-swap each, so taking a task never locks;
+ * the mutex is only used to wake the workers at the start of a batch and to
+ * report its end.
+ *
+ * Tasks must not depend on each other or on the worker that runs them.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * @brief Constructs a pool and starts its workers
+     * @param threadCount Number of threads running tasks, including the caller of run()
+     */
+    explicit WorkStealingPool(int threadCount);
+
+    /**
+     * @brief Destructor, joins the workers
+     */
+    ~WorkStealingPool();
+
+    /**
+     * @brief Gets the number of threads running tasks
+     * @return The thread count, including the caller of run()
+     */
+    int threadCount() const;
+
+    /**
+     * @brief Runs a batch of tasks and waits for all of them
+     * @param taskCount Number of tasks; task numbers are 0 to taskCount - 1
+     * @param task Callable invoked as task(int) once per task number
+     *
+     * Must not be called concurrently or from within a task.
+     */
+    template <typename Task>
+    void run(int taskCount, Task&& task)
+    {
+        using TaskType = std::remove_reference_t<Task>;
+        execute(taskCount, [](void* context, int index) {
+            (*static_cast<TaskType*>(context))(index);
+        }, const_cast<void*>(static_cast<const void*>(&task)));
+    }
+
+    /**
+     * @brief Gets the number of tasks run by a worker other than their owner
+     * @return The steal counter since construction
+     */
+    quint64 stolenTasks() const;
+
+private:
+    Q_DISABLE_COPY(WorkStealingPool)
+
+    /** @brief Type-erased task entry point */
+    using Invoker = void (*)(void*, int);
+
+    /**
+     * @struct Range
+     * @brief Task numbers owned by one worker, packed as begin and end
+     *
+     * Padded to a cache line so workers claiming tasks do not contend on
+     * their neighbours' ranges.
+     */
+    struct alignas(64) Range
+    {
+        std::atomic<quint64> bounds{0};
+    };
+
+    /**
+     * @brief Distributes a batch and runs it to completion
+     * @param taskCount Number of tasks
+     * @param invoke Entry point called with the context and a task number
+     * @param context The callable
+     */
+    void execute(int taskCount, Invoker invoke, void* context);
+
+    /**
+     * @brief Runs tasks until all ranges are empty
+     * @param worker The worker index
+     */
+    void drain(int worker);
+
+    /**
+     * @brief Takes the next task from the front of a worker's own range
+     * @param worker The worker index
+     * @return The task number, or -1 if the range is empty
+     */
+    int takeOwn(int worker);
+
+    /**
+     * @brief Takes one task from the back of another worker's range
+     * @param worker The index of the stealing worker
+     * @return The task number, or -1 if every other range is empty
+     */
+    int steal(int worker);
+
+    /**
+     * @brief Waits for batches and runs them (worker threads)
+     * @param worker The worker index
+     */
+    void workerLoop(int worker);
+
+    /** @brief Threads of workers 1 and up; worker 0 is the caller of run() */
+    QVector<QThread*> m_threads;
+
+    /** @brief One range of task numbers per worker */
+    std::unique_ptr<Range[]> m_ranges;
+
+    /** @brief Number of threads running tasks */
+    int m_threadCount;
+
+    /** @brief Entry point of the current batch */
+    Invoker m_invoke;
+
+    /** @brief Callable of the current batch */
+    void* m_context;
+
+    /** @brief Guards the batch handoff */
+    QMutex m_mutex;
+
+    /** @brief Wakes the workers when a batch starts or the pool stops */
+    QWaitCondition m_batchStarted;
+
+    /** @brief Wakes the caller of run() when the last worker is done */
+    QWaitCondition m_batchFinished;
+
+    /** @brief Incremented for every batch */
+    quint64 m_generation;
+
+    /** @brief Workers still draining the current batch */
+    int m_busyWorkers;
+
+    /** @brief Set when the pool is being destroyed */
+    bool m_stopping;
+
+    /** @brief Number of stolen tasks */
+    std::atomic<quint64> m_stolenTasks;
+};
+
+#endif // WORKSTEALINGPOOL_HPP
@@ -0,0 +1,168 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QMetaEnum>
+#include <QTextStream>
+#include <QThread>
+#include "FleetSimulator.hpp"
+#include "ScenarioRunner.hpp"
+#include "EventLog.hpp"
+#include "ConflictDetector.hpp"
+#include "Geofence.hpp"
+
+namespace {
+
+/**
+ * @brief Formats a duration for the report
+ * @param nanoseconds The duration
+ * @return The duration in milliseconds
+ */
+QString milliseconds(qint64 nanoseconds)
+{
+    return QStringLiteral("%1 ms").arg(nanoseconds / 1.0e6, 0, 'f', 3);
+}
+
+/**
+ * @brief Prints the measurements of one run
+ */
+void printStats(QTextStream& out, int run, const ScenarioRunner::Stats& stats, const FleetSimulator& fleet, qint64 breaches,
+                const ConflictDetector& conflicts, qint64 detectionTime, qint64 maxDetectionTime)
+{
+    out << QStringLiteral("Run %1: %2 ticks, %3 s simulated in %4 s (%5x real time)\n")
+               .arg(run)
+               .arg(stats.ticks)
+               .arg(stats.simulatedTime / 1000.0, 0, 'f', 1)
+               .arg(stats.wallTime / 1.0e9, 0, 'f', 3)
+               .arg(stats.realTimeFactor(), 0, 'f', 1);
+    out << QStringLiteral("  throughput    %1 M vehicle-steps/s\n")
+               .arg(stats.vehicleStepsPerSecond() / 1.0e6, 0, 'f', 2);
+
+    const ScenarioRunner::Latency& tick = stats.tickLatency;
+    out << QStringLiteral("  tick latency  min %1  mean %2  p50 %3  p99 %4  max %5\n")
+               .arg(milliseconds(tick.min), milliseconds(tick.mean), milliseconds(tick.median),
+                    milliseconds(tick.p99), milliseconds(tick.max));
+
+    const ScenarioRunner::Latency& command = stats.commandLatency;
+    out << QStringLiteral("  commands      %1 batches, %2 of %3 vehicle commands accepted, p50 %4  max %5\n")
+               .arg(stats.commandBatches)
+               .arg(stats.commandsAccepted)
+               .arg(stats.commandsRequested)
+               .arg(milliseconds(command.median), milliseconds(command.max));
+
+    const QMetaEnum states = QMetaEnum::fromType<UASState::State>();
+    QStringList counts;
+    for (int state = 0; state < UASState::STATE_COUNT; ++state) {
+        counts << QStringLiteral("%1 %2").arg(QLatin1String(states.valueToKey(state)))
+                                          .arg(fleet.stateStore()->count(UASState::State(state)));
+    }
+    out << QStringLiteral("  final states  %1\n").arg(counts.join(QStringLiteral(", ")));
+
+    if (fleet.geofence()) {
+        out << QStringLiteral("  geofence      %1 breaches, %2 vehicles in breach at the end\n")
+                   .arg(breaches)
+                   .arg(fleet.breachCount());
+    }
+
+    if (conflicts.fleet()) {
+        out << QStringLiteral("  conflicts     %1 at the end, detection mean %2, max %3\n")
+                   .arg(conflicts.conflictCount())
+                   .arg(milliseconds(stats.ticks > 0 ? detectionTime / qint64(stats.ticks) : 0))
+                   .arg(milliseconds(maxDetectionTime));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Runs a scripted fleet scenario without any display and prints its statistics
+ *
+ * Only QCoreApplication is needed, so this runs on servers without a
+ * display, e.g. for soak tests.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs a scripted fleet scenario as fast as possible and prints throughput and latency statistics.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scenario", "The scenario script.");
+    QCommandLineOption threadsOption("threads", "Step the fleet on <count> threads, by default one per core.", "count");
+    parser.addOption(threadsOption);
+    QCommandLineOption repeatOption("repeat", "Run the scenario <count> times on a fresh fleet.", "count", "1");
+    parser.addOption(repeatOption);
+    QCommandLineOption seedOption("seed", "Seed the fleet with <seed> for reproducible runs.", "seed", "1");
+    parser.addOption(seedOption);
+    QCommandLineOption logOption("log", "Write flight events to <file> instead of the console.", "file");
+    parser.addOption(logOption);
+    QCommandLineOption geofenceOption("geofence", "Check the fleet against the zones of fence <file>.", "file");
+    parser.addOption(geofenceOption);
+    QCommandLineOption conflictsOption("conflicts", "Predict losses of separation after every tick.");
+    parser.addOption(conflictsOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    ScenarioRunner runner;
+    if (!runner.load(parser.positionalArguments().first())) {
+        err << runner.errorString() << Qt::endl;
+        return 1;
+    }
+
+    Geofence geofence;
+    if (parser.isSet(geofenceOption) && !geofence.load(parser.value(geofenceOption))) {
+        err << geofence.errorString() << Qt::endl;
+        return 1;
+    }
+
+    if (!EventLog::start(parser.value(logOption))) {
+        return 1;
+    }
+
+    const int threads = parser.isSet(threadsOption) ? parser.value(threadsOption).toInt() : QThread::idealThreadCount();
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    out << QStringLiteral("Scenario %1: %2 vehicles, %3 s, %4 commands, %5 threads\n")
+               .arg(parser.positionalArguments().first())
+               .arg(runner.vehicleCount())
+               .arg(runner.duration() / 1000.0, 0, 'f', 1)
+               .arg(runner.actionCount())
+               .arg(threads);
+    out.flush();
+
+    for (int run = 1; run <= repeat; ++run) {
+        FleetSimulator fleet;
+        fleet.setSeed(parser.value(seedOption).toUInt());
+        fleet.setThreadCount(threads);
+
+        qint64 breaches = 0;
+        if (parser.isSet(geofenceOption)) {
+            fleet.setGeofence(&geofence);
+            QObject::connect(&fleet, &FleetSimulator::geofenceBreached, [&breaches](const QVector<int>& indices) {
+                breaches += indices.size();
+            });
+        }
+
+        ConflictDetector conflicts;
+        qint64 detectionTime = 0;
+        qint64 maxDetectionTime = 0;
+        if (parser.isSet(conflictsOption)) {
+            conflicts.setFleet(&fleet);
+            QObject::connect(&fleet, &FleetSimulator::stepped, [&]() {
+                detectionTime += conflicts.detectionTime();
+                maxDetectionTime = qMax(maxDetectionTime, conflicts.detectionTime());
+            });
+        }
+
+        const ScenarioRunner::Stats stats = runner.run(&fleet);
+        printStats(out, run, stats, fleet, breaches, conflicts, detectionTime, maxDetectionTime);
+        out.flush();
+    }
+
+    EventLog::stop();
+    return 0;
+}
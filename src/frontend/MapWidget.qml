@@ -24,16 +24,22 @@ Item {
         id: map
         anchors.fill: parent
         plugin: mapPlugin
-        center: TelemetryData.position
+        center: TelemetryPresenter.position
         zoomLevel: MapController.zoomLevel
 
-        // Keep the map centered on the UAS position
+        // Present the vehicles once per rendered frame while they move
+        FrameAnimation {
+            running: TelemetryPresenter.animating
+            onTriggered: TelemetryPresenter.present()
+        }
+
+        // Keep the map centered on the presented UAS position
         Connections {
-            target: TelemetryData
+            target: TelemetryPresenter
             function onPositionChanged() {
                 // Only auto-center when not in navigation mode
                 if (!MapController.isInteractive) {
-                    map.center = TelemetryData.position
+                    map.center = TelemetryPresenter.position
                 }
             }
         }
@@ -44,11 +50,32 @@ Item {
             }
         }
 
-        // Animation for center coordinate changes
-        Behavior on center {
-            CoordinateAnimation {
-                duration: 1000
-            }
+        // Track flown by the displayed vehicle, below the markers
+        VehicleTrack
+        {
+            id: vehicleTrack
+            anchors.fill: parent
+            tracks: VehicleTracks
+            vehicle: TelemetryChart.vehicle
+            center: map.center
+            zoomLevel: map.zoomLevel
+            color: "#b0de2828"
+            lineWidth: 3
+        }
+
+        // Every vehicle, drawn in one batch below the controls; the displayed
+        // one is highlighted
+        VehicleMarkers
+        {
+            id: vehicleMarkers
+            anchors.fill: parent
+            positions: VehiclePositions
+            center: map.center
+            zoomLevel: map.zoomLevel
+            markerSize: 32
+            color: "#e63cc3ff"
+            selectedVehicle: TelemetryChart.vehicle
+            selectedColor: "#e6de2828"
         }
 
         // Handle tap/click on the map
@@ -130,32 +157,6 @@ Item {
             }
         }
 
-        MapQuickItem
-        {
-            id: uasMarker
-            anchorPoint.x: uasIcon.width/2
-            anchorPoint.y: uasIcon.height/2
-            coordinate: TelemetryData.position
-
-            // Animation for center coordinate changes
-            Behavior on coordinate
-            {
-                CoordinateAnimation
-                {
-                    duration: 1000
-                }
-            }
-
-            sourceItem: Rectangle {
-                id: uasIcon
-                color: "#de2828"
-                width: 32
-                height: 32
-                radius: 16
-                opacity: .9
-            }
-        }
-        
         MapQuickItem
         {
             id: destinationMarker
@@ -188,7 +189,7 @@ Item {
             opacity: .5
             visible: UASState.FlyingToWaypoint === TelemetryData.state
             path: [
-                TelemetryData.position,
+                TelemetryPresenter.position,
                 destinationMarker.coordinate
             ]
         }
@@ -72,6 +72,24 @@ Rectangle {
             }
         }
         
+        DataLabel
+        {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            label: "GEOFENCE"
+            value: TelemetryData.geofenceBreached ? "Breach" : "Clear"
+            valueColor: TelemetryData.geofenceBreached ? "red" : "#4dff64"
+        }
+
+        DataLabel
+        {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            label: "CONFLICTS"
+            value: ConflictDetector.conflictCount > 0 ? ConflictDetector.conflictCount : "None"
+            valueColor: ConflictDetector.conflictCount > 0 ? "#ffcc00" : "#4dff64"
+        }
+
         DataLabel
         {
             Layout.fillWidth: true
@@ -37,8 +37,43 @@ Rectangle {
                     return "#ffcc00"
                 return "#ff4d4d"
             }
+
+            // Trend of the last minutes behind the value
+            TelemetrySeries {
+                anchors.fill: parent
+                anchors.margins: 4
+                z: -1
+                model: TelemetryChart
+                channel: TelemetryHistory.Battery
+                color: "#404dff64"
+                minimumValue: 0
+                maximumValue: 100
+            }
         }
         
+        DataLabel
+        {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            label: "ENDURANCE"
+            value: {
+                if (TelemetryData.remainingFlightTime < 0)
+                    return "--"
+                var minutes = Math.floor(TelemetryData.remainingFlightTime / 60)
+                return Math.floor(minutes / 60) + "h " + (minutes % 60) + "m / "
+                        + (TelemetryData.remainingRange / 1000).toFixed(1) + " km"
+            }
+            valueColor: {
+                if (TelemetryData.remainingFlightTime < 0)
+                    return "#ffffff"
+                if (TelemetryData.remainingFlightTime > 1200)
+                    return "#4dff64"
+                if (TelemetryData.remainingFlightTime > 600)
+                    return "#ffcc00"
+                return "#ff4d4d"
+            }
+        }
+
         DataLabel
         {
             Layout.fillWidth: true
@@ -46,6 +81,18 @@ Rectangle {
             label: "ALTITUDE"
             value: TelemetryData.altitude + " m"
             valueColor: "#3cc3ff"
+
+            // Trend of the last minutes behind the value
+            TelemetrySeries {
+                anchors.fill: parent
+                anchors.margins: 4
+                z: -1
+                model: TelemetryChart
+                channel: TelemetryHistory.Altitude
+                color: "#403cc3ff"
+                minimumValue: 0
+                maximumValue: 500
+            }
         }
         
         DataLabel
@@ -55,6 +102,18 @@ Rectangle {
             label: "SPEED"
             value: TelemetryData.speed + " m/s"
             valueColor: "#3cc3ff"
+
+            // Trend of the last minutes behind the value
+            TelemetrySeries {
+                anchors.fill: parent
+                anchors.margins: 4
+                z: -1
+                model: TelemetryChart
+                channel: TelemetryHistory.Speed
+                color: "#403cc3ff"
+                minimumValue: 0
+                maximumValue: 60
+            }
         }
         
         DataLabel
@@ -0,0 +1,221 @@
+#include "TelemetrySeriesItem.hpp"
+#include <QMatrix4x4>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+
+/**
+ * @brief Constructs a chart without a model
+ * @param parent The parent item
+ */
+TelemetrySeriesItem::TelemetrySeriesItem(QQuickItem* parent)
+    : QQuickItem(parent)
+    , m_channel(TelemetryHistory::Altitude)
+    , m_color(QColor(0x3c, 0xc3, 0xff))
+    , m_minimumValue(0.0)
+    , m_maximumValue(100.0)
+    , m_pendingRows(0)
+    , m_invalidated(true)
+    , m_colorChanged(true)
+    , m_origin(0)
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);
+    connect(this, &QQuickItem::widthChanged, this, &QQuickItem::update);
+    connect(this, &QQuickItem::heightChanged, this, &QQuickItem::update);
+}
+
+TelemetryChartModel* TelemetrySeriesItem::model() const
+{
+    return m_model;
+}
+
+void TelemetrySeriesItem::setModel(TelemetryChartModel* model)
+{
+    if (m_model == model) {
+        return;
+    }
+
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = model;
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::rowsInserted, this, &TelemetrySeriesItem::rowsAppended);
+        connect(m_model, &QAbstractItemModel::rowsRemoved, this, &QQuickItem::update);
+        connect(m_model, &QAbstractItemModel::modelReset, this, &TelemetrySeriesItem::invalidate);
+    }
+    emit modelChanged();
+    invalidate();
+}
+
+TelemetryHistory::Channel TelemetrySeriesItem::channel() const
+{
+    return m_channel;
+}
+
+void TelemetrySeriesItem::setChannel(TelemetryHistory::Channel channel)
+{
+    if (m_channel == channel || channel < 0 || channel >= TelemetryHistory::ChannelCount) {
+        return;
+    }
+
+    m_channel = channel;
+    emit channelChanged();
+    invalidate();
+}
+
+QColor TelemetrySeriesItem::color() const
+{
+    return m_color;
+}
+
+void TelemetrySeriesItem::setColor(const QColor& color)
+{
+    if (m_color == color) {
+        return;
+    }
+
+    m_color = color;
+    m_colorChanged = true;
+    emit colorChanged();
+    update();
+}
+
+qreal TelemetrySeriesItem::minimumValue() const
+{
+    return m_minimumValue;
+}
+
+void TelemetrySeriesItem::setMinimumValue(qreal value)
+{
+    if (m_minimumValue == value) {
+        return;
+    }
+
+    m_minimumValue = value;
+    emit rangeChanged();
+    update();
+}
+
+qreal TelemetrySeriesItem::maximumValue() const
+{
+    return m_maximumValue;
+}
+
+void TelemetrySeriesItem::setMaximumValue(qreal value)
+{
+    if (m_maximumValue == value) {
+        return;
+    }
+
+    m_maximumValue = value;
+    emit rangeChanged();
+    update();
+}
+
+/**
+ * @brief Writes the new segments and updates the transform
+ * @param oldNode The node of the previous frame, or nullptr
+ * @param data Unused
+ * @return The node to render
+ *
+ * Runs on the render thread while the GUI thread is blocked, so the model
+ * can be read directly. The vertex buffer holds two vertices per ring
+ * position and is only reallocated when the capacity changes. Slots
+ * without a row hold zero-length segments, which draw nothing.
+ */
+QSGNode* TelemetrySeriesItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+
+    const TelemetryChartModel* chart = m_model;
+    if (!chart || chart->rowCount() == 0 || width() <= 0 || height() <= 0) {
+        delete oldNode;
+        m_invalidated = true;
+        m_colorChanged = true;
+        return nullptr;
+    }
+
+    auto* transform = static_cast<QSGTransformNode*>(oldNode);
+    QSGGeometryNode* line = nullptr;
+    if (transform) {
+        line = static_cast<QSGGeometryNode*>(transform->firstChild());
+    } else {
+        transform = new QSGTransformNode();
+        line = new QSGGeometryNode();
+        line->setMaterial(new QSGFlatColorMaterial());
+        line->setFlag(QSGNode::OwnsMaterial);
+        line->setFlag(QSGNode::OwnsGeometry);
+        transform->appendChildNode(line);
+    }
+
+    const int capacity = chart->capacity();
+    QSGGeometry* geometry = line->geometry();
+    if (!geometry || geometry->vertexCount() != 2 * capacity) {
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 2 * capacity);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+        geometry->setLineWidth(2);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        line->setGeometry(geometry);
+        m_invalidated = true;
+    }
+
+    if (m_colorChanged) {
+        static_cast<QSGFlatColorMaterial*>(line->material())->setColor(m_color);
+        line->markDirty(QSGNode::DirtyMaterial);
+        m_colorChanged = false;
+    }
+
+    // Write the segments of the appended rows, or of all rows after a reset
+    QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+    const int count = chart->rowCount();
+    int first = count - m_pendingRows;
+    if (m_invalidated || first < 0) {
+        m_origin = chart->row(0).timestamp;
+        const float value = chart->row(0).values[m_channel];
+        for (int vertex = 0; vertex < 2 * capacity; ++vertex) {
+            vertices[vertex].set(0.0f, value);
+        }
+        first = 0;
+        m_invalidated = false;
+    }
+    for (int row = first; row < count; ++row) {
+        const TelemetryChartModel::Row& previous = chart->row(qMax(0, row - 1));
+        const TelemetryChartModel::Row& current = chart->row(row);
+        QSGGeometry::Point2D* segment = vertices + 2 * chart->position(row);
+        segment[0].set(static_cast<float>(previous.timestamp - m_origin), previous.values[m_channel]);
+        segment[1].set(static_cast<float>(current.timestamp - m_origin), current.values[m_channel]);
+    }
+    if (first < count) {
+        geometry->markVertexDataDirty();
+        line->markDirty(QSGNode::DirtyGeometry);
+    }
+    m_pendingRows = 0;
+
+    // Map the model's time window and the value range onto the item
+    const double span = static_cast<double>(capacity) * chart->resolution();
+    const double left = static_cast<double>(chart->end() - m_origin) - span;
+    const double range = (m_maximumValue != m_minimumValue) ? m_maximumValue - m_minimumValue : 1.0;
+    QMatrix4x4 matrix;
+    matrix.translate(0.0f, static_cast<float>(height()));
+    matrix.scale(static_cast<float>(width() / span), static_cast<float>(-height() / range));
+    matrix.translate(static_cast<float>(-left), static_cast<float>(-m_minimumValue));
+    transform->setMatrix(matrix);
+    return transform;
+}
+
+void TelemetrySeriesItem::rowsAppended(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    m_pendingRows += last - first + 1;
+    update();
+}
+
+void TelemetrySeriesItem::invalidate()
+{
+    m_invalidated = true;
+    m_pendingRows = 0;
+    update();
+}
@@ -0,0 +1,173 @@
+#ifndef TELEMETRYSERIESITEM_HPP
+#define TELEMETRYSERIESITEM_HPP
+
+#include <QQuickItem>
+#include <QColor>
+#include <QPointer>
+#include "TelemetryChartModel.hpp"
+#include "TelemetryHistory.hpp"
+
+/**
+ * @class TelemetrySeriesItem
+ * @brief Scene graph line chart of one channel of a TelemetryChartModel
+ *
+ * The line is a list of segments, one per model row from the previous row
+ * to it, stored in a vertex buffer with one slot per ring position of the
+ * model. A new row overwrites the slot of the row it pushed out, so an
+ * update only writes the vertices of the rows appended since the last
+ * frame. Vertices are kept in data coordinates, milliseconds and channel
+ * units, and a transform node maps them to the item: scrolling the time
+ * axis or changing the value range only changes the matrix.
+ *
+ * The time axis always shows the capacity of the model, ending with its
+ * latest row.
+ */
+class TelemetrySeriesItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(TelemetryChartModel* model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(TelemetryHistory::Channel channel READ channel WRITE setChannel NOTIFY channelChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(qreal minimumValue READ minimumValue WRITE setMinimumValue NOTIFY rangeChanged)
+    Q_PROPERTY(qreal maximumValue READ maximumValue WRITE setMaximumValue NOTIFY rangeChanged)
+
+public:
+    /**
+     * @brief Constructs a chart without a model
+     * @param parent The parent item
+     */
+    explicit TelemetrySeriesItem(QQuickItem* parent = nullptr);
+
+    /**
+     * @brief Gets the model drawn
+     * @return The model, or nullptr
+     */
+    TelemetryChartModel* model() const;
+
+    /**
+     * @brief Sets the model drawn
+     * @param model The model, or nullptr
+     */
+    void setModel(TelemetryChartModel* model);
+
+    /**
+     * @brief Gets the channel drawn
+     * @return The channel
+     */
+    TelemetryHistory::Channel channel() const;
+
+    /**
+     * @brief Sets the channel drawn
+     * @param channel The channel
+     */
+    void setChannel(TelemetryHistory::Channel channel);
+
+    /**
+     * @brief Gets the line color
+     * @return The color
+     */
+    QColor color() const;
+
+    /**
+     * @brief Sets the line color
+     * @param color The color
+     */
+    void setColor(const QColor& color);
+
+    /**
+     * @brief Gets the value at the bottom edge
+     * @return The value in channel units
+     */
+    qreal minimumValue() const;
+
+    /**
+     * @brief Sets the value at the bottom edge
+     * @param value The value in channel units
+     */
+    void setMinimumValue(qreal value);
+
+    /**
+     * @brief Gets the value at the top edge
+     * @return The value in channel units
+     */
+    qreal maximumValue() const;
+
+    /**
+     * @brief Sets the value at the top edge
+     * @param value The value in channel units
+     */
+    void setMaximumValue(qreal value);
+
+signals:
+    /**
+     * @brief Emitted when the model changes
+     */
+    void modelChanged();
+
+    /**
+     * @brief Emitted when the channel changes
+     */
+    void channelChanged();
+
+    /**
+     * @brief Emitted when the line color changes
+     */
+    void colorChanged();
+
+    /**
+     * @brief Emitted when the minimum or maximum value changes
+     */
+    void rangeChanged();
+
+protected:
+    /**
+     * @brief Writes the new segments and updates the transform
+     * @param oldNode The node of the previous frame, or nullptr
+     * @param data Unused
+     * @return The node to render
+     */
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+private:
+    /**
+     * @brief Queues the rows appended to the model for the next frame
+     * @param parent Unused; the model is a flat list
+     * @param first The first appended row
+     * @param last The last appended row
+     */
+    void rowsAppended(const QModelIndex& parent, int first, int last);
+
+    /**
+     * @brief Rewrites all segments in the next frame
+     */
+    void invalidate();
+
+    /** @brief The model drawn */
+    QPointer<TelemetryChartModel> m_model;
+
+    /** @brief The channel drawn */
+    TelemetryHistory::Channel m_channel;
+
+    /** @brief Line color */
+    QColor m_color;
+
+    /** @brief Value at the bottom edge */
+    qreal m_minimumValue;
+
+    /** @brief Value at the top edge */
+    qreal m_maximumValue;
+
+    /** @brief Rows at the end of the model whose segments are not written yet */
+    int m_pendingRows;
+
+    /** @brief Whether all segments have to be rewritten */
+    bool m_invalidated;
+
+    /** @brief Whether the color changed since the last frame */
+    bool m_colorChanged;
+
+    /** @brief Time subtracted from the vertices, so they fit a float */
+    qint64 m_origin;
+};
+
+#endif // TELEMETRYSERIESITEM_HPP
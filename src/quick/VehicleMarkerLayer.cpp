@@ -0,0 +1,256 @@
+#include "VehicleMarkerLayer.hpp"
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <cmath>
+
+namespace {
+
+/**
+ * @struct VertexColor
+ * @brief A color in the premultiplied form QSGVertexColorMaterial expects
+ */
+struct VertexColor
+{
+    uchar red;
+    uchar green;
+    uchar blue;
+    uchar alpha;
+};
+
+/**
+ * @brief Premultiplies a color with its alpha
+ * @param color The color
+ * @return The vertex color
+ */
+VertexColor premultiplied(const QColor& color)
+{
+    const int alpha = color.alpha();
+    return {
+        static_cast<uchar>(color.red() * alpha / 255),
+        static_cast<uchar>(color.green() * alpha / 255),
+        static_cast<uchar>(color.blue() * alpha / 255),
+        static_cast<uchar>(alpha)
+    };
+}
+
+} // namespace
+
+/**
+ * @brief Constructs a layer without positions
+ * @param parent The parent item
+ */
+VehicleMarkerLayer::VehicleMarkerLayer(QQuickItem* parent)
+    : QQuickItem(parent)
+    , m_zoomLevel(0.0)
+    , m_markerSize(24.0)
+    , m_color(QColor(0x3c, 0xc3, 0xff))
+    , m_selectedVehicle(-1)
+    , m_selectedColor(QColor(0xde, 0x28, 0x28))
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);
+    connect(this, &QQuickItem::widthChanged, this, &QQuickItem::update);
+    connect(this, &QQuickItem::heightChanged, this, &QQuickItem::update);
+}
+
+VehiclePositions* VehicleMarkerLayer::positions() const
+{
+    return m_positions;
+}
+
+void VehicleMarkerLayer::setPositions(VehiclePositions* positions)
+{
+    if (m_positions == positions) {
+        return;
+    }
+
+    if (m_positions) {
+        disconnect(m_positions, nullptr, this, nullptr);
+    }
+    m_positions = positions;
+    if (m_positions) {
+        connect(m_positions, &VehiclePositions::updated, this, &QQuickItem::update);
+    }
+    emit positionsChanged();
+    update();
+}
+
+QGeoCoordinate VehicleMarkerLayer::center() const
+{
+    return m_center;
+}
+
+void VehicleMarkerLayer::setCenter(const QGeoCoordinate& center)
+{
+    if (m_center == center) {
+        return;
+    }
+
+    m_center = center;
+    emit centerChanged();
+    update();
+}
+
+qreal VehicleMarkerLayer::zoomLevel() const
+{
+    return m_zoomLevel;
+}
+
+void VehicleMarkerLayer::setZoomLevel(qreal zoomLevel)
+{
+    if (m_zoomLevel == zoomLevel) {
+        return;
+    }
+
+    m_zoomLevel = zoomLevel;
+    emit zoomLevelChanged();
+    update();
+}
+
+qreal VehicleMarkerLayer::markerSize() const
+{
+    return m_markerSize;
+}
+
+void VehicleMarkerLayer::setMarkerSize(qreal size)
+{
+    if (m_markerSize == size || size <= 0) {
+        return;
+    }
+
+    m_markerSize = size;
+    emit markerSizeChanged();
+    update();
+}
+
+QColor VehicleMarkerLayer::color() const
+{
+    return m_color;
+}
+
+void VehicleMarkerLayer::setColor(const QColor& color)
+{
+    if (m_color == color) {
+        return;
+    }
+
+    m_color = color;
+    emit colorChanged();
+    update();
+}
+
+int VehicleMarkerLayer::selectedVehicle() const
+{
+    return m_selectedVehicle;
+}
+
+void VehicleMarkerLayer::setSelectedVehicle(int vehicle)
+{
+    if (m_selectedVehicle == vehicle) {
+        return;
+    }
+
+    m_selectedVehicle = vehicle;
+    emit selectedVehicleChanged();
+    update();
+}
+
+QColor VehicleMarkerLayer::selectedColor() const
+{
+    return m_selectedColor;
+}
+
+void VehicleMarkerLayer::setSelectedColor(const QColor& color)
+{
+    if (m_selectedColor == color) {
+        return;
+    }
+
+    m_selectedColor = color;
+    emit selectedColorChanged();
+    update();
+}
+
+/**
+ * @brief Writes the triangles of the visible markers
+ * @param oldNode The node of the previous frame, or nullptr
+ * @param data Unused
+ * @return The node to render
+ *
+ * Runs on the render thread while the GUI thread is blocked, so the
+ * positions can be read directly. Each marker is an arrowhead of two
+ * triangles sharing the tip and the notch at its back. The vertex buffer
+ * is sized to the visible markers; QSGGeometry only reallocates when that
+ * count changes.
+ */
+QSGNode* VehicleMarkerLayer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+
+    const VehiclePositions* positions = m_positions;
+    if (!positions || !m_center.isValid() || width() <= 0 || height() <= 0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    const WebMercator::Viewport viewport(m_center.latitude(), m_center.longitude(), m_zoomLevel, width(), height());
+    const int visible = positions->cull(viewport, m_markerSize, m_visible);
+    if (visible == 0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    auto* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        node = new QSGGeometryNode();
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::StreamPattern);
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGVertexColorMaterial());
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(VERTICES_PER_MARKER * visible);
+
+    const VertexColor normal = premultiplied(m_color);
+    const VertexColor selected = premultiplied(m_selectedColor);
+    const float half = static_cast<float>(0.5 * m_markerSize);
+    const std::vector<VehiclePositions::Marker>& markers = positions->markers();
+    QSGGeometry::ColoredPoint2D* vertex = geometry->vertexDataAsColoredPoint2D();
+    for (const int index : m_visible) {
+        const VehiclePositions::Marker& marker = markers[index];
+        const float x = static_cast<float>(viewport.screenX(marker.x));
+        const float y = static_cast<float>(viewport.screenY(marker.y));
+
+        // Forward and right unit vectors on the screen, whose y axis points south
+        const float forwardX = std::sin(marker.heading);
+        const float forwardY = -std::cos(marker.heading);
+        const float rightX = -forwardY;
+        const float rightY = forwardX;
+
+        const float tipX = x + forwardX * half;
+        const float tipY = y + forwardY * half;
+        const float notchX = x - forwardX * 0.4f * half;
+        const float notchY = y - forwardY * 0.4f * half;
+        const float backX = x - forwardX * 0.8f * half;
+        const float backY = y - forwardY * 0.8f * half;
+        const float wingX = rightX * 0.7f * half;
+        const float wingY = rightY * 0.7f * half;
+
+        const VertexColor& color = (static_cast<int>(marker.vehicle) == m_selectedVehicle) ? selected : normal;
+        vertex[0].set(tipX, tipY, color.red, color.green, color.blue, color.alpha);
+        vertex[1].set(backX + wingX, backY + wingY, color.red, color.green, color.blue, color.alpha);
+        vertex[2].set(notchX, notchY, color.red, color.green, color.blue, color.alpha);
+        vertex[3].set(tipX, tipY, color.red, color.green, color.blue, color.alpha);
+        vertex[4].set(notchX, notchY, color.red, color.green, color.blue, color.alpha);
+        vertex[5].set(backX - wingX, backY - wingY, color.red, color.green, color.blue, color.alpha);
+        vertex += VERTICES_PER_MARKER;
+    }
+
+    geometry->markVertexDataDirty();
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
@@ -0,0 +1,201 @@
+#ifndef VEHICLEMARKERLAYER_HPP
+#define VEHICLEMARKERLAYER_HPP
+
+#include <QQuickItem>
+#include <QColor>
+#include <QGeoCoordinate>
+#include <QPointer>
+#include <vector>
+#include "VehiclePositions.hpp"
+
+/**
+ * @class VehicleMarkerLayer
+ * @brief Scene graph map overlay drawing the markers of many vehicles
+ *
+ * Every visible vehicle is drawn as an arrowhead pointing along its
+ * heading, two triangles in one geometry node with per-vertex colors, so
+ * the whole fleet is a single batched draw call regardless of its size.
+ * Markers are read from a VehiclePositions array and placed with the
+ * Web Mercator viewport given by the center and zoom level of the map the
+ * layer overlays; markers outside the item are culled before any vertex is
+ * written. The selected vehicle is drawn in its own color.
+ *
+ * The layer assumes a north-up map without tilt and must fill the map.
+ */
+class VehicleMarkerLayer : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(VehiclePositions* positions READ positions WRITE setPositions NOTIFY positionsChanged)
+    Q_PROPERTY(QGeoCoordinate center READ center WRITE setCenter NOTIFY centerChanged)
+    Q_PROPERTY(qreal zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY zoomLevelChanged)
+    Q_PROPERTY(qreal markerSize READ markerSize WRITE setMarkerSize NOTIFY markerSizeChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(int selectedVehicle READ selectedVehicle WRITE setSelectedVehicle NOTIFY selectedVehicleChanged)
+    Q_PROPERTY(QColor selectedColor READ selectedColor WRITE setSelectedColor NOTIFY selectedColorChanged)
+
+public:
+    /** @brief Vertices written per marker: two triangles */
+    static constexpr int VERTICES_PER_MARKER = 6;
+
+    /**
+     * @brief Constructs a layer without positions
+     * @param parent The parent item
+     */
+    explicit VehicleMarkerLayer(QQuickItem* parent = nullptr);
+
+    /**
+     * @brief Gets the positions drawn
+     * @return The positions, or nullptr
+     */
+    VehiclePositions* positions() const;
+
+    /**
+     * @brief Sets the positions drawn
+     * @param positions The positions, or nullptr
+     */
+    void setPositions(VehiclePositions* positions);
+
+    /**
+     * @brief Gets the coordinate at the center of the map
+     * @return The coordinate
+     */
+    QGeoCoordinate center() const;
+
+    /**
+     * @brief Sets the coordinate at the center of the map
+     * @param center The coordinate
+     */
+    void setCenter(const QGeoCoordinate& center);
+
+    /**
+     * @brief Gets the zoom level of the map
+     * @return The zoom level
+     */
+    qreal zoomLevel() const;
+
+    /**
+     * @brief Sets the zoom level of the map
+     * @param zoomLevel The zoom level
+     */
+    void setZoomLevel(qreal zoomLevel);
+
+    /**
+     * @brief Gets the length of a marker
+     * @return The length in pixels
+     */
+    qreal markerSize() const;
+
+    /**
+     * @brief Sets the length of a marker
+     * @param size The length in pixels
+     */
+    void setMarkerSize(qreal size);
+
+    /**
+     * @brief Gets the marker color
+     * @return The color
+     */
+    QColor color() const;
+
+    /**
+     * @brief Sets the marker color
+     * @param color The color
+     */
+    void setColor(const QColor& color);
+
+    /**
+     * @brief Gets the vehicle drawn in the selected color
+     * @return The vehicle id, or -1 for none
+     */
+    int selectedVehicle() const;
+
+    /**
+     * @brief Sets the vehicle drawn in the selected color
+     * @param vehicle The vehicle id, or -1 for none
+     */
+    void setSelectedVehicle(int vehicle);
+
+    /**
+     * @brief Gets the color of the selected vehicle
+     * @return The color
+     */
+    QColor selectedColor() const;
+
+    /**
+     * @brief Sets the color of the selected vehicle
+     * @param color The color
+     */
+    void setSelectedColor(const QColor& color);
+
+signals:
+    /**
+     * @brief Emitted when the positions change
+     */
+    void positionsChanged();
+
+    /**
+     * @brief Emitted when the center changes
+     */
+    void centerChanged();
+
+    /**
+     * @brief Emitted when the zoom level changes
+     */
+    void zoomLevelChanged();
+
+    /**
+     * @brief Emitted when the marker size changes
+     */
+    void markerSizeChanged();
+
+    /**
+     * @brief Emitted when the marker color changes
+     */
+    void colorChanged();
+
+    /**
+     * @brief Emitted when the selected vehicle changes
+     */
+    void selectedVehicleChanged();
+
+    /**
+     * @brief Emitted when the color of the selected vehicle changes
+     */
+    void selectedColorChanged();
+
+protected:
+    /**
+     * @brief Writes the triangles of the visible markers
+     * @param oldNode The node of the previous frame, or nullptr
+     * @param data Unused
+     * @return The node to render
+     */
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+private:
+    /** @brief The positions drawn */
+    QPointer<VehiclePositions> m_positions;
+
+    /** @brief Coordinate at the center of the map */
+    QGeoCoordinate m_center;
+
+    /** @brief Zoom level of the map */
+    qreal m_zoomLevel;
+
+    /** @brief Marker length in pixels */
+    qreal m_markerSize;
+
+    /** @brief Marker color */
+    QColor m_color;
+
+    /** @brief Vehicle drawn in the selected color, -1 for none */
+    int m_selectedVehicle;
+
+    /** @brief Color of the selected vehicle */
+    QColor m_selectedColor;
+
+    /** @brief Indices of the visible markers, kept to avoid allocating per frame */
+    std::vector<int> m_visible;
+};
+
+#endif // VEHICLEMARKERLAYER_HPP
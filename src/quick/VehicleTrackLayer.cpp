@@ -0,0 +1,265 @@
+#include "VehicleTrackLayer.hpp"
+#include <QMatrix4x4>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <algorithm>
+#include "WebMercator.hpp"
+
+/**
+ * @brief Constructs a layer without tracks
+ * @param parent The parent item
+ */
+VehicleTrackLayer::VehicleTrackLayer(QQuickItem* parent)
+    : QQuickItem(parent)
+    , m_vehicle(-1)
+    , m_zoomLevel(0.0)
+    , m_color(QColor(0xde, 0x28, 0x28))
+    , m_lineWidth(3.0)
+    , m_invalidated(true)
+    , m_appended(false)
+    , m_styleChanged(true)
+    , m_level(0)
+    , m_settled(0)
+    , m_count(0)
+    , m_origin{0, 0}
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);
+    connect(this, &QQuickItem::widthChanged, this, &QQuickItem::update);
+    connect(this, &QQuickItem::heightChanged, this, &QQuickItem::update);
+}
+
+VehicleTracks* VehicleTrackLayer::tracks() const
+{
+    return m_tracks;
+}
+
+void VehicleTrackLayer::setTracks(VehicleTracks* tracks)
+{
+    if (m_tracks == tracks) {
+        return;
+    }
+
+    if (m_tracks) {
+        disconnect(m_tracks, nullptr, this, nullptr);
+    }
+    m_tracks = tracks;
+    if (m_tracks) {
+        connect(m_tracks, &VehicleTracks::updated, this, &VehicleTrackLayer::append);
+        connect(m_tracks, &VehicleTracks::cleared, this, &VehicleTrackLayer::invalidate);
+    }
+    emit tracksChanged();
+    invalidate();
+}
+
+int VehicleTrackLayer::vehicle() const
+{
+    return m_vehicle;
+}
+
+void VehicleTrackLayer::setVehicle(int vehicle)
+{
+    if (m_vehicle == vehicle) {
+        return;
+    }
+
+    m_vehicle = vehicle;
+    emit vehicleChanged();
+    invalidate();
+}
+
+QGeoCoordinate VehicleTrackLayer::center() const
+{
+    return m_center;
+}
+
+void VehicleTrackLayer::setCenter(const QGeoCoordinate& center)
+{
+    if (m_center == center) {
+        return;
+    }
+
+    m_center = center;
+    emit centerChanged();
+    update();
+}
+
+qreal VehicleTrackLayer::zoomLevel() const
+{
+    return m_zoomLevel;
+}
+
+void VehicleTrackLayer::setZoomLevel(qreal zoomLevel)
+{
+    if (m_zoomLevel == zoomLevel) {
+        return;
+    }
+
+    m_zoomLevel = zoomLevel;
+    emit zoomLevelChanged();
+    update();
+}
+
+QColor VehicleTrackLayer::color() const
+{
+    return m_color;
+}
+
+void VehicleTrackLayer::setColor(const QColor& color)
+{
+    if (m_color == color) {
+        return;
+    }
+
+    m_color = color;
+    m_styleChanged = true;
+    emit colorChanged();
+    update();
+}
+
+qreal VehicleTrackLayer::lineWidth() const
+{
+    return m_lineWidth;
+}
+
+void VehicleTrackLayer::setLineWidth(qreal width)
+{
+    if (m_lineWidth == width || width <= 0) {
+        return;
+    }
+
+    m_lineWidth = width;
+    m_styleChanged = true;
+    emit lineWidthChanged();
+    update();
+}
+
+/**
+ * @brief Writes the changed vertices and updates the transform
+ * @param oldNode The node of the previous frame, or nullptr
+ * @param data Unused
+ * @return The node to render
+ *
+ * Runs on the render thread while the GUI thread is blocked, so the tracks
+ * can be read directly. Crossing to another level rewrites the vertices
+ * from the simplification of that level. After an append only the
+ * vertices from the first unsettled one of the previous frame on are
+ * written, and only the index pairs of segments the track gained or lost.
+ * Frames that only pan or zoom within the level write no data at all.
+ */
+QSGNode* VehicleTrackLayer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+
+    const VehicleTracks* tracks = m_tracks;
+    const quint32 vehicle = static_cast<quint32>(m_vehicle);
+    const int level = VehicleTracks::level(m_zoomLevel);
+    const int count = (tracks && m_vehicle >= 0) ? tracks->vertexCount(vehicle, level) : 0;
+    if (count < 2 || !m_center.isValid() || width() <= 0 || height() <= 0) {
+        delete oldNode;
+        m_invalidated = true;
+        m_styleChanged = true;
+        return nullptr;
+    }
+
+    auto* transform = static_cast<QSGTransformNode*>(oldNode);
+    QSGGeometryNode* line = nullptr;
+    if (transform) {
+        line = static_cast<QSGGeometryNode*>(transform->firstChild());
+    } else {
+        transform = new QSGTransformNode();
+        line = new QSGGeometryNode();
+        line->setMaterial(new QSGFlatColorMaterial());
+        line->setFlag(QSGNode::OwnsMaterial);
+        line->setFlag(QSGNode::OwnsGeometry);
+        transform->appendChildNode(line);
+    }
+
+    QSGGeometry* geometry = line->geometry();
+    if (!geometry || geometry->vertexCount() < count) {
+        int capacity = geometry ? geometry->vertexCount() : INITIAL_CAPACITY;
+        while (capacity < count) {
+            capacity *= 2;
+        }
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), capacity,
+                                   2 * (capacity - 1), QSGGeometry::UnsignedIntType);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        geometry->setIndexDataPattern(QSGGeometry::DynamicPattern);
+        std::fill_n(geometry->indexDataAsUInt(), geometry->indexCount(), 0u);
+        line->setGeometry(geometry);
+        m_count = 0;
+        m_invalidated = true;
+        m_styleChanged = true;
+    }
+
+    if (m_styleChanged) {
+        static_cast<QSGFlatColorMaterial*>(line->material())->setColor(m_color);
+        geometry->setLineWidth(static_cast<float>(m_lineWidth));
+        line->markDirty(QSGNode::DirtyMaterial | QSGNode::DirtyGeometry);
+        m_styleChanged = false;
+    }
+
+    // Write the vertices from the first one not settled in the last frame
+    if (level != m_level) {
+        m_invalidated = true;
+    }
+    const float scale = static_cast<float>(WebMercator::worldSize(level) * VehicleTracks::POINT_SCALE);
+    if (m_invalidated || m_appended) {
+        int first = m_settled;
+        if (m_invalidated) {
+            m_origin = tracks->vertex(vehicle, level, 0);
+            m_level = level;
+            first = 0;
+        }
+
+        QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+        for (int index = first; index < count; ++index) {
+            const VehicleTracks::Point point = tracks->vertex(vehicle, level, index);
+            vertices[index].set(static_cast<qint32>(point.x - m_origin.x) * scale,
+                                static_cast<qint32>(point.y - m_origin.y) * scale);
+        }
+
+        // Segment i always joins vertices i and i + 1, so only segments the
+        // track gained or lost change; the others stay collapsed onto vertex 0
+        quint32* indices = geometry->indexDataAsUInt();
+        for (int segment = qMax(m_count - 1, 0); segment < count - 1; ++segment) {
+            indices[2 * segment] = static_cast<quint32>(segment);
+            indices[2 * segment + 1] = static_cast<quint32>(segment + 1);
+        }
+        for (int segment = count - 1; segment < m_count - 1; ++segment) {
+            indices[2 * segment] = 0;
+            indices[2 * segment + 1] = 0;
+        }
+        geometry->markVertexDataDirty();
+        geometry->markIndexDataDirty();
+        line->markDirty(QSGNode::DirtyGeometry);
+        m_settled = tracks->settledCount(vehicle, level);
+        m_count = count;
+        m_invalidated = false;
+        m_appended = false;
+    }
+
+    // Map the pixels of the level onto the item at the map's zoom
+    const VehicleTracks::Point center = VehicleTracks::project(m_center.latitude(), m_center.longitude());
+    const double mapScale = WebMercator::worldSize(m_zoomLevel) * VehicleTracks::POINT_SCALE;
+    QMatrix4x4 matrix;
+    matrix.translate(static_cast<float>(0.5 * width() + static_cast<qint32>(m_origin.x - center.x) * mapScale),
+                     static_cast<float>(0.5 * height() + static_cast<qint32>(m_origin.y - center.y) * mapScale));
+    matrix.scale(static_cast<float>(mapScale / scale), static_cast<float>(mapScale / scale));
+    transform->setMatrix(matrix);
+    return transform;
+}
+
+void VehicleTrackLayer::append()
+{
+    m_appended = true;
+    update();
+}
+
+void VehicleTrackLayer::invalidate()
+{
+    m_invalidated = true;
+    update();
+}
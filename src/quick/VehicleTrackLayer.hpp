@@ -0,0 +1,212 @@
+#ifndef VEHICLETRACKLAYER_HPP
+#define VEHICLETRACKLAYER_HPP
+
+#include <QQuickItem>
+#include <QColor>
+#include <QGeoCoordinate>
+#include <QPointer>
+#include "VehicleTracks.hpp"
+
+/**
+ * @class VehicleTrackLayer
+ * @brief Scene graph map overlay drawing the flown track of one vehicle
+ *
+ * Only the simplification of the zoom level nearest to the map's is kept
+ * in the vertex buffer, in the pixel coordinates of that level relative
+ * to the start of the track. A transform node maps them onto the item, so
+ * panning and zooming within a level only change the matrix. Settled
+ * vertices never change, so after an append only the vertices from the
+ * first one not yet settled in the previous frame are written.
+ *
+ * The track is drawn as indexed line segments. The buffers grow by
+ * doubling; the index pairs of unused segments point at the first vertex
+ * and draw nothing. Segment i always joins vertices i and i + 1, so an
+ * append only writes the pairs of the segments the track gained or lost,
+ * and its cost depends on the tail rather than on the track length.
+ *
+ * The layer assumes a north-up map without tilt and must fill the map.
+ */
+class VehicleTrackLayer : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(VehicleTracks* tracks READ tracks WRITE setTracks NOTIFY tracksChanged)
+    Q_PROPERTY(int vehicle READ vehicle WRITE setVehicle NOTIFY vehicleChanged)
+    Q_PROPERTY(QGeoCoordinate center READ center WRITE setCenter NOTIFY centerChanged)
+    Q_PROPERTY(qreal zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY zoomLevelChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(qreal lineWidth READ lineWidth WRITE setLineWidth NOTIFY lineWidthChanged)
+
+public:
+    /** @brief Vertices allocated for the first frame */
+    static constexpr int INITIAL_CAPACITY = 256;
+
+    /**
+     * @brief Constructs a layer without tracks
+     * @param parent The parent item
+     */
+    explicit VehicleTrackLayer(QQuickItem* parent = nullptr);
+
+    /**
+     * @brief Gets the tracks drawn from
+     * @return The tracks, or nullptr
+     */
+    VehicleTracks* tracks() const;
+
+    /**
+     * @brief Sets the tracks drawn from
+     * @param tracks The tracks, or nullptr
+     */
+    void setTracks(VehicleTracks* tracks);
+
+    /**
+     * @brief Gets the vehicle whose track is drawn
+     * @return The vehicle id, or -1 for none
+     */
+    int vehicle() const;
+
+    /**
+     * @brief Sets the vehicle whose track is drawn
+     * @param vehicle The vehicle id, or -1 for none
+     */
+    void setVehicle(int vehicle);
+
+    /**
+     * @brief Gets the coordinate at the center of the map
+     * @return The coordinate
+     */
+    QGeoCoordinate center() const;
+
+    /**
+     * @brief Sets the coordinate at the center of the map
+     * @param center The coordinate
+     */
+    void setCenter(const QGeoCoordinate& center);
+
+    /**
+     * @brief Gets the zoom level of the map
+     * @return The zoom level
+     */
+    qreal zoomLevel() const;
+
+    /**
+     * @brief Sets the zoom level of the map
+     * @param zoomLevel The zoom level
+     */
+    void setZoomLevel(qreal zoomLevel);
+
+    /**
+     * @brief Gets the line color
+     * @return The color
+     */
+    QColor color() const;
+
+    /**
+     * @brief Sets the line color
+     * @param color The color
+     */
+    void setColor(const QColor& color);
+
+    /**
+     * @brief Gets the line width
+     * @return The width in pixels
+     */
+    qreal lineWidth() const;
+
+    /**
+     * @brief Sets the line width
+     * @param width The width in pixels
+     */
+    void setLineWidth(qreal width);
+
+signals:
+    /**
+     * @brief Emitted when the tracks change
+     */
+    void tracksChanged();
+
+    /**
+     * @brief Emitted when the vehicle changes
+     */
+    void vehicleChanged();
+
+    /**
+     * @brief Emitted when the center changes
+     */
+    void centerChanged();
+
+    /**
+     * @brief Emitted when the zoom level changes
+     */
+    void zoomLevelChanged();
+
+    /**
+     * @brief Emitted when the line color changes
+     */
+    void colorChanged();
+
+    /**
+     * @brief Emitted when the line width changes
+     */
+    void lineWidthChanged();
+
+protected:
+    /**
+     * @brief Writes the changed vertices and updates the transform
+     * @param oldNode The node of the previous frame, or nullptr
+     * @param data Unused
+     * @return The node to render
+     */
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+private:
+    /**
+     * @brief Writes the appended vertices in the next frame
+     */
+    void append();
+
+    /**
+     * @brief Rewrites all vertices in the next frame
+     */
+    void invalidate();
+
+    /** @brief The tracks drawn from */
+    QPointer<VehicleTracks> m_tracks;
+
+    /** @brief Vehicle whose track is drawn, -1 for none */
+    int m_vehicle;
+
+    /** @brief Coordinate at the center of the map */
+    QGeoCoordinate m_center;
+
+    /** @brief Zoom level of the map */
+    qreal m_zoomLevel;
+
+    /** @brief Line color */
+    QColor m_color;
+
+    /** @brief Line width in pixels */
+    qreal m_lineWidth;
+
+    /** @brief Whether all vertices have to be rewritten */
+    bool m_invalidated;
+
+    /** @brief Whether positions were appended since the last frame */
+    bool m_appended;
+
+    /** @brief Whether the color or width changed since the last frame */
+    bool m_styleChanged;
+
+    /** @brief Level of the vertices in the buffer */
+    int m_level;
+
+    /** @brief Settled vertices in the buffer */
+    int m_settled;
+
+    /** @brief Vertices of the track in the buffer, joined by the non-collapsed segments */
+    int m_count;
+
+    /** @brief Start of the track, subtracted from the vertices so they fit a float */
+    VehicleTracks::Point m_origin;
+};
+
+#endif // VEHICLETRACKLAYER_HPP
@@ -0,0 +1,265 @@
+#ifndef SHAREDTELEMETRY_HPP
+#define SHAREDTELEMETRY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Whether the platform offers POSIX shared memory
+ *
+ * Android lacks shm_open(), and Windows has no POSIX shared memory at all;
+ * there the export and the reader fail to open.
+ */
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__ANDROID__)
+#define GCS_SHARED_TELEMETRY 1
+#else
+#define GCS_SHARED_TELEMETRY 0
+#endif
+
+/**
+ * @namespace SharedTelemetry
+ * @brief Layout of the telemetry exported into POSIX shared memory
+ *
+ * This header is shared by the writer in the ground station and by the
+ * reader library. It only depends on the standard library, so co-located
+ * processes can read telemetry without linking Qt.
+ *
+ * The shared memory object holds a 64 byte header, a table with the latest
+ * snapshot of every vehicle, and a ring of the most recent frames:
+ *
+ * | Offset                              | Size                   | Content       |
+ * |-------------------------------------|------------------------|---------------|
+ * | 0                                   | 64                     | Header        |
+ * | 64                                  | vehicleCapacity * 64   | Vehicle table |
+ * | 64 + vehicleCapacity * 64           | ringCapacity * 48      | Frame ring    |
+ *
+ * Every table slot and ring entry is a Record protected by a seqlock: the
+ * writer makes the sequence odd, stores the payload and makes it even
+ * again. Readers copy the payload and retry if the sequence was odd or
+ * changed meanwhile. Reading never takes a lock or makes a system call,
+ * and readers can never slow down the writer.
+ *
+ * Ring entry n holds the n-th frame written, at index n % ringCapacity,
+ * and is complete once its sequence is 2n + 2. The header's frame count
+ * tells readers how many frames were written so far.
+ *
+ * All values are in the byte order of the host; the memory is only ever
+ * shared on one machine.
+ */
+namespace SharedTelemetry {
+
+/** @brief Header magic, "GCSM" when read as little-endian bytes */
+constexpr std::uint32_t MAGIC = 0x4D534347;
+
+/** @brief Current layout version */
+constexpr std::uint32_t VERSION = 1;
+
+/** @brief Shared memory object used when no name is given */
+constexpr const char* DEFAULT_NAME = "/gcs_telemetry";
+
+/** @brief Default number of vehicle table slots */
+constexpr std::uint32_t DEFAULT_VEHICLE_CAPACITY = 16384;
+
+/** @brief Default number of ring entries, a power of two */
+constexpr std::uint32_t DEFAULT_RING_CAPACITY = 65536;
+
+/**
+ * @struct Snapshot
+ * @brief Telemetry and flight state of one vehicle at one point in time
+ */
+struct Snapshot
+{
+    /** @brief Vehicle id, e.g. the fleet index */
+    std::uint32_t vehicle;
+
+    /** @brief UASState::State */
+    std::uint8_t state;
+
+    /** @brief Battery level as a percentage (0-100) */
+    std::uint8_t battery;
+
+    /** @brief Speed in meters per second */
+    std::int16_t speed;
+
+    /** @brief Altitude in meters */
+    std::int32_t altitude;
+
+    /** @brief Reserved, zero */
+    std::uint32_t reserved;
+
+    /** @brief Time of the snapshot in milliseconds of source time */
+    std::int64_t timestamp;
+
+    /** @brief Latitude in degrees */
+    double latitude;
+
+    /** @brief Longitude in degrees */
+    double longitude;
+};
+
+static_assert(std::is_trivially_copyable<Snapshot>::value, "Snapshot must stay trivially copyable");
+static_assert(sizeof(Snapshot) == 40, "Snapshot is expected to be packed into 40 bytes");
+
+/** @brief Number of 64-bit words a snapshot is stored in */
+constexpr std::size_t SNAPSHOT_WORDS = sizeof(Snapshot) / sizeof(std::uint64_t);
+
+/**
+ * @struct Header
+ * @brief Describes the shared memory object and how far the writer got
+ *
+ * The writer stores the magic last, once everything else is initialized.
+ */
+struct Header
+{
+    /** @brief MAGIC once the object is initialized */
+    std::atomic<std::uint32_t> magic;
+
+    /** @brief Layout version */
+    std::uint32_t version;
+
+    /** @brief Number of vehicle table slots */
+    std::uint32_t vehicleCapacity;
+
+    /** @brief Number of ring entries, a power of two */
+    std::uint32_t ringCapacity;
+
+    /** @brief Number of table slots in use; slots are assigned in order and never freed */
+    std::atomic<std::uint32_t> vehicleCount;
+
+    /** @brief Process id of the writer */
+    std::uint32_t writerPid;
+
+    /** @brief Number of frames written to the ring so far */
+    std::atomic<std::uint64_t> frameCount;
+
+    /** @brief Number of batches written, e.g. simulation ticks */
+    std::atomic<std::uint64_t> updateCount;
+
+    /** @brief Reserved, zero */
+    std::uint64_t reserved[3];
+};
+
+/**
+ * @struct Record
+ * @brief A snapshot protected by a seqlock
+ */
+struct Record
+{
+    /** @brief Odd while the writer stores the snapshot */
+    std::atomic<std::uint64_t> sequence;
+
+    /** @brief The snapshot, stored word by word */
+    std::atomic<std::uint64_t> words[SNAPSHOT_WORDS];
+};
+
+/**
+ * @struct Slot
+ * @brief A vehicle table entry, on its own cache line
+ */
+struct alignas(64) Slot
+{
+    /** @brief The latest snapshot of the vehicle */
+    Record record;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory needs lock-free 64-bit atomics");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Shared memory needs lock-free 32-bit atomics");
+static_assert(sizeof(Header) == 64, "Header is expected to be 64 bytes");
+static_assert(sizeof(Slot) == 64, "Slot is expected to fill one cache line");
+static_assert(sizeof(Record) == 48, "Record is expected to be 48 bytes");
+
+/**
+ * @brief Gets the size of a shared memory object
+ * @param vehicleCapacity Number of vehicle table slots
+ * @param ringCapacity Number of ring entries
+ * @return The size in bytes
+ */
+inline std::size_t objectSize(std::uint32_t vehicleCapacity, std::uint32_t ringCapacity)
+{
+    return sizeof(Header) + std::size_t(vehicleCapacity) * sizeof(Slot) + std::size_t(ringCapacity) * sizeof(Record);
+}
+
+/**
+ * @brief Gets the vehicle table of a shared memory object
+ * @param header The start of the object
+ * @return The first slot
+ */
+inline const Slot* table(const Header* header)
+{
+    return reinterpret_cast<const Slot*>(reinterpret_cast<const char*>(header) + sizeof(Header));
+}
+
+inline Slot* table(Header* header)
+{
+    return const_cast<Slot*>(table(static_cast<const Header*>(header)));
+}
+
+/**
+ * @brief Gets the frame ring of a shared memory object
+ * @param header The start of the object
+ * @return The first ring entry
+ */
+inline const Record* ring(const Header* header)
+{
+    return reinterpret_cast<const Record*>(reinterpret_cast<const char*>(header) + sizeof(Header)
+                                           + std::size_t(header->vehicleCapacity) * sizeof(Slot));
+}
+
+inline Record* ring(Header* header)
+{
+    return const_cast<Record*>(ring(static_cast<const Header*>(header)));
+}
+
+/**
+ * @brief Stores a snapshot into a record (writer)
+ * @param record The record
+ * @param sequence The odd sequence marking the write; the record ends up at sequence + 1
+ * @param snapshot The snapshot
+ */
+inline void write(Record& record, std::uint64_t sequence, const Snapshot& snapshot)
+{
+    std::uint64_t words[SNAPSHOT_WORDS];
+    std::memcpy(words, &snapshot, sizeof(Snapshot));
+
+    record.sequence.store(sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < SNAPSHOT_WORDS; ++i) {
+        record.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    record.sequence.store(sequence + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Makes one attempt to copy a snapshot out of a record (reader)
+ * @param record The record
+ * @param snapshot Receives the snapshot
+ * @param sequence Receives the even sequence the snapshot was written with
+ * @return False if the writer was storing the record meanwhile; try again
+ */
+inline bool tryRead(const Record& record, Snapshot& snapshot, std::uint64_t& sequence)
+{
+    const std::uint64_t before = record.sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+
+    std::uint64_t words[SNAPSHOT_WORDS];
+    for (std::size_t i = 0; i < SNAPSHOT_WORDS; ++i) {
+        words[i] = record.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (record.sequence.load(std::memory_order_relaxed) != before) {
+        return false;
+    }
+
+    std::memcpy(&snapshot, words, sizeof(Snapshot));
+    sequence = before;
+    return true;
+}
+
+} // namespace SharedTelemetry
+
+#endif // SHAREDTELEMETRY_HPP
@@ -0,0 +1,200 @@
+#include "SharedTelemetryReader.hpp"
+#include <cerrno>
+#include <cstring>
+
+#if GCS_SHARED_TELEMETRY
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Constructs a closed reader
+ */
+SharedTelemetryReader::SharedTelemetryReader()
+    : m_header(nullptr)
+    , m_size(0)
+    , m_slots(nullptr)
+    , m_ring(nullptr)
+    , m_nextFrame(0)
+    , m_lostFrames(0)
+    , m_retries(0)
+{
+}
+
+/**
+ * @brief Destructor
+ *
+ * Unmaps the shared memory object.
+ */
+SharedTelemetryReader::~SharedTelemetryReader()
+{
+    close();
+}
+
+/**
+ * @brief Maps an exported shared memory object
+ * @param name The object name, e.g. SharedTelemetry::DEFAULT_NAME
+ * @return False if it does not exist or is not a compatible export; see errorString()
+ *
+ * The object is only accepted once the writer has stored the magic, and
+ * only if it is as large as its header claims, so a reader never touches
+ * memory outside the mapping.
+ */
+bool SharedTelemetryReader::open(const std::string& name)
+{
+    close();
+
+#if GCS_SHARED_TELEMETRY
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        m_errorString = "Cannot open shared memory " + name + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(SharedTelemetry::Header)) {
+        ::close(fd);
+        m_errorString = "Shared memory " + name + " is not a telemetry export";
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        m_errorString = "Cannot map shared memory " + name + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const auto* header = static_cast<const SharedTelemetry::Header*>(mapping);
+    if (header->magic.load(std::memory_order_acquire) != SharedTelemetry::MAGIC
+        || header->version != SharedTelemetry::VERSION
+        || size < SharedTelemetry::objectSize(header->vehicleCapacity, header->ringCapacity)
+        || header->ringCapacity == 0 || (header->ringCapacity & (header->ringCapacity - 1)) != 0) {
+        ::munmap(mapping, size);
+        m_errorString = "Shared memory " + name + " is not a compatible telemetry export";
+        return false;
+    }
+
+    m_header = header;
+    m_size = size;
+    m_slots = SharedTelemetry::table(header);
+    m_ring = SharedTelemetry::ring(header);
+    m_nextFrame = header->frameCount.load(std::memory_order_acquire);
+    m_lostFrames = 0;
+    m_retries = 0;
+    m_errorString.clear();
+    return true;
+#else
+    m_errorString = "Shared memory telemetry is not supported on this platform (" + name + ")";
+    return false;
+#endif
+}
+
+void SharedTelemetryReader::close()
+{
+#if GCS_SHARED_TELEMETRY
+    if (m_header) {
+        ::munmap(const_cast<SharedTelemetry::Header*>(m_header), m_size);
+    }
+#endif
+    m_header = nullptr;
+    m_size = 0;
+    m_slots = nullptr;
+    m_ring = nullptr;
+}
+
+bool SharedTelemetryReader::isOpen() const
+{
+    return m_header != nullptr;
+}
+
+const std::string& SharedTelemetryReader::errorString() const
+{
+    return m_errorString;
+}
+
+std::uint32_t SharedTelemetryReader::vehicleCount() const
+{
+    return m_header ? m_header->vehicleCount.load(std::memory_order_acquire) : 0;
+}
+
+std::uint32_t SharedTelemetryReader::writerPid() const
+{
+    return m_header ? m_header->writerPid : 0;
+}
+
+std::uint64_t SharedTelemetryReader::updateCount() const
+{
+    return m_header ? m_header->updateCount.load(std::memory_order_acquire) : 0;
+}
+
+bool SharedTelemetryReader::vehicle(std::uint32_t slot, SharedTelemetry::Snapshot& snapshot) const
+{
+    if (slot >= vehicleCount()) {
+        return false;
+    }
+
+    std::uint64_t sequence;
+    while (!SharedTelemetry::tryRead(m_slots[slot].record, snapshot, sequence)) {
+        ++m_retries;
+    }
+    return true;
+}
+
+std::uint64_t SharedTelemetryReader::frameCount() const
+{
+    return m_header ? m_header->frameCount.load(std::memory_order_acquire) : 0;
+}
+
+/**
+ * @brief Reads frames written since the previous call
+ * @param frames Receives the frames, oldest first
+ * @param maxFrames Capacity of frames
+ * @return The number of frames read
+ *
+ * A reader more than a ring behind jumps to the oldest frame still in the
+ * ring. A frame is also lost if the writer laps the reader while it is
+ * being read; its entry then carries the sequence of a later frame.
+ */
+std::size_t SharedTelemetryReader::readFrames(SharedTelemetry::Snapshot* frames, std::size_t maxFrames)
+{
+    if (!m_header) {
+        return 0;
+    }
+
+    const std::uint64_t written = frameCount();
+    const std::uint64_t capacity = m_header->ringCapacity;
+    if (written - m_nextFrame > capacity) {
+        m_lostFrames += written - capacity - m_nextFrame;
+        m_nextFrame = written - capacity;
+    }
+
+    std::size_t count = 0;
+    for (; m_nextFrame < written && count < maxFrames; ++m_nextFrame) {
+        const SharedTelemetry::Record& entry = m_ring[m_nextFrame & (capacity - 1)];
+        const std::uint64_t expected = 2 * m_nextFrame + 2;
+        std::uint64_t sequence = 0;
+        while (!SharedTelemetry::tryRead(entry, frames[count], sequence)) {
+            ++m_retries;
+        }
+        if (sequence == expected) {
+            ++count;
+        } else {
+            ++m_lostFrames;
+        }
+    }
+    return count;
+}
+
+std::uint64_t SharedTelemetryReader::lostFrames() const
+{
+    return m_lostFrames;
+}
+
+std::uint64_t SharedTelemetryReader::retries() const
+{
+    return m_retries;
+}
@@ -0,0 +1,159 @@
+#ifndef SHAREDTELEMETRYREADER_HPP
+#define SHAREDTELEMETRYREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "SharedTelemetry.hpp"
+
+/**
+ * @class SharedTelemetryReader
+ * @brief Reads the telemetry a ground station exports into shared memory
+ *
+ * Opening maps the shared memory object read-only; after that, every read
+ * is a handful of memory loads without locks, system calls or parsing.
+ * Reads are retried while the writer updates the same record, which takes
+ * nanoseconds, so a reader never sees a torn snapshot.
+ *
+ * Only the standard library and POSIX are used, so the reader can be
+ * linked into processes that do not use Qt. A reader may be used by one
+ * thread at a time; use one reader per thread.
+ *
+ * @code
+ * SharedTelemetryReader reader;
+ * if (reader.open(SharedTelemetry::DEFAULT_NAME)) {
+ *     SharedTelemetry::Snapshot snapshot;
+ *     for (std::uint32_t slot = 0; slot < reader.vehicleCount(); ++slot) {
+ *         if (reader.vehicle(slot, snapshot)) {
+ *             // snapshot.latitude, snapshot.altitude, ...
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+class SharedTelemetryReader
+{
+public:
+    /**
+     * @brief Constructs a closed reader
+     */
+    SharedTelemetryReader();
+
+    /**
+     * @brief Destructor
+     *
+     * Unmaps the shared memory object.
+     */
+    ~SharedTelemetryReader();
+
+    SharedTelemetryReader(const SharedTelemetryReader&) = delete;
+    SharedTelemetryReader& operator=(const SharedTelemetryReader&) = delete;
+
+    /**
+     * @brief Maps an exported shared memory object
+     * @param name The object name, e.g. SharedTelemetry::DEFAULT_NAME
+     * @return False if it does not exist or is not a compatible export; see errorString()
+     *
+     * Starts reading the frame ring at the frames written from now on.
+     */
+    bool open(const std::string& name = SharedTelemetry::DEFAULT_NAME);
+
+    /**
+     * @brief Unmaps the shared memory object
+     */
+    void close();
+
+    /**
+     * @brief Checks whether an object is mapped
+     * @return True if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the reason the last open() failed
+     * @return The error message
+     */
+    const std::string& errorString() const;
+
+    /**
+     * @brief Gets the number of vehicles in the table
+     * @return The vehicle count
+     */
+    std::uint32_t vehicleCount() const;
+
+    /**
+     * @brief Gets the process id of the writer
+     * @return The process id
+     */
+    std::uint32_t writerPid() const;
+
+    /**
+     * @brief Gets the number of batches the writer has written, e.g. simulation ticks
+     * @return The count; if it stops growing, the writer is gone
+     */
+    std::uint64_t updateCount() const;
+
+    /**
+     * @brief Reads the latest snapshot of a vehicle
+     * @param slot The table slot, below vehicleCount(); slots keep their vehicle
+     * @param snapshot Receives the snapshot
+     * @return False if the slot is not in use
+     */
+    bool vehicle(std::uint32_t slot, SharedTelemetry::Snapshot& snapshot) const;
+
+    /**
+     * @brief Gets the total number of frames written to the ring
+     * @return The frame count
+     */
+    std::uint64_t frameCount() const;
+
+    /**
+     * @brief Reads frames written since the previous call
+     * @param frames Receives the frames, oldest first
+     * @param maxFrames Capacity of frames
+     * @return The number of frames read
+     *
+     * Frames the writer overwrote before they were read are skipped and
+     * counted in lostFrames().
+     */
+    std::size_t readFrames(SharedTelemetry::Snapshot* frames, std::size_t maxFrames);
+
+    /**
+     * @brief Gets the number of frames overwritten before readFrames() got to them
+     * @return The count since open()
+     */
+    std::uint64_t lostFrames() const;
+
+    /**
+     * @brief Gets the number of times a read found the writer busy and retried
+     * @return The count since open()
+     */
+    std::uint64_t retries() const;
+
+private:
+    /** @brief The mapped object, nullptr if closed */
+    const SharedTelemetry::Header* m_header;
+
+    /** @brief Size of the mapping in bytes */
+    std::size_t m_size;
+
+    /** @brief The vehicle table */
+    const SharedTelemetry::Slot* m_slots;
+
+    /** @brief The frame ring */
+    const SharedTelemetry::Record* m_ring;
+
+    /** @brief Number of the next frame readFrames() returns */
+    std::uint64_t m_nextFrame;
+
+    /** @brief Frames skipped by readFrames() */
+    std::uint64_t m_lostFrames;
+
+    /** @brief Retried reads */
+    mutable std::uint64_t m_retries;
+
+    /** @brief Reason the last open() failed */
+    std::string m_errorString;
+};
+
+#endif // SHAREDTELEMETRYREADER_HPP
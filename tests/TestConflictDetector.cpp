@@ -0,0 +1,231 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QGeoCoordinate>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <set>
+#include <utility>
+#include <vector>
+#include "ConflictDetector.hpp"
+#include "FleetSimulator.hpp"
+
+class TestConflictDetector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testHeadOn();
+    void testVerticalSeparation();
+    void testExistingLoss();
+    void testAgainstAllPairs();
+    void testFleet();
+    void benchmarkDetect();
+
+private:
+    // Helper function building a track a given distance east and north of Detroit
+    static ConflictDetector::Track track(int id, double east, double north, double altitude,
+                                         double speed, double heading, double climbRate = 0.0);
+
+    // Helper function scattering tracks with random headings, about one per 200m square
+    static std::vector<ConflictDetector::Track> scatter(int count, QRandomGenerator& random);
+};
+
+ConflictDetector::Track TestConflictDetector::track(int id, double east, double north, double altitude,
+                                                    double speed, double heading, double climbRate)
+{
+    const QGeoCoordinate position = QGeoCoordinate(42.3314, -83.0458).atDistanceAndAzimuth(qHypot(east, north),
+                                                                                           qRadiansToDegrees(qAtan2(east, north)));
+    ConflictDetector::Track track;
+    track.id = id;
+    track.latitude = position.latitude();
+    track.longitude = position.longitude();
+    track.altitude = altitude;
+    track.speed = speed;
+    track.heading = heading;
+    track.climbRate = climbRate;
+    return track;
+}
+
+std::vector<ConflictDetector::Track> TestConflictDetector::scatter(int count, QRandomGenerator& random)
+{
+    const double side = qSqrt(count) * 200.0;
+    std::vector<ConflictDetector::Track> tracks;
+    for (int i = 0; i < count; ++i) {
+        tracks.push_back(track(i, random.generateDouble() * side, random.generateDouble() * side,
+                               80.0 + random.generateDouble() * 60.0, 38.0 + random.generateDouble() * 4.0,
+                               random.generateDouble() * 360.0, (random.generateDouble() - 0.5) * 4.0));
+    }
+    return tracks;
+}
+
+void TestConflictDetector::testHeadOn()
+{
+    // Closing at 80 m/s from 1000m, separation is lost after (1000 - 30) / 80 seconds
+    const std::vector<ConflictDetector::Track> tracks = {
+        track(7, 0.0, 0.0, 100.0, 40.0, 90.0),
+        track(3, 1000.0, 0.0, 100.0, 40.0, 270.0),
+    };
+
+    ConflictDetector detector;
+    detector.detect(tracks);
+    QCOMPARE(detector.conflictCount(), 0);
+
+    detector.setHorizon(20.0);
+    detector.detect(tracks);
+    QCOMPARE(detector.conflictCount(), 1);
+
+    const ConflictDetector::Conflict& conflict = detector.conflicts()[0];
+    QCOMPARE(conflict.first, 3);
+    QCOMPARE(conflict.second, 7);
+    QVERIFY(qAbs(conflict.timeToLoss - 970.0 / 80.0) < 0.05);
+    QVERIFY(qAbs(conflict.closestTime - 12.5) < 0.05);
+    QVERIFY(conflict.closestDistance < 1.0);
+
+    // Passing 50m apart keeps the separation
+    detector.detect({track(7, 0.0, 0.0, 100.0, 40.0, 90.0), track(3, 1000.0, 50.0, 100.0, 40.0, 270.0)});
+    QCOMPARE(detector.conflictCount(), 0);
+}
+
+void TestConflictDetector::testVerticalSeparation()
+{
+    ConflictDetector detector;
+    detector.setHorizon(20.0);
+
+    // 50m above each other, the head-on pair passes safely
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 90.0), track(1, 1000.0, 0.0, 150.0, 40.0, 270.0)});
+    QCOMPARE(detector.conflictCount(), 0);
+
+    // Unless one descends into the other's altitude band before they pass
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 90.0), track(1, 1000.0, 0.0, 150.0, 40.0, 270.0, -4.0)});
+    QCOMPARE(detector.conflictCount(), 1);
+    QVERIFY(qAbs(detector.conflicts()[0].timeToLoss - 970.0 / 80.0) < 0.05);
+
+    // A descent that is too slow is not a conflict
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 90.0), track(1, 1000.0, 0.0, 150.0, 40.0, 270.0, -2.0)});
+    QCOMPARE(detector.conflictCount(), 0);
+}
+
+void TestConflictDetector::testExistingLoss()
+{
+    ConflictDetector detector;
+    QSignalSpy changedSpy(&detector, &ConflictDetector::conflictsChanged);
+
+    // Flying in formation 20m apart, separation is lost already
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 0.0), track(1, 20.0, 0.0, 105.0, 40.0, 0.0)});
+    QCOMPARE(detector.conflictCount(), 1);
+    QCOMPARE(detector.conflicts()[0].timeToLoss, 0.0);
+    QVERIFY(qAbs(detector.conflicts()[0].closestDistance - 20.0) < 0.1);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toInt(), 1);
+
+    // The same conflict again is no change; 40m apart it is resolved
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 0.0), track(1, 20.0, 0.0, 105.0, 40.0, 0.0)});
+    QCOMPARE(changedSpy.count(), 1);
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 0.0), track(1, 40.0, 0.0, 105.0, 40.0, 0.0)});
+    QCOMPARE(detector.conflictCount(), 0);
+    QCOMPARE(changedSpy.count(), 2);
+
+    // Without a horizon only current losses are reported
+    detector.setHorizon(0.0);
+    detector.detect({track(0, 0.0, 0.0, 100.0, 40.0, 90.0), track(1, 100.0, 0.0, 100.0, 40.0, 270.0)});
+    QCOMPARE(detector.conflictCount(), 0);
+    detector.detect({track(0, 0.0, 0.0, 100.0, 0.0, 0.0), track(1, 10.0, 0.0, 100.0, 0.0, 0.0)});
+    QCOMPARE(detector.conflictCount(), 1);
+}
+
+void TestConflictDetector::testAgainstAllPairs()
+{
+    // 2,000 vehicles, dense enough for hundreds of conflicts
+    QRandomGenerator random(11);
+    std::vector<ConflictDetector::Track> tracks = scatter(2000, random);
+    for (ConflictDetector::Track& t : tracks) {
+        t.id = 5000 - t.id;
+        t.speed = random.generateDouble() < 0.1 ? 0.0 : t.speed;
+    }
+
+    ConflictDetector detector;
+    detector.detect(tracks);
+    QVERIFY(detector.conflictCount() > 100);
+    QVERIFY(detector.candidateCount() < qint64(tracks.size()) * 20);
+
+    // Every pair within reach tested on its own, projected around the same first track
+    std::set<std::pair<int, int>> expected;
+    ConflictDetector pairDetector;
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        for (size_t j = i + 1; j < tracks.size(); ++j) {
+            if (QGeoCoordinate(tracks[i].latitude, tracks[i].longitude)
+                    .distanceTo(QGeoCoordinate(tracks[j].latitude, tracks[j].longitude)) > 1000.0) {
+                continue;
+            }
+            if (i == 0) {
+                pairDetector.detect({tracks[i], tracks[j]});
+            } else {
+                pairDetector.detect({tracks[0], tracks[i], tracks[j]});
+            }
+
+            const int first = qMin(tracks[i].id, tracks[j].id);
+            const int second = qMax(tracks[i].id, tracks[j].id);
+            for (const ConflictDetector::Conflict& conflict : pairDetector.conflicts()) {
+                if (conflict.first == first && conflict.second == second) {
+                    expected.insert({first, second});
+                }
+            }
+        }
+    }
+
+    std::set<std::pair<int, int>> found;
+    for (const ConflictDetector::Conflict& conflict : detector.conflicts()) {
+        QVERIFY(conflict.first < conflict.second);
+        found.insert({conflict.first, conflict.second});
+    }
+    QCOMPARE(found.size(), size_t(detector.conflictCount()));
+    QVERIFY(found == expected);
+}
+
+void TestConflictDetector::testFleet()
+{
+    FleetSimulator fleet;
+    fleet.addVehicles(4, QGeoCoordinate(42.3314, -83.0458), 20.0);
+
+    ConflictDetector detector;
+    QSignalSpy changedSpy(&detector, &ConflictDetector::conflictsChanged);
+
+    // Landed vehicles are never in conflict
+    detector.setFleet(&fleet);
+    QCOMPARE(detector.conflictCount(), 0);
+
+    // Two vehicles taking off next to each other are, within the same tick
+    QVERIFY(fleet.takeOff(0));
+    QVERIFY(fleet.takeOff(1));
+    fleet.step();
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(detector.conflictCount(), 1);
+    QCOMPARE(detector.conflicts()[0].first, 0);
+    QCOMPARE(detector.conflicts()[0].second, 1);
+    QCOMPARE(detector.conflicts()[0].timeToLoss, 0.0);
+
+    // Detaching the fleet clears the conflicts
+    detector.setFleet(nullptr);
+    QCOMPARE(detector.conflictCount(), 0);
+    QCOMPARE(changedSpy.count(), 2);
+    fleet.step();
+    QCOMPARE(changedSpy.count(), 2);
+}
+
+void TestConflictDetector::benchmarkDetect()
+{
+    // One tick of a 10,000-vehicle fleet
+    QRandomGenerator random(29);
+    const std::vector<ConflictDetector::Track> tracks = scatter(10000, random);
+
+    ConflictDetector detector;
+    QBENCHMARK {
+        detector.detect(tracks);
+    }
+    QVERIFY(detector.candidateCount() < qint64(tracks.size()) * 20);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestConflictDetector)
+#include "TestConflictDetector.moc"
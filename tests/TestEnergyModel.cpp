@@ -0,0 +1,159 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QtMath>
+#include <vector>
+#include "EnergyModel.hpp"
+
+class TestEnergyModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLevelPower_data();
+    void testLevelPower();
+    void testManeuvers();
+    void testOptimalSpeeds();
+    void testEstimates();
+    void benchmarkPower();
+
+private:
+    // Helper function evaluating the level-flight power formula directly
+    static double levelPower(const EnergyModel::Airframe& airframe, double speed);
+};
+
+double TestEnergyModel::levelPower(const EnergyModel::Airframe& airframe, double speed)
+{
+    const double density = 1.225;
+    const double weight = airframe.mass * EnergyModel::GRAVITY;
+    const double parasite = 0.5 * density * airframe.wingArea * airframe.zeroLiftDrag * speed * speed * speed;
+    const double induced = 2.0 * airframe.inducedDragFactor * weight * weight / (density * airframe.wingArea * speed);
+    return (parasite + induced) / airframe.propulsiveEfficiency + airframe.avionicsPower;
+}
+
+void TestEnergyModel::testLevelPower_data()
+{
+    QTest::addColumn<double>("speed");
+
+    QTest::newRow("stall") << 15.0;
+    QTest::newRow("loiter") << 17.3;
+    QTest::newRow("between entries") << 26.11;
+    QTest::newRow("cruise") << 40.0;
+    QTest::newRow("fastest") << EnergyModel::MAX_AIRSPEED;
+}
+
+void TestEnergyModel::testLevelPower()
+{
+    QFETCH(double, speed);
+
+    // The interpolated tables stay within 0.1% of the formula
+    const EnergyModel model;
+    const double expected = levelPower(model.airframe(), speed);
+    QVERIFY2(qAbs(model.power(speed, 0.0, 0.0) - expected) < expected * 0.001,
+             qPrintable(QStringLiteral("%1 W, expected %2 W").arg(model.power(speed, 0.0, 0.0)).arg(expected)));
+}
+
+void TestEnergyModel::testManeuvers()
+{
+    const EnergyModel model;
+    const double level = model.power(40.0, 0.0, 0.0);
+
+    // Climbing adds the rate of change of potential energy
+    const double climb = model.power(40.0, 5.0, 0.0);
+    const EnergyModel::Airframe& airframe = model.airframe();
+    QVERIFY(qAbs(climb - level - airframe.mass * EnergyModel::GRAVITY * 5.0 / airframe.propulsiveEfficiency) < 1e-6);
+
+    // Descending saves power down to the avionics load
+    QVERIFY(model.power(40.0, -2.0, 0.0) < level);
+    QCOMPARE(model.power(40.0, -50.0, 0.0), airframe.avionicsPower);
+
+    // Turning costs more the tighter the turn, in either direction
+    const double gentle = model.power(17.0, 0.0, 0.1);
+    const double tight = model.power(17.0, 0.0, 0.4);
+    QVERIFY(model.power(17.0, 0.0, 0.0) < gentle);
+    QVERIFY(gentle < tight);
+    QCOMPARE(model.power(17.0, 0.0, -0.4), tight);
+
+    // A vehicle at rest is powered down and faster flight reads as the fastest entry
+    QCOMPARE(model.power(0.0, 0.0, 0.0), 0.0);
+    QVERIFY(model.power(5.0, 0.0, 0.0) < model.power(10.0, 0.0, 0.0));
+    QCOMPARE(model.power(100.0, 0.0, 0.0), model.power(EnergyModel::MAX_AIRSPEED, 0.0, 0.0));
+}
+
+void TestEnergyModel::testOptimalSpeeds()
+{
+    const EnergyModel model;
+
+    // Maximum range is flown faster than maximum endurance, both above stall
+    QVERIFY(model.enduranceSpeed() >= model.airframe().stallSpeed);
+    QVERIFY(model.rangeSpeed() > model.enduranceSpeed());
+    QCOMPARE(model.minimumPower(), model.power(model.enduranceSpeed(), 0.0, 0.0));
+
+    for (double speed = model.airframe().stallSpeed; speed <= EnergyModel::MAX_AIRSPEED; speed += 1.0) {
+        QVERIFY(model.power(speed, 0.0, 0.0) >= model.minimumPower());
+    }
+
+    // A heavier vehicle needs more power and flies slower for endurance
+    EnergyModel::Airframe heavy;
+    heavy.mass = 25.0;
+    const EnergyModel heavyModel(heavy);
+    QVERIFY(heavyModel.minimumPower() > model.minimumPower());
+    QVERIFY(heavyModel.enduranceSpeed() > model.enduranceSpeed());
+}
+
+void TestEnergyModel::testEstimates()
+{
+    const EnergyModel model;
+    const double capacity = model.capacity();
+    QCOMPARE(capacity, model.airframe().capacity * 3600.0);
+
+    // On the ground the estimates assume the best case
+    QCOMPARE(model.remainingFlightTime(capacity, 0.0), capacity / model.minimumPower());
+    QVERIFY(model.remainingRange(capacity, 0.0, 0.0) >= model.remainingFlightTime(capacity, 0.0) * model.enduranceSpeed());
+
+    // Cruising for ten minutes, the averages converge on the actual draw
+    const double dt = 0.25;
+    const double cruise = model.power(40.0, 0.0, 0.0);
+    double energy = capacity;
+    double averagePower = 0.0;
+    double averageSpeed = 0.0;
+    for (int step = 0; step < 2400; ++step) {
+        const double power = model.power(40.0, 0.0, 0.0);
+        energy -= power * dt;
+        averagePower += (power - averagePower) * EnergyModel::smoothing(dt);
+        averageSpeed += (40.0 - averageSpeed) * EnergyModel::smoothing(dt);
+    }
+
+    QVERIFY(qAbs(energy - (capacity - cruise * 600.0)) < 1.0);
+    QVERIFY(qAbs(averagePower - cruise) < cruise * 0.001);
+
+    const double flightTime = model.remainingFlightTime(energy, averagePower);
+    QVERIFY(qAbs(flightTime - energy / cruise) < 5.0);
+    QVERIFY(qAbs(model.remainingRange(energy, averagePower, averageSpeed) - flightTime * averageSpeed) < 1.0);
+}
+
+void TestEnergyModel::benchmarkPower()
+{
+    // One tick of a 10,000-vehicle fleet
+    const int count = 10000;
+    const EnergyModel model;
+    std::vector<double> speed(count);
+    std::vector<double> climb(count);
+    std::vector<double> turn(count);
+    for (int i = 0; i < count; ++i) {
+        speed[i] = 15.0 + (i % 100) * 0.3;
+        climb[i] = (i % 11) - 5.0;
+        turn[i] = (i % 7) * 0.05;
+    }
+
+    double total = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i) {
+            total += model.power(speed[i], climb[i], turn[i]);
+        }
+    }
+    QVERIFY(total > 0.0);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestEnergyModel)
+#include "TestEnergyModel.moc"
@@ -0,0 +1,219 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QRegularExpression>
+#include <QVector>
+#include "EventLog.hpp"
+#include "UASStateMachine.hpp"
+
+class TestEventLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testCompiledLevels();
+    void testFormat();
+    void testWritesRecords();
+    void testThreadsMerged();
+    void testDroppedWhenFull();
+    void benchmarkLog();
+    void benchmarkQDebug();
+
+private:
+    /**
+     * @brief Reads the lines of a log file
+     */
+    QStringList readLines(const QString& path);
+
+    /**
+     * @brief Drains pending records into a scratch file
+     */
+    void discardPending();
+
+    QTemporaryDir m_dir;
+};
+
+void TestEventLog::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+QStringList TestEventLog::readLines(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return {};
+    }
+    return QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+void TestEventLog::discardPending()
+{
+    QVERIFY(EventLog::start(m_dir.filePath("discarded.log")));
+    EventLog::stop();
+}
+
+void TestEventLog::testCompiledLevels()
+{
+    // Debug events are compiled into debug builds only
+    QCOMPARE(EventLog::isEnabled(EventLog::Debug), GCS_LOG_LEVEL == 0);
+    QVERIFY(EventLog::isEnabled(EventLog::Warning));
+    QVERIFY(!EventLog::isEnabled(EventLog::Off));
+}
+
+void TestEventLog::testFormat()
+{
+    EventLog::Record record{0, -1, EventLog::TakeOffStarted, EventLog::Info, 0, {120.0, 0.0, 0.0}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("taking off to 120 m"));
+
+    record = {0, 42, EventLog::WaypointReached, EventLog::Debug, 0, {42.3314, -83.0458, 0.0}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("vehicle 42 reached destination 42.331400, -83.045800"));
+
+    record = {0, -1, EventLog::StateChanged, EventLog::Debug, 0, {UASState::Landed, UASState::TakingOff, 0.0}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("state changed from Landed to TakingOff"));
+
+    record = {0, 7, EventLog::GeofenceBreached, EventLog::Debug, 0, {2.0, 42.3314, -83.0458}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("vehicle 7 geofence breached - inside exclusion zone 2 at 42.331400, -83.045800"));
+
+    record = {0, 7, EventLog::GeofenceBreached, EventLog::Debug, 0, {-2.0, 42.3314, -83.0458}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("vehicle 7 geofence breached - outside all inclusion zones at 42.331400, -83.045800"));
+
+    record = {0, -1, EventLog::GeofenceRejected, EventLog::Info, 0, {UASState::FlyingToWaypoint, 0.0, 0.0}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("command to FlyingToWaypoint rejected by the geofence"));
+
+    record = {0, 3, EventLog::ConflictPredicted, EventLog::Warning, 0, {9.0, 4.3, 12.0}};
+    QCOMPARE(EventLog::format(record), QStringLiteral("vehicle 3 conflict with vehicle 9 in 4.3 s, closest approach 12.0 m"));
+
+    record = {0, -1, EventLog::EVENT_COUNT, EventLog::Info, 0, {0.0, 0.0, 0.0}};
+    QVERIFY(EventLog::format(record).startsWith(QStringLiteral("unknown event")));
+}
+
+void TestEventLog::testWritesRecords()
+{
+    const QString path = m_dir.filePath("records.log");
+    QVERIFY(EventLog::start(path));
+    QVERIFY(EventLog::isRunning());
+
+    EventLog::info(EventLog::TakeOffStarted, -1, 120);
+    EventLog::info(EventLog::Landed, 3);
+    EventLog::warning(EventLog::CommandDropped);
+
+    // Compiled out in release builds
+    EventLog::debug(EventLog::LandingStarted, 3);
+
+    // stop() writes everything logged before it
+    EventLog::stop();
+    QVERIFY(!EventLog::isRunning());
+
+    const QStringList lines = readLines(path);
+    QCOMPARE(lines.size(), EventLog::isEnabled(EventLog::Debug) ? 4 : 3);
+    QVERIFY(lines[0].endsWith(QStringLiteral("info: taking off to 120 m")));
+    QVERIFY(lines[1].endsWith(QStringLiteral("info: vehicle 3 landed")));
+    QVERIFY(lines[2].endsWith(QStringLiteral("warning: simulation is not keeping up, command dropped")));
+    if (EventLog::isEnabled(EventLog::Debug)) {
+        QVERIFY(lines[3].endsWith(QStringLiteral("debug: vehicle 3 landing")));
+    }
+    QVERIFY(lines[0].contains(QStringLiteral("[T")));
+}
+
+void TestEventLog::testThreadsMerged()
+{
+    const int threadCount = 4;
+    const int events = 1000;
+
+    const QString path = m_dir.filePath("threads.log");
+    QVERIFY(EventLog::start(path));
+
+    QVector<QThread*> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.append(QThread::create([t]() {
+            for (int i = 0; i < events; ++i) {
+                EventLog::info(EventLog::WaypointSet, t, i, 0.0);
+                if (i % 250 == 0) {
+                    QThread::msleep(5);
+                }
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread* thread : std::as_const(threads)) {
+        QVERIFY(thread->wait(10000));
+        delete thread;
+    }
+
+    EventLog::stop();
+
+    // Every record arrives once, and each thread's records in sequence
+    const QRegularExpression pattern(QStringLiteral("^(\\d+\\.\\d+) \\[T\\d+\\] info: vehicle (\\d+) flying to (\\d+)\\."));
+    const QStringList lines = readLines(path);
+    QCOMPARE(lines.size(), threadCount * events);
+
+    QVector<int> next(threadCount, 0);
+    QVector<double> previousTime(threadCount, 0.0);
+    for (const QString& line : lines) {
+        const QRegularExpressionMatch match = pattern.match(line);
+        QVERIFY2(match.hasMatch(), qPrintable(line));
+
+        const int thread = match.captured(2).toInt();
+        const double time = match.captured(1).toDouble();
+        QVERIFY(time >= previousTime[thread]);
+        previousTime[thread] = time;
+
+        QCOMPARE(match.captured(3).toInt(), next[thread]);
+        ++next[thread];
+    }
+}
+
+void TestEventLog::testDroppedWhenFull()
+{
+    const quint64 before = EventLog::droppedRecords();
+
+    // Without a running drain thread the ring of a new thread fills up
+    QThread* thread = QThread::create([]() {
+        for (int i = 0; i < EventLog::RING_CAPACITY + 10; ++i) {
+            EventLog::info(EventLog::Landed, i);
+        }
+    });
+    thread->start();
+    QVERIFY(thread->wait(10000));
+    delete thread;
+
+    QCOMPARE(EventLog::droppedRecords() - before, quint64(10));
+
+    // The ring of the exited thread is drained and freed
+    discardPending();
+    QCOMPARE(EventLog::droppedRecords() - before, quint64(10));
+}
+
+void TestEventLog::benchmarkLog()
+{
+    QVERIFY(EventLog::start(m_dir.filePath("benchmark.log")));
+
+    // Once the ring is full between two drains, the cost is that of a drop
+    int vehicle = 0;
+    QBENCHMARK {
+        EventLog::info(EventLog::TakeOffCompleted, vehicle++, 120.0, 25.0);
+    }
+
+    EventLog::stop();
+}
+
+void TestEventLog::benchmarkQDebug()
+{
+    // The cost the logger replaces: formatting and the message handler, even when it discards
+    QtMessageHandler previous = qInstallMessageHandler([](QtMsgType, const QMessageLogContext&, const QString&) {});
+
+    int vehicle = 0;
+    QBENCHMARK {
+        qDebug() << "Vehicle" << vehicle++ << "takeoff completed - Altitude:" << 120.0 << "Speed:" << 25.0;
+    }
+
+    qInstallMessageHandler(previous);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestEventLog)
+#include "TestEventLog.moc"
@@ -0,0 +1,483 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QGeoCoordinate>
+#include <QObject>
+#include <QThread>
+#include "FleetSimulator.hpp"
+#include "FleetVehicle.hpp"
+#include "Geofence.hpp"
+
+class TestFleetSimulator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testAddVehicles();
+    void testFlightSequence();
+    void testInvalidCommands();
+    void testSingleSignalPerTick();
+    void testVehicleView();
+    void testEndurance();
+    void testBatchCommands();
+    void testGeofence();
+    void testParallelMatchesSerial_data();
+    void testParallelMatchesSerial();
+    void benchmarkParallelStep_data();
+    void benchmarkParallelStep();
+    void cleanup();
+
+private:
+    FleetSimulator* m_fleet;
+
+    // Helper function to step the fleet until the predicate holds or the step budget runs out
+    template <typename Predicate>
+    bool stepUntil(Predicate predicate, int maxSteps = 400);
+
+    // Helper function building a rectangular geofence zone
+    static Geofence::Zone rectangle(Geofence::ZoneType type, double south, double west, double north, double east);
+
+    // Helper function to put a seeded fleet through takeoff, waypoints and landing
+    static void runScenario(FleetSimulator& fleet, int vehicles);
+};
+
+template <typename Predicate>
+bool TestFleetSimulator::stepUntil(Predicate predicate, int maxSteps)
+{
+    for (int i = 0; i < maxSteps; ++i) {
+        if (predicate()) {
+            return true;
+        }
+        m_fleet->step();
+    }
+    return predicate();
+}
+
+Geofence::Zone TestFleetSimulator::rectangle(Geofence::ZoneType type, double south, double west, double north, double east)
+{
+    Geofence::Zone zone;
+    zone.type = type;
+    zone.vertices = {GeoPoint(south, west), GeoPoint(south, east), GeoPoint(north, east), GeoPoint(north, west)};
+    return zone;
+}
+
+void TestFleetSimulator::runScenario(FleetSimulator& fleet, int vehicles)
+{
+    fleet.setSeed(2024);
+    fleet.addVehicles(vehicles, QGeoCoordinate(42.3314, -83.0458));
+
+    for (int i = 0; i < vehicles; ++i) {
+        fleet.takeOff(i);
+    }
+    for (int tick = 0; tick < 40; ++tick) {
+        fleet.step();
+    }
+
+    // Half of the fleet flies to waypoints, a quarter lands, the rest keeps cruising
+    for (int i = 0; i < vehicles; ++i) {
+        if (i % 2 == 0) {
+            fleet.goTo(i, QGeoCoordinate(42.3314 + 0.001 * (i % 7), -83.0458), 100, i % 4 == 0);
+        } else if (i % 4 == 1) {
+            fleet.land(i);
+        }
+    }
+    for (int tick = 0; tick < 120; ++tick) {
+        fleet.step();
+    }
+}
+
+void TestFleetSimulator::init()
+{
+    m_fleet = new FleetSimulator();
+    m_fleet->addVehicles(100, QGeoCoordinate(42.3314, -83.0458));
+}
+
+void TestFleetSimulator::testAddVehicles()
+{
+    QSignalSpy countSpy(m_fleet, &FleetSimulator::vehicleCountChanged);
+
+    // Adding vehicles appends to the existing arrays
+    const int first = m_fleet->addVehicles(25, QGeoCoordinate(42.0, -83.0));
+    QCOMPARE(first, 100);
+    QCOMPARE(m_fleet->vehicleCount(), 125);
+    QCOMPARE(countSpy.count(), 1);
+
+    // All vehicles start landed with a full battery
+    for (int i = 0; i < m_fleet->vehicleCount(); ++i) {
+        QCOMPARE(m_fleet->state(i), UASState::Landed);
+        QCOMPARE(m_fleet->battery(i), 100.0);
+        QCOMPARE(m_fleet->speed(i), 0.0);
+    }
+
+    // Vehicles are spread out rather than stacked on the origin
+    QVERIFY(m_fleet->position(0).distanceTo(m_fleet->position(1)) > 1.0);
+}
+
+void TestFleetSimulator::testFlightSequence()
+{
+    const int count = m_fleet->vehicleCount();
+
+    // Take off the whole fleet
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(m_fleet->takeOff(i));
+        QCOMPARE(m_fleet->state(i), UASState::TakingOff);
+    }
+
+    // Takeoff completes after the takeoff duration
+    QVERIFY(stepUntil([&]() { return m_fleet->state(count - 1) == UASState::Flying; }));
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(m_fleet->state(i), UASState::Flying);
+        QVERIFY(m_fleet->altitude(i) > 100.0);
+        QVERIFY(m_fleet->speed(i) >= 38.0);
+    }
+
+    // Send every vehicle to a waypoint about 500m away
+    const QGeoCoordinate destination(42.3314 + 0.0045, -83.0458);
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(m_fleet->goTo(i, destination, 100, i % 2 == 0));
+    }
+
+    // Every vehicle reaches the waypoint and starts loitering around it
+    QVERIFY(stepUntil([&]() {
+        for (int i = 0; i < count; ++i) {
+            if (m_fleet->state(i) != UASState::Loitering) {
+                return false;
+            }
+        }
+        return true;
+    }));
+
+    m_fleet->step();
+    QVERIFY(qAbs(m_fleet->position(0).distanceTo(destination) - 100.0) < 5.0);
+
+    // Land the whole fleet
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(m_fleet->land(i));
+    }
+
+    QVERIFY(stepUntil([&]() { return m_fleet->state(count - 1) == UASState::Landed; }));
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(m_fleet->state(i), UASState::Landed);
+        QCOMPARE(m_fleet->altitude(i), 0.0);
+        QCOMPARE(m_fleet->speed(i), 0.0);
+    }
+}
+
+void TestFleetSimulator::testInvalidCommands()
+{
+    // Cannot land or go to a waypoint while landed
+    QVERIFY(!m_fleet->land(0));
+    QVERIFY(!m_fleet->goTo(0, QGeoCoordinate(42.34, -83.04), 100, true));
+    QCOMPARE(m_fleet->state(0), UASState::Landed);
+
+    // Cannot take off twice
+    QVERIFY(m_fleet->takeOff(0));
+    QVERIFY(!m_fleet->takeOff(0));
+    QCOMPARE(m_fleet->state(0), UASState::TakingOff);
+
+    // Rejections are recorded per vehicle instead of logged
+    const TransitionAudit& audit = m_fleet->audit(0);
+    QCOMPARE(audit.totalRecorded(), quint32(4));
+    QCOMPARE(audit.rejectedCount(), quint32(3));
+    QCOMPARE(audit.at(0).result, UASState::RequiresFlying);
+    QCOMPARE(audit.at(2).to, UASState::TakingOff);
+    QCOMPARE(audit.last().result, UASState::RequiresLanded);
+    QCOMPARE(m_fleet->audit(1).count(), 0);
+
+    // Transitions made by the simulation carry the simulated time
+    QVERIFY(stepUntil([&]() { return m_fleet->state(0) == UASState::Flying; }));
+    QCOMPARE(audit.last().to, UASState::Flying);
+    QVERIFY(audit.last().timestamp > 0);
+    QVERIFY(audit.last().timestamp < m_fleet->simulatedTime());
+
+    // Out of range indices are rejected
+    QVERIFY(!m_fleet->takeOff(-1));
+    QVERIFY(!m_fleet->takeOff(m_fleet->vehicleCount()));
+    QVERIFY(m_fleet->vehicle(m_fleet->vehicleCount()) == nullptr);
+}
+
+void TestFleetSimulator::testSingleSignalPerTick()
+{
+    QSignalSpy stepSpy(m_fleet, &FleetSimulator::stepped);
+
+    for (int i = 0; i < m_fleet->vehicleCount(); ++i) {
+        m_fleet->takeOff(i);
+    }
+
+    // One notification per tick regardless of fleet size
+    m_fleet->step();
+    m_fleet->step();
+    QCOMPARE(stepSpy.count(), 2);
+    QCOMPARE(m_fleet->tickCount(), quint64(2));
+}
+
+void TestFleetSimulator::testVehicleView()
+{
+    FleetVehicle* vehicle = m_fleet->vehicle(3);
+    QVERIFY(vehicle != nullptr);
+    QCOMPARE(m_fleet->vehicle(3), vehicle);
+    QCOMPARE(vehicle->index(), 3);
+
+    QSignalSpy stateSpy(vehicle, &TelemetryData::stateChanged);
+    QSignalSpy positionSpy(vehicle, &TelemetryData::positionChanged);
+    QSignalSpy batterySpy(vehicle, &TelemetryData::batteryChanged);
+
+    // Commands through the view are reflected immediately
+    vehicle->takeOff();
+    QCOMPARE(vehicle->state(), UASState::TakingOff);
+    QCOMPARE(m_fleet->state(3), UASState::TakingOff);
+    QCOMPARE(stateSpy.count(), 1);
+
+    // Stepping refreshes the view with the fleet values
+    m_fleet->step();
+    QCOMPARE(positionSpy.count(), 1);
+    QCOMPARE(vehicle->position(), m_fleet->position(3));
+    QCOMPARE(vehicle->speed(), qRound(m_fleet->speed(3)));
+
+    // Unchanged properties do not emit
+    QCOMPARE(batterySpy.count(), vehicle->battery() == 100 ? 0 : 1);
+
+    // Changes made directly on the fleet also reach the view
+    QVERIFY(stepUntil([&]() { return vehicle->state() == UASState::Flying; }));
+    m_fleet->land(3);
+    m_fleet->step();
+    QCOMPARE(vehicle->state(), UASState::Landing);
+}
+
+void TestFleetSimulator::testEndurance()
+{
+    FleetSimulator fleet;
+    fleet.setSeed(11);
+    fleet.addVehicles(4, QGeoCoordinate(42.3314, -83.0458));
+
+    const EnergyModel model;
+    const double landedEstimate = model.capacity() / model.minimumPower();
+    QCOMPARE(fleet.remainingFlightTime(0), landedEstimate);
+
+    FleetVehicle* vehicle = fleet.vehicle(0);
+    QCOMPARE(vehicle->remainingFlightTime(), qRound(landedEstimate));
+    QVERIFY(vehicle->remainingRange() > 0);
+    QSignalSpy timeSpy(vehicle, &TelemetryData::remainingFlightTimeChanged);
+
+    // One vehicle cruises, one circles tightly, one widely and one stays on the ground
+    fleet.takeOff(QVector<int>{0, 1, 2});
+    for (int tick = 0; tick < 40; ++tick) {
+        fleet.step();
+    }
+    QCOMPARE(fleet.state(2), UASState::Flying);
+    fleet.goTo(1, fleet.position(1), 30, true);
+    fleet.goTo(2, fleet.position(2), 1000, true);
+    for (int tick = 0; tick < 1200; ++tick) {
+        fleet.step();
+    }
+    QCOMPARE(fleet.state(1), UASState::Loitering);
+
+    // Cruising drains the battery fastest, and a tight circle costs more than a wide one
+    QVERIFY(fleet.battery(0) < fleet.battery(1));
+    QVERIFY(fleet.battery(1) < fleet.battery(2));
+    QCOMPARE(fleet.battery(3), 100.0);
+    QVERIFY(fleet.remainingFlightTime(0) < fleet.remainingFlightTime(2));
+    QCOMPARE(fleet.remainingFlightTime(3), landedEstimate);
+
+    // At cruise the estimates follow from the remaining energy
+    const double energy = fleet.battery(0) / 100.0 * model.capacity();
+    const double cruise = energy / model.power(40.0, 0.0, 0.0);
+    QVERIFY(qAbs(fleet.remainingFlightTime(0) - cruise) < cruise * 0.05);
+    QVERIFY(qAbs(fleet.remainingRange(0) - cruise * 40.0) < cruise * 40.0 * 0.05);
+
+    // The view publishes the estimates on every refresh
+    QVERIFY(timeSpy.count() > 0);
+    QCOMPARE(vehicle->remainingFlightTime(), qRound(fleet.remainingFlightTime(0)));
+    QCOMPARE(vehicle->remainingRange(), qRound(fleet.remainingRange(0)));
+    QCOMPARE(vehicle->battery(), qRound(fleet.battery(0)));
+}
+
+void TestFleetSimulator::testBatchCommands()
+{
+    // A second group of 100 vehicles next to the first
+    m_fleet->addVehicles(100, QGeoCoordinate(42.3314, -83.0358), 50.0, 4);
+    QCOMPARE(m_fleet->stateStore()->group(150), quint8(4));
+
+    QVector<int> all;
+    QVector<QGeoCoordinate> destinations;
+    for (int i = 0; i < m_fleet->vehicleCount(); ++i) {
+        all.append(i);
+        destinations.append(QGeoCoordinate(42.3314 + 0.0045, -83.0458 + 0.0001 * i));
+    }
+
+    QSignalSpy changedSpy(m_fleet->stateStore(), &FleetStateStore::statesChanged);
+
+    // The whole fleet takes off with one notification
+    QCOMPARE(m_fleet->takeOff(all), 200);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).value<QVector<int>>().size(), 200);
+    QVERIFY(stepUntil([&]() { return m_fleet->stateStore()->count(UASState::Flying) == 200; }));
+
+    // Every vehicle is sent to its own waypoint
+    changedSpy.clear();
+    QCOMPARE(m_fleet->goTo(all, destinations, 100, true), 200);
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(stepUntil([&]() { return m_fleet->stateStore()->count(UASState::Loitering) == 200; }));
+    m_fleet->step();
+    QVERIFY(qAbs(m_fleet->position(150).distanceTo(destinations[150]) - 100.0) < 5.0);
+
+    // Mismatched destination lists are rejected as a whole
+    QCOMPARE(m_fleet->goTo(all, destinations.mid(0, 2), 100, true), 0);
+
+    // Land the loitering vehicles of group 4 only
+    changedSpy.clear();
+    QCOMPARE(m_fleet->landWhere(UASState::Loitering, 4), 100);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(m_fleet->state(150), UASState::Landing);
+    QCOMPARE(m_fleet->state(50), UASState::Loitering);
+
+    QVERIFY(stepUntil([&]() { return m_fleet->stateStore()->count(UASState::Landed) == 100; }));
+    QCOMPARE(m_fleet->altitude(150), 0.0);
+}
+
+void TestFleetSimulator::testGeofence()
+{
+    FleetVehicle* view = m_fleet->vehicle(0);
+    QSignalSpy breachedSpy(m_fleet, &FleetSimulator::geofenceBreached);
+    QSignalSpy clearedSpy(m_fleet, &FleetSimulator::geofenceCleared);
+    QSignalSpy viewSpy(view, &TelemetryData::geofenceBreachedChanged);
+
+    // A fence over the parked fleet reports every vehicle at once
+    Geofence covering;
+    covering.setZones({rectangle(Geofence::Exclusion, 42.3264, -83.0528, 42.3364, -83.0388)});
+    m_fleet->setGeofence(&covering);
+    QCOMPARE(breachedSpy.count(), 1);
+    QCOMPARE(breachedSpy.at(0).at(0).value<QVector<int>>().size(), 100);
+    QCOMPARE(m_fleet->breachCount(), 100);
+    QCOMPARE(m_fleet->geofenceBreach(0), 0);
+    QVERIFY(view->geofenceBreached());
+    QCOMPARE(viewSpy.count(), 1);
+
+    // Vehicles cannot take off inside an exclusion zone
+    QVERIFY(!m_fleet->takeOff(0));
+    QCOMPARE(m_fleet->state(0), UASState::Landed);
+    QCOMPARE(m_fleet->audit(0).last().to, UASState::TakingOff);
+    QCOMPARE(m_fleet->audit(0).last().result, UASState::GeofenceViolation);
+
+    // Further ticks report nothing new; removing the fence clears everyone
+    m_fleet->step();
+    QCOMPARE(breachedSpy.count(), 1);
+    m_fleet->setGeofence(nullptr);
+    QCOMPARE(clearedSpy.count(), 1);
+    QCOMPARE(clearedSpy.at(0).at(0).value<QVector<int>>().size(), 100);
+    QCOMPARE(m_fleet->breachCount(), 0);
+    QVERIFY(!view->geofenceBreached());
+
+    const int count = m_fleet->vehicleCount();
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(m_fleet->takeOff(i));
+    }
+    QVERIFY(stepUntil([&]() { return m_fleet->stateStore()->count(UASState::Flying) == count; }));
+
+    // Waypoints inside or behind an exclusion zone are rejected
+    Geofence band;
+    band.setZones({rectangle(Geofence::Exclusion, 42.3500, -83.1000, 42.3600, -83.0000)});
+    m_fleet->setGeofence(&band);
+    QVERIFY(!m_fleet->goTo(0, QGeoCoordinate(42.3550, -83.0458), 100, true));
+    QVERIFY(!m_fleet->goTo(0, QGeoCoordinate(42.3700, -83.0458), 100, true));
+    QCOMPARE(m_fleet->audit(0).last().to, UASState::FlyingToWaypoint);
+    QCOMPARE(m_fleet->audit(0).last().result, UASState::GeofenceViolation);
+    QCOMPARE(m_fleet->state(0), UASState::Flying);
+
+    // The whole fleet is sent short of the band
+    QVector<int> all;
+    for (int i = 0; i < count; ++i) {
+        all.append(i);
+    }
+    const QGeoCoordinate destination(42.3314 + 0.0045, -83.0458);
+    QCOMPARE(m_fleet->goTo(all, {destination}, 100, true), count);
+
+    // With the land action, vehicles entering a new exclusion zone are landed
+    Geofence restricted;
+    restricted.setZones({rectangle(Geofence::Exclusion, 42.3340, -83.0600, 42.3400, -83.0300)});
+    restricted.setBreachAction(Geofence::Land);
+    m_fleet->setGeofence(&restricted);
+    QVERIFY(stepUntil([&]() { return m_fleet->stateStore()->count(UASState::Landed) == count; }));
+    QCOMPARE(m_fleet->breachCount(), count);
+    QCOMPARE(m_fleet->audit(0).last().to, UASState::Landed);
+    QVERIFY(view->geofenceBreached());
+
+    m_fleet->setGeofence(nullptr);
+}
+
+void TestFleetSimulator::testParallelMatchesSerial_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+void TestFleetSimulator::testParallelMatchesSerial()
+{
+    QFETCH(int, threads);
+
+    // Several shards, the last one partial
+    const int vehicles = FleetSimulator::SHARD_SIZE * 5 + 123;
+
+    FleetSimulator serial;
+    runScenario(serial, vehicles);
+
+    FleetSimulator parallel;
+    parallel.setThreadCount(threads);
+    QCOMPARE(parallel.threadCount(), threads);
+    runScenario(parallel, vehicles);
+
+    // Shards only touch their own vehicles, so the results are bit for bit equal
+    QCOMPARE(parallel.tickCount(), serial.tickCount());
+    for (int i = 0; i < vehicles; ++i) {
+        QCOMPARE(parallel.state(i), serial.state(i));
+        QCOMPARE(parallel.latitude(i), serial.latitude(i));
+        QCOMPARE(parallel.longitude(i), serial.longitude(i));
+        QCOMPARE(parallel.altitude(i), serial.altitude(i));
+        QCOMPARE(parallel.speed(i), serial.speed(i));
+        QCOMPARE(parallel.heading(i), serial.heading(i));
+        QCOMPARE(parallel.battery(i), serial.battery(i));
+    }
+}
+
+void TestFleetSimulator::benchmarkParallelStep_data()
+{
+    QTest::addColumn<int>("threads");
+
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        QTest::addRow("%d threads", threads) << threads;
+    }
+}
+
+void TestFleetSimulator::benchmarkParallelStep()
+{
+    QFETCH(int, threads);
+
+    if (threads > QThread::idealThreadCount()) {
+        QSKIP("More threads than cores");
+    }
+
+    // Compare the per-tick time across rows; it should drop close to 1/threads
+    FleetSimulator fleet;
+    fleet.setThreadCount(threads);
+    fleet.addVehicles(200000, QGeoCoordinate(42.3314, -83.0458));
+    for (int i = 0; i < fleet.vehicleCount(); ++i) {
+        fleet.takeOff(i);
+    }
+
+    QBENCHMARK {
+        fleet.step();
+    }
+}
+
+void TestFleetSimulator::cleanup()
+{
+    delete m_fleet;
+    m_fleet = nullptr;
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestFleetSimulator)
+#include "TestFleetSimulator.moc"
@@ -0,0 +1,184 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QObject>
+#include "FleetStateStore.hpp"
+
+class TestFleetStateStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testAddVehicles();
+    void testBatchTransition();
+    void testBatchRejections();
+    void testTransitionWhere();
+    void testSilentTransition();
+    void benchmarkBroadcastLanding();
+    void cleanup();
+
+private:
+    FleetStateStore* m_store;
+
+    // Helper function to build a list of consecutive vehicle indices
+    static QVector<int> range(int first, int count);
+};
+
+QVector<int> TestFleetStateStore::range(int first, int count)
+{
+    QVector<int> indices;
+    for (int i = first; i < first + count; ++i) {
+        indices.append(i);
+    }
+    return indices;
+}
+
+void TestFleetStateStore::init()
+{
+    m_store = new FleetStateStore();
+    m_store->addVehicles(300);
+    m_store->addVehicles(200, 7);
+}
+
+void TestFleetStateStore::testAddVehicles()
+{
+    QSignalSpy countSpy(m_store, &FleetStateStore::vehicleCountChanged);
+
+    QCOMPARE(m_store->addVehicles(10, 2), 500);
+    QCOMPARE(m_store->vehicleCount(), 510);
+    QCOMPARE(countSpy.count(), 1);
+
+    // New vehicles are landed and keep their group
+    QCOMPARE(m_store->count(UASState::Landed), 510);
+    QCOMPARE(m_store->group(0), quint8(0));
+    QCOMPARE(m_store->group(300), quint8(7));
+    QCOMPARE(m_store->group(505), quint8(2));
+
+    m_store->setGroup(505, 9);
+    QCOMPARE(m_store->group(505), quint8(9));
+}
+
+void TestFleetStateStore::testBatchTransition()
+{
+    QSignalSpy changedSpy(m_store, &FleetStateStore::statesChanged);
+
+    // One signal for the whole batch, listing every changed vehicle
+    QCOMPARE(m_store->transition(range(0, 200), UASState::TakingOff), 200);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).value<QVector<int>>(), range(0, 200));
+    QCOMPARE(changedSpy.at(0).at(1).value<UASState::State>(), UASState::TakingOff);
+    QCOMPARE(m_store->count(UASState::TakingOff), 200);
+
+    // Per-request arguments are paired by position in the batch
+    QVector<int> positions;
+    const QVector<int> indices = {5, 999, 3};
+    QCOMPARE(m_store->transition(indices, UASState::Flying, [&positions](int position, int index) {
+        positions.append(position);
+        QCOMPARE(index, position == 0 ? 5 : 3);
+    }), 2);
+    QCOMPARE(positions, QVector<int>({0, 2}));
+
+    // Vehicles already in the state are accepted without a signal
+    changedSpy.clear();
+    QCOMPARE(m_store->transition({5, 3}, UASState::Flying), 2);
+    QCOMPARE(changedSpy.count(), 0);
+}
+
+void TestFleetStateStore::testBatchRejections()
+{
+    QSignalSpy changedSpy(m_store, &FleetStateStore::statesChanged);
+
+    // Landed vehicles cannot land; nothing changes, nothing is emitted
+    QCOMPARE(m_store->transition(range(0, 50), UASState::Landing), 0);
+    QCOMPARE(changedSpy.count(), 0);
+
+    // Each rejection is recorded with its reason instead of being logged
+    const TransitionAudit& audit = m_store->audit(10);
+    QCOMPARE(audit.count(), 1);
+    QCOMPARE(audit.last().from, UASState::Landed);
+    QCOMPARE(audit.last().to, UASState::Landing);
+    QCOMPARE(audit.last().result, UASState::RequiresFlying);
+
+    // A mixed batch applies the valid part only
+    m_store->transition(range(0, 10), UASState::TakingOff);
+    changedSpy.clear();
+    QCOMPARE(m_store->transition(range(0, 20), UASState::TakingOff), 10);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).value<QVector<int>>(), range(10, 10));
+    QCOMPARE(m_store->audit(0).last().result, UASState::RequiresLanded);
+
+    // Audit records carry the owner's time
+    m_store->setTimestamp(1234);
+    m_store->transition({42}, UASState::TakingOff);
+    QCOMPARE(m_store->audit(42).last().timestamp, qint64(1234));
+}
+
+void TestFleetStateStore::testTransitionWhere()
+{
+    // Vehicles 0-99 and 300-399 loiter, 100-149 fly
+    m_store->transition(range(0, 500), UASState::TakingOff);
+    m_store->transition(range(0, 500), UASState::Flying);
+    m_store->transition(range(0, 100) + range(300, 100), UASState::Loitering);
+    QCOMPARE(m_store->count(UASState::Loitering), 200);
+    QCOMPARE(m_store->count(UASState::Loitering, 7), 100);
+
+    QSignalSpy changedSpy(m_store, &FleetStateStore::statesChanged);
+
+    // Land all loitering vehicles of group 7
+    QVector<int> landed;
+    QCOMPARE(m_store->transitionWhere(UASState::Loitering, 7, UASState::Landing, [&landed](int index) {
+        landed.append(index);
+    }), 100);
+    QCOMPARE(landed, range(300, 100));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(m_store->count(UASState::Landing), 100);
+    QCOMPARE(m_store->count(UASState::Loitering), 100);
+
+    // Vehicles outside the selection are untouched and not recorded
+    const quint32 recorded = m_store->audit(150).totalRecorded();
+    QCOMPARE(m_store->transitionWhere(UASState::Loitering, FleetStateStore::ANY_GROUP, UASState::Landing), 100);
+    QCOMPARE(m_store->audit(150).totalRecorded(), recorded);
+    QCOMPARE(m_store->state(150), UASState::Flying);
+    QCOMPARE(changedSpy.count(), 2);
+}
+
+void TestFleetStateStore::testSilentTransition()
+{
+    QSignalSpy changedSpy(m_store, &FleetStateStore::statesChanged);
+
+    // Transitions made by a simulation are validated and recorded, not emitted
+    QCOMPARE(m_store->transition(0, UASState::TakingOff), UASState::Accepted);
+    QCOMPARE(m_store->transition(0, UASState::TakingOff), UASState::RequiresLanded);
+    QCOMPARE(m_store->state(0), UASState::TakingOff);
+    QCOMPARE(m_store->audit(0).totalRecorded(), quint32(2));
+    QCOMPARE(changedSpy.count(), 0);
+}
+
+void TestFleetStateStore::benchmarkBroadcastLanding()
+{
+    // Landing every loitering vehicle of one group in a fleet of 100,000
+    FleetStateStore store;
+    for (int group = 0; group < 10; ++group) {
+        store.addVehicles(10000, group);
+    }
+    const QVector<int> all = range(0, store.vehicleCount());
+    store.transition(all, UASState::TakingOff);
+
+    QBENCHMARK {
+        store.transition(all, UASState::Flying);
+        store.transition(all, UASState::Loitering);
+        store.transitionWhere(UASState::Loitering, 3, UASState::Landing);
+    }
+
+    QCOMPARE(store.count(UASState::Landing, 3), 10000);
+}
+
+void TestFleetStateStore::cleanup()
+{
+    delete m_store;
+    m_store = nullptr;
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestFleetStateStore)
+#include "TestFleetStateStore.moc"
@@ -0,0 +1,244 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QObject>
+#include "FlightRecorder.hpp"
+#include "FlightLogReader.hpp"
+#include "FleetSimulator.hpp"
+#include "FleetVehicle.hpp"
+#include "SimulationClock.hpp"
+
+class TestFlightRecorder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testRecordFleet();
+    void testSeekLongLog();
+    void testTruncatedLog();
+    void testTimeBases();
+    void cleanup();
+
+private:
+    QTemporaryDir* m_dir;
+
+    // Helper function returning a log path inside the temporary directory
+    QString logPath() const;
+};
+
+void TestFlightRecorder::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+QString TestFlightRecorder::logPath() const
+{
+    return m_dir->filePath(QStringLiteral("flight.gcslog"));
+}
+
+void TestFlightRecorder::testRecordFleet()
+{
+    FleetSimulator fleet;
+    SimulationClock clock(SimulationClock::Manual);
+    clock.setTickInterval(FleetSimulator::TICK_INTERVAL);
+    fleet.setClock(&clock);
+    fleet.addVehicles(3, QGeoCoordinate(42.3314, -83.0458));
+
+    FlightRecorder recorder;
+    QSignalSpy recordingSpy(&recorder, &FlightRecorder::recordingChanged);
+    QVERIFY(recorder.open(logPath()));
+    QVERIFY(recorder.isRecording());
+    for (int i = 0; i < fleet.vehicleCount(); ++i) {
+        recorder.attach(fleet.vehicle(i), static_cast<quint16>(i));
+    }
+
+    // Take off and fly long enough to finish the takeoff
+    fleet.vehicle(0)->takeOff();
+    clock.step(60);
+    const TelemetryFrame lastFrame = fleet.vehicle(0)->frame();
+
+    recorder.close();
+    QVERIFY(!recorder.isRecording());
+    QCOMPARE(recordingSpy.count(), 2);
+
+    FlightLogReader reader;
+    QVERIFY(reader.open(logPath()));
+    QVERIFY(reader.hasIndex());
+    QCOMPARE(quint64(reader.recordCount()), recorder.recordsWritten());
+
+    // Both transitions of vehicle 0 were recorded in order, nothing for the others
+    QVector<UASState::State> transitions;
+    FlightLog::Record lastTelemetry;
+    for (qint64 i = 0; i < reader.recordCount(); ++i) {
+        const FlightLog::Record record = reader.record(i);
+        if (i > 0) {
+            QVERIFY(reader.time(i) >= reader.time(i - 1));
+        }
+        if (record.type == FlightLog::StateChange) {
+            QCOMPARE(record.vehicleId, quint16(0));
+            transitions.append(record.state);
+        } else if (record.vehicleId == 0) {
+            lastTelemetry = record;
+        }
+    }
+    QCOMPARE(transitions, QVector<UASState::State>({UASState::TakingOff, UASState::Flying}));
+
+    // The last recorded frame matches what was published
+    QCOMPARE(lastTelemetry.state, UASState::Flying);
+    QCOMPARE(lastTelemetry.frame.timestamp, lastFrame.timestamp);
+    QCOMPARE(lastTelemetry.frame.altitude, lastFrame.altitude);
+    QCOMPARE(lastTelemetry.frame.battery, lastFrame.battery);
+    QVERIFY(lastTelemetry.frame.position().distanceTo(lastFrame.position()) < 0.1);
+
+    // Frames published while not recording are dropped
+    clock.step(4);
+    QVERIFY(reader.open(logPath()));
+    QCOMPARE(quint64(reader.recordCount()), recorder.recordsWritten());
+}
+
+void TestFlightRecorder::testSeekLongLog()
+{
+    // Ten hours of four vehicles at 1 Hz
+    const int vehicles = 4;
+    const qint64 duration = 10 * 3600;
+
+    FlightRecorder recorder;
+    QVERIFY(recorder.open(logPath()));
+    TelemetryFrame frame;
+    for (qint64 second = 0; second < duration; ++second) {
+        frame.timestamp = second * 1000;
+        frame.setAltitude(static_cast<int>(second % 1000));
+        for (int vehicle = 0; vehicle < vehicles; ++vehicle) {
+            recorder.recordFrame(static_cast<quint16>(vehicle), frame, UASState::Flying, second * 1000);
+        }
+    }
+    recorder.close();
+
+    FlightLogReader reader;
+    QVERIFY(reader.open(logPath()));
+    QVERIFY(reader.hasIndex());
+    QCOMPARE(reader.recordCount(), vehicles * duration);
+    QCOMPARE(reader.firstTime(), qint64(0));
+    QCOMPARE(reader.lastTime(), (duration - 1) * 1000);
+
+    // Seeking lands on the first record at or after the requested millisecond
+    const qint64 targets[] = {-5, 0, 1, 999, 1000, 1234567, 18000000, 35999000, 35999001};
+    QVector<qint64> indexed;
+    for (qint64 target : targets) {
+        const qint64 index = reader.seek(target);
+        if (index < reader.recordCount()) {
+            QVERIFY(reader.time(index) >= target);
+        }
+        if (index > 0) {
+            QVERIFY(reader.time(index - 1) < target);
+        }
+        indexed.append(index);
+    }
+    QCOMPARE(reader.seek(1000), qint64(vehicles));
+    QCOMPARE(reader.seek(duration * 1000), reader.recordCount());
+
+    const FlightLog::Record record = reader.record(reader.seek(1234567));
+    QCOMPARE(record.frame.timestamp, qint64(1235000));
+    QCOMPARE(record.frame.altitude, 235);
+    QCOMPARE(record.vehicleId, quint16(0));
+
+    // Without the index, seeks fall back to bisection with the same results
+    reader.close();
+    QVERIFY(QFile::remove(logPath() + QStringLiteral(".idx")));
+    QVERIFY(reader.open(logPath()));
+    QVERIFY(!reader.hasIndex());
+    int i = 0;
+    for (qint64 target : targets) {
+        QCOMPARE(reader.seek(target), indexed[i++]);
+    }
+}
+
+void TestFlightRecorder::testTruncatedLog()
+{
+    FlightRecorder recorder;
+    QVERIFY(recorder.open(logPath()));
+    TelemetryFrame frame;
+    for (int i = 0; i < 10; ++i) {
+        frame.timestamp = i * 100;
+        recorder.recordFrame(1, frame, UASState::Landed, i * 100);
+    }
+    recorder.close();
+
+    // A partial trailing record is ignored
+    QFile file(logPath());
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(QByteArray(FlightLog::RECORD_SIZE / 2, '\0'));
+    file.close();
+
+    FlightLogReader reader;
+    QVERIFY(reader.open(logPath()));
+    QCOMPARE(reader.recordCount(), qint64(10));
+    QCOMPARE(reader.lastTime(), qint64(900));
+    reader.close();
+
+    // A file that is not a flight log is rejected
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QByteArray(FlightLog::HEADER_SIZE, 'x'));
+    file.close();
+    QVERIFY(!reader.open(logPath()));
+    QVERIFY(!reader.isOpen());
+}
+
+void TestFlightRecorder::testTimeBases()
+{
+    // Vehicle 1 reports simulated time from 0, vehicle 2 milliseconds since epoch
+    const qint64 epoch = 1700000000000LL;
+    FlightRecorder recorder;
+    QVERIFY(recorder.open(logPath()));
+    TelemetryFrame frame;
+    for (int i = 0; i < 100; ++i) {
+        frame.timestamp = i * 100;
+        frame.setAltitude(i);
+        recorder.recordFrame(1, frame, UASState::Flying, i * 100);
+        frame.timestamp = epoch + i * 100 - 150;
+        recorder.recordFrame(2, frame, UASState::Flying, i * 100 + 50);
+    }
+
+    // A record given an earlier log time is stored at the previous one
+    frame.timestamp = epoch;
+    recorder.recordStateChange(2, frame, UASState::Landing, 5000);
+    recorder.close();
+
+    // Frames keep the timestamps of their sources, log times never decrease
+    FlightLogReader reader;
+    QVERIFY(reader.open(logPath()));
+    QCOMPARE(reader.recordCount(), qint64(201));
+    for (qint64 i = 1; i < reader.recordCount(); ++i) {
+        QVERIFY(reader.time(i) >= reader.time(i - 1));
+    }
+    QCOMPARE(reader.record(50).frame.timestamp, qint64(2500));
+    QCOMPARE(reader.record(51).frame.timestamp, epoch + 2350);
+    QCOMPARE(reader.record(51).frame.altitude, 25);
+    QCOMPARE(reader.record(51).time, qint64(2550));
+    QCOMPARE(reader.record(200).frame.timestamp, epoch);
+    QCOMPARE(reader.record(200).time, qint64(9950));
+
+    // Seeks land on the first record at or after the requested log time
+    for (qint64 target = -200; target < 10100; target += 37) {
+        const qint64 index = reader.seek(target);
+        if (index < reader.recordCount()) {
+            QVERIFY(reader.time(index) >= target);
+        }
+        if (index > 0) {
+            QVERIFY(reader.time(index - 1) < target);
+        }
+    }
+}
+
+void TestFlightRecorder::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestFlightRecorder)
+#include "TestFlightRecorder.moc"
@@ -0,0 +1,75 @@
+#include <QtTest/QTest>
+#include <QGeoCoordinate>
+#include <QObject>
+#include "GeoPoint.hpp"
+
+class TestGeoPoint : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testValidity();
+    void testCoordinateConversion();
+    void testMatchesQGeoCoordinate_data();
+    void testMatchesQGeoCoordinate();
+};
+
+void TestGeoPoint::testValidity()
+{
+    QVERIFY(!GeoPoint().isValid());
+    QVERIFY(GeoPoint(42.3314, -83.0458).isValid());
+    QVERIFY(GeoPoint(-90.0, 180.0).isValid());
+    QVERIFY(!GeoPoint(91.0, 0.0).isValid());
+    QVERIFY(!GeoPoint(0.0, -181.0).isValid());
+}
+
+void TestGeoPoint::testCoordinateConversion()
+{
+    // Without altitude the coordinate stays two-dimensional
+    const QGeoCoordinate flat = GeoPoint(42.3314, -83.0458).toCoordinate();
+    QCOMPARE(flat.type(), QGeoCoordinate::Coordinate2D);
+    QCOMPARE(flat.latitude(), 42.3314);
+    QCOMPARE(flat.longitude(), -83.0458);
+
+    const GeoPoint point = GeoPoint::fromCoordinate(QGeoCoordinate(42.3314, -83.0458, 120.0));
+    QCOMPARE(point.latitude, 42.3314);
+    QCOMPARE(point.longitude, -83.0458);
+    QCOMPARE(point.altitude, 120.0);
+    QCOMPARE(point.toCoordinate().type(), QGeoCoordinate::Coordinate3D);
+
+    QVERIFY(!GeoPoint::fromCoordinate(QGeoCoordinate()).isValid());
+}
+
+void TestGeoPoint::testMatchesQGeoCoordinate_data()
+{
+    QTest::addColumn<double>("lat1");
+    QTest::addColumn<double>("lon1");
+    QTest::addColumn<double>("lat2");
+    QTest::addColumn<double>("lon2");
+
+    QTest::newRow("short hop") << 42.3314 << -83.0458 << 42.3364 << -83.0408;
+    QTest::newRow("due west") << 42.3314 << -83.0458 << 42.3314 << -83.5458;
+    QTest::newRow("across the antimeridian") << 10.0 << 179.5 << 10.5 << -179.5;
+    QTest::newRow("southern hemisphere") << -33.8688 << 151.2093 << -37.8136 << 144.9631;
+    QTest::newRow("same point") << 42.3314 << -83.0458 << 42.3314 << -83.0458;
+}
+
+void TestGeoPoint::testMatchesQGeoCoordinate()
+{
+    QFETCH(double, lat1);
+    QFETCH(double, lon1);
+    QFETCH(double, lat2);
+    QFETCH(double, lon2);
+
+    const QGeoCoordinate from(lat1, lon1);
+    const QGeoCoordinate to(lat2, lon2);
+    const GeoPoint a(lat1, lon1);
+    const GeoPoint b(lat2, lon2);
+
+    QVERIFY(qAbs(a.distanceTo(b) - from.distanceTo(to)) < 1e-6);
+    QVERIFY(qAbs(a.azimuthTo(b) - from.azimuthTo(to)) < 1e-9);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestGeoPoint)
+#include "TestGeoPoint.moc"
@@ -0,0 +1,210 @@
+#include <QtTest/QTest>
+#include <QGeoCoordinate>
+#include <QRandomGenerator>
+#include <QObject>
+#include <QVector>
+#include "Geodesy.hpp"
+
+class TestGeodesy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testDistanceMatchesQGeoCoordinate();
+    void testBearingMatchesQGeoCoordinate();
+    void testDestinationMatchesQGeoCoordinate();
+    void testDestinationInPlace();
+    void testPartialBlocks();
+    void benchmarkDistanceQGeoCoordinate();
+    void benchmarkDistanceBatch();
+    void benchmarkBearingQGeoCoordinate();
+    void benchmarkBearingBatch();
+    void benchmarkDestinationQGeoCoordinate();
+    void benchmarkDestinationBatch();
+
+private:
+    static constexpr int COUNT = 10000;
+
+    // Helper function returning the smallest difference between two angles in degrees
+    static double angleDifference(double a, double b);
+
+    QVector<double> m_lat1;
+    QVector<double> m_lon1;
+    QVector<double> m_lat2;
+    QVector<double> m_lon2;
+    QVector<double> m_bearing;
+    QVector<double> m_meters;
+    QVector<QGeoCoordinate> m_from;
+    QVector<QGeoCoordinate> m_to;
+};
+
+double TestGeodesy::angleDifference(double a, double b)
+{
+    const double difference = qAbs(a - b);
+    return qMin(difference, 360.0 - difference);
+}
+
+void TestGeodesy::initTestCase()
+{
+    // A fixed seed keeps failures reproducible
+    QRandomGenerator random(42);
+
+    for (int i = 0; i < COUNT; ++i) {
+        m_lat1.append(random.bounded(170.0) - 85.0);
+        m_lon1.append(random.bounded(360.0) - 180.0);
+
+        // Half of the pairs are close together, like a vehicle and its waypoint
+        if (i % 2 == 0) {
+            m_lat2.append(qBound(-90.0, m_lat1.last() + random.bounded(0.2) - 0.1, 90.0));
+            m_lon2.append(m_lon1.last() + random.bounded(0.2) - 0.1);
+        } else {
+            m_lat2.append(random.bounded(170.0) - 85.0);
+            m_lon2.append(random.bounded(360.0) - 180.0);
+        }
+
+        m_bearing.append(random.bounded(360.0));
+        m_meters.append(random.bounded(100000.0));
+
+        m_from.append(QGeoCoordinate(m_lat1.last(), m_lon1.last()));
+        m_to.append(QGeoCoordinate(m_lat2.last(), m_lon2.last()));
+    }
+}
+
+void TestGeodesy::testDistanceMatchesQGeoCoordinate()
+{
+    QVector<double> meters(COUNT);
+    Geodesy::distance(m_lat1.constData(), m_lon1.constData(), m_lat2.constData(), m_lon2.constData(),
+                      meters.data(), COUNT);
+
+    for (int i = 0; i < COUNT; ++i) {
+        QVERIFY2(qAbs(meters[i] - m_from[i].distanceTo(m_to[i])) < Geodesy::DISTANCE_TOLERANCE,
+                 qPrintable(QString::number(i)));
+    }
+}
+
+void TestGeodesy::testBearingMatchesQGeoCoordinate()
+{
+    QVector<double> degrees(COUNT);
+    Geodesy::bearing(m_lat1.constData(), m_lon1.constData(), m_lat2.constData(), m_lon2.constData(),
+                     degrees.data(), COUNT);
+
+    for (int i = 0; i < COUNT; ++i) {
+        QVERIFY(degrees[i] >= 0.0 && degrees[i] < 360.0);
+        QVERIFY2(angleDifference(degrees[i], m_from[i].azimuthTo(m_to[i])) < Geodesy::ANGLE_TOLERANCE,
+                 qPrintable(QString::number(i)));
+    }
+}
+
+void TestGeodesy::testDestinationMatchesQGeoCoordinate()
+{
+    QVector<double> latitude(COUNT);
+    QVector<double> longitude(COUNT);
+    Geodesy::destination(m_lat1.constData(), m_lon1.constData(), m_bearing.constData(), m_meters.constData(),
+                         latitude.data(), longitude.data(), COUNT);
+
+    for (int i = 0; i < COUNT; ++i) {
+        const QGeoCoordinate expected = m_from[i].atDistanceAndAzimuth(m_meters[i], m_bearing[i]);
+        QVERIFY2(qAbs(latitude[i] - expected.latitude()) < Geodesy::ANGLE_TOLERANCE,
+                 qPrintable(QString::number(i)));
+        QVERIFY2(angleDifference(longitude[i], expected.longitude()) < Geodesy::ANGLE_TOLERANCE,
+                 qPrintable(QString::number(i)));
+        QVERIFY(longitude[i] >= -180.0 && longitude[i] <= 180.0);
+    }
+}
+
+void TestGeodesy::testDestinationInPlace()
+{
+    QVector<double> expectedLatitude(COUNT);
+    QVector<double> expectedLongitude(COUNT);
+    Geodesy::destination(m_lat1.constData(), m_lon1.constData(), m_bearing.constData(), m_meters.constData(),
+                         expectedLatitude.data(), expectedLongitude.data(), COUNT);
+
+    // Positions can be advanced in place, as a fleet step does
+    QVector<double> latitude = m_lat1;
+    QVector<double> longitude = m_lon1;
+    Geodesy::destination(latitude.constData(), longitude.constData(), m_bearing.constData(), m_meters.constData(),
+                         latitude.data(), longitude.data(), COUNT);
+
+    QCOMPARE(latitude, expectedLatitude);
+    QCOMPARE(longitude, expectedLongitude);
+}
+
+void TestGeodesy::testPartialBlocks()
+{
+    // Counts around the internal block size, including nothing at all
+    for (int count : {0, 1, 127, 128, 129, 300}) {
+        QVector<double> degrees(count + 1, -1.0);
+        Geodesy::bearing(m_lat1.constData(), m_lon1.constData(), m_lat2.constData(), m_lon2.constData(),
+                         degrees.data(), count);
+
+        for (int i = 0; i < count; ++i) {
+            QVERIFY(angleDifference(degrees[i], m_from[i].azimuthTo(m_to[i])) < Geodesy::ANGLE_TOLERANCE);
+        }
+
+        // Nothing is written past the end
+        QCOMPARE(degrees[count], -1.0);
+    }
+}
+
+void TestGeodesy::benchmarkDistanceQGeoCoordinate()
+{
+    QVector<double> meters(COUNT);
+    QBENCHMARK {
+        for (int i = 0; i < COUNT; ++i) {
+            meters[i] = m_from[i].distanceTo(m_to[i]);
+        }
+    }
+}
+
+void TestGeodesy::benchmarkDistanceBatch()
+{
+    QVector<double> meters(COUNT);
+    QBENCHMARK {
+        Geodesy::distance(m_lat1.constData(), m_lon1.constData(), m_lat2.constData(), m_lon2.constData(),
+                          meters.data(), COUNT);
+    }
+}
+
+void TestGeodesy::benchmarkBearingQGeoCoordinate()
+{
+    QVector<double> degrees(COUNT);
+    QBENCHMARK {
+        for (int i = 0; i < COUNT; ++i) {
+            degrees[i] = m_from[i].azimuthTo(m_to[i]);
+        }
+    }
+}
+
+void TestGeodesy::benchmarkBearingBatch()
+{
+    QVector<double> degrees(COUNT);
+    QBENCHMARK {
+        Geodesy::bearing(m_lat1.constData(), m_lon1.constData(), m_lat2.constData(), m_lon2.constData(),
+                         degrees.data(), COUNT);
+    }
+}
+
+void TestGeodesy::benchmarkDestinationQGeoCoordinate()
+{
+    QVector<QGeoCoordinate> reached(COUNT);
+    QBENCHMARK {
+        for (int i = 0; i < COUNT; ++i) {
+            reached[i] = m_from[i].atDistanceAndAzimuth(m_meters[i], m_bearing[i]);
+        }
+    }
+}
+
+void TestGeodesy::benchmarkDestinationBatch()
+{
+    QVector<double> latitude(COUNT);
+    QVector<double> longitude(COUNT);
+    QBENCHMARK {
+        Geodesy::destination(m_lat1.constData(), m_lon1.constData(), m_bearing.constData(), m_meters.constData(),
+                             latitude.data(), longitude.data(), COUNT);
+    }
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestGeodesy)
+#include "TestGeodesy.moc"
@@ -0,0 +1,308 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtMath>
+#include <vector>
+#include "Geofence.hpp"
+
+class TestGeofence : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParse();
+    void testParseErrors_data();
+    void testParseErrors();
+    void testLoad();
+    void testEmptyFence();
+    void testZoneTypes();
+    void testAgainstBruteForce();
+    void testPaths();
+    void benchmarkBreach();
+
+private:
+    // Helper function building a rectangular zone
+    static Geofence::Zone rectangle(Geofence::ZoneType type, double south, double west, double north, double east);
+
+    // Helper function building a star-shaped zone with random radii
+    static Geofence::Zone star(Geofence::ZoneType type, double latitude, double longitude, double radius,
+                               int vertices, QRandomGenerator& random);
+
+    // Helper function checking a position against every zone by ray casting
+    static int bruteForceBreach(const std::vector<Geofence::Zone>& zones, double latitude, double longitude);
+};
+
+Geofence::Zone TestGeofence::rectangle(Geofence::ZoneType type, double south, double west, double north, double east)
+{
+    Geofence::Zone zone;
+    zone.type = type;
+    zone.vertices = {GeoPoint(south, west), GeoPoint(south, east), GeoPoint(north, east), GeoPoint(north, west)};
+    return zone;
+}
+
+Geofence::Zone TestGeofence::star(Geofence::ZoneType type, double latitude, double longitude, double radius,
+                                  int vertices, QRandomGenerator& random)
+{
+    Geofence::Zone zone;
+    zone.type = type;
+    for (int i = 0; i < vertices; ++i) {
+        const double angle = 2.0 * M_PI * i / vertices;
+        const double r = radius * (0.5 + 0.5 * random.generateDouble());
+        zone.vertices.push_back(GeoPoint(latitude + r * qCos(angle), longitude + r * qSin(angle)));
+    }
+    return zone;
+}
+
+int TestGeofence::bruteForceBreach(const std::vector<Geofence::Zone>& zones, double latitude, double longitude)
+{
+    bool hasInclusion = false;
+    bool included = false;
+    for (size_t z = 0; z < zones.size(); ++z) {
+        const std::vector<GeoPoint>& v = zones[z].vertices;
+        bool inside = false;
+        for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+            if ((v[i].latitude > latitude) != (v[j].latitude > latitude)
+                && longitude < (v[j].longitude - v[i].longitude) * (latitude - v[i].latitude)
+                                   / (v[j].latitude - v[i].latitude) + v[i].longitude) {
+                inside = !inside;
+            }
+        }
+
+        if (zones[z].type == Geofence::Inclusion) {
+            hasInclusion = true;
+            included = included || inside;
+        } else if (inside) {
+            return static_cast<int>(z);
+        }
+    }
+    return included || !hasInclusion ? Geofence::NO_BREACH : Geofence::OUTSIDE_INCLUSION;
+}
+
+void TestGeofence::testParse()
+{
+    Geofence fence;
+    QVERIFY2(fence.parse(QStringLiteral("# Test fence\n"
+                                        "action land\n"
+                                        "\n"
+                                        "inclusion Operating area\n"
+                                        "42.0 -84.0\n"
+                                        "42.0 -82.0   # south-east\n"
+                                        "43.0 -82.0\n"
+                                        "43.0 -84.0\n"
+                                        "exclusion\n"
+                                        "  42.4 -83.2\n"
+                                        "42.4 -83.0\n"
+                                        "42.6 -83.1\n")),
+             qPrintable(fence.errorString()));
+
+    QCOMPARE(fence.breachAction(), Geofence::Land);
+    QCOMPARE(fence.zones().size(), size_t(2));
+    QCOMPARE(fence.zones()[0].name, QStringLiteral("Operating area"));
+    QCOMPARE(fence.zones()[0].type, Geofence::Inclusion);
+    QCOMPARE(fence.zones()[1].name, QString());
+    QCOMPARE(fence.zones()[1].type, Geofence::Exclusion);
+    QCOMPARE(fence.zones()[1].vertices.size(), size_t(3));
+    QCOMPARE(fence.zones()[1].vertices[2].latitude, 42.6);
+    QCOMPARE(fence.zones()[1].vertices[2].longitude, -83.1);
+    QCOMPARE(fence.edgeCount(), 7);
+    QVERIFY(fence.cellCount() > 0);
+    QVERIFY(fence.errorString().isEmpty());
+}
+
+void TestGeofence::testParseErrors_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("error");
+
+    QTest::newRow("empty") << QString() << QStringLiteral("missing zone statement");
+    QTest::newRow("bad action") << QStringLiteral("action hover\n") << QStringLiteral("line 1: expected action report|land");
+    QTest::newRow("unknown statement") << QStringLiteral("# fence\ncircle 42 -83\n")
+                                       << QStringLiteral("line 2: unknown statement \"circle\"");
+    QTest::newRow("vertex first") << QStringLiteral("42.0 -83.0\n") << QStringLiteral("line 1: vertex outside of a zone");
+    QTest::newRow("extra value") << QStringLiteral("exclusion\n42.0 -83.0 120\n") << QStringLiteral("line 2: invalid vertex");
+    QTest::newRow("out of range") << QStringLiteral("exclusion\n95.0 -83.0\n") << QStringLiteral("line 2: invalid vertex");
+    QTest::newRow("open zone") << QStringLiteral("exclusion a\n42 -83\n42 -82\nexclusion b\n")
+                               << QStringLiteral("line 1: zone needs at least three vertices");
+    QTest::newRow("last zone") << QStringLiteral("inclusion\n42 -83\n42 -82\n43 -82\nexclusion\n42 -83\n")
+                               << QStringLiteral("line 5: zone needs at least three vertices");
+}
+
+void TestGeofence::testParseErrors()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, error);
+
+    // A failed parse keeps the previous zones
+    Geofence fence;
+    QVERIFY(fence.parse(QStringLiteral("exclusion\n42 -83\n42 -82\n43 -82\n")));
+    QVERIFY(!fence.parse(text));
+    QCOMPARE(fence.errorString(), error);
+    QCOMPARE(fence.zones().size(), size_t(1));
+    QVERIFY(!fence.permits(42.2, -82.2));
+}
+
+void TestGeofence::testLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    Geofence fence;
+    QVERIFY(!fence.load(dir.filePath(QStringLiteral("missing.fence"))));
+    QVERIFY(fence.errorString().contains(QStringLiteral("missing.fence")));
+
+    QFile file(dir.filePath(QStringLiteral("test.fence")));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("inclusion\n42.3 -83.1\n42.3 -83.0\n42.4 -83.0\n42.4 -83.1\n");
+    file.close();
+
+    QVERIFY2(fence.load(file.fileName()), qPrintable(fence.errorString()));
+    QCOMPARE(fence.breachAction(), Geofence::Report);
+    QVERIFY(fence.permits(42.35, -83.05));
+    QCOMPARE(fence.breach(42.45, -83.05), Geofence::OUTSIDE_INCLUSION);
+}
+
+void TestGeofence::testEmptyFence()
+{
+    // Without zones every position and path is permitted
+    Geofence fence;
+    QCOMPARE(fence.cellCount(), 0);
+    QCOMPARE(fence.breach(42.3314, -83.0458), Geofence::NO_BREACH);
+    QVERIFY(fence.permitsPath(-45.0, -170.0, 45.0, 170.0));
+
+    // Degenerate zones are dropped
+    Geofence::Zone line;
+    line.vertices = {GeoPoint(42.0, -83.0), GeoPoint(43.0, -83.0)};
+    fence.setZones({line});
+    QVERIFY(fence.zones().empty());
+    QVERIFY(fence.permits(42.5, -83.0));
+}
+
+void TestGeofence::testZoneTypes()
+{
+    Geofence fence;
+    fence.setZones({rectangle(Geofence::Inclusion, 42.0, -84.0, 43.0, -83.0),
+                    rectangle(Geofence::Inclusion, 42.0, -83.0, 43.0, -82.0),
+                    rectangle(Geofence::Exclusion, 42.4, -83.6, 42.6, -83.4),
+                    rectangle(Geofence::Exclusion, 42.45, -83.55, 42.55, -83.45)});
+
+    // Inside either inclusion zone and outside every exclusion zone
+    QCOMPARE(fence.breach(42.2, -83.8), Geofence::NO_BREACH);
+    QCOMPARE(fence.breach(42.2, -82.2), Geofence::NO_BREACH);
+    QCOMPARE(fence.breach(42.5, -83.0), Geofence::NO_BREACH);
+
+    // Outside all inclusion zones
+    QCOMPARE(fence.breach(43.5, -83.5), Geofence::OUTSIDE_INCLUSION);
+    QCOMPARE(fence.breach(42.5, -81.0), Geofence::OUTSIDE_INCLUSION);
+    QCOMPARE(fence.breach(-42.5, 83.5), Geofence::OUTSIDE_INCLUSION);
+
+    // Exclusion zones win over inclusion zones; the first containing zone is reported
+    QCOMPARE(fence.breach(42.42, -83.5), 2);
+    QCOMPARE(fence.breach(42.5, -83.5), 2);
+    QVERIFY(!fence.permits(42.5, -83.5));
+
+    // The batch query matches the single one
+    const double latitude[] = {42.2, 43.5, 42.5};
+    const double longitude[] = {-83.8, -83.5, -83.5};
+    int zones[3] = {0, 0, 0};
+    fence.breach(latitude, longitude, zones, 3);
+    QCOMPARE(zones[0], Geofence::NO_BREACH);
+    QCOMPARE(zones[1], Geofence::OUTSIDE_INCLUSION);
+    QCOMPARE(zones[2], 2);
+}
+
+void TestGeofence::testAgainstBruteForce()
+{
+    // One inclusion zone with 99 exclusion zones of 100 edges each inside
+    QRandomGenerator random(17);
+    std::vector<Geofence::Zone> zones;
+    zones.push_back(star(Geofence::Inclusion, 42.4, -83.0, 0.09, 100, random));
+    for (int i = 1; i < 100; ++i) {
+        zones.push_back(star(Geofence::Exclusion, 42.3 + random.generateDouble() * 0.2,
+                             -83.1 + random.generateDouble() * 0.2, 0.005 + random.generateDouble() * 0.01, 100, random));
+    }
+
+    Geofence fence;
+    fence.setZones(zones);
+    QCOMPARE(fence.edgeCount(), 10000);
+    QVERIFY(fence.cellCount() <= Geofence::MAX_CELLS);
+
+    // Overlapping exclusion zones may report either one
+    auto check = [&](double latitude, double longitude) {
+        const int expected = bruteForceBreach(zones, latitude, longitude);
+        const int actual = fence.breach(latitude, longitude);
+        return actual == expected || (actual >= 0 && expected >= 0
+                                      && bruteForceBreach({zones[0], zones[actual]}, latitude, longitude) >= 0);
+    };
+
+    // Random positions, some outside the grid
+    for (int i = 0; i < 100000; ++i) {
+        const double latitude = 42.18 + random.generateDouble() * 0.44;
+        const double longitude = -83.22 + random.generateDouble() * 0.44;
+        QVERIFY2(check(latitude, longitude), qPrintable(QStringLiteral("%1, %2").arg(latitude).arg(longitude)));
+    }
+
+    // A lattice hitting cell borders and vertices exactly
+    for (int i = 0; i <= 200; ++i) {
+        for (int j = 0; j <= 200; ++j) {
+            const double latitude = 42.3 + i * 0.001;
+            const double longitude = -83.1 + j * 0.001;
+            QVERIFY2(check(latitude, longitude), qPrintable(QStringLiteral("%1, %2").arg(latitude).arg(longitude)));
+        }
+    }
+}
+
+void TestGeofence::testPaths()
+{
+    Geofence fence;
+    fence.setZones({rectangle(Geofence::Inclusion, 42.0, -84.0, 43.0, -82.0),
+                    rectangle(Geofence::Exclusion, 42.4, -83.1, 42.6, -82.9)});
+
+    // Around the exclusion zone and into it
+    QVERIFY(fence.permitsPath(42.2, -83.5, 42.2, -82.5));
+    QVERIFY(!fence.permitsPath(42.5, -83.5, 42.5, -82.5));
+    QVERIFY(!fence.permitsPath(42.5, -83.5, 42.5, -83.0));
+
+    // Leaving an exclusion zone is always allowed
+    QVERIFY(fence.permitsPath(42.5, -83.0, 42.5, -82.5));
+    QVERIFY(fence.permitsPath(42.5, -83.0, 42.9, -83.0));
+
+    // The destination must lie inside the operating area
+    QVERIFY(!fence.permitsPath(42.2, -83.5, 43.2, -83.5));
+
+    // Clipping a corner counts as entering
+    QVERIFY(!fence.permitsPath(42.35, -83.05, 42.45, -82.85));
+}
+
+void TestGeofence::benchmarkBreach()
+{
+    // One tick of 1,000 vehicles against a 10,000-edge fence
+    QRandomGenerator random(23);
+    std::vector<Geofence::Zone> zones;
+    zones.push_back(star(Geofence::Inclusion, 42.4, -83.0, 0.09, 100, random));
+    for (int i = 1; i < 100; ++i) {
+        zones.push_back(star(Geofence::Exclusion, 42.3 + random.generateDouble() * 0.2,
+                             -83.1 + random.generateDouble() * 0.2, 0.005 + random.generateDouble() * 0.01, 100, random));
+    }
+
+    Geofence fence;
+    fence.setZones(zones);
+
+    const int count = 1000;
+    std::vector<double> latitude(count);
+    std::vector<double> longitude(count);
+    std::vector<int> breaches(count);
+    for (int i = 0; i < count; ++i) {
+        latitude[i] = 42.3 + random.generateDouble() * 0.2;
+        longitude[i] = -83.1 + random.generateDouble() * 0.2;
+    }
+
+    QBENCHMARK {
+        fence.breach(latitude.data(), longitude.data(), breaches.data(), count);
+    }
+    QVERIFY(fence.edgeCount() == 10000);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestGeofence)
+#include "TestGeofence.moc"
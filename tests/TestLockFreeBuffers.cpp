@@ -0,0 +1,185 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QThread>
+#include "TripleBuffer.hpp"
+#include "SpscRing.hpp"
+
+class TestLockFreeBuffers : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testTripleBufferLatestValue();
+    void testTripleBufferConcurrent();
+    void testSpscRingOrder();
+    void testSpscRingFull();
+    void testSpscRingConcurrent();
+
+private:
+    // A value that is only consistent if it was never torn while copied
+    struct Sample
+    {
+        quint64 sequence = 0;
+        quint64 check = 0;
+        double payload[6] = {};
+    };
+};
+
+void TestLockFreeBuffers::testTripleBufferLatestValue()
+{
+    TripleBuffer<int> buffer;
+    int value = -1;
+
+    // Nothing was published yet
+    QVERIFY(!buffer.read(value));
+    QCOMPARE(value, -1);
+
+    // Only the newest of several writes is seen
+    buffer.write(1);
+    buffer.write(2);
+    buffer.write(3);
+    QVERIFY(buffer.read(value));
+    QCOMPARE(value, 3);
+
+    // A value is only delivered once
+    QVERIFY(!buffer.read(value));
+    QCOMPARE(buffer.readBuffer(), 3);
+
+    // Filling the write buffer in place
+    buffer.writeBuffer() = 4;
+    buffer.publish();
+    QVERIFY(buffer.update());
+    QCOMPARE(buffer.readBuffer(), 4);
+}
+
+void TestLockFreeBuffers::testTripleBufferConcurrent()
+{
+    constexpr quint64 COUNT = 50000;
+    TripleBuffer<Sample> buffer;
+
+    QThread* producer = QThread::create([&buffer]() {
+        for (quint64 i = 1; i <= COUNT; ++i) {
+            Sample& sample = buffer.writeBuffer();
+            sample.sequence = i;
+            for (double& value : sample.payload) {
+                value = static_cast<double>(i);
+            }
+            sample.check = ~i;
+            buffer.publish();
+        }
+    });
+    producer->start();
+
+    // Values arrive untorn and never go backwards; checked after joining the
+    // producer so a failure cannot leave it running
+    quint64 last = 0;
+    int reads = 0;
+    bool consistent = true;
+    while (consistent && last < COUNT) {
+        if (!buffer.update()) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        const Sample& sample = buffer.readBuffer();
+        consistent = sample.sequence > last && sample.check == ~sample.sequence;
+        for (double value : sample.payload) {
+            consistent = consistent && value == static_cast<double>(sample.sequence);
+        }
+        last = sample.sequence;
+        ++reads;
+    }
+
+    producer->wait();
+    delete producer;
+    QVERIFY(consistent);
+    QVERIFY(reads > 0);
+    QCOMPARE(last, COUNT);
+}
+
+void TestLockFreeBuffers::testSpscRingOrder()
+{
+    SpscRing<int, 8> ring;
+    int value = -1;
+
+    QVERIFY(ring.isEmpty());
+    QVERIFY(!ring.pop(value));
+
+    // Values come out in order, across the wrap-around of the slots
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 5; ++i) {
+            QVERIFY(ring.push(round * 10 + i));
+        }
+        for (int i = 0; i < 5; ++i) {
+            QVERIFY(ring.pop(value));
+            QCOMPARE(value, round * 10 + i);
+        }
+    }
+    QVERIFY(ring.isEmpty());
+}
+
+void TestLockFreeBuffers::testSpscRingFull()
+{
+    SpscRing<int, 4> ring;
+    QCOMPARE(ring.capacity(), 4);
+
+    for (int i = 0; i < ring.capacity(); ++i) {
+        QVERIFY(ring.push(i));
+    }
+
+    // A full ring rejects values instead of overwriting
+    QVERIFY(!ring.push(99));
+
+    int value = -1;
+    QVERIFY(ring.pop(value));
+    QCOMPARE(value, 0);
+    QVERIFY(ring.push(4));
+
+    for (int i = 1; i <= 4; ++i) {
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!ring.pop(value));
+}
+
+void TestLockFreeBuffers::testSpscRingConcurrent()
+{
+    constexpr quint64 COUNT = 50000;
+    SpscRing<Sample, 64> ring;
+
+    QThread* producer = QThread::create([&ring]() {
+        Sample sample;
+        for (quint64 i = 1; i <= COUNT; ++i) {
+            sample.sequence = i;
+            sample.check = ~i;
+            while (!ring.push(sample)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    });
+    producer->start();
+
+    // Every value arrives exactly once, in order
+    quint64 expected = 1;
+    quint64 mismatches = 0;
+    Sample sample;
+    while (expected <= COUNT) {
+        if (!ring.pop(sample)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        if (sample.sequence != expected || sample.check != ~expected) {
+            ++mismatches;
+        }
+        ++expected;
+    }
+
+    producer->wait();
+    delete producer;
+    QCOMPARE(mismatches, quint64(0));
+    QVERIFY(ring.isEmpty());
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestLockFreeBuffers)
+#include "TestLockFreeBuffers.moc"
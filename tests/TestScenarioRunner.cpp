@@ -0,0 +1,154 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QFile>
+#include "ScenarioRunner.hpp"
+#include "FleetSimulator.hpp"
+
+class TestScenarioRunner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParse();
+    void testParseErrors_data();
+    void testParseErrors();
+    void testLoad();
+    void testRun();
+    void testSummarize();
+};
+
+void TestScenarioRunner::testParse()
+{
+    ScenarioRunner runner;
+    QVERIFY2(runner.parse(QStringLiteral(
+        "# Two waves\n"
+        "fleet 100 42.3314 -83.0458 25\n"
+        "tick 100\n"
+        "\n"
+        "at 10 land 0-49   # out of order on purpose\n"
+        "at 0 takeoff all\n"
+        "at 5.5 goto 50 42.34 -83.04 150 ccw\n")), qPrintable(runner.errorString()));
+
+    QCOMPARE(runner.vehicleCount(), 100);
+    QCOMPARE(runner.tickInterval(), 100);
+    QCOMPARE(runner.actionCount(), 3);
+
+    // Without a duration statement the scenario ends 60 s after its last command
+    QCOMPARE(runner.duration(), qint64(70000));
+
+    QVERIFY(runner.parse(QStringLiteral("fleet 1 0 0\nduration 2.5\n")));
+    QCOMPARE(runner.duration(), qint64(2500));
+    QCOMPARE(runner.tickInterval(), FleetSimulator::TICK_INTERVAL);
+}
+
+void TestScenarioRunner::testParseErrors_data()
+{
+    QTest::addColumn<QString>("script");
+    QTest::addColumn<QString>("error");
+
+    QTest::newRow("no fleet") << "at 0 takeoff all" << "missing fleet statement";
+    QTest::newRow("unknown statement") << "fleet 10 0 0\nlaunch all" << "line 2: unknown statement";
+    QTest::newRow("bad count") << "fleet -5 0 0" << "line 1: invalid vehicle count";
+    QTest::newRow("bad origin") << "fleet 10 95 0" << "line 1: invalid origin";
+    QTest::newRow("bad selection") << "fleet 10 0 0\nat 0 takeoff 5-2" << "line 2: invalid vehicles";
+    QTest::newRow("out of range") << "fleet 10 0 0\n\nat 0 land 8-10" << "line 3: vehicle out of range";
+    QTest::newRow("unknown command") << "fleet 10 0 0\nat 0 hover all" << "line 2: invalid command";
+    QTest::newRow("goto without destination") << "fleet 10 0 0\nat 0 goto all 42" << "line 2: invalid command";
+    QTest::newRow("bad direction") << "fleet 10 0 0\nat 0 goto all 42 -83 100 left" << "line 2: expected cw or ccw";
+    QTest::newRow("negative time") << "fleet 10 0 0\nat -1 takeoff all" << "line 2: invalid time";
+    QTest::newRow("bad tick") << "fleet 10 0 0\ntick 0" << "line 2: expected tick";
+}
+
+void TestScenarioRunner::testParseErrors()
+{
+    QFETCH(QString, script);
+    QFETCH(QString, error);
+
+    ScenarioRunner runner;
+    QVERIFY(runner.parse(QStringLiteral("fleet 3 0 0")));
+
+    QVERIFY(!runner.parse(script));
+    QVERIFY2(runner.errorString().startsWith(error), qPrintable(runner.errorString()));
+
+    // A failed parse keeps the previous scenario
+    QCOMPARE(runner.vehicleCount(), 3);
+}
+
+void TestScenarioRunner::testLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = dir.filePath("scenario.txt");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("fleet 5 42.3314 -83.0458\nat 0 takeoff all\n");
+    file.close();
+
+    ScenarioRunner runner;
+    QVERIFY(runner.load(path));
+    QCOMPARE(runner.vehicleCount(), 5);
+    QCOMPARE(runner.actionCount(), 1);
+
+    QVERIFY(!runner.load(dir.filePath("missing.txt")));
+    QVERIFY(!runner.errorString().isEmpty());
+}
+
+void TestScenarioRunner::testRun()
+{
+    ScenarioRunner runner;
+    QVERIFY(runner.parse(QStringLiteral(
+        "fleet 20 42.3314 -83.0458\n"
+        "duration 60\n"
+        "at 0 takeoff all\n"
+        "at 20 land 0-9\n"
+        "at 30 land 0-9\n"       // already landed: rejected
+        "at 120 land all\n")));  // past the duration: never issued
+
+    FleetSimulator fleet;
+    fleet.setSeed(7);
+    const ScenarioRunner::Stats stats = runner.run(&fleet);
+
+    QCOMPARE(stats.vehicleCount, 20);
+    QCOMPARE(stats.ticks, quint64(60000 / FleetSimulator::TICK_INTERVAL));
+    QCOMPARE(stats.simulatedTime, qint64(60000));
+    QCOMPARE(fleet.simulatedTime(), qint64(60000));
+    QVERIFY(stats.wallTime > 0);
+
+    QCOMPARE(stats.commandBatches, 3);
+    QCOMPARE(stats.commandsRequested, qint64(40));
+    QCOMPARE(stats.commandsAccepted, qint64(30));
+
+    QCOMPARE(fleet.stateStore()->count(UASState::Landed), 10);
+    QCOMPARE(fleet.stateStore()->count(UASState::Flying), 10);
+
+    const ScenarioRunner::Latency& tick = stats.tickLatency;
+    QVERIFY(tick.min <= tick.median);
+    QVERIFY(tick.median <= tick.p99);
+    QVERIFY(tick.p99 <= tick.max);
+    QVERIFY(stats.realTimeFactor() > 0.0);
+    QVERIFY(stats.vehicleStepsPerSecond() > 0.0);
+}
+
+void TestScenarioRunner::testSummarize()
+{
+    std::vector<qint64> samples;
+    for (qint64 i = 100; i >= 1; --i) {
+        samples.push_back(i);
+    }
+
+    const ScenarioRunner::Latency latency = ScenarioRunner::summarize(samples);
+    QCOMPARE(latency.min, qint64(1));
+    QCOMPARE(latency.max, qint64(100));
+    QCOMPARE(latency.mean, qint64(50));
+    QCOMPARE(latency.median, qint64(51));
+    QCOMPARE(latency.p99, qint64(100));
+
+    std::vector<qint64> empty;
+    QCOMPARE(ScenarioRunner::summarize(empty).max, qint64(0));
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestScenarioRunner)
+#include "TestScenarioRunner.moc"
@@ -0,0 +1,285 @@
+#include <QtTest/QTest>
+#include <QCoreApplication>
+#include <QObject>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "SharedTelemetryExport.hpp"
+#include "SharedTelemetryReader.hpp"
+#include "TelemetryBus.hpp"
+
+#if GCS_SHARED_TELEMETRY
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+class TestSharedTelemetry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testTable();
+    void testRing();
+    void testErrors();
+    void testOwnership();
+    void testBus();
+    void benchmarkReadUnderWriter();
+
+private:
+    // Helper function returning a shared memory name unique to this process
+    static QString name();
+
+    // Helper function building frames of vehicles 100 to 100 + count - 1 whose fields all derive from the timestamp
+    static TelemetryBus::FrameBatch frames(qint64 timestamp, int count);
+
+    // Helper function checking that a snapshot was not torn between two writes
+    static bool isConsistent(const SharedTelemetry::Snapshot& snapshot);
+};
+
+void TestSharedTelemetry::init()
+{
+#if !GCS_SHARED_TELEMETRY
+    QSKIP("POSIX shared memory is not available on this platform");
+#endif
+}
+
+QString TestSharedTelemetry::name()
+{
+    return QStringLiteral("/gcs_test_%1").arg(QCoreApplication::applicationPid());
+}
+
+TelemetryBus::FrameBatch TestSharedTelemetry::frames(qint64 timestamp, int count)
+{
+    TelemetryBus::FrameBatch batch;
+    batch.timestamp = timestamp;
+    batch.frames.resize(count);
+    for (int i = 0; i < count; ++i) {
+        TelemetryBus::VehicleFrame& entry = batch.frames[i];
+        entry.vehicle = static_cast<quint32>(100 + i);
+        entry.frame.timestamp = timestamp;
+        entry.frame.setPosition(timestamp * 1e-3, -timestamp * 1e-3);
+        entry.frame.setAltitude(static_cast<int>(timestamp % 100000));
+        entry.frame.setSpeed(static_cast<int>(timestamp % 1000));
+        entry.frame.setBattery(static_cast<int>(timestamp % 100));
+    }
+    return batch;
+}
+
+bool TestSharedTelemetry::isConsistent(const SharedTelemetry::Snapshot& snapshot)
+{
+    const qint64 timestamp = snapshot.timestamp;
+    return snapshot.latitude == timestamp * 1e-3 && snapshot.longitude == -timestamp * 1e-3
+        && snapshot.altitude == timestamp % 100000 && snapshot.speed == timestamp % 1000
+        && snapshot.battery == timestamp % 100;
+}
+
+void TestSharedTelemetry::testTable()
+{
+    SharedTelemetryExport writer;
+    QVERIFY2(writer.open(name(), 4, 16), qPrintable(writer.errorString()));
+    SharedTelemetryReader reader;
+    QVERIFY2(reader.open(name().toStdString()), reader.errorString().c_str());
+    QCOMPARE(reader.writerPid(), quint32(QCoreApplication::applicationPid()));
+
+    // Nothing written yet
+    SharedTelemetry::Snapshot snapshot;
+    QCOMPARE(reader.vehicleCount(), 0u);
+    QVERIFY(!reader.vehicle(0, snapshot));
+
+    // Vehicles get slots in the order they are first written
+    writer.write(frames(250, 3));
+    QCOMPARE(reader.vehicleCount(), 3u);
+    QCOMPARE(reader.updateCount(), quint64(1));
+    QVERIFY(reader.vehicle(2, snapshot));
+    QCOMPARE(snapshot.vehicle, 102u);
+    QCOMPARE(snapshot.timestamp, qint64(250));
+    QCOMPARE(int(snapshot.state), int(UASState::Landed));
+    QVERIFY(isConsistent(snapshot));
+
+    // Transitions update the state and keep the telemetry
+    writer.write(std::vector<TelemetryBus::Transition>{{101, UASState::TakingOff, 300}});
+    QVERIFY(reader.vehicle(1, snapshot));
+    QCOMPARE(int(snapshot.state), int(UASState::TakingOff));
+    QCOMPARE(snapshot.timestamp, qint64(300));
+    QCOMPARE(snapshot.altitude, 250);
+
+    // Vehicles beyond the capacity are dropped
+    writer.write(frames(500, 6));
+    QCOMPARE(reader.vehicleCount(), 4u);
+    QCOMPARE(writer.droppedFrames(), quint64(2));
+    QVERIFY(reader.vehicle(1, snapshot));
+    QCOMPARE(int(snapshot.state), int(UASState::TakingOff));
+    QCOMPARE(snapshot.timestamp, qint64(500));
+}
+
+void TestSharedTelemetry::testRing()
+{
+    SharedTelemetryExport writer;
+    QVERIFY(writer.open(name(), 64, 16));
+    writer.write(frames(100, 5));
+
+    // A reader starts with the frames written after it opened
+    SharedTelemetryReader reader;
+    QVERIFY(reader.open(name().toStdString()));
+    SharedTelemetry::Snapshot received[64];
+    QCOMPARE(reader.readFrames(received, 64), size_t(0));
+
+    writer.write(frames(200, 5));
+    writer.write(frames(300, 5));
+    QCOMPARE(reader.frameCount(), quint64(15));
+    QCOMPARE(reader.readFrames(received, 4), size_t(4));
+    QCOMPARE(received[0].vehicle, 100u);
+    QCOMPARE(received[0].timestamp, qint64(200));
+    QCOMPARE(reader.readFrames(received, 64), size_t(6));
+    QCOMPARE(received[5].timestamp, qint64(300));
+    QCOMPARE(received[5].vehicle, 104u);
+
+    // A reader lapped by the writer continues with the oldest frame still in the ring
+    for (int tick = 4; tick <= 9; ++tick) {
+        writer.write(frames(tick * 100, 5));
+    }
+    QCOMPARE(reader.readFrames(received, 64), size_t(16));
+    QCOMPARE(reader.lostFrames(), quint64(14));
+    QCOMPARE(received[0].timestamp, qint64(600));
+    QCOMPARE(received[0].vehicle, 104u);
+    QCOMPARE(received[15].timestamp, qint64(900));
+}
+
+void TestSharedTelemetry::testErrors()
+{
+    SharedTelemetryReader reader;
+    QVERIFY(!reader.open(name().toStdString()));
+    QVERIFY(!reader.errorString().empty());
+
+    SharedTelemetryExport writer;
+    QVERIFY(!writer.open(name(), 16, 100));
+    QVERIFY(!writer.errorString().isEmpty());
+
+    // Closing the export removes the object
+    QVERIFY(writer.open(name(), 16, 64));
+    QVERIFY(reader.open(name().toStdString()));
+    writer.close();
+    reader.close();
+    QVERIFY(!reader.open(name().toStdString()));
+}
+
+void TestSharedTelemetry::testOwnership()
+{
+#if GCS_SHARED_TELEMETRY
+    // A second export of a name in use fails and leaves the first one intact
+    SharedTelemetryExport writer;
+    QVERIFY(writer.open(name(), 16, 64));
+    SharedTelemetryExport other;
+    QVERIFY(!other.open(name(), 16, 64));
+    QVERIFY(other.errorString().contains(QStringLiteral("already exported")));
+    writer.write(frames(250, 2));
+    SharedTelemetryReader reader;
+    QVERIFY(reader.open(name().toStdString()));
+    QCOMPARE(reader.vehicleCount(), 2u);
+    reader.close();
+    writer.close();
+
+    // An object left behind by a process that exited without closing is replaced
+    const pid_t child = ::fork();
+    if (child == 0) {
+        SharedTelemetryExport crashed;
+        ::_exit(crashed.open(name(), 16, 64) ? 0 : 1);
+    }
+    int status = 0;
+    QCOMPARE(::waitpid(child, &status, 0), child);
+    QVERIFY(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    QVERIFY(reader.open(name().toStdString()));
+    reader.close();
+    QVERIFY(writer.open(name(), 16, 64));
+    QVERIFY(reader.open(name().toStdString()));
+    QCOMPARE(reader.vehicleCount(), 0u);
+    reader.close();
+    writer.close();
+
+    // An object whose writer died before publishing the header is replaced,
+    // whether it is too small for the header or just lacks the magic
+    const QByteArray path = name().toLocal8Bit();
+    for (const off_t size : {off_t(0), static_cast<off_t>(SharedTelemetry::objectSize(16, 64))}) {
+        const int fd = ::shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        QVERIFY(fd >= 0);
+        QCOMPARE(::ftruncate(fd, size), 0);
+        ::close(fd);
+        QVERIFY(!reader.open(name().toStdString()));
+        QVERIFY2(writer.open(name(), 16, 64), qPrintable(writer.errorString()));
+        QVERIFY(reader.open(name().toStdString()));
+        QCOMPARE(reader.writerPid(), quint32(QCoreApplication::applicationPid()));
+        reader.close();
+        writer.close();
+    }
+#endif
+}
+
+void TestSharedTelemetry::testBus()
+{
+    TelemetryBus bus;
+    SharedTelemetryExport writer;
+    QVERIFY(writer.open(name(), 16, 64));
+    writer.attach(&bus);
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Frames));
+
+    SharedTelemetryReader reader;
+    QVERIFY(reader.open(name().toStdString()));
+    bus.publishFrames(std::make_shared<const TelemetryBus::FrameBatch>(frames(250, 2)));
+    bus.publishTransitions(std::make_shared<const std::vector<TelemetryBus::Transition>>(
+        1, TelemetryBus::Transition{100, UASState::TakingOff, 250}));
+    QCoreApplication::processEvents();
+
+    SharedTelemetry::Snapshot snapshot;
+    QCOMPARE(reader.vehicleCount(), 2u);
+    QVERIFY(reader.vehicle(0, snapshot));
+    QCOMPARE(snapshot.vehicle, 100u);
+    QCOMPARE(int(snapshot.state), int(UASState::TakingOff));
+    QVERIFY(isConsistent(snapshot));
+
+    writer.attach(nullptr);
+    QCOMPARE(bus.subscriberCount(), 0);
+}
+
+void TestSharedTelemetry::benchmarkReadUnderWriter()
+{
+    // A writer updating 100 vehicles at 1 kHz while the reader polls all of them
+    SharedTelemetryExport writer;
+    QVERIFY(writer.open(name(), 128, 4096));
+    writer.write(frames(0, 100));
+
+    std::atomic<bool> stop(false);
+    std::unique_ptr<QThread> thread(QThread::create([&writer, &stop]() {
+        auto next = std::chrono::steady_clock::now();
+        for (qint64 tick = 1; !stop.load(std::memory_order_relaxed); ++tick) {
+            writer.write(frames(tick, 100));
+            next += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(next);
+        }
+    }));
+    thread->start();
+
+    SharedTelemetryReader reader;
+    QVERIFY(reader.open(name().toStdString()));
+    SharedTelemetry::Snapshot snapshot;
+    int torn = 0;
+    QBENCHMARK {
+        for (quint32 slot = 0; slot < 100; ++slot) {
+            reader.vehicle(slot, snapshot);
+            torn += isConsistent(snapshot) ? 0 : 1;
+        }
+    }
+
+    stop = true;
+    thread->wait();
+    QCOMPARE(torn, 0);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestSharedTelemetry)
+#include "TestSharedTelemetry.moc"
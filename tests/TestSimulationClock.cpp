@@ -0,0 +1,137 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <climits>
+#include "SimulationClock.hpp"
+
+class TestSimulationClock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testManualStepping();
+    void testAdvanceRoundsUp();
+    void testTimeWarp();
+    void testUnbounded();
+    void testTinyTimeWarp();
+    void testStopPreservesTime();
+};
+
+void TestSimulationClock::testManualStepping()
+{
+    SimulationClock clock(SimulationClock::Manual);
+    QSignalSpy tickSpy(&clock, &SimulationClock::tick);
+
+    QCOMPARE(clock.mode(), SimulationClock::Manual);
+    QCOMPARE(clock.now(), qint64(0));
+
+    // A manual clock never ticks on its own
+    clock.start();
+    QVERIFY(!clock.isRunning());
+    QTest::qWait(50);
+    QCOMPARE(tickSpy.count(), 0);
+
+    // Each step emits one tick of the configured interval
+    clock.step(4);
+    QCOMPARE(tickSpy.count(), 4);
+    QCOMPARE(tickSpy.at(0).at(0).toInt(), 250);
+    QCOMPARE(clock.now(), qint64(1000));
+
+    clock.setTickInterval(100);
+    clock.step();
+    QCOMPARE(tickSpy.last().at(0).toInt(), 100);
+    QCOMPARE(clock.now(), qint64(1100));
+}
+
+void TestSimulationClock::testAdvanceRoundsUp()
+{
+    SimulationClock clock(SimulationClock::Manual);
+    QSignalSpy tickSpy(&clock, &SimulationClock::tick);
+
+    // Whole ticks only, rounded up to cover the requested span
+    clock.advance(1001);
+    QCOMPARE(tickSpy.count(), 5);
+    QCOMPARE(clock.now(), qint64(1250));
+
+    clock.advance(0);
+    QCOMPARE(tickSpy.count(), 5);
+}
+
+void TestSimulationClock::testTimeWarp()
+{
+    SimulationClock clock;
+    QSignalSpy warpSpy(&clock, &SimulationClock::timeWarpChanged);
+
+    clock.setTimeWarp(100.0);
+    QCOMPARE(warpSpy.count(), 1);
+    QCOMPARE(clock.timeWarp(), 100.0);
+
+    // 100x warp covers 10 s of simulated time in about 100 ms of wall time
+    QElapsedTimer wallClock;
+    wallClock.start();
+    clock.start();
+    QVERIFY(clock.isRunning());
+    QTRY_VERIFY_WITH_TIMEOUT(clock.now() >= 10000, 5000);
+    QVERIFY(wallClock.elapsed() < 5000);
+    clock.stop();
+}
+
+void TestSimulationClock::testUnbounded()
+{
+    SimulationClock clock;
+    clock.setTimeWarp(SimulationClock::Unbounded);
+
+    // An unbounded clock ticks as fast as the event loop allows
+    clock.start();
+    QTRY_VERIFY_WITH_TIMEOUT(clock.now() >= 250 * 1000, 5000);
+    clock.stop();
+}
+
+void TestSimulationClock::testTinyTimeWarp()
+{
+    SimulationClock clock;
+    clock.setTimeWarp(1e-9);
+    QCOMPARE(clock.timeWarp(), 1e-9);
+
+    // The timer interval saturates instead of overflowing, so the clock
+    // runs but does not tick within any practical wait
+    clock.start();
+    QVERIFY(clock.isRunning());
+    QTimer* timer = clock.findChild<QTimer*>();
+    QVERIFY(timer);
+    QCOMPARE(timer->interval(), INT_MAX);
+    QTest::qWait(50);
+    QCOMPARE(clock.now(), qint64(0));
+    clock.stop();
+}
+
+void TestSimulationClock::testStopPreservesTime()
+{
+    SimulationClock clock;
+    QSignalSpy runningSpy(&clock, &SimulationClock::runningChanged);
+    clock.setTimeWarp(50.0);
+
+    clock.start();
+    QTRY_VERIFY_WITH_TIMEOUT(clock.now() > 0, 5000);
+    clock.stop();
+    QCOMPARE(runningSpy.count(), 2);
+
+    // No ticks while stopped
+    const qint64 stoppedAt = clock.now();
+    QTest::qWait(50);
+    QCOMPARE(clock.now(), stoppedAt);
+
+    // Resuming continues from the stopped time without a burst of catch-up ticks
+    QSignalSpy tickSpy(&clock, &SimulationClock::tick);
+    clock.start();
+    QTest::qWait(10);
+    clock.stop();
+    QVERIFY(clock.now() >= stoppedAt);
+    QVERIFY(tickSpy.count() < 100);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestSimulationClock)
+#include "TestSimulationClock.moc"
@@ -0,0 +1,303 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "TelemetryBus.hpp"
+#include "TelemetrySubscriber.hpp"
+#include "FleetSimulator.hpp"
+
+class TestTelemetryBus : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSharedBatches();
+    void testLatestFrameOnly();
+    void testTransitionOrder();
+    void testRateLimit();
+    void testSlowSubscriber();
+    void testUnsubscribe();
+    void testFleet();
+    void benchmarkPublish();
+
+private:
+    // Helper function building a frame batch of vehicles 0 to count - 1
+    static TelemetryBus::FrameBatchPointer frames(qint64 timestamp, int count = 1);
+
+    // Helper function building a batch with one transition
+    static TelemetryBus::TransitionBatchPointer transition(quint32 vehicle, UASState::State state, qint64 timestamp);
+};
+
+TelemetryBus::FrameBatchPointer TestTelemetryBus::frames(qint64 timestamp, int count)
+{
+    auto batch = std::make_shared<TelemetryBus::FrameBatch>();
+    batch->timestamp = timestamp;
+    batch->frames.resize(count);
+    for (int i = 0; i < count; ++i) {
+        batch->frames[i].vehicle = static_cast<quint32>(i);
+        batch->frames[i].frame.timestamp = timestamp;
+        batch->frames[i].frame.setAltitude(i);
+    }
+    return batch;
+}
+
+TelemetryBus::TransitionBatchPointer TestTelemetryBus::transition(quint32 vehicle, UASState::State state, qint64 timestamp)
+{
+    return std::make_shared<const std::vector<TelemetryBus::Transition>>(1, TelemetryBus::Transition{vehicle, state, timestamp});
+}
+
+void TestTelemetryBus::testSharedBatches()
+{
+    TelemetryBus bus;
+    TelemetrySubscriber ui(TelemetryBus::Frames);
+    TelemetrySubscriber recorder(TelemetryBus::AllTopics);
+    TelemetrySubscriber alerts(TelemetryBus::Transitions);
+    bus.subscribe(&ui);
+    bus.subscribe(&recorder);
+    bus.subscribe(&alerts);
+    QCOMPARE(bus.subscriberCount(), 3);
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Frames));
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Transitions));
+
+    QSignalSpy uiSpy(&ui, &TelemetrySubscriber::framesReceived);
+    QSignalSpy recorderSpy(&recorder, &TelemetrySubscriber::framesReceived);
+    QSignalSpy alertsSpy(&alerts, &TelemetrySubscriber::framesReceived);
+
+    // Publishing never runs subscriber code on the producer's stack
+    const TelemetryBus::FrameBatchPointer batch = frames(250, 100);
+    bus.publishFrames(batch);
+    QCOMPARE(uiSpy.count(), 0);
+
+    // Every frame subscriber receives the very same batch, not a copy
+    QCoreApplication::processEvents();
+    QCOMPARE(uiSpy.count(), 1);
+    QCOMPARE(recorderSpy.count(), 1);
+    QCOMPARE(alertsSpy.count(), 0);
+    QCOMPARE(uiSpy.at(0).at(0).value<TelemetryBus::FrameBatchPointer>().get(), batch.get());
+    QCOMPARE(recorderSpy.at(0).at(0).value<TelemetryBus::FrameBatchPointer>().get(), batch.get());
+}
+
+void TestTelemetryBus::testLatestFrameOnly()
+{
+    TelemetryBus bus;
+    TelemetrySubscriber subscriber(TelemetryBus::Frames);
+    bus.subscribe(&subscriber);
+    QSignalSpy spy(&subscriber, &TelemetrySubscriber::framesReceived);
+
+    // Ten ticks before the subscriber gets to run: only the last one arrives
+    for (int tick = 1; tick <= 10; ++tick) {
+        bus.publishFrames(frames(tick * 250));
+    }
+    QCoreApplication::processEvents();
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<TelemetryBus::FrameBatchPointer>()->timestamp, qint64(2500));
+    QCOMPARE(subscriber.droppedFrames(), quint64(9));
+}
+
+void TestTelemetryBus::testTransitionOrder()
+{
+    TelemetryBus bus;
+    TelemetrySubscriber subscriber(TelemetryBus::Transitions);
+    bus.subscribe(&subscriber);
+    QSignalSpy spy(&subscriber, &TelemetrySubscriber::transitionsReceived);
+
+    // Transitions are all delivered, in order
+    bus.publishTransitions(transition(4, UASState::TakingOff, 100));
+    bus.publishTransitions(transition(4, UASState::Flying, 200));
+    bus.publishTransitions(transition(2, UASState::TakingOff, 300));
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(1).at(0).value<TelemetryBus::TransitionBatchPointer>()->at(0).state, UASState::Flying);
+    QCOMPARE(spy.at(2).at(0).value<TelemetryBus::TransitionBatchPointer>()->at(0).vehicle, quint32(2));
+
+    // Up to the mailbox limit; beyond it the oldest are dropped
+    spy.clear();
+    for (int i = 0; i < TelemetryBus::MAX_PENDING_TRANSITIONS + 10; ++i) {
+        bus.publishTransitions(transition(1, UASState::Flying, i));
+    }
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), TelemetryBus::MAX_PENDING_TRANSITIONS);
+    QCOMPARE(spy.at(0).at(0).value<TelemetryBus::TransitionBatchPointer>()->at(0).timestamp, qint64(10));
+    QCOMPARE(subscriber.droppedTransitions(), quint64(10));
+}
+
+void TestTelemetryBus::testRateLimit()
+{
+    TelemetryBus bus;
+    TelemetrySubscriber fast(TelemetryBus::Frames);
+    TelemetrySubscriber slow(TelemetryBus::Frames, 10.0);
+    QCOMPARE(slow.maxRate(), 10.0);
+    bus.subscribe(&fast);
+    bus.subscribe(&slow);
+    QSignalSpy fastSpy(&fast, &TelemetrySubscriber::framesReceived);
+    QSignalSpy slowSpy(&slow, &TelemetrySubscriber::framesReceived);
+
+    // Publishing at 100 Hz for half a second
+    QElapsedTimer timer;
+    timer.start();
+    for (int tick = 1; tick <= 50; ++tick) {
+        bus.publishFrames(frames(tick * 10));
+        QTest::qWait(10);
+    }
+    QTest::qWait(150);
+    const qint64 elapsed = timer.elapsed();
+
+    // The unlimited subscriber gets nearly every tick, the limited one at most 10 per second
+    QVERIFY(fastSpy.count() > 25);
+    QVERIFY(slowSpy.count() >= 3);
+    QVERIFY(slowSpy.count() <= elapsed / 100 + 1);
+
+    // Nothing is lost at the end: the last delivery carries the last tick
+    QCOMPARE(slowSpy.last().at(0).value<TelemetryBus::FrameBatchPointer>()->timestamp, qint64(500));
+    QCOMPARE(fastSpy.last().at(0).value<TelemetryBus::FrameBatchPointer>()->timestamp, qint64(500));
+}
+
+void TestTelemetryBus::testSlowSubscriber()
+{
+    TelemetryBus bus;
+
+    // A subscriber on its own thread taking 50ms per delivery
+    QThread thread;
+    auto* slow = new TelemetrySubscriber(TelemetryBus::Frames);
+    std::atomic<int> slowDeliveries(0);
+    std::atomic<qint64> slowLast(0);
+    connect(slow, &TelemetrySubscriber::framesReceived, slow,
+        [&slowDeliveries, &slowLast](const TelemetryBus::FrameBatchPointer& batch) {
+            QThread::msleep(50);
+            slowLast = batch->timestamp;
+            ++slowDeliveries;
+        });
+    bus.subscribe(slow);
+    slow->moveToThread(&thread);
+    thread.start();
+
+    TelemetrySubscriber fast(TelemetryBus::Frames);
+    bus.subscribe(&fast);
+    int fastDeliveries = 0;
+    connect(&fast, &TelemetrySubscriber::framesReceived, this, [&fastDeliveries]() { ++fastDeliveries; });
+
+    // The producer is not held up by the slow subscriber, nor is the fast one
+    QElapsedTimer timer;
+    timer.start();
+    for (int tick = 1; tick <= 200; ++tick) {
+        bus.publishFrames(frames(tick, 1000));
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(timer.elapsed() < 2000);
+    QCOMPARE(fastDeliveries, 200);
+
+    // The slow subscriber skipped ahead and still ends on the last tick
+    QTRY_COMPARE(slowLast.load(), qint64(200));
+    QVERIFY(slowDeliveries < 200);
+
+    QMetaObject::invokeMethod(slow, [slow]() { delete slow; }, Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+    QCOMPARE(bus.subscriberCount(), 1);
+}
+
+void TestTelemetryBus::testUnsubscribe()
+{
+    TelemetryBus bus;
+    auto* subscriber = new TelemetrySubscriber(TelemetryBus::AllTopics);
+    bus.subscribe(subscriber);
+    QCOMPARE(subscriber->bus(), &bus);
+
+    // A subscriber destroyed with a delivery pending is unsubscribed and never called
+    bus.publishFrames(frames(1));
+    bus.publishTransitions(transition(0, UASState::TakingOff, 1));
+    delete subscriber;
+    QCOMPARE(bus.subscriberCount(), 0);
+    QVERIFY(!bus.hasSubscribers(TelemetryBus::Frames));
+    QVERIFY(!bus.hasSubscribers(TelemetryBus::Transitions));
+    bus.publishFrames(frames(2));
+    QCoreApplication::processEvents();
+
+    // Subscribers outliving the bus are detached from it
+    TelemetrySubscriber survivor(TelemetryBus::Frames);
+    {
+        TelemetryBus shortLived;
+        shortLived.subscribe(&survivor);
+        shortLived.publishFrames(frames(3));
+    }
+    QVERIFY(!survivor.bus());
+    QSignalSpy spy(&survivor, &TelemetrySubscriber::framesReceived);
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 0);
+
+    // Explicit unsubscription discards what was waiting
+    bus.subscribe(&survivor);
+    bus.publishFrames(frames(4));
+    bus.unsubscribe(&survivor);
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestTelemetryBus::testFleet()
+{
+    FleetSimulator fleet;
+    fleet.addVehicles(3, QGeoCoordinate(42.3314, -83.0458));
+
+    TelemetryBus bus;
+    bus.attach(&fleet);
+    TelemetrySubscriber subscriber(TelemetryBus::AllTopics);
+    bus.subscribe(&subscriber);
+    QSignalSpy framesSpy(&subscriber, &TelemetrySubscriber::framesReceived);
+    QSignalSpy transitionsSpy(&subscriber, &TelemetrySubscriber::transitionsReceived);
+
+    // One batch per tick with every vehicle, plus the tick's transitions
+    QVERIFY(fleet.takeOff(1));
+    fleet.step();
+    QCoreApplication::processEvents();
+    QCOMPARE(framesSpy.count(), 1);
+    const TelemetryBus::FrameBatchPointer batch = framesSpy.at(0).at(0).value<TelemetryBus::FrameBatchPointer>();
+    QCOMPARE(batch->timestamp, fleet.simulatedTime());
+    QCOMPARE(int(batch->frames.size()), 3);
+    QCOMPARE(batch->frames[2].vehicle, quint32(2));
+    QCOMPARE(batch->frames[1].frame.latitude, fleet.latitude(1));
+    QCOMPARE(int(batch->frames[1].frame.battery), qRound(fleet.battery(1)));
+
+    QCOMPARE(transitionsSpy.count(), 1);
+    const TelemetryBus::TransitionBatchPointer transitions = transitionsSpy.at(0).at(0).value<TelemetryBus::TransitionBatchPointer>();
+    QCOMPARE(int(transitions->size()), 1);
+    QCOMPARE(transitions->at(0).vehicle, quint32(1));
+    QCOMPARE(transitions->at(0).state, UASState::TakingOff);
+
+    // A tick without state changes publishes no transitions
+    fleet.step();
+    QCoreApplication::processEvents();
+    QCOMPARE(framesSpy.count(), 2);
+    QCOMPARE(transitionsSpy.count(), 1);
+
+    // Detached fleets publish nothing
+    bus.detach(&fleet);
+    fleet.step();
+    QCoreApplication::processEvents();
+    QCOMPARE(framesSpy.count(), 2);
+}
+
+void TestTelemetryBus::benchmarkPublish()
+{
+    // One tick of a 10,000-vehicle fleet fanned out to 8 subscribers
+    TelemetryBus bus;
+    std::vector<std::unique_ptr<TelemetrySubscriber>> subscribers;
+    for (int i = 0; i < 8; ++i) {
+        subscribers.push_back(std::make_unique<TelemetrySubscriber>(TelemetryBus::Frames, 10.0));
+        bus.subscribe(subscribers.back().get());
+    }
+    const TelemetryBus::FrameBatchPointer batch = frames(0, 10000);
+
+    QBENCHMARK {
+        bus.publishFrames(batch);
+    }
+    QCOMPARE(batch.use_count(), long(1 + subscribers.size()));
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestTelemetryBus)
+#include "TestTelemetryBus.moc"
@@ -0,0 +1,156 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QObject>
+#include "TelemetryChartModel.hpp"
+#include "TelemetryHistory.hpp"
+
+class TestTelemetryChartModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testAppend();
+    void testRing();
+    void testReset();
+    void testData();
+
+private:
+    // Helper function appending one sample of a vehicle per 250 ms in [from, to), with the altitude in seconds
+    static void fill(TelemetryHistory& history, quint32 vehicle, qint64 from, qint64 to);
+};
+
+void TestTelemetryChartModel::fill(TelemetryHistory& history, quint32 vehicle, qint64 from, qint64 to)
+{
+    TelemetryBus::FrameBatch batch;
+    batch.frames.resize(1);
+    batch.frames[0].vehicle = vehicle;
+    for (qint64 timestamp = from; timestamp < to; timestamp += 250) {
+        batch.timestamp = timestamp;
+        batch.frames[0].frame.timestamp = timestamp;
+        batch.frames[0].frame.setAltitude(static_cast<int>(timestamp / 1000));
+        batch.frames[0].frame.setBattery(100 - static_cast<int>(timestamp / 1000));
+        history.append(batch);
+    }
+}
+
+void TestTelemetryChartModel::testAppend()
+{
+    TelemetryHistory history;
+    TelemetryChartModel model(&history);
+    model.setVehicle(3);
+    model.setCapacity(10);
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+
+    // The interval still filling is not appended
+    fill(history, 3, 0, 1000);
+    QCOMPARE(model.rowCount(), 0);
+
+    // Each completed interval is appended once, at the end
+    fill(history, 3, 1000, 1250);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.end(), qint64(1000));
+    fill(history, 3, 1250, 4250);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(insertedSpy.count(), 4);
+    for (int i = 0; i < insertedSpy.count(); ++i) {
+        QCOMPARE(insertedSpy.at(i).at(1).toInt(), i);
+        QCOMPARE(insertedSpy.at(i).at(2).toInt(), i);
+    }
+    QCOMPARE(model.row(3).timestamp, qint64(3000));
+    QCOMPARE(model.row(3).values[TelemetryHistory::Altitude], 3.0f);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(resetSpy.count(), 0);
+
+    // Other vehicles do not append rows
+    fill(history, 4, 4250, 8000);
+    QCOMPARE(model.rowCount(), 4);
+}
+
+void TestTelemetryChartModel::testRing()
+{
+    TelemetryHistory history;
+    TelemetryChartModel model(&history);
+    model.setCapacity(10);
+    fill(history, 0, 0, 8250);
+    QCOMPARE(model.rowCount(), 8);
+
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+
+    // Five intervals completed at once remove the three oldest rows in one range and append five
+    for (qint64 timestamp = 8250; timestamp <= 13000; timestamp += 250) {
+        TelemetryFrame frame;
+        frame.timestamp = timestamp;
+        history.append(0, frame);
+    }
+    model.refresh();
+    QCOMPARE(model.rowCount(), 10);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 0);
+    QCOMPARE(removedSpy.at(0).at(2).toInt(), 2);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 5);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 9);
+
+    // New rows take the positions of the removed ones
+    QCOMPARE(model.row(0).timestamp, qint64(3000));
+    QCOMPARE(model.row(9).timestamp, qint64(12000));
+    QCOMPARE(model.position(0), 3);
+    QCOMPARE(model.position(7), 0);
+    for (int row = 1; row < model.rowCount(); ++row) {
+        QVERIFY(model.row(row).timestamp > model.row(row - 1).timestamp);
+    }
+}
+
+void TestTelemetryChartModel::testReset()
+{
+    TelemetryHistory history;
+    TelemetryChartModel model(&history);
+    fill(history, 0, 0, 5250);
+    fill(history, 1, 0, 2250);
+    QCOMPARE(model.rowCount(), 5);
+
+    // Another vehicle reloads the model from the history
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    model.setVehicle(1);
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 2);
+
+    // So does a history that started over
+    fill(history, 1, 0, 1250);
+    QCOMPARE(resetSpy.count(), 2);
+    QCOMPARE(model.rowCount(), 1);
+
+    // A coarser resolution merges the intervals
+    model.setVehicle(0);
+    model.setResolution(2000);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.row(1).values[TelemetryHistory::Altitude], 2.5f);
+
+    model.setHistory(nullptr);
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void TestTelemetryChartModel::testData()
+{
+    TelemetryHistory history;
+    TelemetryChartModel model(&history);
+    fill(history, 0, 0, 2250);
+
+    const QHash<int, QByteArray> roles = model.roleNames();
+    QCOMPARE(roles.value(TelemetryChartModel::AltitudeRole), QByteArray("altitude"));
+    QCOMPARE(roles.value(TelemetryChartModel::BatteryRole), QByteArray("battery"));
+
+    const QModelIndex index = model.index(1);
+    QCOMPARE(model.data(index, TelemetryChartModel::TimestampRole).toLongLong(), qint64(1000));
+    QCOMPARE(model.data(index, TelemetryChartModel::AltitudeRole).toFloat(), 1.0f);
+    QCOMPARE(model.data(index, TelemetryChartModel::BatteryRole).toFloat(), 99.0f);
+    QVERIFY(!model.data(model.index(2), TelemetryChartModel::AltitudeRole).isValid());
+    QVERIFY(!model.data(index, Qt::DisplayRole).isValid());
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestTelemetryChartModel)
+#include "TestTelemetryChartModel.moc"
@@ -0,0 +1,211 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QGeoCoordinate>
+#include <QUdpSocket>
+#include <QObject>
+#include "TelemetryDataLink.hpp"
+#include "TelemetryLinkSender.hpp"
+#include "TelemetryProtocol.hpp"
+
+class TestTelemetryDataLink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testProtocolRoundTrip();
+    void testMalformedDatagrams();
+    void testLoopbackReplay();
+    void testIgnoresOtherVehicles();
+    void testStaleFramesDropped();
+    void cleanup();
+
+private:
+    TelemetryDataLink* m_link;
+    TelemetryLinkSender* m_sender;
+
+    // Helper function to send one datagram to the link
+    void sendDatagram(const QByteArray& datagram);
+};
+
+void TestTelemetryDataLink::init()
+{
+    m_link = new TelemetryDataLink(7);
+    QVERIFY(m_link->start(0, QHostAddress::LocalHost));
+    QVERIFY(m_link->localPort() != 0);
+
+    m_sender = new TelemetryLinkSender();
+    m_sender->setDestination(QHostAddress::LocalHost, m_link->localPort());
+}
+
+void TestTelemetryDataLink::sendDatagram(const QByteArray& datagram)
+{
+    QUdpSocket socket;
+    QCOMPARE(socket.writeDatagram(datagram, QHostAddress::LocalHost, m_link->localPort()), qint64(datagram.size()));
+}
+
+void TestTelemetryDataLink::testProtocolRoundTrip()
+{
+    TelemetryProtocol::WireFrame frames[2];
+    frames[0].vehicleId = 7;
+    frames[0].state = UASState::Loitering;
+    frames[0].battery = 63;
+    frames[0].sequence = 0xFFFFFFF0u;
+    frames[0].timestamp = 1700000000123LL;
+    frames[0].latitude = 42.3314;
+    frames[0].longitude = -83.0458;
+    frames[0].altitude = 120;
+    frames[0].speed = -3;
+    frames[1] = frames[0];
+    frames[1].vehicleId = 8;
+
+    char buffer[TelemetryProtocol::MAX_DATAGRAM_SIZE];
+    const int size = TelemetryProtocol::encodeDatagram(frames, 2, buffer, sizeof(buffer));
+    QCOMPARE(size, TelemetryProtocol::HEADER_SIZE + 2 * TelemetryProtocol::FRAME_SIZE);
+
+    QVector<TelemetryProtocol::WireFrame> decoded;
+    QCOMPARE(TelemetryProtocol::parseDatagram(buffer, size, [&](const TelemetryProtocol::WireFrame& frame) {
+        decoded.append(frame);
+    }), 2);
+
+    QCOMPARE(decoded.size(), 2);
+    QCOMPARE(decoded[0].vehicleId, quint16(7));
+    QCOMPARE(decoded[1].vehicleId, quint16(8));
+    QCOMPARE(decoded[0].state, UASState::Loitering);
+    QCOMPARE(decoded[0].battery, quint8(63));
+    QCOMPARE(decoded[0].sequence, 0xFFFFFFF0u);
+    QCOMPARE(decoded[0].timestamp, 1700000000123LL);
+    QVERIFY(qAbs(decoded[0].latitude - 42.3314) < 1e-7);
+    QVERIFY(qAbs(decoded[0].longitude + 83.0458) < 1e-7);
+    QCOMPARE(decoded[0].altitude, 120);
+    QCOMPARE(decoded[0].speed, qint16(-3));
+
+    // The byte order on the wire is fixed
+    QCOMPARE(QByteArray(buffer, 4), QByteArray("GCST"));
+
+    // Too small a buffer is reported instead of overrun
+    QCOMPARE(TelemetryProtocol::encodeDatagram(frames, 2, buffer, TelemetryProtocol::HEADER_SIZE), 0);
+}
+
+void TestTelemetryDataLink::testMalformedDatagrams()
+{
+    char buffer[TelemetryProtocol::MAX_DATAGRAM_SIZE];
+    TelemetryProtocol::WireFrame frame;
+    frame.vehicleId = 7;
+    const int size = TelemetryProtocol::encodeDatagram(&frame, 1, buffer, sizeof(buffer));
+
+    // Truncated, padded, and wrong magic or version
+    QCOMPARE(TelemetryProtocol::validateDatagram(buffer, size - 1), -1);
+    QCOMPARE(TelemetryProtocol::validateDatagram(buffer, size + 1), -1);
+    QCOMPARE(TelemetryProtocol::validateDatagram(buffer, 3), -1);
+    QByteArray badMagic(buffer, size);
+    badMagic[0] = 'X';
+    QCOMPARE(TelemetryProtocol::validateDatagram(badMagic.constData(), badMagic.size()), -1);
+    QByteArray badVersion(buffer, size);
+    badVersion[4] = char(TelemetryProtocol::VERSION + 1);
+    QCOMPARE(TelemetryProtocol::validateDatagram(badVersion.constData(), badVersion.size()), -1);
+
+    // The link counts them and publishes nothing
+    QSignalSpy frameSpy(m_link, &TelemetryData::frameChanged);
+    sendDatagram(badMagic);
+    sendDatagram(badVersion);
+    sendDatagram(QByteArray(TelemetryProtocol::MAX_DATAGRAM_SIZE + 100, 'x'));
+    QTRY_COMPARE(m_link->malformedDatagrams(), quint64(3));
+    QTest::qWait(3 * 1000 / m_link->publishRate());
+    QCOMPARE(frameSpy.count(), 0);
+    QCOMPARE(m_link->framesReceived(), quint64(0));
+}
+
+void TestTelemetryDataLink::testLoopbackReplay()
+{
+    const int frameCount = 4000;
+    QVector<TelemetryProtocol::WireFrame> frames =
+        TelemetryLinkSender::syntheticFlight(7, frameCount + 1, QGeoCoordinate(42.3314, -83.0458));
+    const TelemetryProtocol::WireFrame last = frames.takeLast();
+
+    QSignalSpy frameSpy(m_link, &TelemetryData::frameChanged);
+    QSignalSpy stateSpy(m_link, &TelemetryData::stateChanged);
+
+    m_sender->setFrames(frames);
+    m_sender->setRate(TelemetryLinkSender::MAX_RATE);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QVERIFY(m_sender->start());
+
+    // UDP may drop a few datagrams even over loopback, but not more than one in a hundred
+    QTRY_COMPARE(m_sender->framesSent(), quint64(frameCount));
+    QTRY_VERIFY(m_link->framesReceived() >= quint64(frameCount * 99 / 100));
+
+    // A closing frame sent after the stream is published intact
+    char buffer[TelemetryProtocol::MAX_DATAGRAM_SIZE];
+    const int size = TelemetryProtocol::encodeDatagram(&last, 1, buffer, sizeof(buffer));
+    sendDatagram(QByteArray(buffer, size));
+    const QGeoCoordinate lastPosition(last.latitude, last.longitude);
+    QTRY_COMPARE(m_link->frame().timestamp, last.timestamp);
+    QVERIFY(m_link->position().distanceTo(lastPosition) < 0.1);
+    QCOMPARE(m_link->altitude(), last.altitude);
+    QCOMPARE(m_link->battery(), int(last.battery));
+    QCOMPARE(m_link->speed(), int(last.speed));
+    QVERIFY(m_link->framesReceived() <= quint64(frameCount + 1));
+
+    // The GUI side sees a bounded number of frames, not one per datagram
+    const qint64 publishPeriod = 1000 / m_link->publishRate();
+    QVERIFY(frameSpy.count() >= 1);
+    QVERIFY(frameSpy.count() <= elapsed.elapsed() / publishPeriod + 2);
+
+    // The reported state is mirrored once
+    QCOMPARE(m_link->state(), UASState::Flying);
+    QCOMPARE(stateSpy.count(), 1);
+    QCOMPARE(m_link->staleFrames(), quint64(0));
+    QCOMPARE(m_link->malformedDatagrams(), quint64(0));
+}
+
+void TestTelemetryDataLink::testIgnoresOtherVehicles()
+{
+    // One datagram carrying two vehicles, the other one last
+    QVector<TelemetryProtocol::WireFrame> frames =
+        TelemetryLinkSender::syntheticFlight(7, 2, QGeoCoordinate(42.3314, -83.0458));
+    frames[1].vehicleId = 8;
+    frames[1].altitude = 999;
+
+    char buffer[TelemetryProtocol::MAX_DATAGRAM_SIZE];
+    const int size = TelemetryProtocol::encodeDatagram(frames.constData(), frames.size(), buffer, sizeof(buffer));
+    sendDatagram(QByteArray(buffer, size));
+
+    QTRY_COMPARE(m_link->framesReceived(), quint64(1));
+    QTRY_COMPARE(m_link->battery(), int(frames[0].battery));
+    QCOMPARE(m_link->altitude(), frames[0].altitude);
+}
+
+void TestTelemetryDataLink::testStaleFramesDropped()
+{
+    const QVector<TelemetryProtocol::WireFrame> frames =
+        TelemetryLinkSender::syntheticFlight(7, 20, QGeoCoordinate(42.3314, -83.0458));
+
+    // A reordered frame arriving after a newer one is dropped
+    char buffer[TelemetryProtocol::MAX_DATAGRAM_SIZE];
+    int size = TelemetryProtocol::encodeDatagram(&frames[19], 1, buffer, sizeof(buffer));
+    sendDatagram(QByteArray(buffer, size));
+    size = TelemetryProtocol::encodeDatagram(&frames[5], 1, buffer, sizeof(buffer));
+    sendDatagram(QByteArray(buffer, size));
+
+    QTRY_COMPARE(m_link->framesReceived(), quint64(2));
+    QCOMPARE(m_link->staleFrames(), quint64(1));
+    QTRY_COMPARE(m_link->frame().timestamp, frames[19].timestamp);
+    QTest::qWait(3 * 1000 / m_link->publishRate());
+    QCOMPARE(m_link->frame().timestamp, frames[19].timestamp);
+}
+
+void TestTelemetryDataLink::cleanup()
+{
+    delete m_sender;
+    m_sender = nullptr;
+    delete m_link;
+    m_link = nullptr;
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestTelemetryDataLink)
+#include "TestTelemetryDataLink.moc"
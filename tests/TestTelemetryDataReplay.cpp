@@ -0,0 +1,256 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QObject>
+#include "TelemetryDataReplay.hpp"
+#include "FlightRecorder.hpp"
+
+class TestTelemetryDataReplay : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void testOpen();
+    void testSeek();
+    void testSilentVehicle();
+    void testDecimatedPlayback();
+    void testPlaybackRateBounds();
+    void testPlayAndPause();
+    void testCommandsIgnored();
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir* m_dir;
+    QString m_logPath;
+    TelemetryDataReplay* m_replay;
+
+    // Helper function returning the altitude recorded for vehicle 1 at a time
+    static int recordedAltitude(qint64 time);
+};
+
+int TestTelemetryDataReplay::recordedAltitude(qint64 time)
+{
+    return static_cast<int>(time / 100);
+}
+
+void TestTelemetryDataReplay::initTestCase()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+    m_logPath = m_dir->filePath(QStringLiteral("replay.gcslog"));
+
+    // One minute of two vehicles at 10 Hz; vehicle 1 takes off at 5 s
+    FlightRecorder recorder;
+    QVERIFY(recorder.open(m_logPath));
+    TelemetryFrame frame;
+    for (qint64 time = 0; time < 60000; time += 100) {
+        frame.timestamp = time;
+        frame.setBattery(100 - static_cast<int>(time / 1000));
+        frame.setAltitude(recordedAltitude(time));
+        frame.setPosition(42.3314 + time * 1e-7, -83.0458);
+
+        const UASState::State state = time < 5000 ? UASState::Landed
+                                    : time < 10000 ? UASState::TakingOff
+                                    : UASState::Flying;
+        if (time == 5000 || time == 10000) {
+            recorder.recordStateChange(1, frame, state, time);
+        }
+        recorder.recordFrame(1, frame, state, time);
+
+        TelemetryFrame other = frame;
+        other.setAltitude(999);
+        recorder.recordFrame(2, other, UASState::Loitering, time);
+    }
+    recorder.close();
+}
+
+void TestTelemetryDataReplay::init()
+{
+    m_replay = new TelemetryDataReplay(1);
+}
+
+void TestTelemetryDataReplay::testOpen()
+{
+    QSignalSpy logSpy(m_replay, &TelemetryDataReplay::logChanged);
+
+    QVERIFY(!m_replay->open(m_dir->filePath(QStringLiteral("missing.gcslog"))));
+    QVERIFY(m_replay->open(m_logPath));
+    QCOMPARE(logSpy.count(), 1);
+    QCOMPARE(m_replay->startTime(), qint64(0));
+    QCOMPARE(m_replay->endTime(), qint64(59900));
+    QCOMPARE(m_replay->currentTime(), qint64(0));
+    QVERIFY(!m_replay->isPlaying());
+
+    // The first frame of the vehicle is shown right away
+    QCOMPARE(m_replay->battery(), 100);
+    QCOMPARE(m_replay->altitude(), 0);
+    QCOMPARE(m_replay->state(), UASState::Landed);
+}
+
+void TestTelemetryDataReplay::testSeek()
+{
+    QVERIFY(m_replay->open(m_logPath));
+    QSignalSpy timeSpy(m_replay, &TelemetryDataReplay::currentTimeChanged);
+
+    // Seeking shows the vehicle's last record at or before the requested time
+    m_replay->seek(30050);
+    QCOMPARE(m_replay->currentTime(), qint64(30050));
+    QCOMPARE(m_replay->altitude(), recordedAltitude(30000));
+    QCOMPARE(m_replay->battery(), 70);
+    QCOMPARE(m_replay->state(), UASState::Flying);
+    QCOMPARE(timeSpy.count(), 1);
+
+    // Backwards, including the state
+    m_replay->seek(7000);
+    QCOMPARE(m_replay->altitude(), recordedAltitude(7000));
+    QCOMPARE(m_replay->state(), UASState::TakingOff);
+
+    // Out of range seeks are bounded to the log
+    m_replay->seek(-100);
+    QCOMPARE(m_replay->currentTime(), m_replay->startTime());
+    QCOMPARE(m_replay->state(), UASState::Landed);
+    m_replay->seek(1000000);
+    QCOMPARE(m_replay->currentTime(), m_replay->endTime());
+    QCOMPARE(m_replay->altitude(), recordedAltitude(59900));
+}
+
+void TestTelemetryDataReplay::testSilentVehicle()
+{
+    // Vehicle 5 only reports at 20 s and 40 s while vehicle 1 reports at 10 Hz
+    const QString path = m_dir->filePath(QStringLiteral("silent.gcslog"));
+    FlightRecorder recorder;
+    QVERIFY(recorder.open(path));
+    TelemetryFrame frame;
+    for (qint64 time = 0; time < 60000; time += 100) {
+        frame.timestamp = time;
+        frame.setAltitude(recordedAltitude(time));
+        recorder.recordFrame(1, frame, UASState::Flying, time);
+        if (time == 20000 || time == 40000) {
+            recorder.recordFrame(5, frame, UASState::Loitering, time);
+        }
+    }
+    recorder.close();
+
+    // Before its first record the vehicle has no data
+    TelemetryDataReplay replay(5);
+    QVERIFY(replay.open(path));
+    QCOMPARE(replay.altitude(), 0);
+    QCOMPARE(replay.state(), UASState::Landed);
+
+    // However long ago, the last record at or before the playhead is shown
+    replay.seek(59900);
+    QCOMPARE(replay.altitude(), recordedAltitude(40000));
+    QCOMPARE(replay.state(), UASState::Loitering);
+    replay.seek(39900);
+    QCOMPARE(replay.altitude(), recordedAltitude(20000));
+
+    // Scrubbing back before the first record shows no data again, not a later frame
+    replay.seek(19900);
+    QCOMPARE(replay.altitude(), 0);
+    QCOMPARE(replay.state(), UASState::Landed);
+}
+
+void TestTelemetryDataReplay::testDecimatedPlayback()
+{
+    QVERIFY(m_replay->open(m_logPath));
+    m_replay->setPlaybackRate(100.0);
+
+    QSignalSpy frameSpy(m_replay, &TelemetryData::frameChanged);
+    QSignalSpy stateSpy(m_replay, &TelemetryData::stateChanged);
+
+    // Each display tick skips 33 recorded frames but publishes only one
+    m_replay->advance(TelemetryDataReplay::DISPLAY_INTERVAL);
+    QCOMPARE(m_replay->currentTime(), qint64(3300));
+    QCOMPARE(frameSpy.count(), 1);
+    QCOMPARE(m_replay->altitude(), recordedAltitude(3300));
+
+    // Both transitions fall into one tick; only the resulting state is shown
+    m_replay->advance(TelemetryDataReplay::DISPLAY_INTERVAL * 3);
+    QCOMPARE(m_replay->currentTime(), qint64(13200));
+    QCOMPARE(frameSpy.count(), 2);
+    QCOMPARE(stateSpy.count(), 1);
+    QCOMPARE(m_replay->state(), UASState::Flying);
+
+    // Playback stops at the end of the log
+    QSignalSpy playingSpy(m_replay, &TelemetryDataReplay::playingChanged);
+    m_replay->play();
+    QCOMPARE(playingSpy.count(), 1);
+    m_replay->advance(60000);
+    QCOMPARE(m_replay->currentTime(), m_replay->endTime());
+    QCOMPARE(frameSpy.count(), 3);
+    QVERIFY(!m_replay->isPlaying());
+    QCOMPARE(playingSpy.count(), 2);
+
+    // Vehicle 2 was never shown
+    QCOMPARE(m_replay->altitude(), recordedAltitude(59900));
+}
+
+void TestTelemetryDataReplay::testPlaybackRateBounds()
+{
+    QSignalSpy rateSpy(m_replay, &TelemetryDataReplay::playbackRateChanged);
+
+    m_replay->setPlaybackRate(10.0);
+    QCOMPARE(m_replay->playbackRate(), 10.0);
+    m_replay->setPlaybackRate(1000.0);
+    QCOMPARE(m_replay->playbackRate(), TelemetryDataReplay::MAX_PLAYBACK_RATE);
+    m_replay->setPlaybackRate(0.1);
+    QCOMPARE(m_replay->playbackRate(), TelemetryDataReplay::MIN_PLAYBACK_RATE);
+    QCOMPARE(rateSpy.count(), 3);
+}
+
+void TestTelemetryDataReplay::testPlayAndPause()
+{
+    // Nothing to play without a log
+    m_replay->play();
+    QVERIFY(!m_replay->isPlaying());
+
+    QVERIFY(m_replay->open(m_logPath));
+    m_replay->setPlaybackRate(100.0);
+    m_replay->play();
+    QVERIFY(m_replay->isPlaying());
+    QTRY_VERIFY(m_replay->currentTime() >= 10000);
+    QCOMPARE(m_replay->state(), UASState::Flying);
+
+    m_replay->pause();
+    QVERIFY(!m_replay->isPlaying());
+    const qint64 pausedAt = m_replay->currentTime();
+    QTest::qWait(TelemetryDataReplay::DISPLAY_INTERVAL * 3);
+    QCOMPARE(m_replay->currentTime(), pausedAt);
+
+    // Playing at the end of the log starts over
+    m_replay->seek(m_replay->endTime());
+    m_replay->play();
+    QVERIFY(m_replay->currentTime() < 1000);
+    m_replay->pause();
+}
+
+void TestTelemetryDataReplay::testCommandsIgnored()
+{
+    QVERIFY(m_replay->open(m_logPath));
+    QSignalSpy stateSpy(m_replay, &TelemetryData::stateChanged);
+
+    m_replay->takeOff();
+    m_replay->goTo(QGeoCoordinate(42.0, -83.0), 100, true);
+    m_replay->land();
+    QCOMPARE(m_replay->state(), UASState::Landed);
+    QCOMPARE(stateSpy.count(), 0);
+}
+
+void TestTelemetryDataReplay::cleanup()
+{
+    delete m_replay;
+    m_replay = nullptr;
+}
+
+void TestTelemetryDataReplay::cleanupTestCase()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestTelemetryDataReplay)
+#include "TestTelemetryDataReplay.moc"
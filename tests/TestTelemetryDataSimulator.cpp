@@ -5,6 +5,9 @@
 #include <QVariant>
 #include <QDebug>
 #include "TelemetryDataSimulator.hpp"
+#include "SimulationThread.hpp"
+#include <QThread>
+#include <cmath>
 
 class TestTelemetryDataSimulator : public QObject
 {
@@ -14,6 +17,12 @@ private slots:
     void initTestCase();
     void testGoTo();
     void testInvalidStateTransitions();
+    void testScenarioWithManualClock();
+    void testFramePublishedOncePerTick();
+    void testSimulationThread();
+    void testFixedStepIndependentOfTickInterval();
+    void testCommandsReplaceActivePhase();
+    void testEnduranceEstimates();
     void cleanupTestCase();
 
 private:
@@ -110,6 +119,238 @@ void TestTelemetryDataSimulator::testInvalidStateTransitions()
     QCOMPARE(m_stateMachine->currentState(), UASState::Landed);
 }
 
+void TestTelemetryDataSimulator::testScenarioWithManualClock()
+{
+    // Drive a separate simulator deterministically, without waiting in real time
+    UASStateMachine stateMachine;
+    SimulationClock clock(SimulationClock::Manual);
+    TelemetryDataSimulator simulator(&stateMachine);
+    simulator.setClock(&clock);
+    QCOMPARE(simulator.clock(), &clock);
+
+    QSignalSpy positionSpy(&simulator, &TelemetryDataSimulator::positionChanged);
+
+    // Takeoff completes after the takeoff duration of simulated time
+    simulator.takeOff();
+    QCOMPARE(stateMachine.currentState(), UASState::TakingOff);
+    clock.advance(6000);
+    QCOMPARE(stateMachine.currentState(), UASState::TakingOff);
+    clock.advance(1000);
+    QCOMPARE(stateMachine.currentState(), UASState::Flying);
+    QCOMPARE(clock.now(), qint64(7000));
+    QCOMPARE(positionSpy.count(), 28);
+
+    // Fly to a waypoint and start loitering once it is reached
+    QGeoCoordinate destination(
+        simulator.position().latitude() + 0.005,
+        simulator.position().longitude() + 0.005
+    );
+    simulator.goTo(destination, 100, true);
+    QCOMPARE(stateMachine.currentState(), UASState::FlyingToWaypoint);
+
+    int ticks = 0;
+    while (stateMachine.currentState() == UASState::FlyingToWaypoint && ticks < 1000) {
+        clock.step();
+        ++ticks;
+    }
+    QCOMPARE(stateMachine.currentState(), UASState::Loitering);
+
+    // Loiter for a while, then land
+    clock.advance(10000);
+    QCOMPARE(stateMachine.currentState(), UASState::Loitering);
+
+    simulator.land();
+    QCOMPARE(stateMachine.currentState(), UASState::Landing);
+    clock.advance(7000);
+    QCOMPARE(stateMachine.currentState(), UASState::Landed);
+    QCOMPARE(simulator.altitude(), 0);
+    QCOMPARE(simulator.speed(), 0);
+
+    // No flight phase keeps running after landing
+    positionSpy.clear();
+    clock.advance(5000);
+    QCOMPARE(positionSpy.count(), 0);
+}
+
+void TestTelemetryDataSimulator::testFramePublishedOncePerTick()
+{
+    UASStateMachine stateMachine;
+    SimulationClock clock(SimulationClock::Manual);
+    TelemetryDataSimulator simulator(&stateMachine);
+    simulator.setClock(&clock);
+
+    // Get airborne, then fly to a waypoint so several phases update the position each tick
+    simulator.takeOff();
+    clock.advance(7000);
+    QCOMPARE(stateMachine.currentState(), UASState::Flying);
+    clock.step();
+
+    QGeoCoordinate destination(
+        simulator.position().latitude() + 0.05,
+        simulator.position().longitude() + 0.05
+    );
+    simulator.goTo(destination, 100, true);
+
+    QSignalSpy frameSpy(&simulator, &TelemetryData::frameChanged);
+    QSignalSpy positionSpy(&simulator, &TelemetryData::positionChanged);
+    QSignalSpy speedSpy(&simulator, &TelemetryData::speedChanged);
+
+    // Exactly one frame and at most one signal per property per tick
+    for (int tick = 1; tick <= 10; ++tick) {
+        clock.step();
+        QCOMPARE(frameSpy.count(), tick);
+        QCOMPARE(positionSpy.count(), tick);
+        QVERIFY(speedSpy.count() <= tick);
+    }
+
+    // The published frame matches the properties and flags what changed
+    const TelemetryFrame& frame = simulator.frame();
+    QVERIFY(frame.isDirty(TelemetryFrame::Position));
+    QCOMPARE(frame.position(), simulator.position());
+    QCOMPARE(int(frame.altitude), simulator.altitude());
+    QCOMPARE(int(frame.speed), simulator.speed());
+    QCOMPARE(int(frame.battery), simulator.battery());
+    QCOMPARE(frame.timestamp, clock.now());
+
+    const TelemetryFrame signalled = frameSpy.last().at(0).value<TelemetryFrame>();
+    QCOMPARE(signalled.dirty, frame.dirty);
+
+    // Nothing is published while nothing changes
+    simulator.land();
+    clock.advance(7000);
+    QCOMPARE(stateMachine.currentState(), UASState::Landed);
+    frameSpy.clear();
+    clock.advance(2000);
+    QCOMPARE(frameSpy.count(), 0);
+}
+
+void TestTelemetryDataSimulator::testSimulationThread()
+{
+    UASStateMachine stateMachine;
+    SimulationThread simulationThread;
+    simulationThread.setTimeWarp(SimulationClock::Unbounded);
+    TelemetryDataSimulator simulator(&stateMachine);
+    simulator.setClock(simulationThread.clock());
+
+    // Telemetry is always published on the simulator's thread
+    QThread* publishThread = nullptr;
+    connect(&simulator, &TelemetryData::frameChanged, this, [&publishThread]() {
+        publishThread = QThread::currentThread();
+    }, Qt::DirectConnection);
+
+    simulationThread.start();
+    QVERIFY(simulationThread.isRunning());
+
+    // Commands are validated immediately and carried out on the worker thread
+    simulator.takeOff();
+    QCOMPARE(stateMachine.currentState(), UASState::TakingOff);
+    QTRY_COMPARE_WITH_TIMEOUT(stateMachine.currentState(), UASState::Flying, 5000);
+    QVERIFY(simulator.altitude() > 0);
+    QCOMPARE(publishThread, QThread::currentThread());
+
+    // Landing completes on the worker thread as well
+    simulator.land();
+    QCOMPARE(stateMachine.currentState(), UASState::Landing);
+    QTRY_COMPARE_WITH_TIMEOUT(stateMachine.currentState(), UASState::Landed, 5000);
+    QTRY_COMPARE_WITH_TIMEOUT(simulator.altitude(), 0, 5000);
+
+    simulationThread.stop();
+    QVERIFY(!simulationThread.isRunning());
+}
+
+void TestTelemetryDataSimulator::testFixedStepIndependentOfTickInterval()
+{
+    UASStateMachine stateMachine;
+    SimulationClock clock(SimulationClock::Manual);
+    clock.setTickInterval(50);
+    TelemetryDataSimulator simulator(&stateMachine);
+    simulator.setClock(&clock);
+
+    QSignalSpy positionSpy(&simulator, &TelemetryDataSimulator::positionChanged);
+
+    // Five ticks make one step; the takeoff takes as many steps as with the default clock
+    simulator.takeOff();
+    clock.advance(6950);
+    QCOMPARE(stateMachine.currentState(), UASState::TakingOff);
+    clock.step();
+    QCOMPARE(stateMachine.currentState(), UASState::Flying);
+    QCOMPARE(positionSpy.count(), 28);
+
+    // Ticks that do not complete a step publish nothing
+    positionSpy.clear();
+    clock.step(4);
+    QCOMPARE(positionSpy.count(), 0);
+    clock.step();
+    QCOMPARE(positionSpy.count(), 1);
+}
+
+void TestTelemetryDataSimulator::testCommandsReplaceActivePhase()
+{
+    UASStateMachine stateMachine;
+    SimulationClock clock(SimulationClock::Manual);
+    TelemetryDataSimulator simulator(&stateMachine);
+    simulator.setClock(&clock);
+
+    simulator.takeOff();
+    clock.advance(7000);
+    QCOMPARE(stateMachine.currentState(), UASState::Flying);
+
+    // Repeated commands do not stack up; the position moves once per step
+    const QGeoCoordinate start = simulator.position();
+    for (int i = 0; i < 20; ++i) {
+        simulator.goTo(QGeoCoordinate(start.latitude() + 0.05, start.longitude()), 100, true);
+    }
+    QCOMPARE(stateMachine.currentState(), UASState::FlyingToWaypoint);
+
+    for (int tick = 0; tick < 10; ++tick) {
+        const QGeoCoordinate before = simulator.position();
+        clock.step();
+        const double moved = std::hypot(simulator.position().latitude() - before.latitude(),
+                                        simulator.position().longitude() - before.longitude());
+        QVERIFY(qAbs(moved - 0.00001 * simulator.speed()) < 1e-9);
+    }
+    QCOMPARE(stateMachine.currentState(), UASState::FlyingToWaypoint);
+}
+
+void TestTelemetryDataSimulator::testEnduranceEstimates()
+{
+    UASStateMachine stateMachine;
+    SimulationClock clock(SimulationClock::Manual);
+    TelemetryDataSimulator simulator(&stateMachine);
+    simulator.setClock(&clock);
+
+    // On the ground the estimates assume the most economical flight
+    const EnergyModel model;
+    QCOMPARE(simulator.battery(), 100);
+    QCOMPARE(simulator.remainingFlightTime(), qRound(model.capacity() / model.minimumPower()));
+    QVERIFY(simulator.remainingRange() > 0);
+
+    QSignalSpy timeSpy(&simulator, &TelemetryData::remainingFlightTimeChanged);
+    QSignalSpy rangeSpy(&simulator, &TelemetryData::remainingRangeChanged);
+
+    // Climbing out and cruising drain the battery and shorten the estimates
+    const int groundTime = simulator.remainingFlightTime();
+    simulator.takeOff();
+    clock.advance(7000);
+    clock.advance(120000);
+    QCOMPARE(stateMachine.currentState(), UASState::Flying);
+    QVERIFY(simulator.battery() < 100);
+    QVERIFY(simulator.remainingFlightTime() < groundTime / 2);
+    QVERIFY(timeSpy.count() > 0);
+    QVERIFY(rangeSpy.count() > 0);
+
+    // The remaining range is the remaining time at the average cruise speed
+    QVERIFY(qAbs(simulator.remainingRange() - simulator.remainingFlightTime() * 40) < simulator.remainingRange() / 20);
+
+    // After landing the estimates recover as the averages settle on the ground
+    const int airborneTime = simulator.remainingFlightTime();
+    simulator.land();
+    clock.advance(300000);
+    QCOMPARE(stateMachine.currentState(), UASState::Landed);
+    QVERIFY(simulator.remainingFlightTime() > airborneTime);
+    QVERIFY(simulator.remainingFlightTime() < groundTime);
+}
+
 void TestTelemetryDataSimulator::cleanupTestCase()
 {
     // Clean up the test fixture
@@ -0,0 +1,214 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QCoreApplication>
+#include <QObject>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "TelemetryHistory.hpp"
+#include "TelemetryBus.hpp"
+
+class TestTelemetryHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRawSamples();
+    void testRollups();
+    void testRetention();
+    void testRestart();
+    void testBus();
+    void benchmarkQuery();
+
+private:
+    /**
+     * @struct Sample
+     * @brief A sample as appended, for brute-force comparisons
+     */
+    struct Sample
+    {
+        qint64 timestamp;
+        int altitude;
+    };
+
+    // Helper function appending samples of vehicle 1 every step milliseconds in [from, to)
+    static std::vector<Sample> fill(TelemetryHistory& history, qint64 from, qint64 to, qint64 step);
+
+    // Helper function checking a point against all samples in [timestamp, timestamp + length)
+    static bool matches(const TelemetryHistory::Point& point, qint64 length, const std::vector<Sample>& samples);
+};
+
+std::vector<TestTelemetryHistory::Sample> TestTelemetryHistory::fill(TelemetryHistory& history, qint64 from, qint64 to, qint64 step)
+{
+    std::vector<Sample> samples;
+    for (qint64 timestamp = from; timestamp < to; timestamp += step) {
+        TelemetryFrame frame;
+        frame.timestamp = timestamp;
+        frame.setAltitude(static_cast<int>((timestamp / step * 7919) % 1000));
+        frame.setSpeed(static_cast<int>(timestamp / step % 50));
+        history.append(1, frame);
+        samples.push_back(Sample{timestamp, frame.altitude});
+    }
+    return samples;
+}
+
+bool TestTelemetryHistory::matches(const TelemetryHistory::Point& point, qint64 length, const std::vector<Sample>& samples)
+{
+    int minimum = std::numeric_limits<int>::max();
+    int maximum = std::numeric_limits<int>::min();
+    double sum = 0.0;
+    int count = 0;
+    for (const Sample& sample : samples) {
+        if (sample.timestamp >= point.timestamp && sample.timestamp < point.timestamp + length) {
+            minimum = qMin(minimum, sample.altitude);
+            maximum = qMax(maximum, sample.altitude);
+            sum += sample.altitude;
+            ++count;
+        }
+    }
+    return count > 0 && point.minimum == minimum && point.maximum == maximum
+        && qAbs(point.average - sum / count) < 1e-3;
+}
+
+void TestTelemetryHistory::testRawSamples()
+{
+    TelemetryHistory history;
+    const std::vector<Sample> samples = fill(history, 0, 1000, 100);
+    QCOMPARE(history.vehicleCount(), 1);
+    QCOMPARE(history.latestTimestamp(1), qint64(900));
+    QCOMPARE(history.latestTimestamp(2), TelemetryHistory::NO_TIMESTAMP);
+
+    // Finer than the finest rollup: every sample is a point of its own
+    const std::vector<TelemetryHistory::Point> points = history.query(1, TelemetryHistory::Altitude, 0, 1000, 100);
+    QCOMPARE(points.size(), size_t(10));
+    for (size_t i = 0; i < points.size(); ++i) {
+        QCOMPARE(points[i].timestamp, samples[i].timestamp);
+        QCOMPARE(points[i].minimum, float(samples[i].altitude));
+        QCOMPARE(points[i].maximum, float(samples[i].altitude));
+        QCOMPARE(points[i].average, float(samples[i].altitude));
+    }
+
+    // Samples are merged into the intervals they fall in
+    const std::vector<TelemetryHistory::Point> halves = history.query(1, TelemetryHistory::Altitude, 0, 1000, 2);
+    QCOMPARE(halves.size(), size_t(2));
+    QVERIFY(matches(halves[1], 500, samples));
+
+    // Other channels, empty windows and unknown vehicles
+    const std::vector<TelemetryHistory::Point> speeds = history.queryLast(1, TelemetryHistory::Speed, 300, 100);
+    QCOMPARE(speeds.size(), size_t(3));
+    QCOMPARE(speeds.back().maximum, 9.0f);
+    QVERIFY(history.query(1, TelemetryHistory::Altitude, 1000, 2000, 10).empty());
+    QVERIFY(history.query(2, TelemetryHistory::Altitude, 0, 1000, 10).empty());
+}
+
+void TestTelemetryHistory::testRollups()
+{
+    // Two hours at 4 Hz, far more than the raw ring holds
+    TelemetryHistory history;
+    const std::vector<Sample> samples = fill(history, 0, 7200000, 250);
+
+    // One-minute intervals read the one-minute rollup
+    std::vector<TelemetryHistory::Point> points = history.query(1, TelemetryHistory::Altitude, 0, 7200000, 120);
+    QCOMPARE(points.size(), size_t(120));
+    for (const TelemetryHistory::Point& point : points) {
+        QVERIFY(matches(point, 60000, samples));
+    }
+
+    // Ten-minute intervals read the ten-minute rollup
+    points = history.query(1, TelemetryHistory::Altitude, 0, 7200000, 12);
+    QCOMPARE(points.size(), size_t(12));
+    QVERIFY(matches(points[5], 600000, samples));
+
+    // The last hour at 5 s has no 1 s rollup left, so it reads 10 s buckets
+    points = history.query(1, TelemetryHistory::Altitude, 3600000, 7200000, 720);
+    QCOMPARE(points.size(), size_t(360));
+    for (const TelemetryHistory::Point& point : points) {
+        QVERIFY(matches(point, 10000, samples));
+    }
+
+    // Two hours at 10 s cannot be read from the 10 s rollup either
+    QCOMPARE(history.query(1, TelemetryHistory::Altitude, 0, 7200000, 720).size(), size_t(120));
+}
+
+void TestTelemetryHistory::testRetention()
+{
+    // Seventy hours at 1 Hz into a history of fixed size
+    TelemetryHistory history;
+    QVERIFY(TelemetryHistory::bytesPerVehicle() < 200 * 1024);
+    fill(history, 0, 70 * 3600000LL, 1000);
+
+    // The coarsest rollup keeps the last 60 hours
+    const std::vector<TelemetryHistory::Point> points = history.query(1, TelemetryHistory::Altitude, 0, 70 * 3600000LL, 70);
+    QCOMPARE(points.size(), size_t(60));
+    QCOMPARE(points.front().timestamp, 10 * 3600000LL);
+
+    // Recent windows are still resolved finely
+    QCOMPARE(history.queryLast(1, TelemetryHistory::Altitude, 60000, 60).size(), size_t(60));
+}
+
+void TestTelemetryHistory::testRestart()
+{
+    TelemetryHistory history;
+    fill(history, 10000, 20000, 100);
+
+    // A sample older than the latest one starts the history over
+    TelemetryFrame frame;
+    frame.timestamp = 5000;
+    frame.setAltitude(42);
+    history.append(1, frame);
+    QCOMPARE(history.latestTimestamp(1), qint64(5000));
+
+    const std::vector<TelemetryHistory::Point> points = history.query(1, TelemetryHistory::Altitude, 0, 30000, 30);
+    QCOMPARE(points.size(), size_t(1));
+    QCOMPARE(points.front().maximum, 42.0f);
+}
+
+void TestTelemetryHistory::testBus()
+{
+    TelemetryBus bus;
+    TelemetryHistory history(2);
+    history.attach(&bus);
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Frames));
+    QSignalSpy updatedSpy(&history, &TelemetryHistory::updated);
+
+    // Vehicles beyond the capacity are dropped
+    auto batch = std::make_shared<TelemetryBus::FrameBatch>();
+    batch->timestamp = 250;
+    batch->frames.resize(3);
+    for (int i = 0; i < 3; ++i) {
+        batch->frames[i].vehicle = static_cast<quint32>(10 + i);
+        batch->frames[i].frame.timestamp = 250;
+        batch->frames[i].frame.setBattery(90 - i);
+    }
+    bus.publishFrames(batch);
+    QCoreApplication::processEvents();
+
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(history.vehicleCount(), 2);
+    QVERIFY(history.contains(11));
+    QVERIFY(!history.contains(12));
+    QCOMPARE(history.droppedFrames(), quint64(1));
+    QCOMPARE(history.queryLast(11, TelemetryHistory::Battery, 1000, 10).front().average, 89.0f);
+
+    history.attach(nullptr);
+    QCOMPARE(bus.subscriberCount(), 0);
+    history.clear();
+    QCOMPARE(history.vehicleCount(), 0);
+}
+
+void TestTelemetryHistory::benchmarkQuery()
+{
+    // The last four hours of a ten-hour flight at 4 Hz, drawn at 500 points
+    TelemetryHistory history;
+    fill(history, 0, 10 * 3600000LL, 250);
+
+    std::vector<TelemetryHistory::Point> points;
+    QBENCHMARK {
+        points = history.queryLast(1, TelemetryHistory::Altitude, 4 * 3600000LL, 500);
+    }
+    QVERIFY(!points.empty() && points.size() <= 500);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestTelemetryHistory)
+#include "TestTelemetryHistory.moc"
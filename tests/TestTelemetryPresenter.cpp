@@ -0,0 +1,211 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QObject>
+#include <QtMath>
+#include "TelemetryPresenter.hpp"
+#include "VehiclePositions.hpp"
+#include "WebMercator.hpp"
+
+class TestTelemetryPresenter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testExtrapolation();
+    void testBlend();
+    void testRate();
+    void testPosition();
+    void testBus();
+    void benchmarkPresent();
+
+private:
+    // Helper function building a batch with the position of one vehicle
+    static TelemetryBus::FrameBatch sample(qint64 timestamp, quint32 vehicle, double latitude, double longitude);
+};
+
+TelemetryBus::FrameBatch TestTelemetryPresenter::sample(qint64 timestamp, quint32 vehicle, double latitude, double longitude)
+{
+    TelemetryBus::FrameBatch batch;
+    batch.timestamp = timestamp;
+    batch.frames.resize(1);
+    batch.frames[0].vehicle = vehicle;
+    batch.frames[0].frame.timestamp = timestamp;
+    batch.frames[0].frame.setPosition(latitude, longitude);
+    return batch;
+}
+
+void TestTelemetryPresenter::testExtrapolation()
+{
+    VehiclePositions positions;
+    TelemetryPresenter presenter(&positions);
+    presenter.append(sample(1000, 1, 42.0, -83.0), 0.0);
+    QVERIFY(presenter.animating());
+    presenter.present(0.0);
+    QCOMPARE(positions.count(), 1);
+    QCOMPARE(positions.markers()[0].x, WebMercator::x(-83.0));
+    QVERIFY(!presenter.animating());
+
+    // The presented position continues from where it was when the next sample arrives
+    presenter.append(sample(1250, 1, 42.0, -82.999), 250.0);
+    presenter.present(250.0);
+    QVERIFY(qAbs(positions.markers()[0].x - WebMercator::x(-83.0)) < 1e-15);
+
+    // Once blended, it runs ahead of the sample at the velocity between the samples
+    const double velocity = (WebMercator::x(-82.999) - WebMercator::x(-83.0)) / 250.0;
+    presenter.present(250.0 + TelemetryPresenter::BLEND_INTERVAL + 50.0);
+    QVERIFY(qAbs(positions.markers()[0].x - (WebMercator::x(-82.999) + velocity * (TelemetryPresenter::BLEND_INTERVAL + 50.0))) < 1e-12);
+    QVERIFY(qAbs(positions.markers()[0].y - WebMercator::y(42.0)) < 1e-15);
+    QVERIFY(qAbs(positions.markers()[0].heading - M_PI / 2.0) < 1e-6);
+    QVERIFY(presenter.animating());
+
+    // Extrapolation stops MAX_EXTRAPOLATION sample intervals past the latest sample
+    const double limit = TelemetryPresenter::MAX_EXTRAPOLATION * 250.0;
+    presenter.present(250.0 + limit + 100.0);
+    QVERIFY(qAbs(positions.markers()[0].x - (WebMercator::x(-82.999) + velocity * limit)) < 1e-12);
+    QVERIFY(!presenter.animating());
+}
+
+void TestTelemetryPresenter::testBlend()
+{
+    // A 4 Hz flight east at constant speed whose samples arrive up to 20 ms early or late
+    VehiclePositions positions;
+    TelemetryPresenter presenter(&positions);
+    const double spacing = 1e-4;
+    const double velocity = WebMercator::x(spacing) - WebMercator::x(0.0);
+    auto arrival = [](int index) {
+        return index * 250.0 + (index % 3 - 1) * 20.0 + 20.0;
+    };
+
+    // Presented at 60 Hz, the vehicle never moves backwards or leaps
+    int next = 0;
+    double previous = 0.0;
+    for (double time = 0.0; time < 5000.0; time += 16.0) {
+        while (arrival(next) <= time) {
+            presenter.append(sample(1000 + next * 250, 1, 42.0, -83.0 + next * spacing), arrival(next));
+            ++next;
+        }
+        presenter.present(time);
+        if (next == 0) {
+            continue;
+        }
+
+        const double x = positions.markers()[0].x;
+        if (time >= 1000.0) {
+            QVERIFY(x >= previous);
+            QVERIFY(x - previous <= 2.0 * velocity * 16.0 / 250.0);
+        }
+        previous = x;
+    }
+
+    // A sample off the extrapolated path bends the path without a jump
+    presenter.present(5000.0);
+    const double before = positions.markers()[0].y;
+    presenter.append(sample(1000 + next * 250, 1, 42.001, -83.0 + next * spacing), 5000.0);
+    presenter.present(5000.0);
+    QVERIFY(qAbs(positions.markers()[0].y - before) < 1e-15);
+    presenter.present(5000.0 + TelemetryPresenter::BLEND_INTERVAL);
+    QVERIFY(positions.markers()[0].y < WebMercator::y(42.001));
+}
+
+void TestTelemetryPresenter::testRate()
+{
+    // Source time running twice as fast as the wall clock, as under a time warp of 2
+    VehiclePositions positions;
+    TelemetryPresenter presenter(&positions);
+    for (int index = 0; index < 40; ++index) {
+        presenter.append(sample(index * 500, 1, 42.0, -83.0 + index * 1e-4), index * 250.0);
+    }
+    QVERIFY(qAbs(presenter.rate() - 2.0) < 1e-3);
+    QVERIFY(qAbs(presenter.sourceTime(39 * 250.0 + 100.0) - (39 * 500.0 + 200.0)) < 0.1);
+
+    // A pause does not count towards the rate
+    presenter.append(sample(40 * 500, 1, 42.0, -83.0 + 40 * 1e-4), 40 * 250.0 + 10000.0);
+    QVERIFY(qAbs(presenter.rate() - 2.0) < 1e-3);
+
+    // Seeking backwards moves the vehicle without blending or extrapolating
+    const double time = 40 * 250.0 + 10010.0;
+    presenter.append(sample(2000, 1, 42.5, -83.5), time);
+    presenter.present(time + 10.0);
+    QCOMPARE(positions.markers()[0].x, WebMercator::x(-83.5));
+    QCOMPARE(positions.markers()[0].y, WebMercator::y(42.5));
+    QVERIFY(!presenter.animating());
+}
+
+void TestTelemetryPresenter::testPosition()
+{
+    VehiclePositions positions;
+    TelemetryPresenter presenter(&positions);
+    QSignalSpy positionSpy(&presenter, &TelemetryPresenter::positionChanged);
+    presenter.setVehicle(2);
+    QVERIFY(!presenter.position().isValid());
+
+    TelemetryBus::FrameBatch batch = sample(1000, 1, 42.0, -83.0);
+    batch.frames.push_back(sample(1000, 2, 42.1, -83.1).frames[0]);
+    presenter.append(batch, 0.0);
+    presenter.present(0.0);
+    QCOMPARE(positionSpy.count(), 1);
+    QVERIFY(qAbs(presenter.position().latitude() - 42.1) < 1e-9);
+    QVERIFY(qAbs(presenter.position().longitude() + 83.1) < 1e-9);
+    QCOMPARE(positions.count(), 2);
+
+    // A vehicle without samples has no position
+    presenter.setVehicle(3);
+    presenter.present(10.0);
+    QVERIFY(!presenter.position().isValid());
+
+    presenter.setVehicle(2);
+    presenter.present(20.0);
+    QVERIFY(presenter.position().isValid());
+    presenter.clear();
+    QVERIFY(!presenter.position().isValid());
+    QCOMPARE(positions.count(), 0);
+}
+
+void TestTelemetryPresenter::testBus()
+{
+    TelemetryBus bus;
+    VehiclePositions positions;
+    TelemetryPresenter presenter(&positions);
+    presenter.attach(&bus);
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Frames));
+
+    auto batch = std::make_shared<TelemetryBus::FrameBatch>(sample(1000, 4, 42.0, -83.0));
+    bus.publishFrames(batch);
+    QCoreApplication::processEvents();
+    QVERIFY(presenter.animating());
+
+    presenter.present();
+    QCOMPARE(positions.count(), 1);
+    QCOMPARE(positions.indexOf(4), 0);
+
+    presenter.attach(nullptr);
+    QCOMPARE(bus.subscriberCount(), 0);
+}
+
+void TestTelemetryPresenter::benchmarkPresent()
+{
+    // A fleet of 5,000 vehicles presented in one display frame between two samples
+    VehiclePositions positions;
+    TelemetryPresenter presenter(&positions);
+    for (int step = 0; step < 2; ++step) {
+        TelemetryBus::FrameBatch batch;
+        batch.timestamp = 1000 + step * 250;
+        batch.frames.resize(5000);
+        for (int i = 0; i < 5000; ++i) {
+            batch.frames[i].vehicle = static_cast<quint32>(i);
+            batch.frames[i].frame.timestamp = batch.timestamp;
+            batch.frames[i].frame.setPosition(42.0 + (i / 100) * 0.001, -83.0 + (i % 100) * 0.001 + step * 1e-5);
+        }
+        presenter.append(batch, step * 250.0);
+    }
+
+    QBENCHMARK {
+        presenter.present(300.0);
+    }
+    QCOMPARE(positions.count(), 5000);
+    QVERIFY(presenter.animating());
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestTelemetryPresenter)
+#include "TestTelemetryPresenter.moc"
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QVariant>
 #include <QDebug>
+#include "EventLog.hpp"
 #include "UASStateMachine.hpp"
 
 class TestUASStateMachine : public QObject
@@ -18,6 +19,9 @@ private slots:
     void testCommandSignals();
     void testInvalidTransitions();
     void testStateEnum();
+    void testTransitionTable();
+    void testAuditRing();
+    void benchmarkValidation();
     void cleanupTestCase();
 
 private:
@@ -265,6 +269,103 @@ void TestUASStateMachine::testStateEnum()
     QCOMPARE(QString(metaEnum.key(5)), QString("Landing"));
 }
 
+void TestUASStateMachine::testTransitionTable()
+{
+    // The table encodes the flight rules for every pair of states
+    for (int f = 0; f < UASState::STATE_COUNT; ++f) {
+        for (int t = 0; t < UASState::STATE_COUNT; ++t) {
+            const auto from = static_cast<UASState::State>(f);
+            const auto to = static_cast<UASState::State>(t);
+            const bool flying = from == UASState::Flying || from == UASState::FlyingToWaypoint || from == UASState::Loitering;
+
+            UASState::TransitionResult expected = UASState::Accepted;
+            if ((to == UASState::Landing || to == UASState::FlyingToWaypoint) && !flying) {
+                expected = UASState::RequiresFlying;
+            } else if (to == UASState::TakingOff && from != UASState::Landed) {
+                expected = UASState::RequiresLanded;
+            }
+
+            QCOMPARE(UASStateMachine::transitionResult(from, to), expected);
+            QCOMPARE(UASStateMachine::isValidTransition(from, to), expected == UASState::Accepted);
+        }
+    }
+
+    // Out of range states are rejected rather than read past the table
+    QCOMPARE(UASStateMachine::transitionResult(static_cast<UASState::State>(UASState::STATE_COUNT), UASState::Landed),
+             UASState::UnknownState);
+}
+
+void TestUASStateMachine::testAuditRing()
+{
+    UASStateMachine stateMachine;
+    QSignalSpy spy(&stateMachine, &UASStateMachine::currentStateChanged);
+    QCOMPARE(stateMachine.audit().count(), 0);
+
+    // Accepted and rejected requests are both recorded, with the reason
+    QVERIFY(stateMachine.setCurrentState(UASState::TakingOff));
+    QVERIFY(!stateMachine.setCurrentState(UASState::TakingOff));
+    QVERIFY(!stateMachine.setCurrentState(UASState::Landing));
+    QCOMPARE(spy.count(), 1);
+
+    const TransitionAudit& audit = stateMachine.audit();
+    QCOMPARE(audit.count(), 3);
+    QCOMPARE(audit.rejectedCount(), quint32(2));
+    QCOMPARE(audit.at(0).from, UASState::Landed);
+    QCOMPARE(audit.at(0).to, UASState::TakingOff);
+    QCOMPARE(audit.at(0).result, UASState::Accepted);
+    QCOMPARE(audit.at(1).result, UASState::RequiresLanded);
+    QCOMPARE(audit.last().to, UASState::Landing);
+    QCOMPARE(audit.last().result, UASState::RequiresFlying);
+    // Stamped by the monotonic event log clock, so entries stay ordered
+    QVERIFY(audit.at(1).timestamp >= audit.at(0).timestamp);
+    QVERIFY(audit.last().timestamp >= audit.at(1).timestamp);
+    QVERIFY(audit.last().timestamp <= EventLog::now() / 1000000);
+    QVERIFY(audit.at(0).timestamp > 0);
+
+    // Requesting the current state again is neither recorded nor emitted
+    QVERIFY(stateMachine.setCurrentState(UASState::Flying));
+    QVERIFY(stateMachine.setCurrentState(UASState::Flying));
+    QCOMPARE(audit.totalRecorded(), quint32(4));
+    QCOMPARE(spy.count(), 2);
+
+    // Mirrored states are recorded as accepted
+    stateMachine.syncState(UASState::Loitering);
+    QCOMPARE(audit.last().from, UASState::Flying);
+    QCOMPARE(audit.last().to, UASState::Loitering);
+    QCOMPARE(audit.last().result, UASState::Accepted);
+
+    // Once full, the oldest records are overwritten
+    for (int i = 0; i < TransitionAudit::CAPACITY; ++i) {
+        stateMachine.setCurrentState(UASState::TakingOff);
+    }
+    QCOMPARE(audit.count(), TransitionAudit::CAPACITY);
+    QCOMPARE(audit.totalRecorded(), quint32(5 + TransitionAudit::CAPACITY));
+    QCOMPARE(audit.rejectedCount(), quint32(2 + TransitionAudit::CAPACITY));
+    for (int i = 0; i < audit.count(); ++i) {
+        QCOMPARE(audit.at(i).to, UASState::TakingOff);
+    }
+}
+
+void TestUASStateMachine::benchmarkValidation()
+{
+    // Validating a command broadcast to 100,000 vehicles in mixed states
+    constexpr int VEHICLES = 100000;
+    QVector<UASState::State> states(VEHICLES);
+    for (int i = 0; i < VEHICLES; ++i) {
+        states[i] = static_cast<UASState::State>(i % UASState::STATE_COUNT);
+    }
+
+    int accepted = 0;
+    QBENCHMARK {
+        accepted = 0;
+        for (const UASState::State state : std::as_const(states)) {
+            accepted += UASStateMachine::isValidTransition(state, UASState::Landing) ? 1 : 0;
+        }
+    }
+
+    QCOMPARE(accepted, VEHICLES / 2);
+}
+
 void TestUASStateMachine::cleanupTestCase()
 {
     // Clean up the test fixture
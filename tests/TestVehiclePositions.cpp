@@ -0,0 +1,190 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QObject>
+#include <QtMath>
+#include "GeoPoint.hpp"
+#include "VehiclePositions.hpp"
+#include "WebMercator.hpp"
+
+class TestVehiclePositions : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testProjection();
+    void testUpdate();
+    void testHeading();
+    void testCull();
+    void testBus();
+    void benchmarkCull();
+
+private:
+    // Helper function building a batch of vehicles on a square grid around a center, spaced in degrees
+    static TelemetryBus::FrameBatch grid(int count, double latitude, double longitude, double spacing);
+};
+
+TelemetryBus::FrameBatch TestVehiclePositions::grid(int count, double latitude, double longitude, double spacing)
+{
+    const int side = qCeil(qSqrt(count));
+    TelemetryBus::FrameBatch batch;
+    batch.frames.resize(count);
+    for (int i = 0; i < count; ++i) {
+        batch.frames[i].vehicle = static_cast<quint32>(i);
+        batch.frames[i].frame.setPosition(latitude + (i / side - side / 2) * spacing,
+                                          longitude + (i % side - side / 2) * spacing);
+    }
+    return batch;
+}
+
+void TestVehiclePositions::testProjection()
+{
+    QCOMPARE(WebMercator::x(0.0), 0.5);
+    QCOMPARE(WebMercator::x(-180.0), 0.0);
+    QCOMPARE(WebMercator::y(0.0), 0.5);
+    QVERIFY(qAbs(WebMercator::y(WebMercator::MAX_LATITUDE)) < 1e-9);
+    QVERIFY(qAbs(WebMercator::y(90.0)) < 1e-9);
+    QVERIFY(qAbs(WebMercator::y(-WebMercator::MAX_LATITUDE) - 1.0) < 1e-9);
+    QVERIFY(qAbs(WebMercator::longitude(WebMercator::x(-83.0458)) + 83.0458) < 1e-12);
+    QVERIFY(qAbs(WebMercator::latitude(WebMercator::y(42.3314)) - 42.3314) < 1e-12);
+
+    // Detroit lies in OpenStreetMap tile 4412/6061 at zoom level 14
+    const double tiles = WebMercator::worldSize(14) / WebMercator::TILE_SIZE;
+    QCOMPARE(qFloor(WebMercator::x(-83.0458) * tiles), 4412);
+    QCOMPARE(qFloor(WebMercator::y(42.3314) * tiles), 6061);
+
+    // The map center lies at the item center, one world width around in both directions
+    const WebMercator::Viewport viewport(42.3314, -83.0458, 10, 800, 600);
+    QCOMPARE(viewport.scale, 256.0 * 1024.0);
+    QVERIFY(qAbs(viewport.screenX(viewport.centerX) - 400.0) < 1e-6);
+    QVERIFY(qAbs(viewport.screenX(viewport.centerX + 1.0) - 400.0) < 1e-6);
+    QVERIFY(qAbs(viewport.screenY(viewport.centerY) - 300.0) < 1e-6);
+    QVERIFY(qAbs(viewport.screenX(viewport.centerX + 100.0 / viewport.scale) - 500.0) < 1e-6);
+    QVERIFY(viewport.contains(-5.0, 300.0, 10.0));
+    QVERIFY(!viewport.contains(-5.0, 300.0, 0.0));
+}
+
+void TestVehiclePositions::testUpdate()
+{
+    VehiclePositions positions;
+    QSignalSpy updatedSpy(&positions, &VehiclePositions::updated);
+    QSignalSpy countSpy(&positions, &VehiclePositions::countChanged);
+
+    positions.update(grid(9, 42.0, -83.0, 0.01));
+    QCOMPARE(positions.count(), 9);
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(positions.indexOf(4), 4);
+    QCOMPARE(positions.indexOf(9), -1);
+    QCOMPARE(positions.markers()[4].vehicle, quint32(4));
+    QCOMPARE(positions.markers()[4].x, WebMercator::x(-83.0));
+    QCOMPARE(positions.markers()[4].y, WebMercator::y(42.0));
+
+    // Known vehicles are updated in place
+    positions.update(grid(9, 43.0, -83.0, 0.01));
+    QCOMPARE(positions.count(), 9);
+    QCOMPARE(updatedSpy.count(), 2);
+    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(positions.markers()[4].y, WebMercator::y(43.0));
+
+    positions.clear();
+    QCOMPARE(positions.count(), 0);
+    QCOMPARE(positions.indexOf(4), -1);
+    QCOMPARE(countSpy.count(), 2);
+}
+
+void TestVehiclePositions::testHeading()
+{
+    VehiclePositions positions;
+    positions.update(7, 42.0, -83.0);
+    QCOMPARE(positions.markers()[0].heading, 0.0f);
+
+    // Headings are clockwise from north
+    positions.update(7, 42.0, -82.99);
+    QVERIFY(qAbs(positions.markers()[0].heading - M_PI_2) < 1e-6);
+    positions.update(7, 41.99, -82.99);
+    QVERIFY(qAbs(qAbs(positions.markers()[0].heading) - M_PI) < 1e-6);
+
+    // The projection is conformal: headings match the bearing on the ground
+    const double bearing = GeoPoint(41.99, -82.99).azimuthTo(GeoPoint(41.98, -83.0)) - 360.0;
+    positions.update(7, 41.98, -83.0);
+    QVERIFY(qAbs(positions.markers()[0].heading - qDegreesToRadians(bearing)) < 1e-3);
+
+    // Standing still keeps the heading
+    positions.update(7, 41.98, -83.0);
+    QVERIFY(qAbs(positions.markers()[0].heading - qDegreesToRadians(bearing)) < 1e-3);
+
+    // Crossing the antimeridian eastwards heads east
+    positions.update(8, 0.0, 179.999);
+    positions.update(8, 0.0, -179.999);
+    QVERIFY(qAbs(positions.markers()[1].heading - M_PI_2) < 1e-6);
+}
+
+void TestVehiclePositions::testCull()
+{
+    VehiclePositions positions;
+    positions.update(grid(100, 42.0, -83.0, 0.01));
+
+    // At zoom 10 a hundredth of a degree is about 7 pixels: the whole grid is visible
+    std::vector<int> visible;
+    QCOMPARE(positions.cull(WebMercator::Viewport(42.0, -83.0, 10, 800, 600), 0.0, visible), 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(visible[i], i);
+    }
+
+    // At zoom 15.5 it is 330 pixels east-west and 443 north-south: only three vehicles of the center row are within the item
+    const WebMercator::Viewport close(42.0, -83.0, 15.5, 800, 200);
+    QCOMPARE(positions.cull(close, 0.0, visible), 3);
+    QCOMPARE(visible[0], positions.indexOf(54));
+    QCOMPARE(visible[2], positions.indexOf(56));
+
+    // The margin admits the next vehicles on both sides, just outside the item
+    const double west = close.screenX(positions.markers()[positions.indexOf(53)].x);
+    QVERIFY(west < 0.0);
+    QCOMPARE(positions.cull(close, 1.0 - west, visible), 5);
+    QCOMPARE(visible[0], positions.indexOf(53));
+    QCOMPARE(visible[4], positions.indexOf(57));
+
+    // Vehicles across the antimeridian are found next to the center
+    positions.clear();
+    positions.update(1, 0.0, 179.9999);
+    positions.update(2, 0.0, -179.9999);
+    positions.update(3, 0.0, 0.0);
+    QCOMPARE(positions.cull(WebMercator::Viewport(0.0, 180.0, 12, 800, 600), 0.0, visible), 2);
+}
+
+void TestVehiclePositions::testBus()
+{
+    TelemetryBus bus;
+    VehiclePositions positions;
+    positions.attach(&bus);
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Frames));
+    QSignalSpy updatedSpy(&positions, &VehiclePositions::updated);
+
+    bus.publishFrames(std::make_shared<TelemetryBus::FrameBatch>(grid(4, 42.0, -83.0, 0.01)));
+    QCoreApplication::processEvents();
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(positions.count(), 4);
+
+    positions.attach(nullptr);
+    QCOMPARE(bus.subscriberCount(), 0);
+}
+
+void TestVehiclePositions::benchmarkCull()
+{
+    // A fleet of 5,000 vehicles, about a third of them on screen, updated and culled as in one map frame
+    VehiclePositions positions;
+    const TelemetryBus::FrameBatch batch = grid(5000, 42.0, -83.0, 0.001);
+    positions.update(batch);
+
+    std::vector<int> visible;
+    const WebMercator::Viewport viewport(42.0, -83.0, 15, 1280, 960);
+    QBENCHMARK {
+        positions.update(batch);
+        positions.cull(viewport, 32.0, visible);
+    }
+    QVERIFY(visible.size() > 1000 && visible.size() < 2500);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestVehiclePositions)
+#include "TestVehiclePositions.moc"
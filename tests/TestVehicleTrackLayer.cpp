@@ -0,0 +1,186 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QtMath>
+#include <QSGGeometryNode>
+#include <algorithm>
+#include "VehicleTrackLayer.hpp"
+#include "VehicleTracks.hpp"
+#include "WebMercator.hpp"
+
+// Layer exposing the scene graph update, run without a window
+class TrackLayer : public VehicleTrackLayer
+{
+public:
+    using VehicleTrackLayer::updatePaintNode;
+};
+
+class TestVehicleTrackLayer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testGeometry();
+    void testAppendCost();
+    void benchmarkAppend();
+
+private:
+    // Helper function appending a 4 Hz loiter at 15 m/s on a 200 m circle drifting east at 1 m/s
+    static void loiter(VehicleTracks& tracks, quint32 vehicle, int from, int to);
+
+    // Helper function setting up a layer at a zoom level around the loiter
+    static void setUp(TrackLayer& layer, VehicleTracks& tracks, qreal zoomLevel);
+
+    // Helper function getting the line geometry of a node returned by the layer
+    static QSGGeometry* geometry(QSGNode* node);
+
+    // Helper function verifying that the geometry draws the segments of the simplified track
+    static bool matches(QSGGeometry* geometry, const VehicleTracks& tracks, int level);
+};
+
+void TestVehicleTrackLayer::loiter(VehicleTracks& tracks, quint32 vehicle, int from, int to)
+{
+    const double latitude = 42.3314;
+    const double longitude = -83.0458;
+    const double metersPerDegree = 111320.0;
+    for (int step = from; step < to; ++step) {
+        const double seconds = step * 0.25;
+        const double angle = seconds * 15.0 / 200.0;
+        const double north = 200.0 * std::cos(angle);
+        const double east = 200.0 * std::sin(angle) + seconds;
+        tracks.append(vehicle, latitude + north / metersPerDegree,
+                      longitude + east / (metersPerDegree * std::cos(qDegreesToRadians(latitude))));
+    }
+}
+
+void TestVehicleTrackLayer::setUp(TrackLayer& layer, VehicleTracks& tracks, qreal zoomLevel)
+{
+    layer.setSize(QSizeF(800, 600));
+    layer.setTracks(&tracks);
+    layer.setVehicle(1);
+    layer.setCenter(QGeoCoordinate(42.3314, -83.0458));
+    layer.setZoomLevel(zoomLevel);
+}
+
+QSGGeometry* TestVehicleTrackLayer::geometry(QSGNode* node)
+{
+    return static_cast<QSGGeometryNode*>(node->firstChild())->geometry();
+}
+
+bool TestVehicleTrackLayer::matches(QSGGeometry* geometry, const VehicleTracks& tracks, int level)
+{
+    const int count = tracks.vertexCount(1, level);
+    const float scale = static_cast<float>(WebMercator::worldSize(level) * VehicleTracks::POINT_SCALE);
+    const VehicleTracks::Point origin = tracks.vertex(1, level, 0);
+    const QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+    for (int index = 0; index < count; ++index) {
+        const VehicleTracks::Point point = tracks.vertex(1, level, index);
+        if (vertices[index].x != static_cast<qint32>(point.x - origin.x) * scale
+            || vertices[index].y != static_cast<qint32>(point.y - origin.y) * scale) {
+            return false;
+        }
+    }
+
+    // Segments beyond the track are collapsed onto the first vertex
+    const quint32* indices = geometry->indexDataAsUInt();
+    for (int segment = 0; segment < geometry->indexCount() / 2; ++segment) {
+        const bool drawn = segment < count - 1;
+        if (indices[2 * segment] != (drawn ? quint32(segment) : 0u)
+            || indices[2 * segment + 1] != (drawn ? quint32(segment + 1) : 0u)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestVehicleTrackLayer::testGeometry()
+{
+    VehicleTracks tracks;
+    TrackLayer layer;
+    setUp(layer, tracks, 15.0);
+    QVERIFY(!layer.updatePaintNode(nullptr, nullptr));
+
+    loiter(tracks, 1, 0, 1000);
+    emit tracks.updated();
+    QSGNode* node = layer.updatePaintNode(nullptr, nullptr);
+    QVERIFY(node);
+    QCOMPARE(geometry(node)->drawingMode(), QSGGeometry::DrawLines);
+    QVERIFY(matches(geometry(node), tracks, 15));
+
+    // Appends, growing the buffers and crossing to other levels keep the segments in step
+    for (int step = 1000; step < 3000; step += 7) {
+        loiter(tracks, 1, step, step + 7);
+        emit tracks.updated();
+        if (step == 1500) {
+            layer.setZoomLevel(17.3);
+        } else if (step == 2500) {
+            layer.setZoomLevel(9.0);
+        }
+        node = layer.updatePaintNode(node, nullptr);
+        QVERIFY(matches(geometry(node), tracks, VehicleTracks::level(layer.zoomLevel())));
+    }
+
+    // Another vehicle without a track removes the node
+    layer.setVehicle(2);
+    QVERIFY(!layer.updatePaintNode(node, nullptr));
+}
+
+void TestVehicleTrackLayer::testAppendCost()
+{
+    // Two seconds appended to a track of a minute and of an hour write the same bounded data
+    const int appended = 8;
+    const int bound = VehicleTracks::SETTLE_INTERVAL + 1 + appended;
+    for (const int length : {4 * 60, 4 * 3600}) {
+        VehicleTracks tracks;
+        TrackLayer layer;
+        setUp(layer, tracks, VehicleTracks::MAX_ZOOM_LEVEL);
+        loiter(tracks, 1, 0, length);
+        QSGNode* node = layer.updatePaintNode(nullptr, nullptr);
+        QSGGeometry* buffers = geometry(node);
+
+        // Overwrite the buffers with a marker value to count what the next frame writes
+        const QSGGeometry::Point2D poison{-1.0f, -1.0f};
+        std::fill_n(buffers->vertexDataAsPoint2D(), buffers->vertexCount(), poison);
+        std::fill_n(buffers->indexDataAsUInt(), buffers->indexCount(), 0xffffffffu);
+        loiter(tracks, 1, length, length + appended);
+        emit tracks.updated();
+        node = layer.updatePaintNode(node, nullptr);
+        QCOMPARE(geometry(node), buffers);
+
+        const int vertices = static_cast<int>(std::count_if(buffers->vertexDataAsPoint2D(),
+            buffers->vertexDataAsPoint2D() + buffers->vertexCount(),
+            [](const QSGGeometry::Point2D& vertex) { return vertex.x != -1.0f || vertex.y != -1.0f; }));
+        const int indices = static_cast<int>(std::count_if(buffers->indexDataAsUInt(),
+            buffers->indexDataAsUInt() + buffers->indexCount(),
+            [](quint32 index) { return index != 0xffffffffu; }));
+        QVERIFY(vertices <= bound);
+        QVERIFY(indices <= 2 * bound);
+        if (length > 4 * 60) {
+            QVERIFY(tracks.vertexCount(1, VehicleTracks::MAX_ZOOM_LEVEL) > 10 * bound);
+        }
+        delete node;
+    }
+}
+
+void TestVehicleTrackLayer::benchmarkAppend()
+{
+    // One frame after a sample of a vehicle that has flown for an hour
+    VehicleTracks tracks;
+    TrackLayer layer;
+    setUp(layer, tracks, VehicleTracks::MAX_ZOOM_LEVEL);
+    loiter(tracks, 1, 0, 4 * 3600);
+    QSGNode* node = layer.updatePaintNode(nullptr, nullptr);
+
+    int step = 4 * 3600;
+    QBENCHMARK {
+        loiter(tracks, 1, step, step + 1);
+        emit tracks.updated();
+        node = layer.updatePaintNode(node, nullptr);
+        ++step;
+    }
+    QVERIFY(matches(geometry(node), tracks, VehicleTracks::MAX_ZOOM_LEVEL));
+    delete node;
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestVehicleTrackLayer)
+#include "TestVehicleTrackLayer.moc"
@@ -0,0 +1,204 @@
+#include <QtTest/QTest>
+#include <QSignalSpy>
+#include <QObject>
+#include <QtMath>
+#include <limits>
+#include <vector>
+#include "VehicleTracks.hpp"
+#include "WebMercator.hpp"
+
+class TestVehicleTracks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testAppend();
+    void testStraight();
+    void testTolerance();
+    void testSettled();
+    void testBus();
+    void benchmarkAppend();
+
+private:
+    // Helper function appending a 4 Hz loiter at 15 m/s on a 200 m circle drifting east at 1 m/s
+    static void loiter(VehicleTracks& tracks, quint32 vehicle, int from, int to);
+
+    // Helper function measuring the distance of a point to a segment in Point units
+    static double distance(const VehicleTracks::Point& point, const VehicleTracks::Point& start, const VehicleTracks::Point& end);
+};
+
+void TestVehicleTracks::loiter(VehicleTracks& tracks, quint32 vehicle, int from, int to)
+{
+    const double latitude = 42.3314;
+    const double longitude = -83.0458;
+    const double metersPerDegree = 111320.0;
+    for (int step = from; step < to; ++step) {
+        const double seconds = step * 0.25;
+        const double angle = seconds * 15.0 / 200.0;
+        const double north = 200.0 * std::cos(angle);
+        const double east = 200.0 * std::sin(angle) + seconds;
+        tracks.append(vehicle, latitude + north / metersPerDegree,
+                      longitude + east / (metersPerDegree * std::cos(qDegreesToRadians(latitude))));
+    }
+}
+
+double TestVehicleTracks::distance(const VehicleTracks::Point& point, const VehicleTracks::Point& start, const VehicleTracks::Point& end)
+{
+    const double segmentX = static_cast<qint32>(end.x - start.x);
+    const double segmentY = static_cast<qint32>(end.y - start.y);
+    const double x = static_cast<qint32>(point.x - start.x);
+    const double y = static_cast<qint32>(point.y - start.y);
+    const double length = segmentX * segmentX + segmentY * segmentY;
+    const double along = (length > 0.0) ? qBound(0.0, (x * segmentX + y * segmentY) / length, 1.0) : 0.0;
+    return std::hypot(x - along * segmentX, y - along * segmentY);
+}
+
+void TestVehicleTracks::testAppend()
+{
+    // Points are fixed-point world coordinates that wrap at the antimeridian
+    QCOMPARE(VehicleTracks::project(0.0, 0.0), (VehicleTracks::Point{0x80000000u, 0x80000000u}));
+    QCOMPARE(VehicleTracks::project(0.0, 180.0).x, 0u);
+    QCOMPARE(VehicleTracks::project(0.0, -180.0).x, 0u);
+    QCOMPARE(VehicleTracks::project(90.0, 0.0).y, 0u);
+    QCOMPARE(VehicleTracks::project(-90.0, 0.0).y, 0xffffffffu);
+    QCOMPARE(VehicleTracks::level(15.4), 15);
+    QCOMPARE(VehicleTracks::level(0.0), VehicleTracks::MIN_ZOOM_LEVEL);
+    QCOMPARE(VehicleTracks::level(22.0), VehicleTracks::MAX_ZOOM_LEVEL);
+
+    VehicleTracks tracks(2);
+    tracks.append(1, 42.0, -83.0);
+    QCOMPARE(tracks.vertexCount(1, 15), 1);
+    QCOMPARE(tracks.settledCount(1, 15), 1);
+    QCOMPARE(tracks.vertex(1, 15, 0), VehicleTracks::project(42.0, -83.0));
+
+    // Repeated positions are stored once
+    tracks.append(1, 42.0, -83.0);
+    tracks.append(1, 42.001, -83.0);
+    QCOMPARE(tracks.points(1).size(), size_t(2));
+    QCOMPARE(tracks.vertexCount(1, 15), 2);
+    QCOMPARE(tracks.vertex(1, 15, 1), VehicleTracks::project(42.001, -83.0));
+
+    // Vehicles beyond the capacity are dropped
+    tracks.append(2, 42.0, -83.0);
+    tracks.append(3, 42.0, -83.0);
+    QCOMPARE(tracks.vehicleCount(), 2);
+    QVERIFY(!tracks.contains(3));
+    QCOMPARE(tracks.droppedFrames(), quint64(1));
+    QVERIFY(tracks.points(3).empty());
+    QCOMPARE(tracks.vertexCount(3, 15), 0);
+
+    tracks.clear();
+    QCOMPARE(tracks.vehicleCount(), 0);
+    QCOMPARE(tracks.droppedFrames(), quint64(0));
+}
+
+void TestVehicleTracks::testStraight()
+{
+    // A straight flight of 3000 points only keeps its ends and the vertices settled every MAX_TAIL points
+    VehicleTracks tracks;
+    for (int step = 0; step < 3000; ++step) {
+        tracks.append(1, 42.0, -83.0 + step * 1e-4);
+    }
+    for (int level = VehicleTracks::MIN_ZOOM_LEVEL; level <= VehicleTracks::MAX_ZOOM_LEVEL; ++level) {
+        QCOMPARE(tracks.settledCount(1, level), 3);
+        QVERIFY(tracks.vertexCount(1, level) <= 4 + VehicleTracks::SETTLE_INTERVAL);
+        QCOMPARE(tracks.vertex(1, level, tracks.vertexCount(1, level) - 1), tracks.points(1).back());
+    }
+}
+
+void TestVehicleTracks::testTolerance()
+{
+    VehicleTracks tracks;
+    loiter(tracks, 1, 0, 1000);
+    const std::vector<VehicleTracks::Point>& points = tracks.points(1);
+
+    // Every point lies within the tolerance of the track of every level
+    int previousCount = 0;
+    for (int level = VehicleTracks::MIN_ZOOM_LEVEL; level <= VehicleTracks::MAX_ZOOM_LEVEL; ++level) {
+        const double tolerance = VehicleTracks::TOLERANCE / (WebMercator::worldSize(level) * VehicleTracks::POINT_SCALE);
+        const int count = tracks.vertexCount(1, level);
+        QCOMPARE(tracks.vertex(1, level, 0), points.front());
+        QCOMPARE(tracks.vertex(1, level, count - 1), points.back());
+        for (const VehicleTracks::Point& point : points) {
+            double nearest = std::numeric_limits<double>::max();
+            for (int index = 1; index < count && nearest > tolerance; ++index) {
+                nearest = qMin(nearest, distance(point, tracks.vertex(1, level, index - 1), tracks.vertex(1, level, index)));
+            }
+            QVERIFY2(nearest <= tolerance, qPrintable(QStringLiteral("Level %1").arg(level)));
+        }
+
+        // Finer levels keep more vertices
+        QVERIFY(count >= previousCount);
+        previousCount = count;
+    }
+    QVERIFY(tracks.vertexCount(1, 12) < 100);
+    QVERIFY(tracks.vertexCount(1, VehicleTracks::MAX_ZOOM_LEVEL) > 500);
+}
+
+void TestVehicleTracks::testSettled()
+{
+    VehicleTracks tracks;
+    loiter(tracks, 1, 0, 500);
+
+    // Appending never changes settled vertices
+    std::vector<std::vector<VehicleTracks::Point>> settled(VehicleTracks::LEVEL_COUNT);
+    for (int level = VehicleTracks::MIN_ZOOM_LEVEL; level <= VehicleTracks::MAX_ZOOM_LEVEL; ++level) {
+        for (int index = 0; index < tracks.settledCount(1, level); ++index) {
+            settled[level - VehicleTracks::MIN_ZOOM_LEVEL].push_back(tracks.vertex(1, level, index));
+        }
+    }
+    loiter(tracks, 1, 500, 1500);
+    for (int level = VehicleTracks::MIN_ZOOM_LEVEL; level <= VehicleTracks::MAX_ZOOM_LEVEL; ++level) {
+        const std::vector<VehicleTracks::Point>& before = settled[level - VehicleTracks::MIN_ZOOM_LEVEL];
+        QVERIFY(tracks.settledCount(1, level) >= static_cast<int>(before.size()));
+        for (int index = 0; index < static_cast<int>(before.size()); ++index) {
+            QCOMPARE(tracks.vertex(1, level, index), before[index]);
+        }
+
+        // Only a bounded tail follows the settled vertices
+        QVERIFY(tracks.vertexCount(1, level) - tracks.settledCount(1, level) <= VehicleTracks::SETTLE_INTERVAL + 1);
+    }
+}
+
+void TestVehicleTracks::testBus()
+{
+    TelemetryBus bus;
+    VehicleTracks tracks;
+    tracks.attach(&bus);
+    QVERIFY(bus.hasSubscribers(TelemetryBus::Frames));
+    QSignalSpy updatedSpy(&tracks, &VehicleTracks::updated);
+
+    auto batch = std::make_shared<TelemetryBus::FrameBatch>();
+    batch->frames.resize(2);
+    batch->frames[0].vehicle = 4;
+    batch->frames[0].frame.setPosition(42.0, -83.0);
+    batch->frames[1].vehicle = 5;
+    batch->frames[1].frame.setPosition(42.1, -83.1);
+    bus.publishFrames(batch);
+    QCoreApplication::processEvents();
+
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(tracks.vehicleCount(), 2);
+    QCOMPARE(tracks.vertex(5, 10, 0), VehicleTracks::project(42.1, -83.1));
+
+    tracks.attach(nullptr);
+    QCOMPARE(bus.subscriberCount(), 0);
+}
+
+void TestVehicleTracks::benchmarkAppend()
+{
+    // An hour of a vehicle loitering at 4 Hz, simplified for every zoom level
+    VehicleTracks tracks;
+    QBENCHMARK {
+        tracks.clear();
+        loiter(tracks, 1, 0, 4 * 3600);
+    }
+    QCOMPARE(tracks.points(1).size(), size_t(4 * 3600));
+
+    // At zoom level 7 the whole hour spans a few pixels
+    QVERIFY(tracks.vertexCount(1, 7) < 100);
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestVehicleTracks)
+#include "TestVehicleTracks.moc"
@@ -0,0 +1,125 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <QSet>
+#include <QThread>
+#include <QMutex>
+#include <atomic>
+#include <vector>
+#include "WorkStealingPool.hpp"
+
+class TestWorkStealingPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testThreadCount();
+    void testEachTaskRunsOnce_data();
+    void testEachTaskRunsOnce();
+    void testUsesWorkerThreads();
+    void testUnevenLoadIsStolen();
+    void testRepeatedBatches();
+};
+
+void TestWorkStealingPool::testThreadCount()
+{
+    QCOMPARE(WorkStealingPool(4).threadCount(), 4);
+
+    // At least the calling thread always runs tasks
+    QCOMPARE(WorkStealingPool(0).threadCount(), 1);
+}
+
+void TestWorkStealingPool::testEachTaskRunsOnce_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("tasks");
+
+    QTest::newRow("single thread") << 1 << 100;
+    QTest::newRow("fewer tasks than threads") << 8 << 3;
+    QTest::newRow("one task") << 4 << 1;
+    QTest::newRow("uneven split") << 3 << 1000;
+    QTest::newRow("many threads") << 16 << 5000;
+}
+
+void TestWorkStealingPool::testEachTaskRunsOnce()
+{
+    QFETCH(int, threads);
+    QFETCH(int, tasks);
+
+    WorkStealingPool pool(threads);
+    std::vector<std::atomic<int>> runs(tasks);
+
+    pool.run(tasks, [&runs](int task) {
+        runs[task].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    // run() is a barrier: every task has finished when it returns
+    for (int task = 0; task < tasks; ++task) {
+        QCOMPARE(runs[task].load(), 1);
+    }
+
+    // An empty batch runs nothing
+    std::atomic<int> emptyRuns(0);
+    pool.run(0, [&emptyRuns](int) { emptyRuns.fetch_add(1); });
+    QCOMPARE(emptyRuns.load(), 0);
+}
+
+void TestWorkStealingPool::testUsesWorkerThreads()
+{
+    WorkStealingPool pool(4);
+    QMutex mutex;
+    QSet<QThread*> threads;
+
+    // Slow tasks give every worker the chance to pick some up
+    pool.run(64, [&mutex, &threads](int) {
+        QThread::msleep(2);
+        QMutexLocker locker(&mutex);
+        threads.insert(QThread::currentThread());
+    });
+
+    QVERIFY(threads.contains(QThread::currentThread()));
+    QVERIFY(threads.size() > 1);
+}
+
+void TestWorkStealingPool::testUnevenLoadIsStolen()
+{
+    WorkStealingPool pool(2);
+    std::atomic<int> done(0);
+
+    // All expensive tasks are in the caller's half; the other worker finishes
+    // its cheap half first and then has to steal
+    pool.run(40, [&done](int task) {
+        if (task < 20) {
+            QThread::msleep(5);
+        }
+        done.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    QCOMPARE(done.load(), 40);
+    QVERIFY(pool.stolenTasks() > 0);
+}
+
+void TestWorkStealingPool::testRepeatedBatches()
+{
+    WorkStealingPool pool(4);
+    std::vector<int> values(2000, 0);
+    std::atomic<int> stale(0);
+
+    // Each batch sees the results of the previous one
+    for (int batch = 1; batch <= 200; ++batch) {
+        pool.run(static_cast<int>(values.size()), [&values, &stale, batch](int task) {
+            if (values[task] != batch - 1) {
+                stale.fetch_add(1, std::memory_order_relaxed);
+            }
+            values[task] = batch;
+        });
+    }
+
+    QCOMPARE(stale.load(), 0);
+    for (int value : values) {
+        QCOMPARE(value, 200);
+    }
+}
+
+// Using QTest's own QTEST_MAIN macro
+QTEST_MAIN(TestWorkStealingPool)
+#include "TestWorkStealingPool.moc"